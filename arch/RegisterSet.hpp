@@ -105,6 +105,18 @@ namespace pegasus
             return registers_by_name_;
         }
 
+        /*!
+         * \brief Returns a host pointer to the storage of a register and the ArchData line that
+         * holds it. The ArchData is laid out when the set is constructed and its lines are never
+         * reallocated, so the pointer is valid for the lifetime of the set.
+         */
+        std::pair<uint8_t*, sparta::ArchData::Line*> getRegisterStorage(uint32_t reg_num)
+        {
+            const sparta::ArchDataView* dview = getRegister(reg_num)->getDataView();
+            sparta::ArchData::Line* line = dview->getLine();
+            return {line->getRawDataPtr(dview->getOffset() - line->getOffset()), line};
+        }
+
         // Bring in getRegister(const char* reg_name) from sparta::RegisterSet
         using sparta::RegisterSet::getRegister;
 
@@ -67,10 +67,15 @@ namespace pegasus
 
         const std::vector<Action> & getActions() const { return actions_; };
 
-        ActionGroup* execute(PegasusState* state)
+        // Templated on the state type so the PegasusState methods can be inlined
+        template <typename StateT> ActionGroup* execute(StateT* state)
         {
             Action::ItrType action_it = actions_.begin();
             const Action::ItrType end_it = actions_.end();
+
+            // Actions divert execution to another ActionGroup (e.g. to take a trap) by returning
+            // the end iterator from PegasusState::redirectActionGroup
+            state->setActionGroupEnd(end_it);
             while (action_it != end_it)
             {
                 try
@@ -82,10 +87,17 @@ namespace pegasus
                 }
                 catch (ActionException & action_excp)
                 {
+                    // Code that is not an Action cannot return a redirect, so it still diverts
+                    // execution by throwing
                     return action_excp.getActionGroup();
                 }
             }
 
+            if (ActionGroup* redirect_action_group = state->takeActionGroupRedirect();
+                SPARTA_EXPECT_FALSE(redirect_action_group != nullptr))
+            {
+                return redirect_action_group;
+            }
             return next_action_group_;
         }
 
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/PegasusInst.hpp"
+#include "include/PegasusTypes.hpp"
+
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/StatisticSet.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace pegasus
+{
+    /*!
+     * \class BlockCache
+     * \brief Cache of decoded straight-line instruction blocks for a single hart
+     *
+     * Blocks are recorded by Decode as instructions are fetched and decoded in program order. A
+     * block ends at a change of flow instruction, an instruction that accesses a CSR, a 4K page
+     * boundary or when it reaches the maximum block length. Blocks are keyed by the physical
+     * address of their first instruction and the translation context they were decoded under.
+     *
+     * Blocks on a page are invalidated when the page is written to, and all blocks are flushed by
+     * fence.i, sfence.vma, hfence.vvma, hfence.gvma or a change to the enabled extensions.
+     */
+    class BlockCache
+    {
+      public:
+        struct Block {
+            // Physical address of the first instruction
+            Addr paddr = 0;
+            // Physical address following the last instruction
+            Addr next_paddr = 0;
+            uint64_t context = 0;
+            // Cleared when the block is invalidated while it is executing
+            bool valid = true;
+            std::vector<PegasusInstPtr> insts;
+        };
+
+        BlockCache(sparta::StatisticSet* stats, const uint32_t max_block_insts) :
+            max_block_insts_(max_block_insts),
+            hits_(stats, "block_cache_hits", "Number of block cache hits",
+                  sparta::Counter::COUNT_NORMAL),
+            misses_(stats, "block_cache_misses", "Number of block cache misses",
+                    sparta::Counter::COUNT_NORMAL),
+            block_insts_(stats, "block_cache_insts",
+                         "Number of instructions executed from the block cache",
+                         sparta::Counter::COUNT_NORMAL),
+            invalidations_(stats, "block_cache_invalidations",
+                           "Number of block cache page invalidations and flushes",
+                           sparta::Counter::COUNT_NORMAL)
+        {
+        }
+
+        bool isEnabled() const { return max_block_insts_ != 0; }
+
+        uint32_t getMaxBlockInsts() const { return max_block_insts_; }
+
+        uint64_t getNumHits() const { return hits_.get(); }
+
+        uint64_t getNumMisses() const { return misses_.get(); }
+
+        uint64_t getNumBlockInsts() const { return block_insts_.get(); }
+
+        // Returns the block starting at paddr, if one has been recorded
+        const Block* lookup(const Addr paddr, const uint64_t context)
+        {
+            const auto it = blocks_.find(BlockKey{paddr, context});
+            if (it == blocks_.end())
+            {
+                ++misses_;
+                return nullptr;
+            }
+            ++hits_;
+
+            // Executing a different block ends the block being recorded
+            recording_block_ = nullptr;
+            return it->second.get();
+        }
+
+        void countBlockInsts(const uint64_t num_insts) { block_insts_ += num_insts; }
+
+        // Append a decoded instruction to the block being recorded. Starts a new block if paddr
+        // does not follow the last recorded instruction.
+        void record(const Addr paddr, const uint64_t context, const PegasusInstPtr & inst,
+                    const bool ends_block)
+        {
+            if ((recording_block_ == nullptr) || (recording_block_->next_paddr != paddr)
+                || (recording_block_->context != context))
+            {
+                recording_block_ = nullptr;
+
+                auto [it, inserted] = blocks_.try_emplace(BlockKey{paddr, context});
+                if (!inserted)
+                {
+                    return;
+                }
+                it->second.reset(new Block);
+                recording_block_ = it->second.get();
+                recording_block_->paddr = paddr;
+                recording_block_->context = context;
+
+                const Addr page = getPage_(paddr);
+                code_pages_.insert(page);
+                code_begin_ = std::min(code_begin_, page << PAGESHIFT);
+                code_end_ = std::max(code_end_, (page + 1) << PAGESHIFT);
+            }
+
+            recording_block_->insts.emplace_back(inst);
+            recording_block_->next_paddr = paddr + inst->getOpcodeSize();
+
+            if (ends_block || (recording_block_->insts.size() >= max_block_insts_)
+                || (getPage_(recording_block_->next_paddr) != getPage_(paddr)))
+            {
+                recording_block_ = nullptr;
+            }
+        }
+
+        void stopRecording() { recording_block_ = nullptr; }
+
+        // Fast check for stores, true if the address may be on a page with cached blocks
+        bool containsCode(const Addr paddr) const
+        {
+            return (paddr >= code_begin_) && (paddr < code_end_)
+                   && code_pages_.contains(getPage_(paddr));
+        }
+
+        // Invalidate blocks on the page(s) written by a store
+        void invalidateStore(const Addr paddr, const size_t size)
+        {
+            if (SPARTA_EXPECT_FALSE(containsCode(paddr)))
+            {
+                invalidatePage(paddr);
+            }
+            if (SPARTA_EXPECT_FALSE(containsCode(paddr + size - 1)))
+            {
+                invalidatePage(paddr + size - 1);
+            }
+        }
+
+        // Invalidate all blocks on the page containing paddr
+        void invalidatePage(const Addr paddr)
+        {
+            const Addr page = getPage_(paddr);
+            if (code_pages_.erase(page) == 0)
+            {
+                return;
+            }
+
+            std::erase_if(blocks_,
+                          [this, page](auto & item)
+                          {
+                              if (getPage_(item.second->paddr) == page)
+                              {
+                                  retireBlock_(std::move(item.second));
+                                  return true;
+                              }
+                              return false;
+                          });
+            ++invalidations_;
+        }
+
+        // Invalidate all blocks
+        void flush()
+        {
+            for (auto & [key, block] : blocks_)
+            {
+                retireBlock_(std::move(block));
+            }
+            blocks_.clear();
+            code_pages_.clear();
+            code_begin_ = std::numeric_limits<Addr>::max();
+            code_end_ = 0;
+            ++invalidations_;
+        }
+
+        // Invalidated blocks are kept alive until no block is executing
+        void releaseRetiredBlocks() { retired_blocks_.clear(); }
+
+      private:
+        static constexpr uint64_t PAGESHIFT = 12;
+
+        static Addr getPage_(const Addr paddr) { return paddr >> PAGESHIFT; }
+
+        void retireBlock_(std::unique_ptr<Block> block)
+        {
+            if (block.get() == recording_block_)
+            {
+                recording_block_ = nullptr;
+            }
+            block->valid = false;
+            retired_blocks_.emplace_back(std::move(block));
+        }
+
+        struct BlockKey {
+            Addr paddr;
+            uint64_t context;
+
+            bool operator==(const BlockKey & other) const = default;
+        };
+
+        struct BlockKeyHash {
+            size_t operator()(const BlockKey & key) const
+            {
+                return std::hash<Addr>()(key.paddr) ^ (key.context * 0x9e3779b97f4a7c15ull);
+            }
+        };
+
+        const uint32_t max_block_insts_;
+
+        std::unordered_map<BlockKey, std::unique_ptr<Block>, BlockKeyHash> blocks_;
+        std::vector<std::unique_ptr<Block>> retired_blocks_;
+        Block* recording_block_ = nullptr;
+
+        // Physical pages with cached blocks
+        std::unordered_set<Addr> code_pages_;
+        Addr code_begin_ = std::numeric_limits<Addr>::max();
+        Addr code_end_ = 0;
+
+        sparta::Counter hits_;
+        sparta::Counter misses_;
+        sparta::Counter block_insts_;
+        sparta::Counter invalidations_;
+    };
+} // namespace pegasus
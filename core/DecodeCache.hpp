@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+#include "core/PegasusInst.hpp"
+#include "include/PegasusTypes.hpp"
+
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/StatisticSet.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace pegasus
+{
+    /*!
+     * \class DecodeCache
+     * \brief Direct-mapped cache of decoded instructions for a single hart
+     *
+     * Decoded instructions are immutable, so every execution of an opcode can share the same
+     * PegasusInst instead of asking Mavis to build a new one. Entries depend on the enabled
+     * extensions and must be flushed whenever the Mavis context changes.
+     */
+    class DecodeCache
+    {
+      public:
+        DecodeCache(sparta::StatisticSet* stats, const uint32_t num_entries) :
+            entries_(num_entries),
+            index_mask_(num_entries ? (num_entries - 1) : 0),
+            hits_(stats, "decode_cache_hits", "Number of decode cache hits",
+                  sparta::Counter::COUNT_NORMAL),
+            misses_(stats, "decode_cache_misses", "Number of decode cache misses",
+                    sparta::Counter::COUNT_NORMAL)
+        {
+            sparta_assert((num_entries & index_mask_) == 0,
+                          "Number of decode cache entries must be a power of 2: " << num_entries);
+        }
+
+        bool isEnabled() const { return !entries_.empty(); }
+
+        uint64_t getNumHits() const { return hits_.get(); }
+
+        uint64_t getNumMisses() const { return misses_.get(); }
+
+        // Returns the decoded instruction for opcode, or nullptr if it has not been decoded
+        const PegasusInstPtr* lookup(const Opcode opcode)
+        {
+            const Entry & entry = entries_[getIndex_(opcode)];
+            if (entry.inst && (entry.opcode == opcode))
+            {
+                ++hits_;
+                return &entry.inst;
+            }
+            ++misses_;
+            return nullptr;
+        }
+
+        void insert(const Opcode opcode, const PegasusInstPtr & inst)
+        {
+            Entry & entry = entries_[getIndex_(opcode)];
+            entry.opcode = opcode;
+            entry.inst = inst;
+        }
+
+        // Release all decoded instructions
+        void flush()
+        {
+            for (Entry & entry : entries_)
+            {
+                entry.inst.reset();
+            }
+        }
+
+      private:
+        struct Entry {
+            Opcode opcode = 0;
+            PegasusInstPtr inst;
+        };
+
+        std::vector<Entry> entries_;
+        const uint32_t index_mask_;
+
+        sparta::Counter hits_;
+        sparta::Counter misses_;
+
+        // Fold the upper bits into the index so that opcodes differing only in their immediate
+        // or register fields do not all collide
+        uint32_t getIndex_(const Opcode opcode) const
+        {
+            return (opcode ^ (opcode >> 15) ^ (opcode >> 25)) & index_mask_;
+        }
+    };
+} // namespace pegasus
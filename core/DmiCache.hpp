@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "include/PegasusTypes.hpp"
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace pegasus
+{
+    /*!
+     * \class DmiCache
+     * \brief Direct-mapped cache of host pointers to 4K pages of system memory
+     *
+     * Lets PegasusState access plain system memory with a memcpy instead of going through the
+     * memory map. Pages that are backed by devices (MagicMemory, UART) have no host pointer and
+     * are never cached. Host pointers remain valid for the lifetime of the system memory, so
+     * entries never need to be invalidated.
+     */
+    class DmiCache
+    {
+      public:
+        static constexpr uint64_t PAGESHIFT = 12;
+        static constexpr Addr PAGESIZE = 1ull << PAGESHIFT;
+        static constexpr Addr PAGEOFFSET_MASK = PAGESIZE - 1;
+
+        explicit DmiCache(const uint32_t num_entries) :
+            entries_(num_entries),
+            index_mask_(num_entries ? (num_entries - 1) : 0)
+        {
+            sparta_assert((num_entries & index_mask_) == 0,
+                          "Number of DMI cache entries must be a power of 2: " << num_entries);
+        }
+
+        bool isEnabled() const { return !entries_.empty(); }
+
+        // Returns true if an access of size bytes at paddr stays within one page
+        static bool isPageContained(const Addr paddr, const size_t size)
+        {
+            return ((paddr & PAGEOFFSET_MASK) + size) <= PAGESIZE;
+        }
+
+        // Returns the host pointer for paddr if its page is cached
+        uint8_t* lookup(const Addr paddr) const
+        {
+            const Entry & entry = entries_[getIndex_(paddr)];
+            if (entry.page == (paddr >> PAGESHIFT))
+            {
+                return entry.host_page + (paddr & PAGEOFFSET_MASK);
+            }
+            return nullptr;
+        }
+
+        // Cache the host pointer to the start of the page containing paddr
+        void insert(const Addr paddr, uint8_t* host_page)
+        {
+            Entry & entry = entries_[getIndex_(paddr)];
+            entry.page = paddr >> PAGESHIFT;
+            entry.host_page = host_page;
+        }
+
+      private:
+        struct Entry {
+            // Page number (paddr >> PAGESHIFT), all ones is never a valid page number
+            Addr page = ~Addr(0);
+            uint8_t* host_page = nullptr;
+        };
+
+        std::vector<Entry> entries_;
+        const uint32_t index_mask_;
+
+        uint32_t getIndex_(const Addr paddr) const { return (paddr >> PAGESHIFT) & index_mask_; }
+    };
+} // namespace pegasus
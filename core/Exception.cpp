@@ -108,15 +108,16 @@ namespace pegasus
         const bool prev_virt_mode = state->getVirtualMode();
         // PC that caused the exception
         const XLEN epc_val = state->getPc();
-        // Get the exception code, handles interrupts and virtual traps
-        const XLEN interrupt_bit = 1 << ((sizeof(XLEN) * 4) - 1);
-        const XLEN cause_val = is_interrupt ? (excp_code & interrupt_bit) : excp_code;
+        // Get the exception code, handles interrupts and virtual traps. The MSB of the cause is
+        // set for interrupts.
+        const XLEN interrupt_bit = XLEN(1) << ((sizeof(XLEN) * 8) - 1);
+        const XLEN cause_val = is_interrupt ? (excp_code | interrupt_bit) : excp_code;
         // Depending on the exception type, get the trap value
         const uint64_t trap_val = is_interrupt
                                       ? determineTrapValue_(interrupt_cause_.getValue(), state)
                                       : determineTrapValue_(fault_cause_.getValue(), state);
         // Values for updating VSSTATUS/SSTATUS
-        const auto mstatus_sie = READ_CSR_FIELD<XLEN>(state, MSTATUS, "sie");
+        const auto mstatus_sie = READ_CSR_FIELD<XLEN, MSTATUS, "sie">(state);
         const auto xpp_val = static_cast<XLEN>(state->getPrivMode());
         const uint64_t sie_val = 0;
 
@@ -124,15 +125,15 @@ namespace pegasus
         if (virt_mode && (priv_mode == PrivMode::SUPERVISOR))
         {
             const TrapVectorMode vstvec_mode =
-                (TrapVectorMode)READ_CSR_FIELD<XLEN>(state, VSTVEC, "mode");
-            const XLEN vstvec_base = READ_CSR_FIELD<XLEN>(state, VSTVEC, "base") << 2;
+                (TrapVectorMode)READ_CSR_FIELD<XLEN, VSTVEC, "mode">(state);
+            const XLEN vstvec_base = READ_CSR_FIELD<XLEN, VSTVEC, "base">(state) << 2;
             if (vstvec_mode == TrapVectorMode::DIRECT)
             {
                 trap_handler_address = vstvec_base;
             }
             if (vstvec_mode == TrapVectorMode::VECTORED)
             {
-                trap_handler_address = vstvec_base + 4 * cause_val * (XLEN)is_interrupt;
+                trap_handler_address = vstvec_base + 4 * excp_code * (XLEN)is_interrupt;
             }
 
             WRITE_CSR_REG<XLEN>(state, VSEPC, epc_val);
@@ -140,23 +141,23 @@ namespace pegasus
             WRITE_CSR_REG<XLEN>(state, VSTVAL, trap_val);
 
             // Update VSSTATUS
-            WRITE_CSR_FIELD<XLEN>(state, VSSTATUS, "spie", mstatus_sie);
-            WRITE_CSR_FIELD<XLEN>(state, VSSTATUS, "spp", xpp_val);
-            WRITE_CSR_FIELD<XLEN>(state, VSSTATUS, "sie", sie_val);
+            WRITE_CSR_FIELD<XLEN, VSSTATUS, "spie">(state, mstatus_sie);
+            WRITE_CSR_FIELD<XLEN, VSSTATUS, "spp">(state, xpp_val);
+            WRITE_CSR_FIELD<XLEN, VSSTATUS, "sie">(state, sie_val);
         }
         // HS-mode
         else if (priv_mode == PrivMode::SUPERVISOR)
         {
             const TrapVectorMode stvec_mode =
-                (TrapVectorMode)READ_CSR_FIELD<XLEN>(state, STVEC, "mode");
-            const XLEN stvec_base = READ_CSR_FIELD<XLEN>(state, STVEC, "base") << 2;
+                (TrapVectorMode)READ_CSR_FIELD<XLEN, STVEC, "mode">(state);
+            const XLEN stvec_base = READ_CSR_FIELD<XLEN, STVEC, "base">(state) << 2;
             if (stvec_mode == TrapVectorMode::DIRECT)
             {
                 trap_handler_address = stvec_base;
             }
             if (stvec_mode == TrapVectorMode::VECTORED)
             {
-                trap_handler_address = stvec_base + 4 * cause_val * (XLEN)is_interrupt;
+                trap_handler_address = stvec_base + 4 * excp_code * (XLEN)is_interrupt;
             }
 
             WRITE_CSR_REG<XLEN>(state, SEPC, epc_val);
@@ -164,24 +165,24 @@ namespace pegasus
             WRITE_CSR_REG<XLEN>(state, STVAL, trap_val);
 
             // Update SSTATUS
-            WRITE_CSR_FIELD<XLEN>(state, SSTATUS, "spie", mstatus_sie);
-            WRITE_CSR_FIELD<XLEN>(state, SSTATUS, "spp", xpp_val);
-            WRITE_CSR_FIELD<XLEN>(state, SSTATUS, "sie", sie_val);
+            WRITE_CSR_FIELD<XLEN, SSTATUS, "spie">(state, mstatus_sie);
+            WRITE_CSR_FIELD<XLEN, SSTATUS, "spp">(state, xpp_val);
+            WRITE_CSR_FIELD<XLEN, SSTATUS, "sie">(state, sie_val);
 
             // Update HSTATUS
             if (state->hasHypervisor())
             {
                 const uint64_t spv_val = prev_virt_mode;
-                WRITE_CSR_FIELD<XLEN>(state, HSTATUS, "spv", spv_val);
+                WRITE_CSR_FIELD<XLEN, HSTATUS, "spv">(state, spv_val);
 
                 if (prev_virt_mode)
                 {
-                    WRITE_CSR_FIELD<XLEN>(state, HSTATUS, "spvp", xpp_val);
+                    WRITE_CSR_FIELD<XLEN, HSTATUS, "spvp">(state, xpp_val);
                 }
 
                 const uint64_t gva_val =
                     !is_interrupt ? determineGvaValue_(fault_cause_.getValue(), prev_virt_mode) : 0;
-                WRITE_CSR_FIELD<XLEN>(state, HSTATUS, "gva", gva_val);
+                WRITE_CSR_FIELD<XLEN, HSTATUS, "gva">(state, gva_val);
 
                 // TODO: Guest physical address that faulted, shifted right by 2 bits
                 const uint64_t htval_val = 0;
@@ -195,15 +196,15 @@ namespace pegasus
         else if (priv_mode == PrivMode::MACHINE)
         {
             const TrapVectorMode mtvec_mode =
-                (TrapVectorMode)READ_CSR_FIELD<XLEN>(state, MTVEC, "mode");
-            const XLEN mtvec_base = READ_CSR_FIELD<XLEN>(state, MTVEC, "base") << 2;
+                (TrapVectorMode)READ_CSR_FIELD<XLEN, MTVEC, "mode">(state);
+            const XLEN mtvec_base = READ_CSR_FIELD<XLEN, MTVEC, "base">(state) << 2;
             if (mtvec_mode == TrapVectorMode::DIRECT)
             {
                 trap_handler_address = mtvec_base;
             }
             if (mtvec_mode == TrapVectorMode::VECTORED)
             {
-                trap_handler_address = mtvec_base + 4 * cause_val * (XLEN)is_interrupt;
+                trap_handler_address = mtvec_base + 4 * excp_code * (XLEN)is_interrupt;
             }
 
             WRITE_CSR_REG<XLEN>(state, MEPC, epc_val);
@@ -211,11 +212,11 @@ namespace pegasus
             WRITE_CSR_REG<XLEN>(state, MTVAL, trap_val);
 
             // Update MSTATUS
-            const auto mstatus_mie = READ_CSR_FIELD<XLEN>(state, MSTATUS, "mie");
-            WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "mpie", mstatus_mie);
-            WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "mpp", xpp_val);
+            const auto mstatus_mie = READ_CSR_FIELD<XLEN, MSTATUS, "mie">(state);
+            WRITE_CSR_FIELD<XLEN, MSTATUS, "mpie">(state, mstatus_mie);
+            WRITE_CSR_FIELD<XLEN, MSTATUS, "mpp">(state, xpp_val);
             const uint64_t mie_val = 0;
-            WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "mie", mie_val);
+            WRITE_CSR_FIELD<XLEN, MSTATUS, "mie">(state, mie_val);
 
             if (state->hasHypervisor())
             {
@@ -228,13 +229,13 @@ namespace pegasus
 
                 if constexpr (std::is_same_v<XLEN, RV64>)
                 {
-                    WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "mpv", mpv_val);
-                    WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "gva", gva_val);
+                    WRITE_CSR_FIELD<XLEN, MSTATUS, "mpv">(state, mpv_val);
+                    WRITE_CSR_FIELD<XLEN, MSTATUS, "gva">(state, gva_val);
                 }
                 else
                 {
-                    WRITE_CSR_FIELD<XLEN>(state, MSTATUSH, "mpv", mpv_val);
-                    WRITE_CSR_FIELD<XLEN>(state, MSTATUSH, "gva", gva_val);
+                    WRITE_CSR_FIELD<XLEN, MSTATUSH, "mpv">(state, mpv_val);
+                    WRITE_CSR_FIELD<XLEN, MSTATUSH, "gva">(state, gva_val);
                 }
             }
         }
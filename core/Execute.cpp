@@ -17,11 +17,51 @@ namespace pegasus
     }
 
     Action::ItrType Execute::execute_(PegasusState* state, Action::ItrType action_it)
+    {
+        const auto & inst = state->getCurrentInst();
+
+        // Atomics access the reservations and memory of all harts, and floating point
+        // instructions use the SoftFloat rounding mode and exception flags, which are shared by
+        // all host threads. They are executed when the hart runs alone.
+        if (SPARTA_EXPECT_FALSE(state->inParallelWindow())
+            && (inst->isAtomic() || inst->usesSoftFloat()))
+        {
+            return state->endParallelWindow();
+        }
+
+        InstActionGroupKey key;
+        key.extractor = inst->getExtractorInfo();
+        key.writes_csr = inst->writesCsr();
+        key.csr = inst->hasCsr() ? inst->getCsr() : 0;
+        key.translation_config = state->getTranslateUnit()->getTranslationConfig();
+
+        ActionGroup* inst_action_group = nullptr;
+        if (auto it = inst_action_group_cache_.find(key);
+            SPARTA_EXPECT_TRUE(it != inst_action_group_cache_.end()))
+        {
+            inst_action_group = &it->second;
+        }
+        else
+        {
+            inst_action_group = buildInstActionGroup_(state, inst, key);
+        }
+        state->getInstScratch()->action_group = inst_action_group;
+
+        ILOG(inst);
+
+        // Execute the instruction
+        execute_action_group_.setNextActionGroup(inst_action_group);
+        return ++action_it;
+    }
+
+    ActionGroup* Execute::buildInstActionGroup_(PegasusState* state, const PegasusInstPtr & inst,
+                                                const InstActionGroupKey & key)
     {
         const InstHandlers* inst_handlers = state->getCore()->getInstHandlers();
+        ActionGroup* inst_action_group =
+            &inst_action_group_cache_.emplace(key, *key.extractor->getActionGroup()).first->second;
+
         // Connect instruction to Fetch
-        const auto inst = state->getCurrentInst();
-        ActionGroup* inst_action_group = inst->getActionGroup();
         inst_action_group->setNextActionGroup(state->getFinishActionGroup());
 
         // Insert translation Action into instruction's ActionGroup between the compute address
@@ -59,12 +99,25 @@ namespace pegasus
             }
         }
 
-        if (inst->writesCsr())
+        if (inst->hasCsr())
+        {
+            const InstHandlers::CsrReadActionsMap* csr_read_actions =
+                (state->getXlen() == 64) ? inst_handlers->getCsrReadActionsMap<RV64>()
+                                         : inst_handlers->getCsrReadActionsMap<RV32>();
+            const auto & action_it = csr_read_actions->find(key.csr);
+            if (action_it != csr_read_actions->end())
+            {
+                auto & action = action_it->second;
+                inst_action_group->insertActionBefore(action, ActionTags::EXECUTE_TAG);
+            }
+        }
+
+        if (key.writes_csr)
         {
             const InstHandlers::CsrUpdateActionsMap* csr_update_actions =
                 (state->getXlen() == 64) ? inst_handlers->getCsrUpdateActionsMap<RV64>()
                                          : inst_handlers->getCsrUpdateActionsMap<RV32>();
-            const auto & action_it = csr_update_actions->find(inst->getCsr());
+            const auto & action_it = csr_update_actions->find(key.csr);
             if (action_it != csr_update_actions->end())
             {
                 auto & action = action_it->second;
@@ -74,10 +127,7 @@ namespace pegasus
 
         state->insertExecuteActions(inst_action_group, inst->isMemoryInst());
 
-        ILOG(inst);
-
-        // Execute the instruction
-        execute_action_group_.setNextActionGroup(inst_action_group);
-        return ++action_it;
+        DLOG("Built ActionGroup for " << inst->getMnemonic() << ": " << inst_action_group);
+        return inst_action_group;
     }
 } // namespace pegasus
@@ -1,14 +1,18 @@
 #pragma once
 
 #include "core/ActionGroup.hpp"
+#include "core/PegasusInst.hpp"
 
 #include "sparta/simulation/ParameterSet.hpp"
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/simulation/Unit.hpp"
 
+#include <unordered_map>
+
 namespace pegasus
 {
     class PegasusState;
+    class PegasusExtractor;
 
     class Execute : public sparta::Unit
     {
@@ -27,9 +31,44 @@ namespace pegasus
 
         ActionGroup* getActionGroup() { return &execute_action_group_; }
 
+        // Must be called when the Actions inserted into instruction ActionGroups change for
+        // reasons not captured by the cache key (i.e. an Observer is added)
+        void invalidateInstActionGroupCache() { inst_action_group_cache_.clear(); }
+
       private:
         Action::ItrType execute_(pegasus::PegasusState* state, Action::ItrType action_it);
 
         ActionGroup execute_action_group_{"Execute"};
+
+        // Fully linked instruction ActionGroups (compute address, translate, CSR read, execute,
+        // CSR update and Observer Actions) are built once and reused for every execution of the
+        // instruction
+        struct InstActionGroupKey {
+            // One PegasusExtractor per instruction mnemonic
+            const PegasusExtractor* extractor = nullptr;
+            // CSR accessed by the instruction, if any
+            uint32_t csr = 0;
+            // Translation modes and XLEN of the translate and CSR update Actions
+            uint32_t translation_config = 0;
+            bool writes_csr = false;
+
+            bool operator==(const InstActionGroupKey & other) const = default;
+        };
+
+        struct InstActionGroupKeyHash {
+            size_t operator()(const InstActionGroupKey & key) const
+            {
+                size_t hash = std::hash<const void*>()(key.extractor);
+                hash ^= (static_cast<size_t>(key.csr) << 1) | key.writes_csr;
+                hash ^= static_cast<size_t>(key.translation_config) << 16;
+                return hash;
+            }
+        };
+
+        std::unordered_map<InstActionGroupKey, ActionGroup, InstActionGroupKeyHash>
+            inst_action_group_cache_;
+
+        ActionGroup* buildInstActionGroup_(PegasusState* state, const PegasusInstPtr & inst,
+                                           const InstActionGroupKey & key);
     };
 } // namespace pegasus
@@ -11,7 +11,10 @@
 
 namespace pegasus
 {
-    Fetch::Fetch(sparta::TreeNode* fetch_node, const FetchParameters*) : sparta::Unit(fetch_node)
+    Fetch::Fetch(sparta::TreeNode* fetch_node, const FetchParameters* p) :
+        sparta::Unit(fetch_node),
+        block_cache_(&unit_stat_set_, p->max_block_insts),
+        decode_cache_(&unit_stat_set_, p->decode_cache_entries)
     {
         Action fetch_action =
             pegasus::Action::createAction<&Fetch::fetch_>(this, "fetch", ActionTags::FETCH_TAG);
@@ -48,6 +51,16 @@ namespace pegasus
         PegasusState::SimState* sim_state = state->getSimState();
         sim_state->reset();
 
+        // Take an interrupt instead of fetching if one became pending or enabled
+        if (SPARTA_EXPECT_FALSE(state->isInterruptCheckRequested()))
+        {
+            const sparta::utils::ValidValue<InterruptCause> interrupt = state->checkInterrupts();
+            if (interrupt.isValid())
+            {
+                return state->redirectToException(interrupt.getValue());
+            }
+        }
+
         PegasusTranslationState* translation_state = state->getFetchTranslationState();
         translation_state->reset();
         translation_state->makeRequest(state->getPc(), sizeof(Opcode));
@@ -63,6 +76,13 @@ namespace pegasus
             state->getFetchTranslationState()->getResult();
         state->getFetchTranslationState()->popResult();
 
+        // Instructions outside of plain memory are fetched when the hart runs alone
+        if (SPARTA_EXPECT_FALSE(
+                !state->canAccessInParallel(result.getPAddr(), result.getSize(), false)))
+        {
+            return state->endParallelWindow();
+        }
+
         // When compressed instructions are enabled, it is possible for a full sized instruction (32
         // bits) to cross a 4K page boundary meaning that first 16 bits of the instruction are on a
         // different page than the second 16 bits. Fetch will always request translation for a 32
@@ -98,12 +118,13 @@ namespace pegasus
         OpcodeSize opcode_size = 4;
         if (SPARTA_EXPECT_TRUE(!page_crossing_access))
         {
-            std::vector<uint8_t> buffer;
-            if (state->readMemory<uint32_t>(result, buffer, MemAccessSource::FETCH) == false)
+            const std::optional<uint32_t> mem_val =
+                state->readMemory<uint32_t>(result, MemAccessSource::FETCH);
+            if (!mem_val)
             {
                 THROW_FETCH_ACCESS;
             }
-            opcode = convertFromByteVector<uint32_t>(buffer);
+            opcode = *mem_val;
 
             // Compression detection
             if ((opcode & 0x3) != 0x3)
@@ -117,49 +138,66 @@ namespace pegasus
             if (opcode == 0)
             {
                 // Load the first 2B, could be a valid 2B compressed inst
-                std::vector<uint8_t> buffer;
-                if (state->readMemory<uint16_t>(result, buffer, MemAccessSource::FETCH) == false)
+                const std::optional<uint16_t> mem_val =
+                    state->readMemory<uint16_t>(result, MemAccessSource::FETCH);
+                if (!mem_val)
                 {
                     THROW_FETCH_ACCESS;
                 }
-                opcode = convertFromByteVector<uint16_t>(buffer);
+                opcode = *mem_val;
                 opcode_size = 2;
 
                 if ((opcode & 0x3) == 0x3)
                 {
                     // Go back to inst translate
-                    throw ActionException(fetch_action_group_.getNextActionGroup());
+                    return state->redirectActionGroup(fetch_action_group_.getNextActionGroup());
                 }
             }
             else
             {
                 // Load the second 2B of a possible 4B inst
-                std::vector<uint8_t> buffer;
-                if (state->readMemory<uint16_t>(result, buffer, MemAccessSource::FETCH) == false)
+                const std::optional<uint16_t> mem_val =
+                    state->readMemory<uint16_t>(result, MemAccessSource::FETCH);
+                if (!mem_val)
                 {
                     THROW_FETCH_ACCESS;
                 }
-                opcode |= convertFromByteVector<uint16_t>(buffer) << 16;
+                opcode |= static_cast<Opcode>(*mem_val) << 16;
             }
         }
 
-        // Decode instruction with Mavis
+        // Decoded instructions are shared, only decode with Mavis if the opcode is not cached
+        const PegasusInstPtr* cached_inst = decode_cache_.isEnabled() ? decode_cache_.lookup(opcode)
+                                                                      : nullptr;
         PegasusInstPtr inst = nullptr;
-        try
+        if (SPARTA_EXPECT_TRUE(cached_inst != nullptr))
         {
-            inst = state->getMavis()->makeInst(opcode, state);
-            inst->updateVectorConfig(state); // Old PegasusInst may be returned from cache. So
-                                             // outside-constructor call is needed.
-            assert(state->getCurrentInst() == nullptr);
-            state->setCurrentInst(inst);
-            // Set next PC, can be overidden by a branch/jump instruction or an exception
-            state->setNextPc(state->getPc() + opcode_size);
+            inst = *cached_inst;
         }
-        catch (const mavis::BaseException & e)
+        else
         {
-            THROW_ILLEGAL_INST;
+            try
+            {
+                inst = state->getMavis()->makeInst(opcode, state);
+            }
+            catch (const mavis::BaseException & e)
+            {
+                THROW_ILLEGAL_INST;
+            }
+
+            if (decode_cache_.isEnabled())
+            {
+                decode_cache_.insert(opcode, inst);
+            }
         }
 
+        // The vector config is per-execution state and must be recomputed for shared insts
+        inst->updateVectorConfig(state);
+        assert(state->getCurrentInst() == nullptr);
+        state->setCurrentInst(inst);
+        // Set next PC, can be overidden by a branch/jump instruction or an exception
+        state->setNextPc(state->getPc() + opcode_size);
+
         // If we only fetched 2B and found a valid compressed inst, then cancel the translation
         // request for the second 2B
         if (page_crossing_access && (opcode_size == 2))
@@ -167,6 +205,32 @@ namespace pegasus
             state->getFetchTranslationState()->popRequest();
         }
 
+        if (SPARTA_EXPECT_FALSE(!checkInst_(state, inst)))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        if (isBlockCacheEnabled())
+        {
+            if (SPARTA_EXPECT_FALSE(page_crossing_access))
+            {
+                block_cache_.stopRecording();
+            }
+            else
+            {
+                // Any instruction that may change the control flow or the translation context
+                // ends the block
+                const bool ends_block = inst->isChangeOfFlowInst() || inst->isReturnInst()
+                                        || inst->hasCsr() || inst->unimplemented();
+                block_cache_.record(result.getPAddr(), getBlockContext_(state), inst, ends_block);
+            }
+        }
+
+        return ++action_it;
+    }
+
+    bool Fetch::checkInst_(PegasusState* state, const PegasusInstPtr & inst) const
+    {
         // Check if Zvfh/Zvfhmin are enabled for vector BF16 support
         if (SPARTA_EXPECT_FALSE(inst->isVector() && inst->isFloat()
                                 && (state->getVectorConfig()->getSEW() == 16)))
@@ -175,7 +239,7 @@ namespace pegasus
             {
                 if (false == (state->isExtensionEnabled("zfhmin") && inst->hasMavisTag("zfhmin")))
                 {
-                    THROW_ILLEGAL_INST;
+                    return false;
                 }
             }
         }
@@ -187,19 +251,107 @@ namespace pegasus
                 inst->getMavisOpcodeInfo()->getSpecialField(mavis::OpcodeInfo::SpecialField::CSR);
             if (state->getCsrRegister(csr) == nullptr)
             {
-                THROW_ILLEGAL_INST;
+                return false;
             }
 
             if (csr == SATP)
             {
-                const uint32_t tvm_val = READ_CSR_FIELD<RV64>(state, MSTATUS, "tvm");
+                const uint32_t tvm_val = READ_CSR_FIELD<RV64, MSTATUS, "tvm">(state);
                 if ((state->getPrivMode() == PrivMode::SUPERVISOR) && tvm_val)
                 {
-                    THROW_ILLEGAL_INST;
+                    return false;
                 }
             }
         }
 
-        return ++action_it;
+        return true;
+    }
+
+    bool Fetch::isBlockCacheEnabled() const
+    {
+        return block_cache_.isEnabled() && state_->getObservers().empty();
+    }
+
+    uint64_t Fetch::getBlockContext_(PegasusState* state) const
+    {
+        // Decoded instructions depend on XLEN, which is part of the translation config
+        return state->getTranslateUnit()->getTranslationConfig();
+    }
+
+    ActionGroup* Fetch::executeBlock(PegasusState* state)
+    {
+        PegasusTranslationState* translation_state = state->getFetchTranslationState();
+        const PegasusTranslationState::TranslationResult & result = translation_state->getResult();
+
+        // Instructions that cross a page boundary are never cached
+        if (SPARTA_EXPECT_FALSE(result.getSize() != sizeof(Opcode)))
+        {
+            return &decode_action_group_;
+        }
+
+        block_cache_.releaseRetiredBlocks();
+        const BlockCache::Block* block =
+            block_cache_.lookup(result.getPAddr(), getBlockContext_(state));
+        if (block == nullptr)
+        {
+            return &decode_action_group_;
+        }
+        translation_state->popResult();
+
+        // Instructions in a block are on the same page as the first instruction, so their
+        // translations are not repeated
+        PegasusState::SimState* sim_state = state->getSimState();
+        ActionGroup* execute_action_group = state->getExecuteUnit()->getActionGroup();
+        ActionGroup* finish_action_group = state->getFinishActionGroup();
+        ActionGroup* next_action_group = &fetch_action_group_;
+        uint64_t num_insts = 0;
+        for (const PegasusInstPtr & inst : block->insts)
+        {
+            if (num_insts != 0)
+            {
+                sim_state->reset();
+            }
+            ++num_insts;
+
+            const Addr pc = state->getPc();
+            const Addr next_pc = pc + inst->getOpcodeSize();
+            try
+            {
+                sim_state->current_opcode = inst->getOpcode();
+                inst->updateVectorConfig(state);
+                state->setCurrentInst(inst);
+                state->setNextPc(next_pc);
+            }
+            catch (ActionException & action_excp)
+            {
+                next_action_group = action_excp.getActionGroup();
+                break;
+            }
+
+            if (SPARTA_EXPECT_FALSE(!checkInst_(state, inst)))
+            {
+                Exception* exception_unit = state->getExceptionUnit();
+                exception_unit->setUnhandledException(FaultCause::ILLEGAL_INST);
+                next_action_group = exception_unit->getActionGroup();
+                break;
+            }
+
+            // Execute and finish the instruction, leaving the block if either one redirects
+            next_action_group = execute_action_group->execute(state)->execute(state);
+            if (next_action_group != finish_action_group)
+            {
+                break;
+            }
+            next_action_group = finish_action_group->execute(state);
+            if ((next_action_group != &fetch_action_group_) || (state->getPc() != next_pc)
+                || SPARTA_EXPECT_FALSE(!block->valid)
+                || SPARTA_EXPECT_FALSE(state->isInterruptCheckRequested()))
+            {
+                break;
+            }
+        }
+        block_cache_.countBlockInsts(num_insts);
+
+        return next_action_group;
     }
 } // namespace pegasus
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/ActionGroup.hpp"
+#include "core/BlockCache.hpp"
+#include "core/DecodeCache.hpp"
 
 #include "sparta/simulation/ParameterSet.hpp"
 #include "sparta/simulation/TreeNode.hpp"
@@ -21,12 +23,39 @@ namespace pegasus
         {
           public:
             FetchParameters(sparta::TreeNode* node) : sparta::ParameterSet(node) {}
+
+            PARAMETER(uint32_t, max_block_insts, 32,
+                      "Maximum number of instructions in a decoded block (0 to disable the "
+                      "block cache)")
+            PARAMETER(uint32_t, decode_cache_entries, 4096,
+                      "Number of entries in the decode cache, must be a power of 2 (0 to disable "
+                      "the decode cache)")
         };
 
         Fetch(sparta::TreeNode* fetch_node, const FetchParameters* p);
 
         ActionGroup* getActionGroup() { return &fetch_action_group_; }
 
+        ActionGroup* getDecodeActionGroup() { return &decode_action_group_; }
+
+        BlockCache* getBlockCache() { return &block_cache_; }
+
+        const BlockCache* getBlockCache() const { return &block_cache_; }
+
+        DecodeCache* getDecodeCache() { return &decode_cache_; }
+
+        const DecodeCache* getDecodeCache() const { return &decode_cache_; }
+
+        // The block cache is bypassed when Observers are registered since they expect to see
+        // every fetch
+        bool isBlockCacheEnabled() const;
+
+        // Called instead of executing the Decode ActionGroup. If a decoded block exists for the
+        // translated PC, executes the instructions in the block until one of them changes the
+        // control flow, and returns the next ActionGroup to execute. Otherwise, returns the
+        // Decode ActionGroup.
+        ActionGroup* executeBlock(PegasusState* state);
+
       private:
         PegasusState* state_ = nullptr;
 
@@ -39,5 +68,14 @@ namespace pegasus
         Action::ItrType decode_(pegasus::PegasusState* state, Action::ItrType action_it);
 
         ActionGroup decode_action_group_{"Decode"};
+
+        // Returns false if the instruction is illegal in the current state
+        bool checkInst_(PegasusState* state, const PegasusInstPtr & inst) const;
+
+        uint64_t getBlockContext_(PegasusState* state) const;
+
+        BlockCache block_cache_;
+
+        DecodeCache decode_cache_;
     };
 } // namespace pegasus
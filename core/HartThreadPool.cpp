@@ -0,0 +1,96 @@
+#include "core/HartThreadPool.hpp"
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+#include <utility>
+
+namespace pegasus
+{
+    HartThreadPool::HartThreadPool(uint32_t num_threads)
+    {
+        sparta_assert(num_threads != 0, "A hart thread pool needs at least one thread");
+        for (uint32_t i = 1; i < num_threads; ++i)
+        {
+            workers_.emplace_back([this]() { work_(); });
+        }
+    }
+
+    HartThreadPool::~HartThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+        start_cond_.notify_all();
+        for (auto & worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void HartThreadPool::run(size_t num_jobs, const Job & job)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = &job;
+        num_jobs_ = num_jobs;
+        next_job_ = 0;
+        num_jobs_done_ = 0;
+        ++generation_;
+        start_cond_.notify_all();
+
+        runJobs_(lock);
+        done_cond_.wait(lock, [this]() { return num_jobs_done_ == num_jobs_; });
+        job_ = nullptr;
+
+        if (exception_)
+        {
+            std::rethrow_exception(std::exchange(exception_, nullptr));
+        }
+    }
+
+    void HartThreadPool::work_()
+    {
+        uint64_t generation = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            start_cond_.wait(lock, [this, generation]()
+                             { return done_ || (generation_ != generation); });
+            if (done_)
+            {
+                return;
+            }
+            generation = generation_;
+            runJobs_(lock);
+        }
+    }
+
+    void HartThreadPool::runJobs_(std::unique_lock<std::mutex> & lock)
+    {
+        while (next_job_ < num_jobs_)
+        {
+            const size_t job_idx = next_job_++;
+            lock.unlock();
+
+            std::exception_ptr exception;
+            try
+            {
+                (*job_)(job_idx);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            lock.lock();
+            if (exception && !exception_)
+            {
+                exception_ = exception;
+            }
+            if (++num_jobs_done_ == num_jobs_)
+            {
+                done_cond_.notify_all();
+            }
+        }
+    }
+} // namespace pegasus
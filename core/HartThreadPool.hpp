@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <cinttypes>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pegasus
+{
+    /*!
+     * \class HartThreadPool
+     * \brief Host threads that execute the harts of a PegasusCore in parallel
+     *
+     * The calling thread is one of the threads of the pool, so a pool of N threads starts
+     * N - 1 worker threads. Workers are kept alive between windows and sleep while the
+     * simulation thread is running alone.
+     */
+    class HartThreadPool
+    {
+      public:
+        using Job = std::function<void(size_t)>;
+
+        explicit HartThreadPool(uint32_t num_threads);
+
+        //! Stops the worker threads
+        ~HartThreadPool();
+
+        HartThreadPool(const HartThreadPool &) = delete;
+        HartThreadPool & operator=(const HartThreadPool &) = delete;
+
+        uint32_t getNumThreads() const { return workers_.size() + 1; }
+
+        //! Run job(0) ... job(num_jobs - 1) on the pool and return when all of them are done.
+        //! The first exception thrown by a job is rethrown on the calling thread.
+        void run(size_t num_jobs, const Job & job);
+
+      private:
+        void work_();
+
+        void runJobs_(std::unique_lock<std::mutex> & lock);
+
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable start_cond_;
+        std::condition_variable done_cond_;
+
+        // Job of the current run, jobs are handed out in order
+        const Job* job_ = nullptr;
+        size_t num_jobs_ = 0;
+        size_t next_job_ = 0;
+        size_t num_jobs_done_ = 0;
+        std::exception_ptr exception_;
+
+        // Incremented for every run so sleeping workers can tell a new run from a spurious wakeup
+        uint64_t generation_ = 0;
+        bool done_ = false;
+    };
+} // namespace pegasus
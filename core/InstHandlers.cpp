@@ -212,6 +212,10 @@ namespace pegasus
         // Get CSR update handlers
         RvzicsrInsts::getCsrUpdateActions<RV64>(rv64_csr_update_actions_);
         RvzicsrInsts::getCsrUpdateActions<RV32>(rv32_csr_update_actions_);
+
+        // Get CSR read handlers
+        RvzicsrInsts::getCsrReadActions<RV64>(rv64_csr_read_actions_);
+        RvzicsrInsts::getCsrReadActions<RV32>(rv32_csr_read_actions_);
     }
 
     template const InstHandlers::InstHandlersMap* InstHandlers::getInstHandlersMap<RV64>() const;
@@ -16,6 +16,7 @@ namespace pegasus
 
         using InstHandlersMap = std::map<std::string, Action>;
         using CsrUpdateActionsMap = std::map<uint32_t, Action>;
+        using CsrReadActionsMap = std::map<uint32_t, Action>;
 
         template <typename XLEN> const InstHandlersMap* getInstHandlersMap() const
         {
@@ -56,6 +57,19 @@ namespace pegasus
             }
         }
 
+        template <typename XLEN> const CsrReadActionsMap* getCsrReadActionsMap() const
+        {
+            static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
+            if constexpr (std::is_same_v<XLEN, RV64>)
+            {
+                return &rv64_csr_read_actions_;
+            }
+            else
+            {
+                return &rv32_csr_read_actions_;
+            }
+        }
+
         // Instruction handler for unsupported instructions
         Action::ItrType unsupportedInstHandler(pegasus::PegasusState* state,
                                                Action::ItrType action_it);
@@ -72,5 +86,9 @@ namespace pegasus
         // CSR update Actions for executing write side effects
         CsrUpdateActionsMap rv64_csr_update_actions_;
         CsrUpdateActionsMap rv32_csr_update_actions_;
+
+        // CSR read Actions for bringing a CSR up to date before it is accessed
+        CsrReadActionsMap rv64_csr_read_actions_;
+        CsrReadActionsMap rv32_csr_read_actions_;
     };
 } // namespace pegasus
@@ -1,4 +1,6 @@
 #include "PegasusCore.hpp"
+#include "core/HartThreadPool.hpp"
+#include "sim/PegasusAllocators.hpp"
 #include "system/PegasusSystem.hpp"
 #include "system/SystemCallEmulator.hpp"
 #include "system/ReservationMemory.hpp"
@@ -9,6 +11,8 @@
 #include "sparta/utils/SpartaTester.hpp"
 #include "sparta/memory/BlockingMemoryIF.hpp"
 
+#include <algorithm>
+
 namespace pegasus
 {
     std::unordered_set<PrivMode> initSupportedPrivilegeModes(const std::string & priv)
@@ -55,6 +59,11 @@ namespace pegasus
         ev_wrssto_counter_expires_(
             &unit_event_set_, "wrssto_counter_expires",
             CREATE_SPARTA_HANDLER_WITH_DATA(PegasusCore, wrsstoCounterExpires_, HartId)),
+        wfi_timeout_(p->wfi_timeout),
+        ev_wfi_timeout_expires_(
+            &unit_event_set_, "wfi_timeout_expires",
+            CREATE_SPARTA_HANDLER_WITH_DATA(PegasusCore, pauseCounterExpires_, HartId)),
+        max_shared_quantum_(p->max_shared_quantum),
         cosim_mode_(p->cosim_mode),
         syscall_emulation_enabled_(
             PegasusSimParameters::getParameter<bool>(core_tn, "enable_syscall_emulation")),
@@ -71,6 +80,15 @@ namespace pegasus
         reservations_(num_harts_),
         inst_handlers_(syscall_emulation_enabled_)
     {
+        sparta_assert(num_harts_ <= MAX_HARTS,
+                      "Number of harts (" << num_harts_ << ") exceeds the maximum of "
+                                          << MAX_HARTS);
+
+        // PegasusCoSim steps each hart explicitly
+        const uint32_t host_threads = (cosim_mode_ || (num_harts_ == 1)) ? 0 : p->host_threads;
+        hart_sched_stats_.resize(num_harts_);
+        sleep_start_cycle_.resize(num_harts_);
+
         // top.core*.hart*
         for (HartId hart_idx = 0; hart_idx < num_harts_; ++hart_idx)
         {
@@ -111,6 +129,18 @@ namespace pegasus
             tns_to_delete_.emplace_back(new sparta::ResourceTreeNode(
                 hart_tn, "exception", sparta::TreeNode::GROUP_NAME_NONE,
                 sparta::TreeNode::GROUP_IDX_NONE, "Exception Unit", &exception_factory_));
+
+            // top.core*.hart*.allocators
+            // Harts running on different host threads cannot share the instruction allocators
+            if (host_threads > 1)
+            {
+                tns_to_delete_.emplace_back(new PegasusAllocators(hart_tn));
+            }
+        }
+
+        if (host_threads > 1)
+        {
+            hart_thread_pool_.reset(new HartThreadPool(std::min(host_threads, num_harts_)));
         }
 
         sparta::StartupEvent(core_tn, CREATE_SPARTA_HANDLER(PegasusCore, advanceSim_));
@@ -134,9 +164,12 @@ namespace pegasus
             thread->setSimStopped(true, exit_code);
             threads_running_.reset(hart_idx);
         }
+        runnable_queue_.clear();
+        in_runnable_queue_.reset();
 
         ev_pause_counter_expires_.cancel();
         ev_wrssto_counter_expires_.cancel();
+        ev_wfi_timeout_expires_.cancel();
     }
 
     void PegasusCore::onBindTreeEarly_()
@@ -181,6 +214,7 @@ namespace pegasus
                 state->setPc(system_->getStartingPc());
                 state->getSimState()->sim_stopped = false;
                 threads_running_.set(hart_idx);
+                queueHart_(hart_idx);
             }
         }
 
@@ -190,88 +224,345 @@ namespace pegasus
         state->setPc(system_->getStartingPc());
         state->getSimState()->sim_stopped = false;
         threads_running_.set(0);
+        queueHart_(0);
     }
 
-    // This method will execute a single thread for up to X instructions
+    // This method will execute the next runnable thread for up to X instructions
     // where X is the quantum for that thread. The cycle count of all threads
     // is updated to match the current thread's cycle count. Then this event
     // is rescheduled at that cycle count.
     void PegasusCore::advanceSim_()
     {
-        PegasusState* state = threads_[current_hart_id_];
-        auto* sim_state = state->getSimState();
-        bool timed_pause = false;
-        if ((sim_state->sim_stopped == false)
-            && (sim_state->sim_pause_reason == SimPauseReason::INVALID))
+        // Drop harts that stopped or went to sleep after they were queued
+        while (!runnable_queue_.empty() && !threads_running_.test(runnable_queue_.front()))
+        {
+            in_runnable_queue_.reset(runnable_queue_.front());
+            runnable_queue_.pop_front();
+        }
+        if (runnable_queue_.empty())
         {
-            DLOG("Running hart" << std::dec << current_hart_id_);
-            Fetch* fetch = state->getFetchUnit();
-            ActionGroup* next_action_group = fetch->getActionGroup();
-            while (next_action_group)
+            return;
+        }
+
+        advancing_sim_ = true;
+        uint64_t current_cycle = 0;
+        if (canRunParallelWindow_())
+        {
+            current_cycle = runParallelWindow_();
+        }
+        else
+        {
+            const HartId hart_id = runnable_queue_.front();
+            runnable_queue_.pop_front();
+            in_runnable_queue_.reset(hart_id);
+            current_hart_id_ = hart_id;
+
+            PegasusState* state = threads_[hart_id];
+            auto* sim_state = state->getSimState();
+            if ((sim_state->sim_stopped == false)
+                && (sim_state->sim_pause_reason == SimPauseReason::INVALID))
             {
-                next_action_group = next_action_group->execute(state);
+                DLOG("Running hart" << std::dec << hart_id);
+                const uint64_t start_inst_count = sim_state->inst_count;
+                executeHart_(state);
+                endSlice_(hart_id, start_inst_count);
             }
-
-            if (sim_state->sim_stopped)
+            else if (threads_running_.test(hart_id))
             {
-                DLOG("Stopping hart" << std::dec << current_hart_id_);
-                threads_running_.reset(current_hart_id_);
+                queueHart_(hart_id);
             }
+            current_cycle = sim_state->cycles;
+        }
+        advancing_sim_ = false;
 
-            switch (sim_state->sim_pause_reason)
+        if (!runnable_queue_.empty())
+        {
+            // Keep going!
+            scheduleAdvanceSim_(current_cycle);
+        }
+    }
+
+    void PegasusCore::executeHart_(PegasusState* state)
+    {
+        Fetch* fetch = state->getFetchUnit();
+        ActionGroup* next_action_group = fetch->getActionGroup();
+        ActionGroup* decode_action_group = fetch->getDecodeActionGroup();
+        const bool block_cache_enabled = fetch->isBlockCacheEnabled();
+        while (next_action_group)
+        {
+            // Once the PC has been translated, execute the decoded block at that address if
+            // there is one
+            if ((next_action_group == decode_action_group) && block_cache_enabled)
             {
-                case SimPauseReason::QUANTUM:
-                    state->unpauseHart();
-                    break;
-                case SimPauseReason::INTERRUPT:
-                    sparta_assert(false, "Pause reason INTERRUPT is not supported yet!");
-                    break;
-                case SimPauseReason::PAUSE:
-                case SimPauseReason::WRS_STO:
-                    timed_pause = true;
-                    break;
-                case SimPauseReason::FORK:
-                    sparta_assert(false, "Pause reason FORK is not supported yet!");
-                    break;
-                case SimPauseReason::WRS_NTO:
-                case SimPauseReason::INVALID:
-                    break;
+                next_action_group = fetch->executeBlock(state);
+                if (next_action_group != decode_action_group)
+                {
+                    continue;
+                }
             }
+            next_action_group = next_action_group->execute(state);
         }
+    }
 
-        // Update current cycle for all threads
-        const uint64_t current_cycle = sim_state->cycles;
-        for (HartId hart_id = 0; hart_id < num_harts_; ++hart_id)
+    void PegasusCore::endSlice_(HartId hart_id, uint64_t start_inst_count)
+    {
+        PegasusState* state = threads_[hart_id];
+        auto* sim_state = state->getSimState();
+        auto & sched_stats = hart_sched_stats_[hart_id];
+        ++sched_stats.num_slices;
+        sched_stats.num_insts += sim_state->inst_count - start_inst_count;
+
+        if (sim_state->sim_stopped)
         {
-            threads_[hart_id]->getSimState()->cycles = current_cycle;
+            DLOG("Stopping hart" << std::dec << hart_id);
+            threads_running_.reset(hart_id);
+        }
+
+        bool timed_pause = false;
+        switch (sim_state->sim_pause_reason)
+        {
+            case SimPauseReason::QUANTUM:
+                // A hart that keeps using its whole quantum gets longer slices. A single
+                // hart only returns to the scheduler to let other harts run, so its
+                // quantum can grow much larger.
+                if (num_harts_ == 1)
+                {
+                    state->growQuantum();
+                }
+                else
+                {
+                    state->growQuantum(max_shared_quantum_);
+                }
+                state->unpauseHart();
+                break;
+            case SimPauseReason::INTERRUPT:
+                sparta_assert(false, "Pause reason INTERRUPT is not supported yet!");
+                break;
+            case SimPauseReason::PAUSE:
+            case SimPauseReason::WRS_STO:
+            case SimPauseReason::WFI:
+                state->resetQuantum();
+                timed_pause = true;
+                break;
+            case SimPauseReason::FORK:
+                sparta_assert(false, "Pause reason FORK is not supported yet!");
+                break;
+            case SimPauseReason::WRS_NTO:
+                // Sleeps until a store to the reservation set wakes it up
+                state->resetQuantum();
+                sleepHart_(hart_id);
+                break;
+            case SimPauseReason::FUTEX:
+                // Sleeps until the system call emulator wakes it up with FUTEX_WAKE or a timeout
+                state->resetQuantum();
+                sleepHart_(hart_id);
+                break;
+            case SimPauseReason::SYNC:
+                sparta_assert(false, "Hart" << hart_id << " is still paused for a parallel window");
+                break;
+            case SimPauseReason::INVALID:
+                break;
         }
 
         if (timed_pause)
         {
-            DLOG("Starting pause counter for hart " << std::dec << current_hart_id_);
-            threads_running_.reset(current_hart_id_);
+            DLOG("Starting pause counter for hart " << std::dec << hart_id);
+            sleepHart_(hart_id);
+            const uint64_t delay = sim_state->cycles - getClock()->currentCycle();
             if (sim_state->sim_pause_reason == SimPauseReason::PAUSE)
             {
-                ev_pause_counter_expires_.preparePayload(current_hart_id_)
-                    ->schedule(current_cycle - getClock()->currentCycle()
-                               + pause_counter_duration_);
+                ev_pause_counter_expires_.preparePayload(hart_id)->schedule(
+                    delay + pause_counter_duration_);
+            }
+            else if (sim_state->sim_pause_reason == SimPauseReason::WRS_STO)
+            {
+                ev_wrssto_counter_expires_.preparePayload(hart_id)->schedule(
+                    delay + wrssto_counter_duration_);
             }
-            else // SimPauseReason::WRS_STO
+            else // SimPauseReason::WFI
             {
-                ev_wrssto_counter_expires_.preparePayload(current_hart_id_)
-                    ->schedule(current_cycle - getClock()->currentCycle()
-                               + wrssto_counter_duration_);
+                ev_wfi_timeout_expires_.preparePayload(hart_id)->schedule(delay + wfi_timeout_);
             }
         }
 
-        // Simple round robin
-        ++current_hart_id_;
-        current_hart_id_ = (current_hart_id_ == num_harts_) ? 0 : current_hart_id_;
+        // Round robin over the runnable harts
+        if (threads_running_.test(hart_id))
+        {
+            queueHart_(hart_id);
+        }
+    }
 
-        if (threads_running_.any())
+    bool PegasusCore::canRunParallelWindow_() const
+    {
+        // Stores must go through ReservationMemory while any reservation is valid, and
+        // observers expect to see every memory access
+        if (!hart_thread_pool_ || reservation_memory_active_ || (runnable_queue_.size() < 2))
         {
-            // Keep going!
-            ev_advance_sim_.schedule(current_cycle - getClock()->currentCycle());
+            return false;
+        }
+        return std::all_of(threads_.begin(), threads_.end(), [](const auto & thread)
+                           { return thread.second->getObservers().empty(); });
+    }
+
+    // Runs the quantum of every runnable hart at the same time, one hart per host thread. A hart
+    // that is about to touch state shared with other harts (atomics, floating point, system
+    // calls, devices) is paused before that instruction. Once all of the harts are done, the
+    // paused harts finish their quantum one at a time in scheduling order, so atomics and
+    // devices are accessed in the same order. Loads and stores to plain memory go through the
+    // DMI cache and are not ordered between harts, so harts that communicate through plain
+    // memory observe each other's stores in host thread order. The cycle counts are updated as
+    // if the harts had run one after another.
+    uint64_t PegasusCore::runParallelWindow_()
+    {
+        window_slices_.clear();
+        while (!runnable_queue_.empty())
+        {
+            const HartId hart_id = runnable_queue_.front();
+            runnable_queue_.pop_front();
+            in_runnable_queue_.reset(hart_id);
+            if (threads_running_.test(hart_id))
+            {
+                const auto* sim_state = threads_[hart_id]->getSimState();
+                const bool runnable = (sim_state->sim_stopped == false)
+                                      && (sim_state->sim_pause_reason == SimPauseReason::INVALID);
+                window_slices_.push_back({hart_id, sim_state->inst_count, runnable});
+            }
+        }
+        DLOG("Running " << std::dec << window_slices_.size() << " harts in parallel");
+
+        const auto run_slice = [this](size_t idx)
+        {
+            const WindowSlice & slice = window_slices_[idx];
+            if (slice.runnable)
+            {
+                PegasusState* state = threads_[slice.hart_id];
+                state->setInParallelWindow(true);
+                executeHart_(state);
+                state->setInParallelWindow(false);
+            }
+        };
+        hart_thread_pool_->run(window_slices_.size(), run_slice);
+        ++num_parallel_windows_;
+
+        uint64_t current_cycle = threads_[window_slices_.front().hart_id]->getSimState()->cycles;
+        for (const WindowSlice & slice : window_slices_)
+        {
+            current_hart_id_ = slice.hart_id;
+            PegasusState* state = threads_[slice.hart_id];
+            auto* sim_state = state->getSimState();
+            sim_state->cycles = current_cycle + (sim_state->inst_count - slice.start_inst_count);
+
+            if (sim_state->sim_pause_reason == SimPauseReason::SYNC)
+            {
+                // Finish the quantum alone, starting with the instruction that ended the window
+                state->unpauseHart();
+                if (sim_state->sim_stopped == false)
+                {
+                    ++num_window_syncs_;
+                    executeHart_(state);
+                }
+            }
+
+            if (slice.runnable)
+            {
+                endSlice_(slice.hart_id, slice.start_inst_count);
+            }
+            else if (threads_running_.test(slice.hart_id))
+            {
+                queueHart_(slice.hart_id);
+            }
+            current_cycle = sim_state->cycles;
+        }
+        return current_cycle;
+    }
+
+    void PegasusCore::queueHart_(HartId hart_id)
+    {
+        if (!in_runnable_queue_.test(hart_id))
+        {
+            in_runnable_queue_.set(hart_id);
+            runnable_queue_.push_back(hart_id);
+        }
+    }
+
+    void PegasusCore::wakeHart_(HartId hart_id)
+    {
+        if (threads_[hart_id]->getSimState()->sim_stopped)
+        {
+            return;
+        }
+
+        // A hart woken up by another hart's slice wakes up at that hart's cycle
+        const uint64_t current_cycle =
+            advancing_sim_
+                ? std::max(getClock()->currentCycle(),
+                           threads_[current_hart_id_]->getSimState()->cycles)
+                : getClock()->currentCycle();
+        auto & sleep_start_cycle = sleep_start_cycle_[hart_id];
+        if (sleep_start_cycle.isValid())
+        {
+            hart_sched_stats_[hart_id].sleep_cycles +=
+                current_cycle - std::min(current_cycle, sleep_start_cycle.getValue());
+            sleep_start_cycle.clearValid();
+        }
+
+        threads_running_.set(hart_id);
+        queueHart_(hart_id);
+
+        // The scheduler stops when all harts are asleep, so restart it. Sleeping harts have
+        // no work to do, so their cycle counts jump ahead to the wakeup.
+        if (!advancing_sim_ && !ev_advance_sim_.isScheduled())
+        {
+            scheduleAdvanceSim_(current_cycle);
+        }
+    }
+
+    void PegasusCore::sleepHart_(HartId hart_id)
+    {
+        threads_running_.reset(hart_id);
+        sleep_start_cycle_[hart_id] = threads_[hart_id]->getSimState()->cycles;
+    }
+
+    void PegasusCore::scheduleAdvanceSim_(uint64_t current_cycle)
+    {
+        // Update current cycle for all threads
+        for (HartId hart_id = 0; hart_id < num_harts_; ++hart_id)
+        {
+            threads_[hart_id]->getSimState()->cycles = current_cycle;
+        }
+        ev_advance_sim_.schedule(current_cycle - getClock()->currentCycle());
+    }
+
+    void PegasusCore::startHart(HartId hart_id, Addr pc)
+    {
+        PegasusState* state = threads_.at(hart_id);
+        sparta_assert(state->getSimState()->sim_stopped,
+                      "Hart" << hart_id << " is already running");
+        DLOG("Starting hart" << std::dec << hart_id << " at 0x" << std::hex << pc);
+
+        state->setPc(pc);
+        state->setSimStopped(false);
+        state->unpauseHart();
+        state->resetQuantum();
+
+        // PegasusCoSim steps each hart explicitly
+        if (!cosim_mode_)
+        {
+            wakeHart_(hart_id);
+        }
+    }
+
+    void PegasusCore::interruptPending(HartId hart_id)
+    {
+        PegasusState* state = threads_.at(hart_id);
+        state->requestInterruptCheck();
+        if ((state->getSimState()->sim_pause_reason == SimPauseReason::WFI)
+            && state->hasEnabledInterrupt())
+        {
+            DLOG("Interrupt pending, waking up hart" << std::dec << hart_id);
+            ev_wfi_timeout_expires_.cancelIf(hart_id);
+            state->unpauseHart();
+            wakeHart_(hart_id);
         }
     }
 
@@ -282,23 +573,12 @@ namespace pegasus
     {
         PegasusState* state = threads_[hart_id];
         const auto pause_reason = state->getSimState()->sim_pause_reason;
-        if (pause_reason == SimPauseReason::PAUSE || pause_reason == SimPauseReason::WRS_STO)
+        if ((pause_reason == SimPauseReason::PAUSE) || (pause_reason == SimPauseReason::WRS_STO)
+            || (pause_reason == SimPauseReason::WFI))
         {
             DLOG("Pause counter expired for hart" << std::dec << hart_id);
             state->unpauseHart();
-            threads_running_.set(hart_id);
-            if (ev_advance_sim_.isScheduled() == false)
-            {
-                // Update current cycle for all threads
-                const uint64_t current_cycle = getClock()->currentCycle();
-                for (HartId hart_id = 0; hart_id < num_harts_; ++hart_id)
-                {
-                    threads_[hart_id]->getSimState()->cycles = current_cycle;
-                }
-
-                // Keep going!
-                ev_advance_sim_.schedule();
-            }
+            wakeHart_(hart_id);
         }
     }
 
@@ -311,6 +591,41 @@ namespace pegasus
         state->unregisterWaitOnReservationSet();
     }
 
+    void PegasusCore::reportHartSchedStats(std::ostream & os) const
+    {
+        uint64_t end_cycle = 0;
+        for (const auto & [hart_id, state] : threads_)
+        {
+            end_cycle = std::max(end_cycle, state->getSimState()->cycles);
+        }
+        if (end_cycle == 0)
+        {
+            return;
+        }
+
+        os << "Hart scheduling (core" << std::dec << core_id_ << "):" << std::endl;
+        for (HartId hart_id = 0; hart_id < num_harts_; ++hart_id)
+        {
+            const auto & stats = hart_sched_stats_[hart_id];
+            uint64_t sleep_cycles = stats.sleep_cycles;
+            const auto & sleep_start_cycle = sleep_start_cycle_[hart_id];
+            if (sleep_start_cycle.isValid())
+            {
+                sleep_cycles += end_cycle - std::min(end_cycle, sleep_start_cycle.getValue());
+            }
+            const double sleep_pct = 100.0 * std::min(sleep_cycles, end_cycle) / end_cycle;
+            os << "    hart" << hart_id << ": " << stats.num_slices << " slices, "
+               << stats.num_insts << " insts, " << (100.0 - sleep_pct) << "% runnable, "
+               << sleep_pct << "% sleeping" << std::endl;
+        }
+        if (hart_thread_pool_)
+        {
+            os << "    " << num_parallel_windows_ << " parallel windows on "
+               << hart_thread_pool_->getNumThreads() << " host threads, " << num_window_syncs_
+               << " ended early for shared state" << std::endl;
+        }
+    }
+
     void PegasusCore::makeReservation(HartId hart_id, Addr paddr)
     {
         for (uint32_t hart_id = 0; hart_id < num_harts_; ++hart_id)
@@ -327,6 +642,7 @@ namespace pegasus
         // FIXME: iterate through cores for multi-core support.
         state->storeOnReservationSet(false);
         current_memory_view_ = reservation_memory_bmi_.get();
+        reservation_memory_active_ = true;
     }
 
     void PegasusCore::clearReservation(HartId hart_id)
@@ -340,6 +656,7 @@ namespace pegasus
                         [](const Reservation & reservation) { return !reservation.isValid(); }))
         {
             current_memory_view_ = system_->getSystemMemory();
+            reservation_memory_active_ = false;
         }
     }
 
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <string>
+#include <deque>
+#include <ostream>
 #include <cinttypes>
 
 #include "core/PegasusAllocatorWrapper.hpp"
@@ -27,6 +29,7 @@ namespace pegasus
 {
     class PegasusSystem;
     class ReservationMemory;
+    class HartThreadPool;
 
     class PegasusCore : public sparta::Unit
     {
@@ -51,6 +54,15 @@ namespace pegasus
             PARAMETER(uint64_t, pause_counter_duration, 256, "Pause counter duration in cycles")
             PARAMETER(uint64_t, wrssto_counter_duration, 256,
                       "WRS.STO pause counter duration in cycles")
+            PARAMETER(uint64_t, wfi_timeout, 10000,
+                      "Cycles a hart sleeps on WFI if no interrupt wakes it up first (0: WFI "
+                      "does not put the hart to sleep)")
+            PARAMETER(uint32_t, max_shared_quantum, 4000,
+                      "Maximum instruction quantum of a hart on a multi-hart core. The quantum "
+                      "of a hart doubles up to this size while it runs without pausing")
+            PARAMETER(uint32_t, host_threads, 0,
+                      "Number of host threads running the harts of this core in parallel "
+                      "windows (0 or 1: the harts run one at a time on the simulation thread)")
             PARAMETER(std::vector<int>, supported_trap_modes, {0},
                       "Supported RISC-V trap modes (0: Direct, 1: Vectored)")
             PARAMETER(bool, misalignment_support, true, "Misalignment Support");
@@ -73,6 +85,9 @@ namespace pegasus
 
         PegasusState* getPegasusState(HartId hart_idx = 0) const { return threads_.at(hart_idx); }
 
+        // Hart that is running, or ran last
+        HartId getCurrentHartId() const { return current_hart_id_; }
+
         std::map<HartId, PegasusState*> & getThreads() { return threads_; }
 
         PegasusSystem* getSystem() const { return system_; }
@@ -83,6 +98,9 @@ namespace pegasus
 
         bool inCoSimMode() const { return cosim_mode_; }
 
+        // PegasusCoSim steps each hart explicitly, so harts never sleep on WFI
+        bool isWfiSleepEnabled() const { return (wfi_timeout_ != 0) && !cosim_mode_; }
+
         bool isSystemCallEmulationEnabled() const { return syscall_emulation_enabled_; }
 
         bool isExtensionSupported(const uint64_t xlen, const std::string & ext) const
@@ -122,9 +140,53 @@ namespace pegasus
 
         void clearReservation(HartId hart_id);
 
+        // Stores must go through ReservationMemory while any reservation is valid
+        bool isReservationMemoryActive() const { return reservation_memory_active_; }
+
         const InstHandlers* getInstHandlers() const { return &inst_handlers_; }
 
-        void unpauseHart(HartId hart_id) { threads_running_.set(hart_id); }
+        void unpauseHart(HartId hart_id) { wakeHart_(hart_id); }
+
+        // Start a hart that is not running at the given PC. The system call emulator runs new
+        // guest threads on idle harts.
+        void startHart(HartId hart_id, Addr pc);
+
+        // Called by interrupt devices after they change the MIP bits of a hart. The hart takes
+        // the interrupt before its next fetch, and wakes up if it is sleeping on WFI.
+        void interruptPending(HartId hart_id);
+
+        // Maximum number of harts on a core
+        static constexpr uint32_t MAX_HARTS = 64;
+
+        // Scheduling statistics of a hart
+        struct HartSchedStats
+        {
+            // Number of times the hart was scheduled
+            uint64_t num_slices = 0;
+
+            // Number of instructions executed by the scheduler
+            uint64_t num_insts = 0;
+
+            // Cycles spent paused or sleeping
+            uint64_t sleep_cycles = 0;
+        };
+
+        const HartSchedStats & getHartSchedStats(HartId hart_id) const
+        {
+            return hart_sched_stats_.at(hart_id);
+        }
+
+        // Print the share of time each hart was runnable or sleeping
+        void reportHartSchedStats(std::ostream & os) const;
+
+        // True if the harts of this core may run in parallel windows on host threads
+        bool hasParallelWindows() const { return hart_thread_pool_ != nullptr; }
+
+        // Number of windows in which the harts ran in parallel on host threads
+        uint64_t getNumParallelWindows() const { return num_parallel_windows_; }
+
+        // Number of times a hart left a parallel window early to access shared state
+        uint64_t getNumWindowSyncs() const { return num_window_syncs_; }
 
         void cancelWrsstoEvent(HartId hart_id) { ev_wrssto_counter_expires_.cancelIf(hart_id); }
 
@@ -164,6 +226,29 @@ namespace pegasus
         // Execute the threads on this core
         void advanceSim_();
         sparta::Event<> ev_advance_sim_;
+        bool advancing_sim_ = false;
+
+        // Execute a hart until it pauses or stops
+        void executeHart_(PegasusState* state);
+
+        // Update the scheduling state of a hart after it ran
+        void endSlice_(HartId hart_id, uint64_t start_inst_count);
+
+        // Parallel windows
+        bool canRunParallelWindow_() const;
+        uint64_t runParallelWindow_();
+        std::unique_ptr<HartThreadPool> hart_thread_pool_;
+
+        struct WindowSlice
+        {
+            HartId hart_id;
+            uint64_t start_inst_count;
+            bool runnable;
+        };
+
+        std::vector<WindowSlice> window_slices_;
+        uint64_t num_parallel_windows_ = 0;
+        uint64_t num_window_syncs_ = 0;
 
         // Pause counter
         const uint64_t pause_counter_duration_;
@@ -173,9 +258,37 @@ namespace pegasus
         void wrsstoCounterExpires_(const HartId & hart_id);
         sparta::PayloadEvent<HartId> ev_wrssto_counter_expires_;
 
+        // WFI sleep
+        const uint64_t wfi_timeout_;
+        sparta::PayloadEvent<HartId> ev_wfi_timeout_expires_;
+
+        // Quantum limit of harts sharing this core
+        const uint64_t max_shared_quantum_;
+
         // Status of each thread
         HartId current_hart_id_ = 0;
-        std::bitset<8> threads_running_;
+        std::bitset<MAX_HARTS> threads_running_;
+
+        // Harts waiting to run, in scheduling order. Only running harts are queued, so
+        // paused and sleeping harts are not visited until they are woken up.
+        std::deque<HartId> runnable_queue_;
+        std::bitset<MAX_HARTS> in_runnable_queue_;
+
+        // Add a hart to the runnable queue
+        void queueHart_(HartId hart_id);
+
+        // Make a paused or sleeping hart runnable again
+        void wakeHart_(HartId hart_id);
+
+        // Take a hart off the runnable queue until it is woken up
+        void sleepHart_(HartId hart_id);
+
+        // Sync the cycle count of all threads and schedule the next slice
+        void scheduleAdvanceSim_(uint64_t current_cycle);
+
+        // Per-hart scheduling statistics
+        std::vector<HartSchedStats> hart_sched_stats_;
+        std::vector<sparta::utils::ValidValue<uint64_t>> sleep_start_cycle_;
 
         // Is this a PegasusCoSim run?
         const bool cosim_mode_;
@@ -223,5 +336,6 @@ namespace pegasus
 
         // ReservationMemory
         std::unique_ptr<ReservationMemory> reservation_memory_bmi_;
+        bool reservation_memory_active_ = false;
     };
 } // namespace pegasus
@@ -34,6 +34,8 @@ namespace pegasus
 
         bool isHypervisorInst() const { return is_hypervisor_inst_; }
 
+        const ActionGroup* getActionGroup() const { return &inst_action_group_; }
+
       private:
         const std::string mnemonic_;
         const std::string inst_handler_name_;
@@ -36,6 +36,30 @@ namespace pegasus
         return translate_types::AccessType::INVALID;
     }
 
+    bool usesSoftFloat(const mavis::OpcodeInfo::PtrType & opcode_info)
+    {
+        if (opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::FLOAT))
+        {
+            return true;
+        }
+
+        // Vector floating point instructions (vf*, vmf*)
+        const std::string & mnemonic = opcode_info->getMnemonic();
+        if (opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::VECTOR)
+            && (mnemonic.starts_with("vf") || mnemonic.starts_with("vmf")))
+        {
+            return true;
+        }
+
+        // fflags, frm and fcsr are backed by the SoftFloat state
+        if (opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::CSR))
+        {
+            const uint32_t csr = opcode_info->getSpecialField(mavis::OpcodeInfo::SpecialField::CSR);
+            return (csr == FFLAGS) || (csr == FRM) || (csr == FCSR);
+        }
+        return false;
+    }
+
     uint64_t getImmediateValue(const mavis::OpcodeInfo::PtrType & opcode_info)
     {
         return opcode_info->getImmediateType() == mavis::ImmediateType::SIGNED
@@ -64,10 +88,13 @@ namespace pegasus
 
     PegasusInst::PegasusInst(const mavis::OpcodeInfo::PtrType & opcode_info,
                              const PegasusExtractorPtr & extractor_info, PegasusState* state) :
+        scratch_(state->getInstScratch()),
         opcode_info_(opcode_info),
         extractor_info_(testExtractorPointer(extractor_info, getMnemonic())),
         opcode_size_(((getOpcode() & 0x3) != 0x3) ? 2 : 4),
         is_store_type_(opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::STORE)),
+        is_atomic_(opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::ATOMIC)),
+        uses_softfloat_(usesSoftFloat(opcode_info)),
         memory_access_type_(
             determineMemoryAccessType(extractor_info_, is_store_type_, getMavisUid())),
         immediate_value_(getImmediateValue(opcode_info)),
@@ -87,8 +114,7 @@ namespace pegasus
         rs3_reg_(state->getSpartaRegister(rs3_info_)),
         rd_reg_(state->getSpartaRegister(rd_info_)),
         rd2_reg_(state->getSpartaRegister(rd2_info_)),
-        translation_state_(state->getInstTranslationState()),
-        inst_action_group_(extractor_info_->inst_action_group_)
+        translation_state_(state->getInstTranslationState())
     {
     }
 
@@ -118,14 +144,14 @@ namespace pegasus
 
     void PegasusInst::updateVectorConfig(const PegasusState* state)
     {
-        vec_config_ = makeVecCfg(*state->getVectorConfig(), veccfg_overrides_);
+        scratch_->vec_config = makeVecCfg(*state->getVectorConfig(), veccfg_overrides_);
     }
 
     template <bool IS_UNIT_TEST> bool PegasusInst::compare(const PegasusInst* inst) const
     {
         if constexpr (IS_UNIT_TEST)
         {
-            EXPECT_EQUAL(uid_, inst->uid_);
+            EXPECT_EQUAL(getUid(), inst->getUid());
             EXPECT_EQUAL(getOpcode(), inst->getOpcode());
             EXPECT_EQUAL(getOpcodeSize(), inst->getOpcodeSize());
             EXPECT_EQUAL(isMemoryInst(), inst->isMemoryInst());
@@ -139,7 +165,7 @@ namespace pegasus
         }
         else
         {
-            if (uid_ != inst->uid_)
+            if (getUid() != inst->getUid())
             {
                 return false;
             }
@@ -193,8 +219,8 @@ namespace pegasus
 
     std::ostream & operator<<(std::ostream & os, const PegasusInst & inst)
     {
-        os << "uid: " << std::dec << inst.uid_ << " " << inst.dasmString() << " "
-           << inst.inst_action_group_;
+        os << "uid: " << std::dec << inst.getUid() << " " << inst.dasmString() << " "
+           << *inst.getActionGroup();
         return os;
     }
 
@@ -18,11 +18,31 @@ namespace pegasus
     class PegasusState;
     class VectorConfig;
 
+    /*!
+     * \class PegasusInst
+     * \brief A decoded instruction
+     *
+     * Decoded instructions are immutable and are shared by every execution of their opcode on a
+     * hart (see DecodeCache). State that changes from one execution to the next is kept in the
+     * per-hart Scratch owned by PegasusState.
+     */
     class PegasusInst
     {
       public:
         using PtrType = sparta::SpartaSharedPointer<PegasusInst>;
 
+        // Per-hart state of the executing instruction
+        struct Scratch {
+            // Unique ID of the current execution
+            uint64_t uid = 0;
+
+            // Vector Config the instruction executes on
+            VectorConfig vec_config;
+
+            // Linked ActionGroup owned by Execute, nullptr until the instruction is executed
+            ActionGroup* action_group = nullptr;
+        };
+
         PegasusInst(const mavis::OpcodeInfo::PtrType & opcode_info,
                     const PegasusExtractorPtr & extractor_info, PegasusState* state);
 
@@ -30,9 +50,7 @@ namespace pegasus
 
         PegasusInst(const PegasusInst &) = default;
 
-        uint64_t getUid() const { return uid_; }
-
-        void setUid(const uint64_t uid) { uid_ = uid; }
+        uint64_t getUid() const { return scratch_->uid; }
 
         mavis::OpcodeInfo::PtrType getMavisOpcodeInfo() { return opcode_info_; }
 
@@ -87,6 +105,10 @@ namespace pegasus
 
         bool isHypervisorInst() const { return extractor_info_->isHypervisorInst(); }
 
+        bool isAtomic() const { return is_atomic_; }
+
+        bool usesSoftFloat() const { return uses_softfloat_; }
+
         bool writesCsr() const;
 
         uint32_t getOpcodeSize() const { return opcode_size_; }
@@ -223,13 +245,19 @@ namespace pegasus
 
         bool hasRd2() const { return rd2_reg_ != nullptr; }
 
-        ActionGroup* getActionGroup() { return &inst_action_group_; }
+        // Returns the linked ActionGroup of the current execution, or the unlinked ActionGroup of
+        // the extractor if the instruction has not been executed yet
+        const ActionGroup* getActionGroup() const
+        {
+            return scratch_->action_group ? scratch_->action_group
+                                          : extractor_info_->getActionGroup();
+        }
 
-        const ActionGroup* getActionGroup() const { return &inst_action_group_; }
+        const PegasusExtractor* getExtractorInfo() const { return extractor_info_.get(); }
 
-        const VectorConfig* getVectorConfig() const { return &vec_config_; }
+        const VectorConfig* getVectorConfig() const { return &scratch_->vec_config; }
 
-        VectorConfig* getVectorConfig() { return &vec_config_; }
+        VectorConfig* getVectorConfig() { return &scratch_->vec_config; }
 
         void updateVectorConfig(const PegasusState* state);
 
@@ -245,8 +273,8 @@ namespace pegasus
         }
 
       private:
-        // Unique ID
-        uint64_t uid_;
+        // Per-hart execution state, owned by PegasusState
+        Scratch* const scratch_;
 
         mavis::OpcodeInfo::PtrType opcode_info_;
         PegasusExtractorPtr extractor_info_;
@@ -257,15 +285,19 @@ namespace pegasus
         // Is this a store-type instruction
         const bool is_store_type_;
 
+        // Is this an atomic instruction (LR/SC, AMO, CAS)
+        const bool is_atomic_;
+
+        // Does this instruction use the SoftFloat rounding mode and exception flags (scalar and
+        // vector floating point instructions, FP CSR accesses)
+        const bool uses_softfloat_;
+
         // Memory access type (execute, load or store)
         const translate_types::AccessType memory_access_type_;
 
         // Cache immediate value, unsigned and signed
         const uint64_t immediate_value_;
 
-        // Vector Config this instruction executes on
-        VectorConfig vec_config_;
-
         // Vector Config overrides
         const VecCfgOverrides veccfg_overrides_;
 
@@ -284,8 +316,6 @@ namespace pegasus
         // Translation state for load/store instructions
         PegasusTranslationState* translation_state_ = nullptr;
 
-        ActionGroup inst_action_group_;
-
         friend std::ostream & operator<<(std::ostream & os, const PegasusInst & inst);
     };
 
@@ -24,6 +24,7 @@
 #include "sparta/utils/SpartaTester.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 namespace pegasus
 {
@@ -79,9 +80,17 @@ namespace pegasus
         reg_json_file_path_(p->reg_json_file_path),
         ilimit_(getInstLimit(hart_tn->getRoot(), p->ilimit)),
         quantum_(p->quantum),
+        max_quantum_(p->max_quantum),
+        current_quantum_(p->quantum),
+        quantum_end_inst_count_(p->quantum),
         stop_sim_on_wfi_(p->stop_sim_on_wfi),
+        vec_kernels_enabled_(p->enable_vec_kernels),
+        vec_crypto_engine_(p->enable_host_crypto ? &vec_crypto::getHostEngine()
+                                                 : &vec_crypto::getPortableEngine()),
+        host_fpu_enabled_(p->enable_host_fpu),
         ulimit_stack_size_(p->ulimit_stack_size),
         stf_filename_(p->stf_filename),
+        stf_writer_buffer_mb_(p->stf_writer_buffer_mb),
         validation_stf_filename_(p->validate_with_stf),
         validate_trace_begin_(p->validate_trace_begin),
         validate_inst_begin_(p->validate_inst_begin),
@@ -106,6 +115,7 @@ namespace pegasus
         zicntr_enabled_(extension_manager_.isEnabled("zicntr")),
         inst_logger_(hart_tn, "inst", "Pegasus Instruction Logger"),
         stf_valid_logger_(hart_tn, "stf_valid", "Pegasus STF Validator Logger"),
+        dmi_cache_(p->dmi_cache_entries),
         finish_action_group_("finish_inst"),
         stop_sim_action_group_("stop_sim"),
         pause_sim_action_group_("pause_sim")
@@ -139,6 +149,10 @@ namespace pegasus
         csr_rset_ = RegisterSet::create(
             hart_tn, reg_json_file_path + std::string("/reg_csr_hart.json"), "csr_regs");
 
+        int_reg_file_.init(int_rset_.get());
+        fp_reg_file_.init(fp_rset_.get());
+        vec_reg_file_.init(vec_rset_.get());
+
         auto add_registers = [this](const auto & reg_set)
         {
             for (const auto & kvp : reg_set->getRegistersByName())
@@ -211,6 +225,10 @@ namespace pegasus
         pause_action_ = pegasus::Action::createAction<&PegasusState::pauseSim_>(this, "pause sim");
         pause_sim_action_group_.addAction(pause_action_);
 
+        check_parallel_accesses_action_ =
+            pegasus::Action::createAction<&PegasusState::checkParallelAccesses_>(
+                this, "check parallel accesses");
+
         // Update VectorConfig vlen
         vector_config_.setVLEN(vlen_);
         vector_config_.setLMUL(p->init_lmul);
@@ -344,7 +362,9 @@ namespace pegasus
 
         if (!stf_filename_.empty())
         {
-            addObserver(std::make_unique<STFLogger>(xlen_, pc_, stf_filename_, this));
+            const size_t stf_buffer_size = static_cast<size_t>(stf_writer_buffer_mb_) * 1024 * 1024;
+            addObserver(
+                std::make_unique<STFLogger>(xlen_, pc_, stf_filename_, stf_buffer_size, this));
         }
 
         if (!validation_stf_filename_.empty())
@@ -387,14 +407,19 @@ namespace pegasus
             translate_types::TranslationMode::SV57  // mode == 10, xlen==64
         };
 
+        // SATP, VSATP and HGATP have the same MODE field and VSATP has the same ASID field as
+        // SATP, so the fields of the runtime selected ATP CSR can be extracted at compile time
+        using AtpMode = CsrField<XLEN, SATP, "mode">;
+        using AtpAsid = CsrField<XLEN, SATP, "asid">;
         const uint32_t ATP_CSR = Translate::getAtpCsr(stage);
-        const uint32_t atp_mode_val = READ_CSR_FIELD<XLEN>(this, ATP_CSR, "mode");
+        const XLEN atp_val = PEEK_CSR_REG<XLEN>(this, ATP_CSR);
+        const uint32_t atp_mode_val = (atp_val & AtpMode::mask) >> AtpMode::lsb;
         sparta_assert(atp_mode_val < mmu_mode_map.size(), "atp mode: " << atp_mode_val);
         const translate_types::TranslationMode mode = mmu_mode_map[atp_mode_val];
 
         // FIXME: Hypervisor does not support MPRV yet
-        const uint32_t mprv_val = READ_CSR_FIELD<XLEN>(this, MSTATUS, "mprv");
-        const PrivMode prev_priv_mode = (PrivMode)READ_CSR_FIELD<XLEN>(this, MSTATUS, "mpp");
+        const uint32_t mprv_val = READ_CSR_FIELD<XLEN, MSTATUS, "mprv">(this);
+        const PrivMode prev_priv_mode = (PrivMode)READ_CSR_FIELD<XLEN, MSTATUS, "mpp">(this);
         ldst_priv_modes_.at(static_cast<uint32_t>(stage)) =
             (mprv_val == 1) ? prev_priv_mode : priv_mode_;
         const translate_types::TranslationMode ls_mode =
@@ -402,6 +427,31 @@ namespace pegasus
                 ? translate_types::TranslationMode::BAREMETAL
                 : mode;
 
+        // Flush the TLB for this stage if the translation context has changed
+        TLB::Context tlb_context;
+        tlb_context.atp = atp_val;
+        if (hasHypervisor() && (stage != translate_types::TranslationStage::SUPERVISOR))
+        {
+            tlb_context.vmid = READ_CSR_FIELD<XLEN, HGATP, "vmid">(this);
+        }
+        tlb_context.asid = (stage == translate_types::TranslationStage::GUEST)
+                               ? tlb_context.vmid
+                               : (atp_val & AtpAsid::mask) >> AtpAsid::lsb;
+        // The VS stage uses the SUM and MXR fields of VSSTATUS. MSTATUS.MXR applies to both
+        // stages of a guest translation.
+        if (hasHypervisor() && (stage == translate_types::TranslationStage::VIRTUAL_SUPERVISOR))
+        {
+            tlb_context.sum = READ_CSR_FIELD<XLEN, VSSTATUS, "sum">(this);
+            tlb_context.mxr = READ_CSR_FIELD<XLEN, VSSTATUS, "mxr">(this)
+                              | READ_CSR_FIELD<XLEN, MSTATUS, "mxr">(this);
+        }
+        else
+        {
+            tlb_context.sum = READ_CSR_FIELD<XLEN, MSTATUS, "sum">(this);
+            tlb_context.mxr = READ_CSR_FIELD<XLEN, MSTATUS, "mxr">(this);
+        }
+        translate_unit_->getTLB(stage)->setContext(tlb_context);
+
         DLOG_CODE_BLOCK(DLOG_OUTPUT(stage << " MMU Mode: " << mode);
                         DLOG_OUTPUT(stage << " MMU LS Mode: " << ls_mode););
         switch (stage)
@@ -425,6 +475,97 @@ namespace pegasus
         }
     }
 
+    Action::ItrType PegasusState::endParallelWindow()
+    {
+        pauseHart(SimPauseReason::SYNC);
+        inst_translation_state_.reset();
+        return redirectActionGroup(&pause_sim_action_group_);
+    }
+
+    sparta::memory::BlockingMemoryIF* PegasusState::getSharedMemory_()
+    {
+        // Only plain memory accessed through the DMI cache is safe to share with harts running
+        // on other host threads
+        sparta_assert(!in_parallel_window_,
+                      "hart" << std::dec << hart_id_
+                             << " accessed memory outside of the DMI cache in a parallel window");
+        return pegasus_core_->getMemory();
+    }
+
+    Action::ItrType PegasusState::checkParallelAccesses_(PegasusState*, Action::ItrType action_it)
+    {
+        if (SPARTA_EXPECT_FALSE(in_parallel_window_))
+        {
+            const bool is_write =
+                getCurrentInst()->getMemoryAccessType() == translate_types::AccessType::STORE;
+            for (uint32_t idx = 0; idx < inst_translation_state_.getNumResults(); ++idx)
+            {
+                const auto & result = inst_translation_state_.getResult(idx);
+                if (!canAccessInParallel(result.getPAddr(), result.getSize(), is_write))
+                {
+                    return endParallelWindow();
+                }
+            }
+        }
+        return ++action_it;
+    }
+
+    sparta::utils::ValidValue<InterruptCause> PegasusState::checkInterrupts()
+    {
+        interrupt_check_requested_ = false;
+        return (xlen_ == 64) ? checkInterrupts_<RV64>() : checkInterrupts_<RV32>();
+    }
+
+    template <typename XLEN>
+    sparta::utils::ValidValue<InterruptCause> PegasusState::checkInterrupts_()
+    {
+        const XLEN pending = PEEK_CSR_REG<XLEN>(this, MIP) & PEEK_CSR_REG<XLEN>(this, MIE);
+        if (pending == 0)
+        {
+            return {};
+        }
+
+        // Interrupts that are not delegated trap into M-mode. They are always enabled in less
+        // privileged modes, and enabled by MSTATUS.MIE in M-mode.
+        const XLEN mideleg = PEEK_CSR_REG<XLEN>(this, MIDELEG);
+        XLEN enabled = 0;
+        if ((priv_mode_ != PrivMode::MACHINE) || READ_CSR_FIELD<XLEN, MSTATUS, "mie">(this))
+        {
+            enabled |= pending & ~mideleg;
+        }
+
+        // Delegated interrupts trap into HS-mode and are never taken in M-mode
+        if ((priv_mode_ == PrivMode::USER) || virtual_mode_
+            || ((priv_mode_ == PrivMode::SUPERVISOR) && READ_CSR_FIELD<XLEN, SSTATUS, "sie">(this)))
+        {
+            enabled |= pending & mideleg;
+        }
+
+        // Interrupts to VS-mode (HIDELEG) are not supported yet
+        static constexpr InterruptCause PRIORITY_ORDER[] = {
+            InterruptCause::MACHINE_EXTERNAL,    InterruptCause::MACHINE_SOFTWARE,
+            InterruptCause::MACHINE_TIMER,       InterruptCause::SUPERVISOR_EXTERNAL,
+            InterruptCause::SUPERVISOR_SOFTWARE, InterruptCause::SUPERVISOR_TIMER,
+            InterruptCause::COUNTER_OVERFLOW};
+        for (const InterruptCause cause : PRIORITY_ORDER)
+        {
+            if (enabled & (XLEN(1) << static_cast<uint64_t>(cause)))
+            {
+                return cause;
+            }
+        }
+        return {};
+    }
+
+    bool PegasusState::hasEnabledInterrupt()
+    {
+        if (xlen_ == 64)
+        {
+            return (PEEK_CSR_REG<RV64>(this, MIP) & PEEK_CSR_REG<RV64>(this, MIE)) != 0;
+        }
+        return (PEEK_CSR_REG<RV32>(this, MIP) & PEEK_CSR_REG<RV32>(this, MIE)) != 0;
+    }
+
     void PegasusState::pauseHart(const SimPauseReason reason)
     {
         sim_state_.sim_pause_reason = reason;
@@ -497,6 +638,13 @@ namespace pegasus
     {
         extension_manager_.switchMavisContext(*mavis_.get());
 
+        // Decoded blocks may contain instructions that are no longer enabled
+        if (fetch_unit_)
+        {
+            fetch_unit_->getBlockCache()->flush();
+            fetch_unit_->getDecodeCache()->flush();
+        }
+
         hypervisor_enabled_ = extension_manager_.isEnabled("h");
         zicntr_enabled_ = extension_manager_.isEnabled("zicntr");
 
@@ -554,20 +702,52 @@ namespace pegasus
         }
     }
 
-    sparta::Register* PegasusState::findRegister(const std::string & reg_name,
-                                                 bool must_exist) const
+    sparta::Register* PegasusState::findRegister(const std::string & reg_name, bool must_exist)
     {
         auto iter = registers_by_name_.find(reg_name);
         auto reg = (iter != registers_by_name_.end()) ? iter->second : nullptr;
         sparta_assert(!must_exist || reg, "Failed to find register: " << reg_name);
+        if (reg && isCounterCsr_(reg->getID()))
+        {
+            syncCounterCsrs();
+        }
         return reg;
     }
 
+    uint8_t* PegasusState::getDmiPointer_(const Addr paddr, const size_t size, const bool is_write)
+    {
+        // Observers expect callbacks for every memory access, and stores must check reservations
+        if (!dmi_cache_.isEnabled() || !observers_.empty()
+            || (is_write && pegasus_core_->isReservationMemoryActive()))
+        {
+            return nullptr;
+        }
+
+        if (SPARTA_EXPECT_FALSE(!DmiCache::isPageContained(paddr, size)))
+        {
+            return nullptr;
+        }
+
+        if (uint8_t* host_ptr = dmi_cache_.lookup(paddr); SPARTA_EXPECT_TRUE(host_ptr != nullptr))
+        {
+            return host_ptr;
+        }
+
+        // Devices (MagicMemory, UART) are not backed by host memory
+        uint8_t* host_page = pegasus_core_->getSystem()->getHostPage(paddr);
+        if (host_page == nullptr)
+        {
+            return nullptr;
+        }
+        dmi_cache_.insert(paddr, host_page);
+        return host_page + (paddr & DmiCache::PAGEOFFSET_MASK);
+    }
+
     template <typename MemoryType>
     bool PegasusState::readMemory(const PegasusTranslationState::TranslationResult & result,
                                   std::vector<uint8_t> & buffer, const MemAccessSource source)
     {
-        auto* memory = pegasus_core_->getMemory();
+        auto* memory = getSharedMemory_();
 
         static_assert(std::is_trivial<MemoryType>());
         static_assert(std::is_standard_layout<MemoryType>());
@@ -589,21 +769,74 @@ namespace pegasus
         return readMemory<MemoryType>(result, buffer, source);
     }
 
+    template <typename MemoryType>
+    std::optional<MemoryType>
+    PegasusState::readMemory(const PegasusTranslationState::TranslationResult & result,
+                             const MemAccessSource source)
+    {
+        static_assert(std::is_trivial<MemoryType>());
+        static_assert(std::is_standard_layout<MemoryType>());
+        const size_t size = sizeof(MemoryType);
+        MemoryType value;
+        if (const uint8_t* host_ptr = getDmiPointer_(result.getPAddr(), size, false))
+        {
+            std::memcpy(&value, host_ptr, size);
+            DLOG("Memory read (" << source << ", " << std::dec << size << "B) to 0x" << std::hex
+                                 << result.getPAddr() << " succeeded!");
+            return value;
+        }
+
+        auto* memory = getSharedMemory_();
+        const MemorySupplement supplement{result.getPAddr(), result.getVAddr(), source};
+        const bool success = memory->tryRead(result.getPAddr(), size,
+                                             reinterpret_cast<uint8_t*>(&value), &supplement);
+        DLOG("Memory read (" << source << ", " << std::dec << size << "B) to 0x" << std::hex
+                             << result.getPAddr() << " " << (success ? "succeeded!" : "failed!"));
+        if (SPARTA_EXPECT_FALSE(!success))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    template <typename MemoryType>
+    std::optional<MemoryType> PegasusState::readMemory(const Addr paddr,
+                                                       const MemAccessSource source)
+    {
+        const Addr vaddr = 0;
+        const PegasusTranslationState::TranslationResult result{vaddr, paddr, sizeof(MemoryType)};
+        return readMemory<MemoryType>(result, source);
+    }
+
     template <typename MemoryType>
     bool PegasusState::writeMemory(const PegasusTranslationState::TranslationResult & result,
                                    const MemoryType value, const MemAccessSource source)
     {
-        auto* memory = pegasus_core_->getMemory();
-
         static_assert(std::is_trivial<MemoryType>());
         static_assert(std::is_standard_layout<MemoryType>());
         const size_t size = sizeof(MemoryType);
-        const std::vector<uint8_t> buffer = convertToByteVector<MemoryType>(value);
-        const MemorySupplement supplement{result.getPAddr(), result.getVAddr(), source};
-        const bool success = memory->tryWrite(result.getPAddr(), size, buffer.data(), &supplement);
+        bool success = false;
+        if (uint8_t* host_ptr = getDmiPointer_(result.getPAddr(), size, true))
+        {
+            std::memcpy(host_ptr, &value, size);
+            success = true;
+        }
+        else
+        {
+            auto* memory = getSharedMemory_();
+            const MemorySupplement supplement{result.getPAddr(), result.getVAddr(), source};
+            success = memory->tryWrite(result.getPAddr(), size,
+                                       reinterpret_cast<const uint8_t*>(&value), &supplement);
+        }
         DLOG("Memory write (" << source << ", " << std::dec << size << "B) to 0x" << std::hex
                               << result.getPAddr() << " (value: 0x" << (uint64_t)value << ") "
                               << (success ? "succeeded!" : "failed!"));
+
+        // Self-modifying code, invalidate any decoded blocks on the written page
+        if (fetch_unit_)
+        {
+            fetch_unit_->getBlockCache()->invalidateStore(result.getPAddr(), size);
+        }
         return success;
     }
 
@@ -616,12 +849,83 @@ namespace pegasus
         return writeMemory<MemoryType>(result, value, source);
     }
 
+    bool PegasusState::readMemoryBlock(const PegasusTranslationState::TranslationResult & result,
+                                       uint8_t* buffer, const size_t elem_size,
+                                       const MemAccessSource source)
+    {
+        const size_t size = result.getSize();
+        sparta_assert((size % elem_size) == 0);
+        if (const uint8_t* host_ptr = getDmiPointer_(result.getPAddr(), size, false))
+        {
+            std::memcpy(buffer, host_ptr, size);
+            DLOG("Memory block read (" << source << ", " << std::dec << size << "B) to 0x"
+                                       << std::hex << result.getPAddr() << " succeeded!");
+            return true;
+        }
+
+        auto* memory = getSharedMemory_();
+        for (size_t offset = 0; offset < size; offset += elem_size)
+        {
+            const MemorySupplement supplement{result.getPAddr() + offset,
+                                              result.getVAddr() + offset, source};
+            const bool success = memory->tryRead(result.getPAddr() + offset, elem_size,
+                                                 buffer + offset, &supplement);
+            DLOG("Memory read (" << source << ", " << std::dec << elem_size << "B) to 0x"
+                                 << std::hex << (result.getPAddr() + offset) << " "
+                                 << (success ? "succeeded!" : "failed!"));
+            if (SPARTA_EXPECT_FALSE(!success))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool PegasusState::writeMemoryBlock(const PegasusTranslationState::TranslationResult & result,
+                                        const uint8_t* buffer, const size_t elem_size,
+                                        const MemAccessSource source)
+    {
+        const size_t size = result.getSize();
+        sparta_assert((size % elem_size) == 0);
+        bool success = true;
+        if (uint8_t* host_ptr = getDmiPointer_(result.getPAddr(), size, true))
+        {
+            std::memcpy(host_ptr, buffer, size);
+            DLOG("Memory block write (" << source << ", " << std::dec << size << "B) to 0x"
+                                        << std::hex << result.getPAddr() << " succeeded!");
+        }
+        else
+        {
+            auto* memory = getSharedMemory_();
+            for (size_t offset = 0; success && (offset < size); offset += elem_size)
+            {
+                const MemorySupplement supplement{result.getPAddr() + offset,
+                                                  result.getVAddr() + offset, source};
+                success = memory->tryWrite(result.getPAddr() + offset, elem_size,
+                                           buffer + offset, &supplement);
+                DLOG("Memory write (" << source << ", " << std::dec << elem_size << "B) to 0x"
+                                      << std::hex << (result.getPAddr() + offset) << " "
+                                      << (success ? "succeeded!" : "failed!"));
+            }
+        }
+
+        // Self-modifying code, invalidate any decoded blocks on the written page
+        if (fetch_unit_)
+        {
+            fetch_unit_->getBlockCache()->invalidateStore(result.getPAddr(), size);
+        }
+        return success;
+    }
+
 #define INSTANTIATE_READ_MEMORY_METHODS(SIZE)                                                      \
     template bool PegasusState::readMemory<SIZE>(                                                  \
         const PegasusTranslationState::TranslationResult &, std::vector<uint8_t> &,                \
         const MemAccessSource);                                                                    \
     template bool PegasusState::readMemory<SIZE>(const Addr, std::vector<uint8_t> &,               \
-                                                 const MemAccessSource);
+                                                 const MemAccessSource);                           \
+    template std::optional<SIZE> PegasusState::readMemory<SIZE>(                                   \
+        const PegasusTranslationState::TranslationResult &, const MemAccessSource);                \
+    template std::optional<SIZE> PegasusState::readMemory<SIZE>(const Addr, const MemAccessSource);
 
     INSTANTIATE_READ_MEMORY_METHODS(int8_t)
     INSTANTIATE_READ_MEMORY_METHODS(uint8_t)
@@ -656,6 +960,12 @@ namespace pegasus
             finish_action_group_.addAction(post_execute_action_);
             exception_unit_->getActionGroup()->insertActionBefore(pre_exception_action_,
                                                                   ActionTags::EXCEPTION_TAG);
+
+            // Cached instruction ActionGroups do not have the pre execute Action
+            if (execute_unit_)
+            {
+                execute_unit_->invalidateInstActionGroupCache();
+            }
         }
 
         pegasus_core_->getSystem()->registerMemoryCallbacks(observer.get());
@@ -669,6 +979,14 @@ namespace pegasus
 
     void PegasusState::insertExecuteActions(ActionGroup* action_group, const bool is_memory_inst)
     {
+        // Memory instructions find out whether they can run in a parallel window once their
+        // addresses are translated, before they execute
+        if (is_memory_inst && pegasus_core_->hasParallelWindows())
+        {
+            action_group->insertActionBefore(check_parallel_accesses_action_,
+                                             ActionTags::EXECUTE_TAG);
+        }
+
         if (pre_execute_action_)
         {
             if (is_memory_inst)
@@ -682,74 +1000,77 @@ namespace pegasus
         }
     }
 
-    template <typename XLEN> void PegasusState::incrCycleCsrs_()
+    void PegasusState::syncCounterCsrs()
     {
-        const XLEN cycle = getCsrRegister(CYCLE)->dmiRead<XLEN>();
-        const XLEN mcycle = getCsrRegister(MCYCLE)->dmiRead<XLEN>();
-        if constexpr (std::is_same_v<XLEN, RV32>)
+        if (xlen_ == 64)
+        {
+            syncCounterCsrs_<RV64>();
+        }
+        else
         {
-            if (SPARTA_EXPECT_FALSE(cycle == std::numeric_limits<XLEN>::max()))
+            syncCounterCsrs_<RV32>();
+        }
+    }
+
+    template <typename XLEN> void PegasusState::syncCounterCsrs_()
+    {
+        const XLEN mcountinhibit = csr_rset_->getRegister(MCOUNTINHIBIT)->dmiRead<XLEN>();
+        const PegasusSystem* system = pegasus_core_->getSystem();
+        const Clint* clint = system ? system->getClint() : nullptr;
+        for (CounterCsr & counter : counter_csrs_)
+        {
+            // time reads mtime when there is a CLINT, which can be written and may tick slower
+            // than the cycle count
+            if (clint && (counter.csr == TIME))
             {
-                const XLEN cycleh = getCsrRegister(CYCLE)->dmiRead<XLEN>();
-                getCsrRegister(CYCLEH)->dmiWrite<XLEN>(cycleh + 1);
+                if (hasZicntr())
+                {
+                    writeCounterCsr_<XLEN>(counter, clint->getMtime(sim_state_.cycles));
+                }
+                continue;
             }
 
-            if (SPARTA_EXPECT_FALSE(mcycle == std::numeric_limits<XLEN>::max()))
+            const uint64_t count = counter.counts_insts ? sim_state_.inst_count : sim_state_.cycles;
+            // Counts only go back when the simulation is rewound, which restores the registers
+            const uint64_t increment =
+                (count > counter.last_count) ? (count - counter.last_count) : 0;
+            counter.last_count = count;
+            if ((increment == 0) || !hasZicntr() || (mcountinhibit & counter.inhibit_mask))
             {
-                const XLEN mcycleh = getCsrRegister(MCYCLE)->dmiRead<XLEN>();
-                getCsrRegister(MCYCLEH)->dmiWrite<XLEN>(mcycleh + 1);
+                continue;
             }
+
+            writeCounterCsr_<XLEN>(counter, readCounterCsr_<XLEN>(counter) + increment);
         }
-        getCsrRegister(CYCLE)->dmiWrite<XLEN>(cycle + 1);
-        getCsrRegister(MCYCLE)->dmiWrite<XLEN>(mcycle + 1);
     }
 
-    template <typename XLEN> void PegasusState::incrTimeCsrs_()
+    template <typename XLEN> uint64_t PegasusState::readCounterCsr_(const CounterCsr & counter)
     {
-        // From the RISC-V spec:
-        // On some simple platforms, cycle count might represent a valid
-        // implementation of RDTIME, in which case RDTIME and RDCYCLE
-        // may return the same result.
-        const XLEN time = getCsrRegister(TIME)->dmiRead<XLEN>();
+        const uint64_t value = csr_rset_->getRegister(counter.csr)->dmiRead<XLEN>();
         if constexpr (std::is_same_v<XLEN, RV32>)
         {
-            if (SPARTA_EXPECT_FALSE(time == std::numeric_limits<XLEN>::max()))
-            {
-                const XLEN timeh = getCsrRegister(TIME)->dmiRead<XLEN>();
-                getCsrRegister(TIMEH)->dmiWrite<XLEN>(timeh + 1);
-            }
+            return (uint64_t(csr_rset_->getRegister(counter.csrh)->dmiRead<XLEN>()) << 32) | value;
         }
-        getCsrRegister(TIME)->dmiWrite<XLEN>(time + 1);
+        return value;
     }
 
-    template <typename XLEN> void PegasusState::incrInstretCsrs_()
+    template <typename XLEN>
+    void PegasusState::writeCounterCsr_(const CounterCsr & counter, uint64_t value)
     {
-        const XLEN instret = getCsrRegister(INSTRET)->dmiRead<XLEN>();
-        const XLEN minstret = getCsrRegister(MINSTRET)->dmiRead<XLEN>();
+        csr_rset_->getRegister(counter.csr)->dmiWrite<XLEN>(XLEN(value));
         if constexpr (std::is_same_v<XLEN, RV32>)
         {
-            if (SPARTA_EXPECT_FALSE(instret == std::numeric_limits<XLEN>::max()))
-            {
-                const XLEN instreth = getCsrRegister(INSTRETH)->dmiRead<XLEN>();
-                getCsrRegister(INSTRETH)->dmiWrite<XLEN>(instreth + 1);
-            }
-
-            if (SPARTA_EXPECT_FALSE(minstret == std::numeric_limits<XLEN>::max()))
-            {
-                const XLEN minstreth = getCsrRegister(MINSTRETH)->dmiRead<XLEN>();
-                getCsrRegister(MINSTRETH)->dmiWrite<XLEN>(minstreth + 1);
-            }
+            csr_rset_->getRegister(counter.csrh)->dmiWrite<XLEN>(XLEN(value >> 32));
         }
-        getCsrRegister(INSTRET)->dmiWrite<XLEN>(instret + 1);
-        getCsrRegister(MINSTRET)->dmiWrite<XLEN>(minstret + 1);
     }
 
-    template void PegasusState::incrCycleCsrs_<RV64>();
-    template void PegasusState::incrTimeCsrs_<RV64>();
-    template void PegasusState::incrInstretCsrs_<RV64>();
-    template void PegasusState::incrCycleCsrs_<RV32>();
-    template void PegasusState::incrTimeCsrs_<RV32>();
-    template void PegasusState::incrInstretCsrs_<RV32>();
+    void PegasusState::rebaseCounterCsrs()
+    {
+        for (CounterCsr & counter : counter_csrs_)
+        {
+            counter.last_count = counter.counts_insts ? sim_state_.inst_count : sim_state_.cycles;
+        }
+    }
 
     template <typename XLEN, bool CHECK_ILIMIT>
     Action::ItrType PegasusState::incrementPc_(PegasusState*, Action::ItrType action_it)
@@ -769,13 +1090,6 @@ namespace pegasus
         // for now just assume each inst takes 1 cycle
         ++sim_state_.cycles;
 
-        if (hasZicntr())
-        {
-            incrInstretCsrs_<XLEN>();
-            incrCycleCsrs_<XLEN>();
-            incrTimeCsrs_<XLEN>();
-        }
-
         if constexpr (CHECK_ILIMIT)
         {
             if (sim_state_.inst_count == ilimit_)
@@ -787,10 +1101,11 @@ namespace pegasus
             }
         }
 
-        if (sim_state_.inst_count % quantum_ == 0)
+        if (SPARTA_EXPECT_FALSE(sim_state_.inst_count >= quantum_end_inst_count_))
         {
-            DLOG("Executed " << std::dec << quantum_
+            DLOG("Executed " << std::dec << current_quantum_
                              << " instructions (total: " << sim_state_.inst_count << ")");
+            quantum_end_inst_count_ = sim_state_.inst_count + current_quantum_;
             pauseHart(SimPauseReason::QUANTUM);
         }
 
@@ -971,6 +1286,7 @@ namespace pegasus
 
             if (hasZicntr())
             {
+                syncCounterCsrs();
                 if (xlen_ == 64)
                 {
                     std::cout << "\tCYCLE: " << getCsrRegister(CYCLE)->dmiRead<RV64>() << std::endl;
@@ -1015,7 +1331,8 @@ namespace pegasus
 
         auto mem = getCore()->getMemory();
         auto emulator = getCore()->getSystemCallEmulator();
-        const XLEN ret_code = static_cast<XLEN>(emulator->emulateSystemCall(call_stack, mem));
+        const XLEN ret_code =
+            static_cast<XLEN>(emulator->emulateSystemCall(call_stack, mem, this));
         return ret_code;
     }
 
@@ -1199,19 +1516,19 @@ namespace pegasus
                 POKE_CSR_REG<RV64>(this, MHARTID, hart_id_);
 
                 const uint64_t xlen_val = 2;
-                POKE_CSR_FIELD<RV64>(this, MISA, "mxl", xlen_val);
+                POKE_CSR_FIELD<RV64, MISA, "mxl">(this, xlen_val);
 
                 const uint32_t ext_val = getMisaExtFieldValue<RV64>();
-                POKE_CSR_FIELD<RV64>(this, MISA, "extensions", ext_val);
+                POKE_CSR_FIELD<RV64, MISA, "extensions">(this, ext_val);
 
                 // Initialize MSTATUS/STATUS with User and Supervisor mode XLEN
-                POKE_CSR_FIELD<RV64>(this, MSTATUS, "uxl", xlen_val);
-                POKE_CSR_FIELD<RV64>(this, MSTATUS, "sxl", xlen_val);
-                POKE_CSR_FIELD<RV64>(this, SSTATUS, "uxl", xlen_val);
+                POKE_CSR_FIELD<RV64, MSTATUS, "uxl">(this, xlen_val);
+                POKE_CSR_FIELD<RV64, MSTATUS, "sxl">(this, xlen_val);
+                POKE_CSR_FIELD<RV64, SSTATUS, "uxl">(this, xlen_val);
 
                 if (hasHypervisor())
                 {
-                    POKE_CSR_FIELD<RV64>(this, VSSTATUS, "uxl", xlen_val);
+                    POKE_CSR_FIELD<RV64, VSSTATUS, "uxl">(this, xlen_val);
                 }
             }
             else
@@ -1219,10 +1536,10 @@ namespace pegasus
                 POKE_CSR_REG<RV32>(this, MHARTID, hart_id_);
 
                 const uint32_t xlen_val = 1;
-                POKE_CSR_FIELD<RV32>(this, MISA, "mxl", xlen_val);
+                POKE_CSR_FIELD<RV32, MISA, "mxl">(this, xlen_val);
 
                 const uint32_t ext_val = getMisaExtFieldValue<RV32>();
-                POKE_CSR_FIELD<RV32>(this, MISA, "extensions", ext_val);
+                POKE_CSR_FIELD<RV32, MISA, "extensions">(this, ext_val);
             }
 
             std::cout << "PegasusState::boot()\n";
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "core/ActionGroup.hpp"
+#include "core/DmiCache.hpp"
 #include "core/PegasusInst.hpp"
+#include "core/RegisterFile.hpp"
+#include "core/VecCrypto.hpp"
 #include "core/observers/Observer.hpp"
 #include "core/VectorConfig.hpp"
 
@@ -21,7 +24,9 @@
 
 #include "mavis/extension_managers/RISCVExtensionManager.hpp"
 
+#include <algorithm>
 #include <filesystem>
+#include <optional>
 #include <regex>
 
 template <class InstT, class ExtenT, class InstTypeAllocator, class ExtTypeAllocator> class Mavis;
@@ -82,7 +87,22 @@ namespace pegasus
             PARAMETER(uint32_t, init_vstart, 0, "Initial vector start index (VSTART)")
             PARAMETER(uint32_t, ilimit, 0, "Instruction limit for stopping simulation")
             PARAMETER(uint32_t, quantum, 500, "Instruction quantum size")
+            PARAMETER(uint32_t, max_quantum, 64000,
+                      "Maximum instruction quantum size of a single-hart core. The quantum doubles "
+                      "up to this size while the hart runs without pausing (0 to disable)")
             PARAMETER(bool, stop_sim_on_wfi, false, "Executing a WFI instruction stops simulation")
+            PARAMETER(bool, enable_vec_kernels, true,
+                      "Execute element-wise vector integer instructions and unit-stride vector "
+                      "loads/stores on whole registers instead of element by element")
+            PARAMETER(bool, enable_host_crypto, true,
+                      "Execute vector crypto instructions with the AES-NI/SHA-NI instructions of the "
+                      "host when it has them instead of the portable implementation")
+            PARAMETER(bool, enable_host_fpu, true,
+                      "Execute scalar F/D arithmetic and conversions on the host FPU when the "
+                      "result is guaranteed to match SoftFloat (falls back to SoftFloat otherwise)")
+            PARAMETER(uint32_t, dmi_cache_entries, 64,
+                      "Number of host page pointers cached for direct memory access (power of 2, "
+                      "0 to disable)")
             // Typical stack pointer is 8KB on most linux systems
             PARAMETER(uint32_t, ulimit_stack_size, 8192,
                       "Typical ulimit stack size for system call emulation")
@@ -90,6 +110,9 @@ namespace pegasus
             // STF Validation
             PARAMETER(std::string, stf_filename, "",
                       "STF Trace file name (when not given, STF tracing is disabled)")
+            PARAMETER(uint32_t, stf_writer_buffer_mb, 0,
+                      "Memory budget in MB for STF records buffered for a background writer "
+                      "thread (0 writes the trace on the simulation thread)")
             PARAMETER(std::string, validate_with_stf, "",
                       "STF Trace file name (when not given, STF tracing is disabled)")
             PARAMETER(uint64_t, validate_trace_begin, 1,
@@ -124,8 +147,46 @@ namespace pegasus
 
         uint64_t getQuantumSize() const { return quantum_; }
 
+        uint64_t getCurrentQuantumSize() const { return current_quantum_; }
+
+        // Double the instruction quantum, up to the maximum quantum size
+        void growQuantum() { growQuantum(max_quantum_); }
+
+        // Double the instruction quantum, up to the given maximum quantum size
+        void growQuantum(uint64_t max_quantum)
+        {
+            if (current_quantum_ < max_quantum)
+            {
+                current_quantum_ = std::min(current_quantum_ * 2, max_quantum);
+                quantum_end_inst_count_ = sim_state_.inst_count + current_quantum_;
+            }
+        }
+
+        // Go back to the initial instruction quantum
+        void resetQuantum()
+        {
+            current_quantum_ = quantum_;
+            quantum_end_inst_count_ = sim_state_.inst_count + current_quantum_;
+        }
+
         bool getStopSimOnWfi() const { return stop_sim_on_wfi_; }
 
+        bool isVecKernelsEnabled() const { return vec_kernels_enabled_; }
+
+        void setVecKernelsEnabled(bool enabled) { vec_kernels_enabled_ = enabled; }
+
+        const VecCryptoEngine & getVecCryptoEngine() const { return *vec_crypto_engine_; }
+
+        void setHostCryptoEnabled(bool enabled)
+        {
+            vec_crypto_engine_ =
+                enabled ? &vec_crypto::getHostEngine() : &vec_crypto::getPortableEngine();
+        }
+
+        bool isHostFpuEnabled() const { return host_fpu_enabled_; }
+
+        void setHostFpuEnabled(bool enabled) { host_fpu_enabled_ = enabled; }
+
         void setPc(Addr pc) { pc_ = pc; }
 
         Addr getPc() const { return pc_; }
@@ -194,18 +255,71 @@ namespace pegasus
 
         void unpauseHart();
 
+        // Set by PegasusCore while the hart runs on a host thread alongside other harts
+        void setInParallelWindow(bool in_parallel_window)
+        {
+            in_parallel_window_ = in_parallel_window;
+        }
+
+        bool inParallelWindow() const { return in_parallel_window_; }
+
+        // Called by an Action before it touches state shared with other harts during a parallel
+        // window. Pauses the hart without executing the current instruction, which is executed
+        // again once the hart runs alone.
+        Action::ItrType endParallelWindow();
+
+        // True if a memory access can be made while other harts run on other host threads, i.e.
+        // it goes through the DMI cache. Always true outside of a parallel window. Actions must
+        // check this, and end the parallel window if needed, before they make any change to the
+        // hart state.
+        bool canAccessInParallel(const Addr paddr, const size_t size, const bool is_write)
+        {
+            return !in_parallel_window_ || (getDmiPointer_(paddr, size, is_write) != nullptr);
+        }
+
+        // Called whenever the pending or enabled interrupts may have changed (MIP, MIE, MIDELEG
+        // or MSTATUS writes, xRET, interrupt devices). Interrupts are only checked before the
+        // next fetch after a request, so they are not polled on every instruction.
+        void requestInterruptCheck() { interrupt_check_requested_ = true; }
+
+        bool isInterruptCheckRequested() const { return interrupt_check_requested_; }
+
+        // Clears the request and returns the highest priority interrupt that can be taken in the
+        // current privilege mode, if any
+        sparta::utils::ValidValue<InterruptCause> checkInterrupts();
+
+        // True if an interrupt is pending and enabled in MIE, which wakes up a hart in WFI
+        // regardless of the global interrupt enables
+        bool hasEnabledInterrupt();
+
+        // The counter CSRs (cycle, time, instret, their machine versions and RV32 high halves)
+        // are not written when instructions retire. They are derived from the instruction and
+        // cycle counts, or from the CLINT mtime for time, and brought up to date by the CSR read
+        // Actions of the CSR instructions that access them and by findRegister(). Anything else
+        // reading them through the CSR register set must sync them first.
+        void syncCounterCsrs();
+
+        // Count from the current counter CSR values, e.g. after they were restored from a
+        // checkpoint along with the instruction count
+        void rebaseCounterCsrs();
+
         const VectorConfig* getVectorConfig() const { return &vector_config_; }
 
         VectorConfig* getVectorConfig() { return &vector_config_; }
 
         const PegasusInstPtr & getCurrentInst() { return sim_state_.current_inst; }
 
-        void setCurrentInst(PegasusInstPtr inst)
+        void setCurrentInst(const PegasusInstPtr & inst)
         {
-            inst->setUid(sim_state_.current_uid);
+            inst_scratch_.uid = sim_state_.current_uid;
+            inst_scratch_.action_group = nullptr;
             sim_state_.current_inst = inst;
         }
 
+        PegasusInst::Scratch* getInstScratch() { return &inst_scratch_; }
+
+        // Raise a trap from code that is not an Action (e.g. a helper called by an Action).
+        // Actions should return redirectToException() instead to avoid unwinding the stack.
         void throwException(FaultCause cause)
         {
             auto exception_unit = getExceptionUnit();
@@ -213,6 +327,40 @@ namespace pegasus
             throw ActionException(exception_unit->getActionGroup());
         }
 
+        // Raise a trap from an Action, which must return the iterator returned here
+        Action::ItrType redirectToException(FaultCause cause)
+        {
+            auto exception_unit = getExceptionUnit();
+            exception_unit->setUnhandledException(cause);
+            return redirectActionGroup(exception_unit->getActionGroup());
+        }
+
+        Action::ItrType redirectToException(InterruptCause cause)
+        {
+            auto exception_unit = getExceptionUnit();
+            exception_unit->setUnhandledException(cause);
+            return redirectActionGroup(exception_unit->getActionGroup());
+        }
+
+        // Divert execution to another ActionGroup after the current Action returns. The Action
+        // must return the iterator returned here, which ends the current ActionGroup.
+        Action::ItrType redirectActionGroup(ActionGroup* action_group)
+        {
+            redirect_action_group_ = action_group;
+            return action_group_end_;
+        }
+
+        // Called by ActionGroup::execute before executing its Actions
+        void setActionGroupEnd(const Action::ItrType & end_it) { action_group_end_ = end_it; }
+
+        // Returns and clears the ActionGroup redirected to by the last ActionGroup, if any
+        ActionGroup* takeActionGroupRedirect()
+        {
+            ActionGroup* action_group = redirect_action_group_;
+            redirect_action_group_ = nullptr;
+            return action_group;
+        }
+
         void setCurrentException(uint64_t excp_code) { current_exception_ = excp_code; }
 
         void clearCurrentException() { current_exception_ = std::numeric_limits<ExcpCode>::max(); }
@@ -302,6 +450,16 @@ namespace pegasus
             return csr_rset_->getRegister(reg_num);
         }
 
+        // Number of registers in the integer, floating point and vector register files
+        static constexpr uint32_t NUM_ARCH_REGS = 32;
+        using ArchRegisterFile = RegisterFile<NUM_ARCH_REGS>;
+
+        ArchRegisterFile & getIntRegisterFile() { return int_reg_file_; }
+
+        ArchRegisterFile & getFpRegisterFile() { return fp_reg_file_; }
+
+        ArchRegisterFile & getVecRegisterFile() { return vec_reg_file_; }
+
         sparta::Register* findRegister(const RegId reg_id)
         {
             switch (reg_id.reg_type)
@@ -320,7 +478,7 @@ namespace pegasus
             return nullptr;
         }
 
-        sparta::Register* findRegister(const std::string & reg_name, bool must_exist = true) const;
+        sparta::Register* findRegister(const std::string & reg_name, bool must_exist = true);
 
         inline bool isRegEnabled(uint32_t id) const
         {
@@ -353,6 +511,14 @@ namespace pegasus
         template <typename MemoryType>
         bool readMemory(const Addr paddr, std::vector<uint8_t> & buffer,
                         const MemAccessSource source = MemAccessSource::INVALID);
+        // Typed reads that do not allocate a buffer, returns nullopt if the access failed
+        template <typename MemoryType>
+        std::optional<MemoryType>
+        readMemory(const PegasusTranslationState::TranslationResult & result,
+                   const MemAccessSource source = MemAccessSource::INVALID);
+        template <typename MemoryType>
+        std::optional<MemoryType> readMemory(const Addr paddr,
+                                             const MemAccessSource source = MemAccessSource::INVALID);
         template <typename MemoryType>
         bool writeMemory(const PegasusTranslationState::TranslationResult & result,
                          const MemoryType value,
@@ -360,6 +526,16 @@ namespace pegasus
         template <typename MemoryType>
         bool writeMemory(const Addr paddr, const MemoryType value,
                          const MemAccessSource source = MemAccessSource::INVALID);
+        // Bulk access of a page-contained block of memory. Blocks that are not backed by host
+        // memory (or that observers must see) are accessed elem_size bytes at a time, so devices
+        // see the same accesses as element by element. Returns false at the first failed access,
+        // all elements before it have been accessed.
+        bool readMemoryBlock(const PegasusTranslationState::TranslationResult & result,
+                             uint8_t* buffer, const size_t elem_size,
+                             const MemAccessSource source = MemAccessSource::INVALID);
+        bool writeMemoryBlock(const PegasusTranslationState::TranslationResult & result,
+                              const uint8_t* buffer, const size_t elem_size,
+                              const MemAccessSource source = MemAccessSource::INVALID);
 
         void addObserver(std::unique_ptr<Observer> observer);
 
@@ -444,15 +620,31 @@ namespace pegasus
 
         // Instruction quantum size
         const uint64_t quantum_;
+        const uint64_t max_quantum_;
+        uint64_t current_quantum_;
+
+        // Instruction count at which the hart is paused for the end of its quantum
+        uint64_t quantum_end_inst_count_;
 
         //! Stop simulatiion on WFI
         const bool stop_sim_on_wfi_;
 
+        //! Use the whole-register engine for element-wise vector instructions and unit-stride
+        //! vector loads/stores
+        bool vec_kernels_enabled_;
+
+        //! Element group engine for the vector crypto instructions (host or portable)
+        const VecCryptoEngine* vec_crypto_engine_;
+
+        //! Compute scalar F/D instructions on the host FPU where it matches SoftFloat
+        bool host_fpu_enabled_;
+
         //! Typical stack size for system call emulation
         const uint64_t ulimit_stack_size_;
 
         // STF Trace Filename
         const std::string stf_filename_;
+        const uint32_t stf_writer_buffer_mb_;
         const std::string validation_stf_filename_;
         const uint64_t validate_trace_begin_;
         const uint64_t validate_inst_begin_;
@@ -497,10 +689,54 @@ namespace pegasus
         //! Vector state
         VectorConfig vector_config_;
 
-        // Increment counter CSRs
-        template <typename XLEN> void incrCycleCsrs_();
-        template <typename XLEN> void incrTimeCsrs_();
-        template <typename XLEN> void incrInstretCsrs_();
+        // Counter CSRs derived from the instruction or cycle count
+        struct CounterCsr
+        {
+            uint32_t csr;
+            uint32_t csrh; // RV32 high half
+            bool counts_insts;
+            uint64_t inhibit_mask; // MCOUNTINHIBIT bit
+            // Instruction or cycle count when the register was last brought up to date
+            uint64_t last_count = 0;
+        };
+
+        // From the RISC-V spec:
+        // On some simple platforms, cycle count might represent a valid
+        // implementation of RDTIME, in which case RDTIME and RDCYCLE
+        // may return the same result.
+        std::array<CounterCsr, 5> counter_csrs_{{{CYCLE, CYCLEH, false, 0x1},
+                                                 {TIME, TIMEH, false, 0x0},
+                                                 {INSTRET, INSTRETH, true, 0x4},
+                                                 {MCYCLE, MCYCLEH, false, 0x1},
+                                                 {MINSTRET, MINSTRETH, true, 0x4}}};
+
+        // Counter CSRs, and MCOUNTINHIBIT which must be synced before it changes
+        static constexpr bool isCounterCsr_(uint32_t reg_num)
+        {
+            switch (reg_num)
+            {
+                case CYCLE:
+                case TIME:
+                case INSTRET:
+                case CYCLEH:
+                case TIMEH:
+                case INSTRETH:
+                case MCYCLE:
+                case MINSTRET:
+                case MCYCLEH:
+                case MINSTRETH:
+                case MCOUNTINHIBIT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        template <typename XLEN> void syncCounterCsrs_();
+
+        // Read or write the full 64-bit value of a counter CSR, both halves on RV32
+        template <typename XLEN> uint64_t readCounterCsr_(const CounterCsr & counter);
+        template <typename XLEN> void writeCounterCsr_(const CounterCsr & counter, uint64_t value);
 
         // Increment PC Action
         template <typename XLEN, bool CHECK_ILIMIT>
@@ -513,6 +749,9 @@ namespace pegasus
         // Instruction translation state
         PegasusTranslationState inst_translation_state_;
 
+        // Execution state of the current instruction, shared by all decoded instructions
+        PegasusInst::Scratch inst_scratch_;
+
         //! PegasusCore
         PegasusCore* pegasus_core_ = nullptr;
 
@@ -571,6 +810,11 @@ namespace pegasus
         std::unique_ptr<RegisterSet> vec_rset_;
         std::unique_ptr<RegisterSet> csr_rset_;
 
+        // Flat views of the GPR, FPR and vector register storage for instruction handlers
+        ArchRegisterFile int_reg_file_;
+        ArchRegisterFile fp_reg_file_;
+        ArchRegisterFile vec_reg_file_;
+
         // Cached registers by name
         std::unordered_map<std::string, sparta::Register*> registers_by_name_;
 
@@ -581,6 +825,27 @@ namespace pegasus
         // Observers
         std::vector<std::unique_ptr<Observer>> observers_;
 
+        // Host page pointers for direct access to system memory
+        DmiCache dmi_cache_;
+
+        // Returns a host pointer for the access if it can bypass the memory map
+        uint8_t* getDmiPointer_(const Addr paddr, const size_t size, const bool is_write);
+
+        // Memory for accesses that do not go through the DMI cache. Must not be reached during a
+        // parallel window, see canAccessInParallel().
+        sparta::memory::BlockingMemoryIF* getSharedMemory_();
+
+        // Ends the parallel window before a memory instruction executes if any of its translated
+        // accesses cannot be made in parallel
+        Action::ItrType checkParallelAccesses_(PegasusState* state, Action::ItrType action_it);
+        Action check_parallel_accesses_action_;
+
+        bool in_parallel_window_ = false;
+
+        bool interrupt_check_requested_ = false;
+
+        template <typename XLEN> sparta::utils::ValidValue<InterruptCause> checkInterrupts_();
+
         // MessageSource used for InstructionLogger
         sparta::log::MessageSource inst_logger_;
 
@@ -594,6 +859,10 @@ namespace pegasus
         Action stop_action_;
         ActionGroup stop_sim_action_group_;
 
+        // End of the ActionGroup being executed and the ActionGroup its Actions redirected to
+        Action::ItrType action_group_end_;
+        ActionGroup* redirect_action_group_ = nullptr;
+
         // Pause simulation Action
         Action pause_action_;
         ActionGroup pause_sim_action_group_;
@@ -614,7 +883,7 @@ namespace pegasus
     static inline XLEN READ_INT_REG(PegasusState* state, uint32_t reg_ident)
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
-        return (reg_ident == 0) ? 0 : state->getIntRegister(reg_ident)->dmiRead<XLEN>();
+        return (reg_ident == 0) ? 0 : state->getIntRegisterFile().read<XLEN>(reg_ident);
     }
 
     template <typename XLEN>
@@ -623,46 +892,46 @@ namespace pegasus
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
         if (reg_ident != 0)
         {
-            state->getIntRegister(reg_ident)->dmiWrite<XLEN>(reg_value);
+            state->getIntRegisterFile().write<XLEN>(reg_ident, reg_value);
         }
     }
 
     template <typename XLEN> static inline XLEN READ_FP_REG(PegasusState* state, uint32_t reg_ident)
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
-        return state->getFpRegister(reg_ident)->dmiRead<XLEN>();
+        return state->getFpRegisterFile().read<XLEN>(reg_ident);
     }
 
     template <typename XLEN>
     static inline void WRITE_FP_REG(PegasusState* state, uint32_t reg_ident, uint64_t reg_value)
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
-        state->getFpRegister(reg_ident)->dmiWrite<XLEN>(reg_value);
+        state->getFpRegisterFile().write<XLEN>(reg_ident, reg_value);
     }
 
     template <typename VLEN>
     static inline VLEN READ_VEC_REG(PegasusState* state, uint32_t reg_ident)
     {
-        return state->getVecRegister(reg_ident)->dmiRead<VLEN>();
+        return state->getVecRegisterFile().read<VLEN>(reg_ident);
     }
 
     template <typename VLEN>
     static inline void WRITE_VEC_REG(PegasusState* state, uint32_t reg_ident, VLEN reg_value)
     {
-        state->getVecRegister(reg_ident)->dmiWrite<VLEN>(reg_value);
+        state->getVecRegisterFile().write<VLEN>(reg_ident, reg_value);
     }
 
     template <typename Elem>
     static inline Elem READ_VEC_ELEM(PegasusState* state, uint32_t reg_ident, uint32_t idx)
     {
-        return state->getVecRegister(reg_ident)->dmiRead<Elem>(idx);
+        return state->getVecRegisterFile().read<Elem>(reg_ident, idx);
     }
 
     template <typename Elem>
     static inline void WRITE_VEC_ELEM(PegasusState* state, uint32_t reg_ident, Elem value,
                                       uint32_t idx)
     {
-        state->getVecRegister(reg_ident)->dmiWrite<Elem>(value, idx);
+        state->getVecRegisterFile().write<Elem>(reg_ident, value, idx);
     }
 
     template <typename XLEN>
@@ -794,4 +1063,75 @@ namespace pegasus
             POKE_CSR_REG<XLEN>(state, reg_ident, csr_value);
         }
     }
+
+    // CSR field name usable as a template argument, e.g. READ_CSR_FIELD<XLEN, MSTATUS, "sum">
+    template <size_t N> struct CsrFieldName {
+        constexpr CsrFieldName(const char (&str)[N]) { std::copy_n(str, N, name); }
+
+        char name[N];
+    };
+
+    // Bit range of a CSR field resolved at compile time, so accessing a field is a shift and
+    // mask. Misspelled field names fail to compile.
+    template <typename XLEN, uint32_t CSR_NUM, CsrFieldName FIELD> struct CsrField {
+        static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
+
+        static constexpr CsrBitRange bit_range = getCsrFieldBitRange<XLEN>(CSR_NUM, FIELD.name);
+        static constexpr uint32_t lsb = bit_range.low_bit;
+        static constexpr uint32_t msb = bit_range.high_bit;
+        // If field spans entire register, no mask/shift is needed
+        static constexpr bool full_width = (lsb == 0) && (msb >= (sizeof(XLEN) * 8 - 1));
+        static constexpr XLEN mask =
+            full_width ? std::numeric_limits<XLEN>::max()
+                       : static_cast<XLEN>(((XLEN(1) << (msb - lsb + 1)) - 1) << lsb);
+    };
+
+    template <typename XLEN, uint32_t CSR_NUM, CsrFieldName FIELD>
+    static inline XLEN READ_CSR_FIELD(PegasusState* state)
+    {
+        using Field = CsrField<XLEN, CSR_NUM, FIELD>;
+        const XLEN csr_value = state->getCsrRegister(CSR_NUM)->dmiRead<XLEN>();
+        if constexpr (Field::full_width)
+        {
+            return csr_value;
+        }
+        else
+        {
+            return (csr_value & Field::mask) >> Field::lsb;
+        }
+    }
+
+    template <typename XLEN, uint32_t CSR_NUM, CsrFieldName FIELD>
+    static inline void WRITE_CSR_FIELD(PegasusState* state, uint64_t field_value)
+    {
+        using Field = CsrField<XLEN, CSR_NUM, FIELD>;
+        if constexpr (Field::full_width)
+        {
+            WRITE_CSR_REG<XLEN>(state, CSR_NUM, field_value);
+        }
+        else
+        {
+            XLEN csr_value = PEEK_CSR_REG<XLEN>(state, CSR_NUM);
+            csr_value &= ~Field::mask;
+            csr_value |= static_cast<XLEN>(field_value << Field::lsb);
+            WRITE_CSR_REG<XLEN>(state, CSR_NUM, csr_value);
+        }
+    }
+
+    template <typename XLEN, uint32_t CSR_NUM, CsrFieldName FIELD>
+    static inline void POKE_CSR_FIELD(PegasusState* state, uint64_t field_value)
+    {
+        using Field = CsrField<XLEN, CSR_NUM, FIELD>;
+        if constexpr (Field::full_width)
+        {
+            POKE_CSR_REG<XLEN>(state, CSR_NUM, field_value);
+        }
+        else
+        {
+            XLEN csr_value = PEEK_CSR_REG<XLEN>(state, CSR_NUM);
+            csr_value &= ~Field::mask;
+            csr_value |= static_cast<XLEN>(field_value << Field::lsb);
+            POKE_CSR_REG<XLEN>(state, CSR_NUM, csr_value);
+        }
+    }
 } // namespace pegasus
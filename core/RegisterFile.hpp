@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+
+#include "arch/RegisterSet.hpp"
+
+#include "sparta/functional/ArchData.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace pegasus
+{
+    /*!
+     * \class RegisterFile
+     * \brief Flat, cache line aligned table of the storage of the registers in a RegisterSet
+     *
+     * Lets instruction handlers access GPRs, FPRs and vector registers with a single indexed
+     * load or store instead of going through RegisterSet::getRegister() and sparta::Register.
+     * The table points directly at the ArchData storage of the Sparta registers, so the Sparta
+     * tree, IDE, checkpoints and observers always see the same values. Writes flag the ArchData
+     * line as dirty just like sparta::Register::dmiWrite().
+     */
+    template <uint32_t NUM_REGS> class RegisterFile
+    {
+      public:
+        void init(RegisterSet* rset)
+        {
+            sparta_assert(rset->getNumRegisters() >= NUM_REGS,
+                          "Register set has " << rset->getNumRegisters() << " registers, expected "
+                                              << NUM_REGS);
+            for (uint32_t reg_num = 0; reg_num < NUM_REGS; ++reg_num)
+            {
+                auto [data, line] = rset->getRegisterStorage(reg_num);
+                entries_[reg_num] = Entry{data, line};
+            }
+            reg_size_ = rset->getRegister(0)->getNumBytes();
+        }
+
+        template <typename T> T read(uint32_t reg_num, uint32_t idx = 0) const
+        {
+#ifndef NDEBUG
+            sparta_assert(((idx + 1) * sizeof(T)) <= reg_size_, "Register access out of bounds");
+#endif
+            T value;
+            std::memcpy(&value, entries_[reg_num].data + (idx * sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        template <typename T> void write(uint32_t reg_num, T value, uint32_t idx = 0)
+        {
+#ifndef NDEBUG
+            sparta_assert(((idx + 1) * sizeof(T)) <= reg_size_, "Register access out of bounds");
+#endif
+            const Entry & entry = entries_[reg_num];
+            std::memcpy(entry.data + (idx * sizeof(T)), &value, sizeof(T));
+            entry.line->flagDirty();
+        }
+
+        // Raw storage of a register for bulk reads
+        const uint8_t* getData(uint32_t reg_num) const { return entries_[reg_num].data; }
+
+        // Raw storage of a register for bulk writes, flags the ArchData line as dirty
+        uint8_t* getDataForWrite(uint32_t reg_num)
+        {
+            const Entry & entry = entries_[reg_num];
+            entry.line->flagDirty();
+            return entry.data;
+        }
+
+        uint32_t getRegSize() const { return reg_size_; }
+
+      private:
+        struct Entry {
+            uint8_t* data = nullptr;
+            sparta::ArchData::Line* line = nullptr;
+        };
+
+        alignas(64) std::array<Entry, NUM_REGS> entries_;
+        uint32_t reg_size_ = 0;
+    };
+} // namespace pegasus
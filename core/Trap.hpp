@@ -54,11 +54,12 @@ namespace pegasus
 
 #include "core/Exception.hpp"
 
+// Traps are taken by returning a redirect to the Exception unit from the Action, so the THROW_*
+// macros can only be used in the body of an Action. Other code must call
+// PegasusState::throwException instead.
 #define TRAP_IMPL(cause)                                                                           \
     {                                                                                              \
-        auto exception_unit = state->getExceptionUnit();                                           \
-        exception_unit->setUnhandledException(cause);                                              \
-        throw ActionException(exception_unit->getActionGroup());                                   \
+        return state->redirectToException(cause);                                                  \
     }
 
 #define THROW_MISALIGNED_FETCH TRAP_IMPL(FaultCause::INST_ADDR_MISALIGNED)
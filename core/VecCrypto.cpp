@@ -0,0 +1,670 @@
+#include "core/VecCrypto.hpp"
+#include "core/inst_handlers/zknd/crypto-utils.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define PEGASUS_VEC_CRYPTO_X86
+#endif
+
+namespace pegasus
+{
+    namespace
+    {
+        template <typename T> inline T loadWord(const uint8_t* eg, size_t idx)
+        {
+            T value;
+            std::memcpy(&value, eg + (idx * sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        template <typename T> inline void storeWord(uint8_t* eg, size_t idx, T value)
+        {
+            std::memcpy(eg + (idx * sizeof(T)), &value, sizeof(T));
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // AES (Zvkned)
+
+        static constexpr size_t AES_EG_BYTES = 16;
+
+        static constexpr uint8_t AES_RCON_BYTES[10] = {0x01, 0x02, 0x04, 0x08, 0x10,
+                                                       0x20, 0x40, 0x80, 0x1b, 0x36};
+
+        // Multiply each byte of a word by x in GF(2^8)
+        inline uint32_t aesXtime4(uint32_t x)
+        {
+            return ((x & 0x7f7f7f7f) << 1) ^ (((x >> 7) & 0x01010101) * 0x1b);
+        }
+
+        // Byte i of the column is row i of the state
+        inline uint32_t aesMixColumnFwd(uint32_t x)
+        {
+            const uint32_t x1 = std::rotr(x, 8);
+            return aesXtime4(x ^ x1) ^ x1 ^ std::rotr(x, 16) ^ std::rotr(x, 24);
+        }
+
+        // InvMixColumns is MixColumns preceded by s[i] ^= 4 * (s[i] ^ s[i + 2])
+        inline uint32_t aesMixColumnInv(uint32_t x)
+        {
+            x ^= aesXtime4(aesXtime4(x ^ std::rotr(x, 16)));
+            return aesMixColumnFwd(x);
+        }
+
+        inline uint32_t aesSubWord(uint32_t x)
+        {
+            return (uint32_t)AES_SBOX_FWD[x & 0xff] | ((uint32_t)AES_SBOX_FWD[(x >> 8) & 0xff] << 8)
+                   | ((uint32_t)AES_SBOX_FWD[(x >> 16) & 0xff] << 16)
+                   | ((uint32_t)AES_SBOX_FWD[x >> 24] << 24);
+        }
+
+        // SubBytes(ShiftRows(state)), byte r + 4c of the state is row r of column c
+        inline void aesSubShiftFwd(uint8_t* out, const uint8_t* in)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                for (uint32_t r = 0; r < 4; ++r)
+                {
+                    out[r + 4 * c] = AES_SBOX_FWD[in[r + 4 * ((c + r) & 3)]];
+                }
+            }
+        }
+
+        // InvSubBytes(InvShiftRows(state))
+        inline void aesSubShiftInv(uint8_t* out, const uint8_t* in)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                for (uint32_t r = 0; r < 4; ++r)
+                {
+                    out[r + 4 * c] = AES_SBOX_INV[in[r + 4 * ((c - r) & 3)]];
+                }
+            }
+        }
+
+        void aesemPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                alignas(16) uint8_t sb[AES_EG_BYTES];
+                aesSubShiftFwd(sb, vd);
+                for (size_t col = 0; col < 4; ++col)
+                {
+                    storeWord<uint32_t>(vd, col,
+                                        aesMixColumnFwd(loadWord<uint32_t>(sb, col))
+                                            ^ loadWord<uint32_t>(vs2, col));
+                }
+            }
+        }
+
+        void aesefPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                alignas(16) uint8_t sb[AES_EG_BYTES];
+                aesSubShiftFwd(sb, vd);
+                for (size_t idx = 0; idx < AES_EG_BYTES; ++idx)
+                {
+                    vd[idx] = sb[idx] ^ vs2[idx];
+                }
+            }
+        }
+
+        void aesdmPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                alignas(16) uint8_t sb[AES_EG_BYTES];
+                aesSubShiftInv(sb, vd);
+                for (size_t col = 0; col < 4; ++col)
+                {
+                    storeWord<uint32_t>(vd, col,
+                                        aesMixColumnInv(loadWord<uint32_t>(sb, col)
+                                                        ^ loadWord<uint32_t>(vs2, col)));
+                }
+            }
+        }
+
+        void aesdfPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                alignas(16) uint8_t sb[AES_EG_BYTES];
+                aesSubShiftInv(sb, vd);
+                for (size_t idx = 0; idx < AES_EG_BYTES; ++idx)
+                {
+                    vd[idx] = sb[idx] ^ vs2[idx];
+                }
+            }
+        }
+
+        void aeszPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                for (size_t idx = 0; idx < AES_EG_BYTES; ++idx)
+                {
+                    vd[idx] ^= vs2[idx];
+                }
+            }
+        }
+
+        // AES-128 forward key schedule, vd = next round key of vs2
+        void aeskf1Portable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, uint32_t uimm)
+        {
+            // Out of range round numbers have bit 3 inverted
+            uint32_t rnd = uimm & 0xf;
+            if ((rnd == 0) || (rnd > 10))
+            {
+                rnd ^= 0x8;
+            }
+            const uint32_t rcon = AES_RCON_BYTES[rnd - 1];
+
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += AES_EG_BYTES)
+            {
+                uint32_t w = loadWord<uint32_t>(vs2, 0)
+                             ^ aesSubWord(std::rotr(loadWord<uint32_t>(vs2, 3), 8)) ^ rcon;
+                std::array<uint32_t, 4> next;
+                next[0] = w;
+                for (size_t idx = 1; idx < 4; ++idx)
+                {
+                    w ^= loadWord<uint32_t>(vs2, idx);
+                    next[idx] = w;
+                }
+                std::memcpy(vd, next.data(), AES_EG_BYTES);
+            }
+        }
+
+        // AES-256 forward key schedule, vd = next round key from vs2 (previous round key) and vd
+        // (the round key before it)
+        void aeskf2Portable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, uint32_t uimm)
+        {
+            uint32_t rnd = uimm & 0xf;
+            if ((rnd < 2) || (rnd > 14))
+            {
+                rnd ^= 0x8;
+            }
+
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += AES_EG_BYTES)
+            {
+                const uint32_t last = loadWord<uint32_t>(vs2, 3);
+                uint32_t w = loadWord<uint32_t>(vd, 0);
+                if (rnd & 1)
+                {
+                    w ^= aesSubWord(last);
+                }
+                else
+                {
+                    w ^= aesSubWord(std::rotr(last, 8)) ^ AES_RCON_BYTES[(rnd >> 1) - 1];
+                }
+                std::array<uint32_t, 4> next;
+                next[0] = w;
+                for (size_t idx = 1; idx < 4; ++idx)
+                {
+                    w ^= loadWord<uint32_t>(vd, idx);
+                    next[idx] = w;
+                }
+                std::memcpy(vd, next.data(), AES_EG_BYTES);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // SHA-2 (Zvknh[ab])
+
+        struct Sha256Traits
+        {
+            using T = uint32_t;
+
+            static T sum0(T x) { return std::rotr(x, 2) ^ std::rotr(x, 13) ^ std::rotr(x, 22); }
+
+            static T sum1(T x) { return std::rotr(x, 6) ^ std::rotr(x, 11) ^ std::rotr(x, 25); }
+
+            static T sig0(T x) { return std::rotr(x, 7) ^ std::rotr(x, 18) ^ (x >> 3); }
+
+            static T sig1(T x) { return std::rotr(x, 17) ^ std::rotr(x, 19) ^ (x >> 10); }
+        };
+
+        struct Sha512Traits
+        {
+            using T = uint64_t;
+
+            static T sum0(T x) { return std::rotr(x, 28) ^ std::rotr(x, 34) ^ std::rotr(x, 39); }
+
+            static T sum1(T x) { return std::rotr(x, 14) ^ std::rotr(x, 18) ^ std::rotr(x, 41); }
+
+            static T sig0(T x) { return std::rotr(x, 1) ^ std::rotr(x, 8) ^ (x >> 7); }
+
+            static T sig1(T x) { return std::rotr(x, 19) ^ std::rotr(x, 61) ^ (x >> 6); }
+        };
+
+        // Two compression rounds. vs2 = {a, b, e, f}, vd = {c, d, g, h} (f and h are element 0),
+        // vs1 = message schedule words plus round constants, the high or low pair is used.
+        template <typename Traits, bool HIGH>
+        void sha2cPortable(uint8_t* vd, const uint8_t* vs2, const uint8_t* vs1, size_t num_egs)
+        {
+            using T = typename Traits::T;
+            static constexpr size_t EG_BYTES = 4 * sizeof(T);
+
+            for (size_t eg = 0; eg < num_egs;
+                 ++eg, vd += EG_BYTES, vs2 += EG_BYTES, vs1 += EG_BYTES)
+            {
+                T f = loadWord<T>(vs2, 0), e = loadWord<T>(vs2, 1);
+                T b = loadWord<T>(vs2, 2), a = loadWord<T>(vs2, 3);
+                T h = loadWord<T>(vd, 0), g = loadWord<T>(vd, 1);
+                T d = loadWord<T>(vd, 2), c = loadWord<T>(vd, 3);
+                const T w0 = loadWord<T>(vs1, HIGH ? 2 : 0);
+                const T w1 = loadWord<T>(vs1, HIGH ? 3 : 1);
+
+                for (const T w : {w0, w1})
+                {
+                    const T t1 = h + Traits::sum1(e) + ((e & f) ^ (~e & g)) + w;
+                    const T t2 = Traits::sum0(a) + ((a & b) ^ (a & c) ^ (b & c));
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+
+                storeWord<T>(vd, 0, f);
+                storeWord<T>(vd, 1, e);
+                storeWord<T>(vd, 2, b);
+                storeWord<T>(vd, 3, a);
+            }
+        }
+
+        // Message schedule: vd = W[3:0], vs2 = {W[11:9], W[4]}, vs1 = W[15:12] -> vd = W[19:16]
+        template <typename Traits>
+        void sha2msPortable(uint8_t* vd, const uint8_t* vs2, const uint8_t* vs1, size_t num_egs)
+        {
+            using T = typename Traits::T;
+            static constexpr size_t EG_BYTES = 4 * sizeof(T);
+
+            for (size_t eg = 0; eg < num_egs;
+                 ++eg, vd += EG_BYTES, vs2 += EG_BYTES, vs1 += EG_BYTES)
+            {
+                T w[20];
+                for (size_t idx = 0; idx < 4; ++idx)
+                {
+                    w[idx] = loadWord<T>(vd, idx);
+                    w[12 + idx] = loadWord<T>(vs1, idx);
+                }
+                w[4] = loadWord<T>(vs2, 0);
+                w[9] = loadWord<T>(vs2, 1);
+                w[10] = loadWord<T>(vs2, 2);
+                w[11] = loadWord<T>(vs2, 3);
+
+                for (size_t idx = 16; idx < 20; ++idx)
+                {
+                    w[idx] = Traits::sig1(w[idx - 2]) + w[idx - 7] + Traits::sig0(w[idx - 15])
+                             + w[idx - 16];
+                }
+
+                for (size_t idx = 0; idx < 4; ++idx)
+                {
+                    storeWord<T>(vd, idx, w[16 + idx]);
+                }
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // SM4 (Zvksed)
+
+        static constexpr size_t SM4_EG_BYTES = 16;
+
+        static constexpr uint8_t SM4_SBOX[256] = {
+            0xd6, 0x90, 0xe9, 0xfe, 0xcc, 0xe1, 0x3d, 0xb7, 0x16, 0xb6, 0x14, 0xc2, 0x28, 0xfb,
+            0x2c, 0x05, 0x2b, 0x67, 0x9a, 0x76, 0x2a, 0xbe, 0x04, 0xc3, 0xaa, 0x44, 0x13, 0x26,
+            0x49, 0x86, 0x06, 0x99, 0x9c, 0x42, 0x50, 0xf4, 0x91, 0xef, 0x98, 0x7a, 0x33, 0x54,
+            0x0b, 0x43, 0xed, 0xcf, 0xac, 0x62, 0xe4, 0xb3, 0x1c, 0xa9, 0xc9, 0x08, 0xe8, 0x95,
+            0x80, 0xdf, 0x94, 0xfa, 0x75, 0x8f, 0x3f, 0xa6, 0x47, 0x07, 0xa7, 0xfc, 0xf3, 0x73,
+            0x17, 0xba, 0x83, 0x59, 0x3c, 0x19, 0xe6, 0x85, 0x4f, 0xa8, 0x68, 0x6b, 0x81, 0xb2,
+            0x71, 0x64, 0xda, 0x8b, 0xf8, 0xeb, 0x0f, 0x4b, 0x70, 0x56, 0x9d, 0x35, 0x1e, 0x24,
+            0x0e, 0x5e, 0x63, 0x58, 0xd1, 0xa2, 0x25, 0x22, 0x7c, 0x3b, 0x01, 0x21, 0x78, 0x87,
+            0xd4, 0x00, 0x46, 0x57, 0x9f, 0xd3, 0x27, 0x52, 0x4c, 0x36, 0x02, 0xe7, 0xa0, 0xc4,
+            0xc8, 0x9e, 0xea, 0xbf, 0x8a, 0xd2, 0x40, 0xc7, 0x38, 0xb5, 0xa3, 0xf7, 0xf2, 0xce,
+            0xf9, 0x61, 0x15, 0xa1, 0xe0, 0xae, 0x5d, 0xa4, 0x9b, 0x34, 0x1a, 0x55, 0xad, 0x93,
+            0x32, 0x30, 0xf5, 0x8c, 0xb1, 0xe3, 0x1d, 0xf6, 0xe2, 0x2e, 0x82, 0x66, 0xca, 0x60,
+            0xc0, 0x29, 0x23, 0xab, 0x0d, 0x53, 0x4e, 0x6f, 0xd5, 0xdb, 0x37, 0x45, 0xde, 0xfd,
+            0x8e, 0x2f, 0x03, 0xff, 0x6a, 0x72, 0x6d, 0x6c, 0x5b, 0x51, 0x8d, 0x1b, 0xaf, 0x92,
+            0xbb, 0xdd, 0xbc, 0x7f, 0x11, 0xd9, 0x5c, 0x41, 0x1f, 0x10, 0x5a, 0xd8, 0x0a, 0xc1,
+            0x31, 0x88, 0xa5, 0xcd, 0x7b, 0xbd, 0x2d, 0x74, 0xd0, 0x12, 0xb8, 0xe5, 0xb4, 0xb0,
+            0x89, 0x69, 0x97, 0x4a, 0x0c, 0x96, 0x77, 0x7e, 0x65, 0xb9, 0xf1, 0x09, 0xc5, 0x6e,
+            0xc6, 0x84, 0x18, 0xf0, 0x7d, 0xec, 0x3a, 0xdc, 0x4d, 0x20, 0x79, 0xee, 0x5f, 0x3e,
+            0xd7, 0xcb, 0x39, 0x48};
+
+        // Key schedule constants, byte j (MSB first) of CK[i] is (4i + j) * 7 mod 256
+        static constexpr std::array<uint32_t, 32> SM4_CK = []()
+        {
+            std::array<uint32_t, 32> ck{};
+            for (uint32_t i = 0; i < 32; ++i)
+            {
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    ck[i] |= (((4 * i + j) * 7) & 0xff) << (24 - (8 * j));
+                }
+            }
+            return ck;
+        }();
+
+        inline uint32_t sm4SubWord(uint32_t x)
+        {
+            return (uint32_t)SM4_SBOX[x & 0xff] | ((uint32_t)SM4_SBOX[(x >> 8) & 0xff] << 8)
+                   | ((uint32_t)SM4_SBOX[(x >> 16) & 0xff] << 16)
+                   | ((uint32_t)SM4_SBOX[x >> 24] << 24);
+        }
+
+        // Four rounds of the key schedule, vs2 = rk[3:0] -> vd = rk[7:4]
+        void sm4kPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, uint32_t uimm)
+        {
+            const uint32_t rnd = uimm & 0x7;
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += SM4_EG_BYTES, vs2 += SM4_EG_BYTES)
+            {
+                uint32_t rk[8];
+                for (size_t idx = 0; idx < 4; ++idx)
+                {
+                    rk[idx] = loadWord<uint32_t>(vs2, idx);
+                }
+                for (size_t idx = 0; idx < 4; ++idx)
+                {
+                    const uint32_t s = sm4SubWord(rk[idx + 1] ^ rk[idx + 2] ^ rk[idx + 3]
+                                                  ^ SM4_CK[(4 * rnd) + idx]);
+                    rk[idx + 4] = rk[idx] ^ s ^ std::rotl(s, 13) ^ std::rotl(s, 23);
+                }
+                std::memcpy(vd, rk + 4, SM4_EG_BYTES);
+            }
+        }
+
+        // Four cipher rounds, vd = x[3:0], vs2 = rk[3:0] -> vd = x[7:4]
+        void sm4rPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += SM4_EG_BYTES, vs2 += key_stride)
+            {
+                uint32_t x[8];
+                for (size_t idx = 0; idx < 4; ++idx)
+                {
+                    x[idx] = loadWord<uint32_t>(vd, idx);
+                }
+                for (size_t idx = 0; idx < 4; ++idx)
+                {
+                    const uint32_t s = sm4SubWord(x[idx + 1] ^ x[idx + 2] ^ x[idx + 3]
+                                                  ^ loadWord<uint32_t>(vs2, idx));
+                    x[idx + 4] = x[idx] ^ s ^ std::rotl(s, 2) ^ std::rotl(s, 10)
+                                 ^ std::rotl(s, 18) ^ std::rotl(s, 24);
+                }
+                std::memcpy(vd, x + 4, SM4_EG_BYTES);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // SM3 (Zvksh), the words are stored big endian in the element groups
+
+        static constexpr size_t SM3_EG_BYTES = 32;
+
+        inline uint32_t sm3Load(const uint8_t* eg, size_t idx)
+        {
+            return __builtin_bswap32(loadWord<uint32_t>(eg, idx));
+        }
+
+        inline void sm3Store(uint8_t* eg, size_t idx, uint32_t value)
+        {
+            storeWord<uint32_t>(eg, idx, __builtin_bswap32(value));
+        }
+
+        inline uint32_t sm3P0(uint32_t x) { return x ^ std::rotl(x, 9) ^ std::rotl(x, 17); }
+
+        inline uint32_t sm3P1(uint32_t x) { return x ^ std::rotl(x, 15) ^ std::rotl(x, 23); }
+
+        // Message expansion, vs1 = W[7:0], vs2 = W[15:8] -> vd = W[23:16]
+        void sm3mePortable(uint8_t* vd, const uint8_t* vs2, const uint8_t* vs1, size_t num_egs)
+        {
+            for (size_t eg = 0; eg < num_egs;
+                 ++eg, vd += SM3_EG_BYTES, vs2 += SM3_EG_BYTES, vs1 += SM3_EG_BYTES)
+            {
+                uint32_t w[24];
+                for (size_t idx = 0; idx < 8; ++idx)
+                {
+                    w[idx] = sm3Load(vs1, idx);
+                    w[8 + idx] = sm3Load(vs2, idx);
+                }
+                for (size_t idx = 16; idx < 24; ++idx)
+                {
+                    w[idx] = sm3P1(w[idx - 16] ^ w[idx - 9] ^ std::rotl(w[idx - 3], 15))
+                             ^ std::rotl(w[idx - 13], 7) ^ w[idx - 6];
+                }
+                for (size_t idx = 0; idx < 8; ++idx)
+                {
+                    sm3Store(vd, idx, w[16 + idx]);
+                }
+            }
+        }
+
+        // Two compression rounds, vd = {H, G, F, E, D, C, B, A} (A is element 0), vs2 = W[7:0]
+        void sm3cPortable(uint8_t* vd, const uint8_t* vs2, size_t num_egs, uint32_t uimm)
+        {
+            const uint32_t first_round = 2 * (uimm & 0x1f);
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += SM3_EG_BYTES, vs2 += SM3_EG_BYTES)
+            {
+                uint32_t a = sm3Load(vd, 0), b = sm3Load(vd, 1), c = sm3Load(vd, 2);
+                uint32_t d = sm3Load(vd, 3), e = sm3Load(vd, 4), f = sm3Load(vd, 5);
+                uint32_t g = sm3Load(vd, 6), h = sm3Load(vd, 7);
+
+                for (uint32_t idx = 0; idx < 2; ++idx)
+                {
+                    const uint32_t j = first_round + idx;
+                    const uint32_t w = sm3Load(vs2, idx);
+                    const uint32_t w_prime = w ^ sm3Load(vs2, idx + 4);
+                    const uint32_t t_j = (j < 16) ? 0x79cc4519 : 0x7a879d8a;
+                    const uint32_t ff = (j < 16) ? (a ^ b ^ c) : ((a & b) | (a & c) | (b & c));
+                    const uint32_t gg = (j < 16) ? (e ^ f ^ g) : ((e & f) | (~e & g));
+
+                    const uint32_t ss1 = std::rotl(std::rotl(a, 12) + e + std::rotl(t_j, j % 32), 7);
+                    const uint32_t ss2 = ss1 ^ std::rotl(a, 12);
+                    const uint32_t tt1 = ff + d + ss2 + w_prime;
+                    const uint32_t tt2 = gg + h + ss1 + w;
+                    d = c;
+                    c = std::rotl(b, 9);
+                    b = a;
+                    a = tt1;
+                    h = g;
+                    g = std::rotl(f, 19);
+                    f = e;
+                    e = sm3P0(tt2);
+                }
+
+                sm3Store(vd, 0, a);
+                sm3Store(vd, 1, b);
+                sm3Store(vd, 2, c);
+                sm3Store(vd, 3, d);
+                sm3Store(vd, 4, e);
+                sm3Store(vd, 5, f);
+                sm3Store(vd, 6, g);
+                sm3Store(vd, 7, h);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Host engine
+
+#ifdef PEGASUS_VEC_CRYPTO_X86
+        __attribute__((target("aes"))) void aesemHost(uint8_t* vd, const uint8_t* vs2,
+                                                      size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                const __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd));
+                const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs2));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(vd), _mm_aesenc_si128(state, key));
+            }
+        }
+
+        __attribute__((target("aes"))) void aesefHost(uint8_t* vd, const uint8_t* vs2,
+                                                      size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                const __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd));
+                const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs2));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(vd),
+                                 _mm_aesenclast_si128(state, key));
+            }
+        }
+
+        // vaesdm adds the round key before InvMixColumns and AESDEC after it, so the key is
+        // transformed with AESIMC first
+        __attribute__((target("aes"))) void aesdmHost(uint8_t* vd, const uint8_t* vs2,
+                                                      size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                const __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd));
+                const __m128i key =
+                    _mm_aesimc_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vs2)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(vd), _mm_aesdec_si128(state, key));
+            }
+        }
+
+        __attribute__((target("aes"))) void aesdfHost(uint8_t* vd, const uint8_t* vs2,
+                                                      size_t num_egs, size_t key_stride)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += AES_EG_BYTES, vs2 += key_stride)
+            {
+                const __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd));
+                const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs2));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(vd),
+                                 _mm_aesdeclast_si128(state, key));
+            }
+        }
+
+        // The SHA-NI state layout is the same as Zvknha: {a, b, e, f} and {c, d, g, h} with f and
+        // h in the lowest word
+        template <bool HIGH>
+        __attribute__((target("sha,ssse3"))) void sha256cHost(uint8_t* vd, const uint8_t* vs2,
+                                                               const uint8_t* vs1, size_t num_egs)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += 16, vs2 += 16, vs1 += 16)
+            {
+                const __m128i abef = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs2));
+                const __m128i cdgh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd));
+                __m128i wk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs1));
+                if constexpr (HIGH)
+                {
+                    wk = _mm_srli_si128(wk, 8);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(vd),
+                                 _mm_sha256rnds2_epu32(cdgh, abef, wk));
+            }
+        }
+
+        __attribute__((target("sha,ssse3"))) void sha256msHost(uint8_t* vd, const uint8_t* vs2,
+                                                               const uint8_t* vs1, size_t num_egs)
+        {
+            for (size_t eg = 0; eg < num_egs; ++eg, vd += 16, vs2 += 16, vs1 += 16)
+            {
+                const __m128i w3_0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vd));
+                const __m128i w11_9_4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs2));
+                const __m128i w15_12 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vs1));
+
+                // W[i] + sig0(W[i + 1]) + W[i + 9], then add sig1(W[i + 14])
+                __m128i w = _mm_sha256msg1_epu32(w3_0, w11_9_4);
+                w = _mm_add_epi32(w, _mm_alignr_epi8(w15_12, w11_9_4, 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(vd), _mm_sha256msg2_epu32(w, w15_12));
+            }
+        }
+#endif
+
+        VecCryptoEngine makePortableEngine()
+        {
+            VecCryptoEngine engine;
+            engine.name = "portable";
+            engine.aesem = aesemPortable;
+            engine.aesef = aesefPortable;
+            engine.aesdm = aesdmPortable;
+            engine.aesdf = aesdfPortable;
+            engine.aesz = aeszPortable;
+            engine.aeskf1 = aeskf1Portable;
+            engine.aeskf2 = aeskf2Portable;
+            engine.sha256ch = sha2cPortable<Sha256Traits, true>;
+            engine.sha256cl = sha2cPortable<Sha256Traits, false>;
+            engine.sha256ms = sha2msPortable<Sha256Traits>;
+            engine.sha512ch = sha2cPortable<Sha512Traits, true>;
+            engine.sha512cl = sha2cPortable<Sha512Traits, false>;
+            engine.sha512ms = sha2msPortable<Sha512Traits>;
+            engine.sm4k = sm4kPortable;
+            engine.sm4r = sm4rPortable;
+            engine.sm3c = sm3cPortable;
+            engine.sm3me = sm3mePortable;
+            return engine;
+        }
+
+        // The AES key schedule, SHA-512, SM3 and SM4 have no host instructions and use the
+        // portable code
+        VecCryptoEngine makeHostEngine()
+        {
+            VecCryptoEngine engine = makePortableEngine();
+            engine.name = "host";
+#ifdef PEGASUS_VEC_CRYPTO_X86
+            if (vec_crypto::hostHasAes())
+            {
+                engine.aesem = aesemHost;
+                engine.aesef = aesefHost;
+                engine.aesdm = aesdmHost;
+                engine.aesdf = aesdfHost;
+            }
+            if (vec_crypto::hostHasSha())
+            {
+                engine.sha256ch = sha256cHost<true>;
+                engine.sha256cl = sha256cHost<false>;
+                engine.sha256ms = sha256msHost;
+            }
+#endif
+            return engine;
+        }
+    } // namespace
+
+    namespace vec_crypto
+    {
+        const VecCryptoEngine & getPortableEngine()
+        {
+            static const VecCryptoEngine engine = makePortableEngine();
+            return engine;
+        }
+
+        const VecCryptoEngine & getHostEngine()
+        {
+            static const VecCryptoEngine engine = makeHostEngine();
+            return engine;
+        }
+
+        bool hostHasAes()
+        {
+#ifdef PEGASUS_VEC_CRYPTO_X86
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES);
+#else
+            return false;
+#endif
+        }
+
+        bool hostHasSha()
+        {
+#ifdef PEGASUS_VEC_CRYPTO_X86
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3))
+            {
+                return false;
+            }
+            return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+#else
+            return false;
+#endif
+        }
+    } // namespace vec_crypto
+} // namespace pegasus
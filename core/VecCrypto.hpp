@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pegasus
+{
+    /*!
+     * \brief Element group engine for the vector crypto extensions (Zvkned, Zvknh[ab], Zvksed,
+     *        Zvksh)
+     *
+     * Every operation processes num_egs consecutive element groups of a register group in one
+     * call. The buffers hold the register bytes exactly as they are stored in the vector register
+     * file (little endian elements). For the .vs forms the round key is the same element group
+     * for every group of vd, which is selected by passing a key stride of 0.
+     *
+     * Two engines are provided. The portable engine is plain C++. The host engine uses AES-NI and
+     * SHA-NI when the host has them (detected at runtime) and falls back to the portable code for
+     * everything else, so both engines always give bit-identical results.
+     */
+    struct VecCryptoEngine
+    {
+        using AesRoundFunc = void (*)(uint8_t* vd, const uint8_t* vs2, size_t num_egs,
+                                      size_t key_stride);
+        using ImmFunc = void (*)(uint8_t* vd, const uint8_t* vs2, size_t num_egs, uint32_t uimm);
+        using ThreeOpFunc = void (*)(uint8_t* vd, const uint8_t* vs2, const uint8_t* vs1,
+                                     size_t num_egs);
+
+        const char* name = nullptr;
+
+        // Zvkned (EGW=128)
+        AesRoundFunc aesem = nullptr;
+        AesRoundFunc aesef = nullptr;
+        AesRoundFunc aesdm = nullptr;
+        AesRoundFunc aesdf = nullptr;
+        AesRoundFunc aesz = nullptr;
+        ImmFunc aeskf1 = nullptr;
+        ImmFunc aeskf2 = nullptr;
+
+        // Zvknh[ab] (EGW=128 for SEW=32, EGW=256 for SEW=64)
+        ThreeOpFunc sha256ch = nullptr;
+        ThreeOpFunc sha256cl = nullptr;
+        ThreeOpFunc sha256ms = nullptr;
+        ThreeOpFunc sha512ch = nullptr;
+        ThreeOpFunc sha512cl = nullptr;
+        ThreeOpFunc sha512ms = nullptr;
+
+        // Zvksed (EGW=128)
+        ImmFunc sm4k = nullptr;
+        AesRoundFunc sm4r = nullptr;
+
+        // Zvksh (EGW=256)
+        ImmFunc sm3c = nullptr;
+        ThreeOpFunc sm3me = nullptr;
+    };
+
+    namespace vec_crypto
+    {
+        // Plain C++ engine, available on every host
+        const VecCryptoEngine & getPortableEngine();
+
+        // Engine using the crypto instructions of the host where they are available
+        const VecCryptoEngine & getHostEngine();
+
+        // Host crypto instructions detected at runtime
+        bool hostHasAes();
+        bool hostHasSha();
+    } // namespace vec_crypto
+} // namespace pegasus
@@ -51,13 +51,14 @@ namespace pegasus
 
         // Access memory
         const auto & result = inst->getTranslationState()->getResult();
-        std::vector<uint8_t> buffer;
-        if (state->readMemory<SIZE>(result, buffer, MemAccessSource::INSTRUCTION) == false)
+        const std::optional<SIZE> mem_val =
+            state->readMemory<SIZE>(result, MemAccessSource::INSTRUCTION);
+        if (!mem_val)
         {
             THROW_STORE_AMO_ACCESS;
         }
 
-        XLEN rd_val = convertFromByteVector<SIZE>(buffer);
+        XLEN rd_val = *mem_val;
         if constexpr (sizeof(XLEN) > sizeof(SIZE))
         {
             rd_val = signExtend<SIZE, XLEN>(rd_val);
@@ -95,12 +96,13 @@ namespace pegasus
 
         // Get the memory
         const auto & result = xlation_state->getResult();
-        std::vector<uint8_t> buffer;
-        if (state->readMemory<SIZE>(result, buffer, MemAccessSource::INSTRUCTION) == false)
+        const std::optional<SIZE> mem_val =
+            state->readMemory<SIZE>(result, MemAccessSource::INSTRUCTION);
+        if (!mem_val)
         {
             THROW_STORE_AMO_ACCESS;
         }
-        const XLEN rd_val = convertFromByteVector<SIZE>(buffer);
+        const XLEN rd_val = *mem_val;
         xlation_state->popResult();
 
         if constexpr (sizeof(XLEN) > sizeof(SIZE))
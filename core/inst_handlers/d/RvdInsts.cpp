@@ -1,5 +1,6 @@
 #include "core/inst_handlers/d/RvdInsts.hpp"
 #include "core/inst_handlers/f/RvfFunctors.hpp"
+#include "core/inst_handlers/hostfpu_helpers.hpp"
 #include "include/ActionTags.hpp"
 #include "core/ActionGroup.hpp"
 
@@ -147,7 +148,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint32_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), i32_to_f64(rs1_val).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::convert<float64_t, int32_t>(state, rs1_val).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -160,7 +162,8 @@ namespace pegasus
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
         const uint64_t rs2_val = READ_FP_REG<RV64>(state, inst->getRs2());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), f64_sub(float64_t{rs1_val}, float64_t{rs2_val}).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::sub(state, float64_t{rs1_val}, float64_t{rs2_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -181,9 +184,9 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            signExtend<uint32_t, uint64_t>(
-                                f64_to_ui32(float64_t{rs1_val}, getRM<XLEN>(state), true)));
+        const uint32_t result =
+            hostfpu::toInt<uint32_t>(state, float64_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<uint32_t, uint64_t>(result));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -198,7 +201,7 @@ namespace pegasus
         const uint64_t rs2_val = READ_FP_REG<RV64>(state, inst->getRs2());
         const uint64_t rs3_val = READ_FP_REG<RV64>(state, inst->getRs3());
         const uint64_t result =
-            Fnmsub<float64_t>{}(float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v;
+            hostfpu::negMulSub(state, float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v;
         WRITE_FP_REG<RV64>(state, inst->getRd(), result);
         updateCsr<XLEN>(state);
         return ++action_it;
@@ -223,7 +226,8 @@ namespace pegasus
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
         const uint64_t rs2_val = READ_FP_REG<RV64>(state, inst->getRs2());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), f64_mul(float64_t{rs1_val}, float64_t{rs2_val}).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::mul(state, float64_t{rs1_val}, float64_t{rs2_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -235,7 +239,7 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), f64_sqrt(float64_t{rs1_val}).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(), hostfpu::sqrt(state, float64_t{rs1_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -251,7 +255,7 @@ namespace pegasus
         const uint64_t rs3_val = READ_FP_REG<RV64>(state, inst->getRs3());
         WRITE_FP_REG<RV64>(
             state, inst->getRd(),
-            Fmadd<float64_t>{}(float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v);
+            hostfpu::mulAdd(state, float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -266,7 +270,7 @@ namespace pegasus
         const uint64_t rs2_val = READ_FP_REG<RV64>(state, inst->getRs2());
         const uint64_t rs3_val = READ_FP_REG<RV64>(state, inst->getRs3());
         const uint64_t result =
-            Fnmadd<float64_t>{}(float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v;
+            hostfpu::negMulAdd(state, float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v;
         WRITE_FP_REG<RV64>(state, inst->getRd(), result);
         updateCsr<XLEN>(state);
         return ++action_it;
@@ -294,7 +298,8 @@ namespace pegasus
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
         const uint64_t rs2_val = READ_FP_REG<RV64>(state, inst->getRs2());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), f64_div(float64_t{rs1_val}, float64_t{rs2_val}).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::div(state, float64_t{rs1_val}, float64_t{rs2_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -327,9 +332,9 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            signExtend<uint32_t, uint64_t>(
-                                f64_to_i32(float64_t{rs1_val}, getRM<XLEN>(state), true)));
+        const int32_t result =
+            hostfpu::toInt<int32_t>(state, float64_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<uint32_t, uint64_t>(result));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -340,8 +345,9 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            f64_to_ui64(float64_t{rs1_val}, getRM<XLEN>(state), true));
+        const uint64_t result =
+            hostfpu::toInt<uint64_t>(state, float64_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), result);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -380,7 +386,8 @@ namespace pegasus
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
         const uint64_t rs2_val = READ_FP_REG<RV64>(state, inst->getRs2());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), f64_add(float64_t{rs1_val}, float64_t{rs2_val}).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::add(state, float64_t{rs1_val}, float64_t{rs2_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -396,7 +403,7 @@ namespace pegasus
         const uint64_t rs3_val = READ_FP_REG<RV64>(state, inst->getRs3());
         WRITE_FP_REG<RV64>(
             state, inst->getRd(),
-            Fmsub<float64_t>{}(float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v);
+            hostfpu::mulSub(state, float64_t{rs1_val}, float64_t{rs2_val}, float64_t{rs3_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -407,7 +414,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint32_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), f32_to_f64(float32_t{rs1_val}).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::convert<float64_t>(state, float32_t{rs1_val}).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -433,8 +441,8 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
         softfloat_roundingMode = getRM<XLEN>(state);
-        WRITE_FP_REG<RV64>(state, inst->getRd(),
-                           nanBoxing<RV64, FLOAT_SP>(f64_to_f32(float64_t{rs1_val}).v));
+        const float32_t result = hostfpu::convert<float32_t>(state, float64_t{rs1_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -445,7 +453,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), ui64_to_f64(rs1_val).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::convert<float64_t, uint64_t>(state, rs1_val).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -479,7 +488,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), i64_to_f64(rs1_val).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::convert<float64_t, int64_t>(state, rs1_val).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -490,7 +500,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint32_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), ui32_to_f64(rs1_val).v);
+        WRITE_FP_REG<RV64>(state, inst->getRd(),
+                           hostfpu::convert<float64_t, uint32_t>(state, rs1_val).v);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -512,8 +523,9 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_FP_REG<RV64>(state, inst->getRs1());
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            f64_to_i64(float64_t{rs1_val}, getRM<XLEN>(state), true));
+        const int64_t result =
+            hostfpu::toInt<int64_t>(state, float64_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), result);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -1,5 +1,6 @@
 #include "core/inst_handlers/f/RvfInsts.hpp"
 #include "core/inst_handlers/f/RvfFunctors.hpp"
+#include "core/inst_handlers/hostfpu_helpers.hpp"
 #include "include/ActionTags.hpp"
 #include "core/ActionGroup.hpp"
 #include "core/PegasusState.hpp"
@@ -139,7 +140,7 @@ namespace pegasus
         const uint32_t rs1_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
         WRITE_FP_REG<RV64>(state, inst->getRd(),
-                           nanBoxing<RV64, FLOAT_SP>(f32_sqrt(float32_t{rs1_val}).v));
+                           nanBoxing<RV64, FLOAT_SP>(hostfpu::sqrt(state, float32_t{rs1_val}).v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -154,9 +155,8 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
         const uint32_t rs2_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
-        WRITE_FP_REG<RV64>(
-            state, inst->getRd(),
-            nanBoxing<RV64, FLOAT_SP>(f32_sub(float32_t{rs1_val}, float32_t{rs2_val}).v));
+        const float32_t result = hostfpu::sub(state, float32_t{rs1_val}, float32_t{rs2_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -173,9 +173,9 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
         const uint32_t rs3_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs3()));
-        const RV64 result = nanBoxing<RV64, FLOAT_SP>(
-            Fnmsub<float32_t>{}(float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val}).v);
-        WRITE_FP_REG<RV64>(state, inst->getRd(), result);
+        const float32_t result =
+            hostfpu::negMulSub(state, float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -219,9 +219,9 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
         const uint32_t rs3_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs3()));
-        const RV64 result = nanBoxing<RV64, FLOAT_SP>(
-            Fmsub<float32_t>{}(float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val}).v);
-        WRITE_FP_REG<RV64>(state, inst->getRd(), result);
+        const float32_t result =
+            hostfpu::mulSub(state, float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -259,8 +259,9 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint32_t rs1_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            f32_to_ui64(float32_t{rs1_val}, getRM<XLEN>(state), true));
+        const uint64_t result =
+            hostfpu::toInt<uint64_t>(state, float32_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), result);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -272,7 +273,8 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint32_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(i32_to_f32(rs1_val).v));
+        const float32_t result = hostfpu::convert<float32_t, int32_t>(state, rs1_val);
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -289,9 +291,9 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
         const uint32_t rs3_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs3()));
-        const RV64 result = nanBoxing<RV64, FLOAT_SP>(
-            Fnmadd<float32_t>{}(float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val}).v);
-        WRITE_FP_REG<RV64>(state, inst->getRd(), result);
+        const float32_t result =
+            hostfpu::negMulAdd(state, float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -302,7 +304,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(i64_to_f32(rs1_val).v));
+        const float32_t result = hostfpu::convert<float32_t, int64_t>(state, rs1_val);
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -317,9 +320,8 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
         const uint32_t rs2_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
-        WRITE_FP_REG<RV64>(
-            state, inst->getRd(),
-            nanBoxing<RV64, FLOAT_SP>(f32_add(float32_t{rs1_val}, float32_t{rs2_val}).v));
+        const float32_t result = hostfpu::add(state, float32_t{rs1_val}, float32_t{rs2_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -377,10 +379,9 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
         const uint32_t rs3_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs3()));
-        WRITE_FP_REG<RV64>(
-            state, inst->getRd(),
-            nanBoxing<RV64, FLOAT_SP>(
-                Fmadd<float32_t>{}(float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val}).v));
+        const float32_t result =
+            hostfpu::mulAdd(state, float32_t{rs1_val}, float32_t{rs2_val}, float32_t{rs3_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -395,9 +396,8 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
         const uint32_t rs2_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
-        WRITE_FP_REG<RV64>(
-            state, inst->getRd(),
-            nanBoxing<RV64, FLOAT_SP>(f32_mul(float32_t{rs1_val}, float32_t{rs2_val}).v));
+        const float32_t result = hostfpu::mul(state, float32_t{rs1_val}, float32_t{rs2_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -422,9 +422,9 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint32_t rs1_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            signExtend<uint32_t, uint64_t>(
-                                f32_to_i32(float32_t{rs1_val}, getRM<XLEN>(state), true)));
+        const int32_t result =
+            hostfpu::toInt<int32_t>(state, float32_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<uint32_t, uint64_t>(result));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -436,8 +436,9 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint32_t rs1_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            f32_to_i64(float32_t{rs1_val}, getRM<XLEN>(state), true));
+        const int64_t result =
+            hostfpu::toInt<int64_t>(state, float32_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), result);
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -463,7 +464,8 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         const uint64_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(ui64_to_f32(rs1_val).v));
+        const float32_t result = hostfpu::convert<float32_t, uint64_t>(state, rs1_val);
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -476,9 +478,9 @@ namespace pegasus
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint32_t rs1_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
-        WRITE_INT_REG<XLEN>(state, inst->getRd(),
-                            signExtend<uint32_t, uint64_t>(
-                                f32_to_ui32(float32_t{rs1_val}, getRM<XLEN>(state), true)));
+        const uint32_t result =
+            hostfpu::toInt<uint32_t>(state, float32_t{rs1_val}, getRM<XLEN>(state));
+        WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<uint32_t, uint64_t>(result));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -493,9 +495,8 @@ namespace pegasus
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs1()));
         const uint32_t rs2_val =
             checkNanBoxing<RV64, FLOAT_SP>(READ_FP_REG<RV64>(state, inst->getRs2()));
-        WRITE_FP_REG<RV64>(
-            state, inst->getRd(),
-            nanBoxing<RV64, FLOAT_SP>(f32_div(float32_t{rs1_val}, float32_t{rs2_val}).v));
+        const float32_t result = hostfpu::div(state, float32_t{rs1_val}, float32_t{rs2_val});
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
@@ -522,7 +523,8 @@ namespace pegasus
         const PegasusInstPtr & inst = state->getCurrentInst();
         softfloat_roundingMode = getRM<XLEN>(state);
         const uint32_t rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
-        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(ui32_to_f32(rs1_val).v));
+        const float32_t result = hostfpu::convert<float32_t, uint32_t>(state, rs1_val);
+        WRITE_FP_REG<RV64>(state, inst->getRd(), nanBoxing<RV64, FLOAT_SP>(result.v));
         updateCsr<XLEN>(state);
         return ++action_it;
     }
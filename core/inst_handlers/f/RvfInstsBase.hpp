@@ -175,12 +175,13 @@ namespace pegasus
             const auto & result = inst->getTranslationState()->getResult();
             if constexpr (LOAD)
             {
-                std::vector<uint8_t> buffer;
-                if (state->readMemory<SIZE>(result, buffer, MemAccessSource::INSTRUCTION) == false)
+                const std::optional<SIZE> mem_val =
+                    state->readMemory<SIZE>(result, MemAccessSource::INSTRUCTION);
+                if (!mem_val)
                 {
                     THROW_LOAD_ACCESS;
                 }
-                const RV64 value = nanBoxing<RV64, SIZE>(convertFromByteVector<SIZE>(buffer));
+                const RV64 value = nanBoxing<RV64, SIZE>(*mem_val);
                 WRITE_FP_REG<RV64>(state, inst->getRd(), value);
             }
             else
@@ -3,6 +3,8 @@
 #include "core/ActionGroup.hpp"
 #include "core/PegasusState.hpp"
 #include "core/PegasusInst.hpp"
+#include "core/Fetch.hpp"
+#include "core/translate/Translate.hpp"
 #include "include/PegasusUtils.hpp"
 
 namespace pegasus
@@ -185,7 +187,38 @@ namespace pegasus
             }
         }
 
-        // TODO: Flush any TLBs and instruction/block caches in the future
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        std::optional<Addr> addr;
+        std::optional<uint32_t> id;
+        if (inst->getRs1() != 0)
+        {
+            addr = READ_INT_REG<XLEN>(state, inst->getRs1());
+        }
+        if (inst->getRs2() != 0)
+        {
+            id = READ_INT_REG<XLEN>(state, inst->getRs2());
+        }
+
+        Translate* translate_unit = state->getTranslateUnit();
+        if constexpr (GUEST)
+        {
+            // rs1 holds the guest physical address shifted right by 2 and rs2 holds the VMID.
+            // G-stage PTEs have no global bit and all cached entries belong to the current VMID.
+            TLB* tlb = translate_unit->getTLB(translate_types::TranslationStage::GUEST);
+            if (!id || (*id == tlb->getContext().vmid))
+            {
+                tlb->flush(addr ? std::optional<Addr>(*addr << 2) : std::nullopt, std::nullopt);
+            }
+        }
+        else
+        {
+            // rs1 holds the guest virtual address and rs2 holds the ASID
+            TLB* tlb = translate_unit->getTLB(translate_types::TranslationStage::VIRTUAL_SUPERVISOR);
+            tlb->flush(addr, id);
+        }
+
+        // Decoded blocks recorded under the old guest mappings must not run again
+        state->getFetchUnit()->getBlockCache()->flush();
         return ++action_it;
     }
 
@@ -221,20 +254,21 @@ namespace pegasus
         const uint64_t paddr = inst->getTranslationState()->getResult().getPAddr();
         inst->getTranslationState()->popResult();
 
-        std::vector<uint8_t> buffer;
-        if (state->readMemory<SIZE>(paddr, buffer, MemAccessSource::INSTRUCTION) == false)
+        const std::optional<SIZE> mem_val =
+            state->readMemory<SIZE>(paddr, MemAccessSource::INSTRUCTION);
+        if (!mem_val)
         {
             THROW_LOAD_ACCESS;
         }
 
         if constexpr (SIGN_EXTEND)
         {
-            const XLEN rd_val = signExtend<SIZE, XLEN>(convertFromByteVector<SIZE>(buffer));
+            const XLEN rd_val = signExtend<SIZE, XLEN>(*mem_val);
             WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<SIZE, XLEN>(rd_val));
         }
         else
         {
-            const XLEN rd_val = convertFromByteVector<SIZE>(buffer);
+            const XLEN rd_val = *mem_val;
             WRITE_INT_REG<XLEN>(state, inst->getRd(), rd_val);
         }
         return ++action_it;
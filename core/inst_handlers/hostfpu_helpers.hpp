@@ -0,0 +1,534 @@
+#pragma once
+
+#include "core/PegasusState.hpp"
+#include "core/inst_handlers/finst_helpers.hpp"
+#include "core/inst_handlers/f/RvfFunctors.hpp"
+
+#include <cfenv>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+extern "C"
+{
+#include "specialize.h"
+#include "internals.h"
+}
+
+// The host FPU is only used when it evaluates float and double in their own precision and its
+// status flags can be read back cheaply
+#if (defined(__x86_64__) || defined(__aarch64__)) && (FLT_EVAL_METHOD == 0)
+#define PEGASUS_HOST_FPU 1
+#else
+#define PEGASUS_HOST_FPU 0
+#endif
+
+namespace pegasus
+{
+    /*!
+     * \brief Host FPU fast path for the scalar F and D instructions
+     *
+     * The try* functions compute an operation on the host FPU with the rounding mode in
+     * softfloat_roundingMode and OR the resulting exception flags into softfloat_exceptionFlags,
+     * exactly like the SoftFloat function they replace. They return false without touching any
+     * state when the host result could differ from SoftFloat, in which case the caller must use
+     * SoftFloat:
+     *   - RMM (and the reserved rounding modes) have no host equivalent
+     *   - NaN operands, because the host does not produce the canonical NaN or raise NV for
+     *     signaling NaNs the same way
+     *   - inexact results in or at the edge of the subnormal range, where the host may detect
+     *     tininess differently
+     * NaN results of non-NaN operands (e.g. inf - inf) are replaced by the canonical NaN.
+     *
+     * The functions taking a PegasusState use the host FPU when it is enabled for the run and
+     * SoftFloat otherwise.
+     */
+    namespace hostfpu
+    {
+        template <typename F> struct HostFloat;
+
+        template <> struct HostFloat<float32_t>
+        {
+            using type = float;
+            using bits = FLOAT_SP;
+        };
+
+        template <> struct HostFloat<float64_t>
+        {
+            using type = double;
+            using bits = FLOAT_DP;
+        };
+
+        // Keeps the compiler from moving a value across the rounding mode and flag accesses
+        template <typename T> inline void barrier(T & value)
+        {
+            asm volatile("" : "+m"(value) : : "memory");
+        }
+
+        template <typename T> inline bool isNaN(const T & value)
+        {
+            if constexpr (std::is_same_v<T, float32_t> || std::is_same_v<T, float64_t>)
+            {
+                using U = typename HostFloat<T>::bits;
+                constexpr FConstants<U> cons = getConst<U>();
+                return ((value.v & cons.EXP_MASK) == cons.EXP_MASK) && (value.v & cons.SIG_MASK);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <typename T> inline auto toHost(const T & value)
+        {
+            if constexpr (std::is_same_v<T, float32_t> || std::is_same_v<T, float64_t>)
+            {
+                typename HostFloat<T>::type host;
+                std::memcpy(&host, &value.v, sizeof(host));
+                barrier(host);
+                return host;
+            }
+            else
+            {
+                T host = value;
+                barrier(host);
+                return host;
+            }
+        }
+
+#if PEGASUS_HOST_FPU
+        /*!
+         * \brief Sets the host rounding mode for one operation and collects its exception flags
+         *
+         * On x86_64 MXCSR is accessed directly, which is much cheaper than the <cfenv> calls
+         * (those also save and restore the x87 state).
+         */
+        class HostFpEnv
+        {
+          public:
+            explicit HostFpEnv(const uint_fast8_t rm)
+            {
+#if defined(__x86_64__)
+                static constexpr uint32_t RC_BITS[] = {0x0000, 0x6000, 0x2000, 0x4000};
+                asm volatile("stmxcsr %0" : "=m"(saved_csr_));
+                // Clear the flags, rounding control, FTZ and DAZ
+                uint32_t csr = (saved_csr_ & ~(0x3Fu | 0x6000u | 0x8000u | 0x40u)) | RC_BITS[rm];
+                asm volatile("ldmxcsr %0" : : "m"(csr));
+#else
+                static constexpr int HOST_RM[] = {FE_TONEAREST, FE_TOWARDZERO, FE_DOWNWARD,
+                                                  FE_UPWARD};
+                std::fegetenv(&saved_env_);
+                std::feclearexcept(FE_ALL_EXCEPT);
+                if (rm != softfloat_round_near_even)
+                {
+                    std::fesetround(HOST_RM[rm]);
+                }
+#endif
+            }
+
+            ~HostFpEnv()
+            {
+#if defined(__x86_64__)
+                asm volatile("ldmxcsr %0" : : "m"(saved_csr_));
+#else
+                std::fesetenv(&saved_env_);
+#endif
+            }
+
+            // Exception flags raised since construction in SoftFloat encoding
+            uint_fast8_t getFlags() const
+            {
+                uint_fast8_t flags = 0;
+#if defined(__x86_64__)
+                uint32_t csr;
+                asm volatile("stmxcsr %0" : "=m"(csr));
+                flags |= (csr & 0x01) ? softfloat_flag_invalid : 0;
+                flags |= (csr & 0x04) ? softfloat_flag_infinite : 0;
+                flags |= (csr & 0x08) ? softfloat_flag_overflow : 0;
+                flags |= (csr & 0x10) ? softfloat_flag_underflow : 0;
+                flags |= (csr & 0x20) ? softfloat_flag_inexact : 0;
+#else
+                const int host_flags = std::fetestexcept(FE_ALL_EXCEPT);
+                flags |= (host_flags & FE_INVALID) ? softfloat_flag_invalid : 0;
+                flags |= (host_flags & FE_DIVBYZERO) ? softfloat_flag_infinite : 0;
+                flags |= (host_flags & FE_OVERFLOW) ? softfloat_flag_overflow : 0;
+                flags |= (host_flags & FE_UNDERFLOW) ? softfloat_flag_underflow : 0;
+                flags |= (host_flags & FE_INEXACT) ? softfloat_flag_inexact : 0;
+#endif
+                return flags;
+            }
+
+          private:
+#if defined(__x86_64__)
+            uint32_t saved_csr_;
+#else
+            std::fenv_t saved_env_;
+#endif
+        };
+#endif // PEGASUS_HOST_FPU
+
+        // Runs op on the host FPU and converts the result to the SoftFloat type F
+        template <typename F, typename OpT, typename... Args>
+        inline bool compute(F & result, OpT op, const Args &... args)
+        {
+#if PEGASUS_HOST_FPU
+            const uint_fast8_t rm = softfloat_roundingMode;
+            if ((rm > softfloat_round_max) || (isNaN(args) || ...))
+            {
+                return false;
+            }
+
+            using H = typename HostFloat<F>::type;
+            using U = typename HostFloat<F>::bits;
+            constexpr FConstants<U> cons = getConst<U>();
+
+            uint_fast8_t flags;
+            H host_result;
+            {
+                HostFpEnv env(rm);
+                host_result = op(toHost(args)...);
+                barrier(host_result);
+                flags = env.getFlags();
+            }
+
+            U bits;
+            std::memcpy(&bits, &host_result, sizeof(bits));
+            const U exp_bits = bits & cons.EXP_MASK;
+            if (exp_bits == cons.EXP_MASK)
+            {
+                if (bits & cons.SIG_MASK)
+                {
+                    bits = cons.CAN_NAN;
+                }
+            }
+            else if ((exp_bits >> cons.EXP_LSB) <= 1)
+            {
+                // Subnormal, zero or smallest normal result: tininess detection and the rounding
+                // of the host may differ from SoftFloat
+                if (flags & (softfloat_flag_inexact | softfloat_flag_underflow))
+                {
+                    return false;
+                }
+            }
+
+            result.v = bits;
+            softfloat_exceptionFlags |= flags;
+            return true;
+#else
+            (void)result;
+            (void)op;
+            ((void)args, ...);
+            return false;
+#endif
+        }
+
+        template <typename F> inline bool tryAdd(F a, F b, F & result)
+        {
+            return compute(result, [](auto x, auto y) { return x + y; }, a, b);
+        }
+
+        template <typename F> inline bool trySub(F a, F b, F & result)
+        {
+            return compute(result, [](auto x, auto y) { return x - y; }, a, b);
+        }
+
+        template <typename F> inline bool tryMul(F a, F b, F & result)
+        {
+            return compute(result, [](auto x, auto y) { return x * y; }, a, b);
+        }
+
+        template <typename F> inline bool tryDiv(F a, F b, F & result)
+        {
+            return compute(result, [](auto x, auto y) { return x / y; }, a, b);
+        }
+
+        template <typename F> inline bool trySqrt(F a, F & result)
+        {
+            return compute(result, [](auto x) { return std::sqrt(x); }, a);
+        }
+
+        // a * b + c with a single rounding
+        template <typename F> inline bool tryMulAdd(F a, F b, F c, F & result)
+        {
+            return compute(result, [](auto x, auto y, auto z) { return std::fma(x, y, z); }, a, b,
+                           c);
+        }
+
+        // Conversion from another float type or from an integer
+        template <typename F, typename T> inline bool tryConvert(T a, F & result)
+        {
+            using H = typename HostFloat<F>::type;
+            return compute(result, [](auto x) { return static_cast<H>(x); }, a);
+        }
+
+        /*!
+         * \brief Conversion to an integer type
+         *
+         * The value is rounded to an integral value with rm and converted when it fits in I. NaN,
+         * infinity and out of range values (which raise NV and saturate) are left to SoftFloat.
+         */
+        template <typename I, typename F>
+        inline bool tryToInt(F a, const uint_fast8_t rm, I & result)
+        {
+            static_assert(std::is_integral_v<I>);
+            using H = typename HostFloat<F>::type;
+            using U = typename HostFloat<F>::bits;
+            constexpr FConstants<U> cons = getConst<U>();
+            if ((rm > softfloat_round_max) || ((a.v & cons.EXP_MASK) == cons.EXP_MASK))
+            {
+                return false;
+            }
+
+            H x;
+            std::memcpy(&x, &a.v, sizeof(x));
+            H rounded;
+            switch (rm)
+            {
+                case softfloat_round_near_even:
+                    // The host is always in round to nearest even between operations
+                    rounded = std::nearbyint(x);
+                    break;
+                case softfloat_round_minMag:
+                    rounded = std::trunc(x);
+                    break;
+                case softfloat_round_min:
+                    rounded = std::floor(x);
+                    break;
+                default:
+                    rounded = std::ceil(x);
+                    break;
+            }
+
+            // Both limits are powers of 2 and therefore exact in H
+            constexpr H half_range = static_cast<H>(1ULL << (sizeof(I) * 8 - 1));
+            constexpr H lower = std::is_signed_v<I> ? -half_range : H(0);
+            constexpr H upper = std::is_signed_v<I> ? half_range : 2 * half_range;
+            if (!((rounded >= lower) && (rounded < upper)))
+            {
+                return false;
+            }
+
+            result = static_cast<I>(rounded);
+            if (rounded != x)
+            {
+                softfloat_exceptionFlags |= softfloat_flag_inexact;
+            }
+            return true;
+        }
+
+        // Operations used by the instruction handlers. Rounding mode and flags are passed
+        // through softfloat_roundingMode and softfloat_exceptionFlags as with SoftFloat.
+
+        template <typename F> inline F add(const PegasusState* state, F a, F b)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && tryAdd(a, b, result))
+            {
+                return result;
+            }
+            return getAdd<F>()(a, b);
+        }
+
+        template <typename F> inline F sub(const PegasusState* state, F a, F b)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && trySub(a, b, result))
+            {
+                return result;
+            }
+            if constexpr (std::is_same_v<F, float32_t>)
+            {
+                return f32_sub(a, b);
+            }
+            else
+            {
+                return f64_sub(a, b);
+            }
+        }
+
+        template <typename F> inline F mul(const PegasusState* state, F a, F b)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && tryMul(a, b, result))
+            {
+                return result;
+            }
+            if constexpr (std::is_same_v<F, float32_t>)
+            {
+                return f32_mul(a, b);
+            }
+            else
+            {
+                return f64_mul(a, b);
+            }
+        }
+
+        template <typename F> inline F div(const PegasusState* state, F a, F b)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && tryDiv(a, b, result))
+            {
+                return result;
+            }
+            if constexpr (std::is_same_v<F, float32_t>)
+            {
+                return f32_div(a, b);
+            }
+            else
+            {
+                return f64_div(a, b);
+            }
+        }
+
+        template <typename F> inline F sqrt(const PegasusState* state, F a)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && trySqrt(a, result))
+            {
+                return result;
+            }
+            if constexpr (std::is_same_v<F, float32_t>)
+            {
+                return f32_sqrt(a);
+            }
+            else
+            {
+                return f64_sqrt(a);
+            }
+        }
+
+        template <typename F> inline F mulAdd(const PegasusState* state, F a, F b, F c)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && tryMulAdd(a, b, c, result))
+            {
+                return result;
+            }
+            return Fmadd<F>{}(a, b, c);
+        }
+
+        // Same operand negation as the Fmsub, Fnmadd and Fnmsub functors
+        template <typename F> inline F mulSub(const PegasusState* state, F a, F b, F c)
+        {
+            return mulAdd(state, a, b, fnegate(c));
+        }
+
+        template <typename F> inline F negMulAdd(const PegasusState* state, F a, F b, F c)
+        {
+            return mulAdd(state, a, fnegate(b), fnegate(c));
+        }
+
+        template <typename F> inline F negMulSub(const PegasusState* state, F a, F b, F c)
+        {
+            return mulAdd(state, a, fnegate(b), c);
+        }
+
+        template <typename F, typename T> inline F convert(const PegasusState* state, T a)
+        {
+            F result;
+            if (state->isHostFpuEnabled() && tryConvert(a, result))
+            {
+                return result;
+            }
+            if constexpr (std::is_same_v<F, float32_t>)
+            {
+                if constexpr (std::is_same_v<T, float64_t>)
+                {
+                    return f64_to_f32(a);
+                }
+                else if constexpr (std::is_same_v<T, int32_t>)
+                {
+                    return i32_to_f32(a);
+                }
+                else if constexpr (std::is_same_v<T, uint32_t>)
+                {
+                    return ui32_to_f32(a);
+                }
+                else if constexpr (std::is_same_v<T, int64_t>)
+                {
+                    return i64_to_f32(a);
+                }
+                else
+                {
+                    static_assert(std::is_same_v<T, uint64_t>);
+                    return ui64_to_f32(a);
+                }
+            }
+            else
+            {
+                if constexpr (std::is_same_v<T, float32_t>)
+                {
+                    return f32_to_f64(a);
+                }
+                else if constexpr (std::is_same_v<T, int32_t>)
+                {
+                    return i32_to_f64(a);
+                }
+                else if constexpr (std::is_same_v<T, uint32_t>)
+                {
+                    return ui32_to_f64(a);
+                }
+                else if constexpr (std::is_same_v<T, int64_t>)
+                {
+                    return i64_to_f64(a);
+                }
+                else
+                {
+                    static_assert(std::is_same_v<T, uint64_t>);
+                    return ui64_to_f64(a);
+                }
+            }
+        }
+
+        template <typename I, typename F>
+        inline I toInt(const PegasusState* state, F a, const uint_fast8_t rm)
+        {
+            I result;
+            if (state->isHostFpuEnabled() && tryToInt(a, rm, result))
+            {
+                return result;
+            }
+            if constexpr (std::is_same_v<F, float32_t>)
+            {
+                if constexpr (std::is_same_v<I, int32_t>)
+                {
+                    return f32_to_i32(a, rm, true);
+                }
+                else if constexpr (std::is_same_v<I, uint32_t>)
+                {
+                    return f32_to_ui32(a, rm, true);
+                }
+                else if constexpr (std::is_same_v<I, int64_t>)
+                {
+                    return f32_to_i64(a, rm, true);
+                }
+                else
+                {
+                    static_assert(std::is_same_v<I, uint64_t>);
+                    return f32_to_ui64(a, rm, true);
+                }
+            }
+            else
+            {
+                if constexpr (std::is_same_v<I, int32_t>)
+                {
+                    return f64_to_i32(a, rm, true);
+                }
+                else if constexpr (std::is_same_v<I, uint32_t>)
+                {
+                    return f64_to_ui32(a, rm, true);
+                }
+                else if constexpr (std::is_same_v<I, int64_t>)
+                {
+                    return f64_to_i64(a, rm, true);
+                }
+                else
+                {
+                    static_assert(std::is_same_v<I, uint64_t>);
+                    return f64_to_ui64(a, rm, true);
+                }
+            }
+        }
+    } // namespace hostfpu
+} // namespace pegasus
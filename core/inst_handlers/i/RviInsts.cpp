@@ -5,7 +5,9 @@
 #include "include/ActionTags.hpp"
 #include "core/ActionGroup.hpp"
 #include "core/PegasusCore.hpp"
+#include "core/Fetch.hpp"
 #include "core/PegasusInst.hpp"
+#include "core/translate/Translate.hpp"
 #include "system/PegasusSystem.hpp"
 #include "system/SystemCallEmulator.hpp"
 #include "sparta/memory/SimpleMemoryMapNode.hpp"
@@ -664,20 +666,20 @@ namespace pegasus
 
         // Access memory
         const auto & result = inst->getTranslationState()->getResult();
-        std::vector<uint8_t> buffer;
-        if (state->readMemory<SIZE>(result, buffer, MemAccessSource::INSTRUCTION) == false)
+        const std::optional<SIZE> mem_val =
+            state->readMemory<SIZE>(result, MemAccessSource::INSTRUCTION);
+        if (!mem_val)
         {
             THROW_LOAD_ACCESS;
         }
-        const SIZE mem_val = convertFromByteVector<SIZE>(buffer);
 
         if constexpr (SIGN_EXTEND)
         {
-            WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<SIZE, XLEN>(mem_val));
+            WRITE_INT_REG<XLEN>(state, inst->getRd(), signExtend<SIZE, XLEN>(*mem_val));
         }
         else
         {
-            WRITE_INT_REG<XLEN>(state, inst->getRd(), mem_val);
+            WRITE_INT_REG<XLEN>(state, inst->getRd(), *mem_val);
         }
 
         inst->getTranslationState()->popResult();
@@ -1034,6 +1036,10 @@ namespace pegasus
         // Clear the current exception (check for back to back)
         state->clearCurrentException();
 
+        // Restoring the interrupt enable bit or lowering the privilege mode can unmask an
+        // interrupt that is already pending
+        state->requestInterruptCheck();
+
         return ++action_it;
     }
 
@@ -1041,6 +1047,12 @@ namespace pegasus
     Action::ItrType RviInsts::ecallHandlerSystemEmulation_(pegasus::PegasusState* state,
                                                            Action::ItrType action_it)
     {
+        // The system call emulator is shared by all harts
+        if (SPARTA_EXPECT_FALSE(state->inParallelWindow()))
+        {
+            return state->endParallelWindow();
+        }
+
         if (state->getCore()->inCoSimMode() == false)
         {
             const XLEN ret_code = state->emulateSystemCall<XLEN>();
@@ -1126,6 +1138,26 @@ namespace pegasus
             THROW_ILLEGAL_INST;
         }
 
+        // rs1 == x0 flushes all addresses, rs2 == x0 flushes all address spaces
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        std::optional<Addr> vaddr;
+        std::optional<uint32_t> asid;
+        if (inst->getRs1() != 0)
+        {
+            vaddr = READ_INT_REG<XLEN>(state, inst->getRs1());
+        }
+        if (inst->getRs2() != 0)
+        {
+            asid = READ_INT_REG<XLEN>(state, inst->getRs2());
+        }
+
+        // When V=1, sfence.vma applies to the VS-stage
+        const translate_types::TranslationStage stage =
+            state->getVirtualMode() ? translate_types::TranslationStage::VIRTUAL_SUPERVISOR
+                                    : translate_types::TranslationStage::SUPERVISOR;
+        state->getTranslateUnit()->getTLB(stage)->flush(vaddr, asid);
+        state->getFetchUnit()->getBlockCache()->flush();
+
         return ++action_it;
     }
 
@@ -1160,8 +1192,15 @@ namespace pegasus
         {
             PegasusState::SimState* sim_state = state->getSimState();
             sim_state->sim_stopped = true;
-            ActionGroup* inst_action_group = state->getCurrentInst()->getActionGroup();
-            inst_action_group->setNextActionGroup(state->getStopSimActionGroup());
+            // Instruction ActionGroups are shared, so redirect without modifying them
+            return state->redirectActionGroup(state->getStopSimActionGroup());
+        }
+
+        // Put the hart to sleep until an interrupt is pending (or the WFI timeout expires)
+        if (state->getCore()->isWfiSleepEnabled()
+            && ((READ_CSR_REG<XLEN>(state, MIP) & READ_CSR_REG<XLEN>(state, MIE)) == 0))
+        {
+            state->pauseHart(SimPauseReason::WFI);
         }
         return ++action_it;
     }
@@ -6,6 +6,7 @@
 #include "core/VecElements.hpp"
 #include "core/inst_handlers/inst_helpers.hpp"
 #include "core/inst_handlers/vector_types.hpp"
+#include "core/inst_handlers/v/RvvKernels.hpp"
 
 namespace pegasus
 {
@@ -85,6 +86,18 @@ namespace pegasus
         FunctorT<T> functor{};
         using R = typename decltype(elems_vd)::ElemType::ValueType;
 
+        // Same-width instructions run on whole registers
+        if constexpr ((opMode.dst == OperandMode::Mode::V) && (opMode.src2 == OperandMode::Mode::V))
+        {
+            static_assert(sizeof(T) * 8 == elemWidth);
+            if (SPARTA_EXPECT_TRUE(rvv_kernels::canExecute(state, inst->getVectorConfig())))
+            {
+                rvv_kernels::unary<T>(state, inst->getVectorConfig(), !inst->getVM(), inst->getRd(),
+                                      inst->getRs2(), functor);
+                return ++action_it;
+            }
+        }
+
         auto execute = [&](auto iter, const auto & end)
         {
             size_t index = 0;
@@ -226,6 +239,41 @@ namespace pegasus
         FunctorT<T> functor{};
         using R = typename decltype(elems_vd)::ElemType::ValueType;
 
+        // Same-width instructions run on whole registers
+        if constexpr ((opMode.dst == OperandMode::Mode::V) && (opMode.src2 == OperandMode::Mode::V))
+        {
+            static_assert(sizeof(T) * 8 == elemWidth);
+            if (SPARTA_EXPECT_TRUE(rvv_kernels::canExecute(state, inst->getVectorConfig())))
+            {
+                const VectorConfig* config = inst->getVectorConfig();
+                const bool masked = !inst->getVM();
+                if constexpr (opMode.src1 == OperandMode::Mode::V)
+                {
+                    rvv_kernels::binary<T>(state, config, masked, inst->getRd(), inst->getRs2(),
+                                           inst->getRs1(), functor);
+                }
+                else
+                {
+                    T scalar;
+                    if constexpr (opMode.src1 == OperandMode::Mode::X)
+                    {
+                        scalar = std::is_signed_v<T>
+                                     ? sext<T>(READ_INT_REG<XLEN>(state, inst->getRs1()))
+                                     : zext<T>(READ_INT_REG<XLEN>(state, inst->getRs1()));
+                    }
+                    else // opMode.src1 == OperandMode::Mode::I
+                    {
+                        scalar = std::is_signed_v<T> ? sext<T>(inst->getImmediate())
+                                                     : zext<T>(inst->getImmediate());
+                    }
+                    rvv_kernels::unary<T>(state, config, masked, inst->getRd(), inst->getRs2(),
+                                          [&functor, scalar](T src2)
+                                          { return functor(src2, scalar); });
+                }
+                return ++action_it;
+            }
+        }
+
         auto execute = [&](auto iter, const auto & end)
         {
             size_t index = 0;
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/PegasusState.hpp"
+#include "core/VectorConfig.hpp"
+#include "include/VecNums.hpp"
+
+namespace pegasus
+{
+    /*!
+     * \brief Whole-register execution engine for element-wise RVV integer instructions
+     *
+     * Instead of reading and writing every element through Element/Elements, each register of
+     * the LMUL group is copied into a local array, the operation is applied by a plain loop over
+     * the active elements that the compiler can vectorize, and the result is copied back. Only
+     * the body elements [vstart, vl) are written, and masked-off elements keep their old value,
+     * which is exactly what the element path does.
+     */
+    namespace rvv_kernels
+    {
+        // Largest VLEN supported by the engine, in bytes
+        static constexpr size_t VLEN_MAX_BYTES = 1024 / 8;
+
+        // Returns false if the instruction must be executed by the element path
+        inline bool canExecute(const PegasusState* state, const VectorConfig* config)
+        {
+            return state->isVecKernelsEnabled() && ((config->getVLEN() / 8) <= VLEN_MAX_BYTES);
+        }
+
+        // Apply op to every active element of a register group. OpT is called with the index of
+        // the element in the local arrays and returns the result.
+        template <typename T, typename LoadT, typename OpT>
+        inline void forEachActiveElement(PegasusState* state, const VectorConfig* config,
+                                         const bool masked, const uint32_t vd, LoadT load, OpT op)
+        {
+            static constexpr size_t MAX_ELEMS_PER_REG = VLEN_MAX_BYTES / sizeof(T);
+            PegasusState::ArchRegisterFile & vec_reg_file = state->getVecRegisterFile();
+            const size_t elems_per_reg = config->getVLEN() / (sizeof(T) * 8);
+            const size_t vstart = config->getVSTART();
+            const size_t vl = config->getVL();
+            if (vstart >= vl)
+            {
+                return;
+            }
+
+            // Copy the mask first in case the destination overlaps v0
+            alignas(64) uint8_t mask[VLEN_MAX_BYTES];
+            if (masked)
+            {
+                std::memcpy(mask, vec_reg_file.getData(V0), (vl + 7) / 8);
+            }
+
+            alignas(64) T dst[MAX_ELEMS_PER_REG];
+            for (size_t reg_start = vstart - (vstart % elems_per_reg); reg_start < vl;
+                 reg_start += elems_per_reg)
+            {
+                const uint32_t reg_offset = reg_start / elems_per_reg;
+                const size_t begin = std::max(vstart, reg_start) - reg_start;
+                const size_t end = std::min(vl - reg_start, elems_per_reg);
+                const size_t num_bytes = (end - begin) * sizeof(T);
+
+                load(reg_offset, begin, num_bytes);
+                if (masked)
+                {
+                    std::memcpy(dst + begin,
+                                vec_reg_file.getData(vd + reg_offset) + (begin * sizeof(T)),
+                                num_bytes);
+                    for (size_t idx = begin; idx < end; ++idx)
+                    {
+                        const size_t elem = reg_start + idx;
+                        if ((mask[elem / 8] >> (elem % 8)) & 1)
+                        {
+                            dst[idx] = op(idx);
+                        }
+                    }
+                }
+                else
+                {
+                    for (size_t idx = begin; idx < end; ++idx)
+                    {
+                        dst[idx] = op(idx);
+                    }
+                }
+                std::memcpy(vec_reg_file.getDataForWrite(vd + reg_offset) + (begin * sizeof(T)),
+                            dst + begin, num_bytes);
+            }
+        }
+
+        // vd[i] = func(vs2[i])
+        template <typename T, typename FuncT>
+        inline void unary(PegasusState* state, const VectorConfig* config, const bool masked,
+                          const uint32_t vd, const uint32_t vs2, FuncT func)
+        {
+            const PegasusState::ArchRegisterFile & vec_reg_file = state->getVecRegisterFile();
+            alignas(64) T src2[VLEN_MAX_BYTES / sizeof(T)];
+            forEachActiveElement<T>(
+                state, config, masked, vd,
+                [&](uint32_t reg_offset, size_t begin, size_t num_bytes)
+                {
+                    std::memcpy(src2 + begin,
+                                vec_reg_file.getData(vs2 + reg_offset) + (begin * sizeof(T)),
+                                num_bytes);
+                },
+                [&](size_t idx) { return static_cast<T>(func(src2[idx])); });
+        }
+
+        // vd[i] = func(vs2[i], vs1[i])
+        template <typename T, typename FuncT>
+        inline void binary(PegasusState* state, const VectorConfig* config, const bool masked,
+                           const uint32_t vd, const uint32_t vs2, const uint32_t vs1, FuncT func)
+        {
+            const PegasusState::ArchRegisterFile & vec_reg_file = state->getVecRegisterFile();
+            alignas(64) T src2[VLEN_MAX_BYTES / sizeof(T)];
+            alignas(64) T src1[VLEN_MAX_BYTES / sizeof(T)];
+            forEachActiveElement<T>(
+                state, config, masked, vd,
+                [&](uint32_t reg_offset, size_t begin, size_t num_bytes)
+                {
+                    std::memcpy(src2 + begin,
+                                vec_reg_file.getData(vs2 + reg_offset) + (begin * sizeof(T)),
+                                num_bytes);
+                    std::memcpy(src1 + begin,
+                                vec_reg_file.getData(vs1 + reg_offset) + (begin * sizeof(T)),
+                                num_bytes);
+                },
+                [&](size_t idx) { return static_cast<T>(func(src2[idx], src1[idx])); });
+        }
+    } // namespace rvv_kernels
+} // namespace pegasus
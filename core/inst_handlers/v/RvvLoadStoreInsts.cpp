@@ -1,5 +1,8 @@
+#include <algorithm>
+
 #include "core/inst_handlers/v/RvvLoadStoreInsts.hpp"
 #include "core/PegasusState.hpp"
+#include "core/DmiCache.hpp"
 #include "core/ActionGroup.hpp"
 #include "core/VecElements.hpp"
 #include "include/ActionTags.hpp"
@@ -343,36 +346,36 @@ namespace pegasus
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
         inst_handlers.emplace(
-            "vle8.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<8, true>,
+            "vle8.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<8, true>,
                                                     RvvLoadStoreInsts>(nullptr, "vle8.v",
                                                                        ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
-            "vle16.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<16, true>,
+            "vle16.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<16, true>,
                                                      RvvLoadStoreInsts>(nullptr, "vle16.v",
                                                                         ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
-            "vle32.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<32, true>,
+            "vle32.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<32, true>,
                                                      RvvLoadStoreInsts>(nullptr, "vle32.v",
                                                                         ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
-            "vle64.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<64, true>,
+            "vle64.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<64, true>,
                                                      RvvLoadStoreInsts>(nullptr, "vle64.v",
                                                                         ActionTags::EXECUTE_TAG));
 
         inst_handlers.emplace(
-            "vse8.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<8, false>,
+            "vse8.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<8, false>,
                                                     RvvLoadStoreInsts>(nullptr, "vse8.v",
                                                                        ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
-            "vse16.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<16, false>,
+            "vse16.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<16, false>,
                                                      RvvLoadStoreInsts>(nullptr, "vse16.v",
                                                                         ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
-            "vse32.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<32, false>,
+            "vse32.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<32, false>,
                                                      RvvLoadStoreInsts>(nullptr, "vse32.v",
                                                                         ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
-            "vse64.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<64, false>,
+            "vse64.v", pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<64, false>,
                                                      RvvLoadStoreInsts>(nullptr, "vse64.v",
                                                                         ActionTags::EXECUTE_TAG));
 
@@ -455,22 +458,22 @@ namespace pegasus
 
         inst_handlers.emplace(
             "vle8ff.v",
-            pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<8, true, true>,
+            pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<8, true, true>,
                                           RvvLoadStoreInsts>(nullptr, "vle8ff.v",
                                                              ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
             "vle16ff.v",
-            pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<16, true, true>,
+            pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<16, true, true>,
                                           RvvLoadStoreInsts>(nullptr, "vle16ff.v",
                                                              ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
             "vle32ff.v",
-            pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<32, true, true>,
+            pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<32, true, true>,
                                           RvvLoadStoreInsts>(nullptr, "vle32ff.v",
                                                              ActionTags::EXECUTE_TAG));
         inst_handlers.emplace(
             "vle64ff.v",
-            pegasus::Action::createAction<&RvvLoadStoreInsts::vlseHandler_<64, true, true>,
+            pegasus::Action::createAction<&RvvLoadStoreInsts::vleHandler_<64, true, true>,
                                           RvvLoadStoreInsts>(nullptr, "vle64ff.v",
                                                              ActionTags::EXECUTE_TAG));
 
@@ -626,6 +629,26 @@ namespace pegasus
         {
             stride = READ_INT_REG<XLEN>(state, inst->getRs2());
         }
+        if constexpr (addrMode == AddressingMode::UNIT)
+        {
+            if (inst->getVM() && isBlockAccess_(state, config, rs1_val, eewb))
+            {
+                size_t vstart = config->getVSTART();
+                if (ffirst && (vstart == 0) && (config->getVL() > 0))
+                {
+                    // Element 0 is translated by itself so that its fault can be reported
+                    inst->getTranslationState()->makeRequest(rs1_val, eewb, true);
+                    vstart = 1;
+                }
+                if (vstart < config->getVL())
+                {
+                    makeBlockRequests_(inst->getTranslationState(), rs1_val + vstart * eewb,
+                                       (config->getVL() - vstart) * eewb);
+                }
+                return ++action_it;
+            }
+        }
+
         if (inst->getVM())
         {
             for (size_t i = config->getVSTART(); i < config->getVL(); ++i)
@@ -701,6 +724,17 @@ namespace pegasus
         const Addr stride = elemWidth / 8;
         const XLEN rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
 
+        if (isBlockAccess_(state, vector_config, rs1_val, eewb))
+        {
+            const size_t vstart = vector_config->getVSTART();
+            if (vstart < vl)
+            {
+                makeBlockRequests_(inst->getTranslationState(), rs1_val + vstart * eewb,
+                                   (vl - vstart) * eewb);
+            }
+            return ++action_it;
+        }
+
         for (size_t i = vector_config->getVSTART(); i < vl; ++i)
         {
             inst->getTranslationState()->makeRequest(rs1_val + i * stride, eewb);
@@ -721,6 +755,16 @@ namespace pegasus
         const size_t vl = (vector_config->getVL() + BYTESIZE - 1) / BYTESIZE;
         const XLEN rs1_val = READ_INT_REG<XLEN>(state, inst->getRs1());
 
+        if (isBlockAccess_(state, vector_config, rs1_val, 1))
+        {
+            const size_t vstart = vector_config->getVSTART();
+            if (vstart < vl)
+            {
+                makeBlockRequests_(inst->getTranslationState(), rs1_val + vstart, vl - vstart);
+            }
+            return ++action_it;
+        }
+
         for (size_t i = vector_config->getVSTART(); i < vl; ++i)
         {
             inst->getTranslationState()->makeRequest(rs1_val + i, 1);
@@ -729,6 +773,40 @@ namespace pegasus
         return ++action_it;
     }
 
+    template <size_t elemWidth, bool isLoad, bool ffirst>
+    Action::ItrType RvvLoadStoreInsts::vleHandler_(pegasus::PegasusState* state,
+                                                   Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        VectorConfig* config = inst->getVectorConfig();
+        PegasusTranslationState* translation_state = inst->getTranslationState();
+        const size_t eewb = elemWidth / 8;
+
+        // The compute address handler made the same decision from the first address. A fault
+        // on the first element of a fault-only-first load leaves no results, the element path
+        // reduces VL.
+        if (!inst->getVM() || !translation_state->getNumResults())
+        {
+            return vlseHandler_<elemWidth, isLoad, ffirst>(state, action_it);
+        }
+        const Addr base_vaddr =
+            translation_state->getResult().getVAddr() - config->getVSTART() * eewb;
+        if (!isBlockAccess_(state, config, base_vaddr, eewb))
+        {
+            return vlseHandler_<elemWidth, isLoad, ffirst>(state, action_it);
+        }
+
+        const uint32_t reg = isLoad ? inst->getRd() : inst->getRs3();
+        if (!blockAccess_<isLoad>(state, config, translation_state, reg,
+                                  config->getVSTART() * eewb, config->getVL() * eewb, eewb))
+        {
+            return state->redirectToException(isLoad ? FaultCause::LOAD_ACCESS
+                                                     : FaultCause::STORE_AMO_ACCESS);
+        }
+
+        return ++action_it;
+    }
+
     template <size_t elemWidth, bool isLoad, bool ffirst>
     Action::ItrType RvvLoadStoreInsts::vlseHandler_(pegasus::PegasusState* state,
                                                     Action::ItrType action_it)
@@ -752,15 +830,13 @@ namespace pegasus
                 const auto & result = transtate->getResult();
                 if constexpr (isLoad)
                 {
-                    std::vector<uint8_t> buffer;
-                    if (state->readMemory<UintType<elemWidth>>(result, buffer,
-                                                               MemAccessSource::INSTRUCTION)
-                        == false)
+                    const std::optional<UintType<elemWidth>> value =
+                        state->readMemory<UintType<elemWidth>>(result, MemAccessSource::INSTRUCTION);
+                    if (!value)
                     {
-                        THROW_LOAD_ACCESS;
+                        state->throwException(FaultCause::LOAD_ACCESS);
                     }
-                    UintType<elemWidth> value = convertFromByteVector<UintType<elemWidth>>(buffer);
-                    elems.getElement(iter.getIndex()).setVal(value);
+                    elems.getElement(iter.getIndex()).setVal(*value);
                 }
                 else
                 {
@@ -769,7 +845,7 @@ namespace pegasus
                                                                 MemAccessSource::INSTRUCTION)
                         == false)
                     {
-                        THROW_STORE_AMO_ACCESS;
+                        state->throwException(FaultCause::STORE_AMO_ACCESS);
                     }
                 }
                 transtate->popResult();
@@ -818,23 +894,44 @@ namespace pegasus
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
         VectorConfig* config = inst->getVectorConfig();
-        Elements<Element<elemWidth>, false> elems{state, config,
-                                                  isLoad ? inst->getRd() : inst->getRs3()};
+        const uint32_t reg = isLoad ? inst->getRd() : inst->getRs3();
+        const size_t eewb = elemWidth / 8;
 
+        PegasusTranslationState* translation_state = inst->getTranslationState();
+        if (translation_state->getNumResults()
+            && isBlockAccess_(state, config,
+                              translation_state->getResult().getVAddr()
+                                  - config->getVSTART() * eewb,
+                              eewb))
+        {
+            if (!blockAccess_<isLoad>(state, config, translation_state, reg,
+                                      config->getVSTART() * eewb, config->getVL() * eewb, eewb))
+            {
+                if constexpr (isLoad)
+                {
+                    THROW_LOAD_ACCESS;
+                }
+                else
+                {
+                    THROW_STORE_AMO_ACCESS;
+                }
+            }
+            return ++action_it;
+        }
+
+        Elements<Element<elemWidth>, false> elems{state, config, reg};
         for (auto iter = elems.begin(); iter != elems.end(); ++iter)
         {
             const auto & result = inst->getTranslationState()->getResult();
             if constexpr (isLoad)
             {
-                std::vector<uint8_t> buffer;
-                if (state->readMemory<UintType<elemWidth>>(result, buffer,
-                                                           MemAccessSource::INSTRUCTION)
-                    == false)
+                const std::optional<UintType<elemWidth>> value =
+                    state->readMemory<UintType<elemWidth>>(result, MemAccessSource::INSTRUCTION);
+                if (!value)
                 {
                     THROW_LOAD_ACCESS;
                 }
-                UintType<elemWidth> value = convertFromByteVector<UintType<elemWidth>>(buffer);
-                elems.getElement(iter.getIndex()).setVal(value);
+                elems.getElement(iter.getIndex()).setVal(*value);
             }
             else
             {
@@ -861,23 +958,41 @@ namespace pegasus
         VectorConfig* config = inst->getVectorConfig();
         config->setLMUL(1 * 8);
         config->setVL((config->getVL() + BYTESIZE - 1) / BYTESIZE);
-        Elements<Element<BYTESIZE>, false> elems{state, config,
-                                                 isLoad ? inst->getRd() : inst->getRs3()};
+        const uint32_t reg = isLoad ? inst->getRd() : inst->getRs3();
+
+        PegasusTranslationState* translation_state = inst->getTranslationState();
+        if (translation_state->getNumResults()
+            && isBlockAccess_(state, config,
+                              translation_state->getResult().getVAddr() - config->getVSTART(), 1))
+        {
+            if (!blockAccess_<isLoad>(state, config, translation_state, reg, config->getVSTART(),
+                                      config->getVL(), 1))
+            {
+                if constexpr (isLoad)
+                {
+                    THROW_LOAD_ACCESS;
+                }
+                else
+                {
+                    THROW_STORE_AMO_ACCESS;
+                }
+            }
+            return ++action_it;
+        }
 
+        Elements<Element<BYTESIZE>, false> elems{state, config, reg};
         for (auto iter = elems.begin(); iter != elems.end(); ++iter)
         {
             const auto & result = inst->getTranslationState()->getResult();
             if constexpr (isLoad)
             {
-                std::vector<uint8_t> buffer;
-                if (state->readMemory<UintType<BYTESIZE>>(result, buffer,
-                                                          MemAccessSource::INSTRUCTION)
-                    == false)
+                const std::optional<UintType<BYTESIZE>> value =
+                    state->readMemory<UintType<BYTESIZE>>(result, MemAccessSource::INSTRUCTION);
+                if (!value)
                 {
                     THROW_LOAD_ACCESS;
                 }
-                UintType<BYTESIZE> value = convertFromByteVector<UintType<BYTESIZE>>(buffer);
-                elems.getElement(iter.getIndex()).setVal(value);
+                elems.getElement(iter.getIndex()).setVal(*value);
             }
             else
             {
@@ -894,4 +1009,80 @@ namespace pegasus
 
         return ++action_it;
     }
+
+    bool RvvLoadStoreInsts::isBlockAccess_(const pegasus::PegasusState* state,
+                                           const VectorConfig* config, const Addr vaddr,
+                                           const size_t eewb)
+    {
+        // Elements must not cross a page or a register, so that a block can always be split
+        // back into the accesses the element path would make
+        const size_t reg_bytes = config->getVLEN() / 8;
+        return state->isVecKernelsEnabled() && ((vaddr % eewb) == 0) && ((reg_bytes % eewb) == 0);
+    }
+
+    void RvvLoadStoreInsts::makeBlockRequests_(PegasusTranslationState* translation_state,
+                                               const Addr vaddr, const size_t size)
+    {
+        // Pages are at least 4K, so a request never needs to be split by Translate
+        Addr addr = vaddr;
+        const Addr end = vaddr + size;
+        while (addr < end)
+        {
+            const Addr page_end = (addr & ~DmiCache::PAGEOFFSET_MASK) + DmiCache::PAGESIZE;
+            const Addr block_end = std::min(end, page_end);
+            translation_state->makeRequest(addr, block_end - addr);
+            addr = block_end;
+        }
+    }
+
+    template <bool isLoad>
+    bool RvvLoadStoreInsts::blockAccess_(pegasus::PegasusState* state, const VectorConfig* config,
+                                         PegasusTranslationState* translation_state,
+                                         const uint32_t reg, const size_t begin, const size_t end,
+                                         const size_t eewb)
+    {
+        PegasusState::ArchRegisterFile & vec_reg_file = state->getVecRegisterFile();
+        const size_t reg_bytes = config->getVLEN() / 8;
+
+        // Results are popped in address order, [begin, end) are byte offsets in the register group
+        size_t offset = begin;
+        while (offset < end)
+        {
+            const PegasusTranslationState::TranslationResult result =
+                translation_state->getResult();
+            sparta_assert((offset + result.getSize()) <= end);
+
+            // A page may span several registers of the group
+            for (size_t done = 0; done < result.getSize();)
+            {
+                const uint32_t reg_num = reg + (offset / reg_bytes);
+                const size_t reg_offset = offset % reg_bytes;
+                const size_t size = std::min(result.getSize() - done, reg_bytes - reg_offset);
+                const PegasusTranslationState::TranslationResult block{
+                    result.getVAddr() + done, result.getPAddr() + done, size};
+
+                bool success;
+                if constexpr (isLoad)
+                {
+                    success = state->readMemoryBlock(
+                        block, vec_reg_file.getDataForWrite(reg_num) + reg_offset, eewb,
+                        MemAccessSource::INSTRUCTION);
+                }
+                else
+                {
+                    success = state->writeMemoryBlock(block,
+                                                      vec_reg_file.getData(reg_num) + reg_offset,
+                                                      eewb, MemAccessSource::INSTRUCTION);
+                }
+                if (!success)
+                {
+                    return false;
+                }
+                done += size;
+                offset += size;
+            }
+            translation_state->popResult();
+        }
+        return true;
+    }
 } // namespace pegasus
@@ -5,10 +5,13 @@
 #include <stdint.h>
 
 #include "core/Action.hpp"
+#include "include/PegasusTypes.hpp"
 
 namespace pegasus
 {
     class PegasusState;
+    class PegasusTranslationState;
+    class VectorConfig;
     class Action;
     class ActionGroup;
 
@@ -44,6 +47,8 @@ namespace pegasus
         Action::ItrType vlsmComputeAddressHandler_(pegasus::PegasusState* state,
                                                    Action::ItrType action_it);
 
+        template <size_t elemWidth, bool isLoad, bool ffirst = false>
+        Action::ItrType vleHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
         template <size_t elemWidth, bool isLoad, bool ffirst = false>
         Action::ItrType vlseHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
         template <bool isLoad>
@@ -52,5 +57,16 @@ namespace pegasus
         Action::ItrType vlsreHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
         template <bool isLoad>
         Action::ItrType vlsmHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
+
+        // Unit-stride accesses of contiguous elements are translated once per page and copied
+        // straight between memory and the vector register bytes
+        static bool isBlockAccess_(const pegasus::PegasusState* state, const VectorConfig* config,
+                                   Addr vaddr, size_t eewb);
+        static void makeBlockRequests_(PegasusTranslationState* translation_state, Addr vaddr,
+                                       size_t size);
+        template <bool isLoad>
+        static bool blockAccess_(pegasus::PegasusState* state, const VectorConfig* config,
+                                 PegasusTranslationState* translation_state, uint32_t reg,
+                                 size_t begin, size_t end, size_t eewb);
     };
 } // namespace pegasus
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "core/PegasusState.hpp"
+#include "core/VecCrypto.hpp"
+#include "core/VectorConfig.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pegasus
+{
+    /*!
+     * \brief Operand handling shared by the vector crypto extensions
+     *
+     * The body element groups of vd, vs2 and vs1 are copied into local buffers, the engine runs
+     * on all of them in one call and the result is copied back to vd. This also takes care of
+     * element groups that span two registers (EGW=256 with VLEN=128).
+     */
+    namespace vcrypto
+    {
+        // Largest register group in bytes (LMUL=8, VLEN=1024)
+        static constexpr size_t MAX_GROUP_BYTES = 8 * (1024 / 8);
+
+        inline void readGroup(const PegasusState::ArchRegisterFile & vec_reg_file,
+                              const uint32_t base_reg, const size_t vlenb, size_t offset,
+                              size_t num_bytes, uint8_t* dst)
+        {
+            while (num_bytes > 0)
+            {
+                const size_t reg_offset = offset % vlenb;
+                const size_t chunk = std::min(num_bytes, vlenb - reg_offset);
+                std::memcpy(dst, vec_reg_file.getData(base_reg + (offset / vlenb)) + reg_offset,
+                            chunk);
+                dst += chunk;
+                offset += chunk;
+                num_bytes -= chunk;
+            }
+        }
+
+        inline void writeGroup(PegasusState::ArchRegisterFile & vec_reg_file,
+                               const uint32_t base_reg, const size_t vlenb, size_t offset,
+                               size_t num_bytes, const uint8_t* src)
+        {
+            while (num_bytes > 0)
+            {
+                const size_t reg_offset = offset % vlenb;
+                const size_t chunk = std::min(num_bytes, vlenb - reg_offset);
+                std::memcpy(vec_reg_file.getDataForWrite(base_reg + (offset / vlenb)) + reg_offset,
+                            src, chunk);
+                src += chunk;
+                offset += chunk;
+                num_bytes -= chunk;
+            }
+        }
+
+        // Returns false for the reserved encodings: wrong SEW, vl or vstart not a multiple of
+        // EGS, an element group larger than the register group, or vd overlapping the scalar
+        // element group of a .vs instruction
+        inline bool isLegal(const VectorConfig* config, const size_t sew, const size_t egs,
+                            const uint32_t vd, const uint32_t vs2, const bool vs_form)
+        {
+            const size_t group_bytes = (config->getVLEN() / 8) * config->getLMUL() / 8;
+            if ((config->getSEW() != sew) || ((config->getVL() % egs) != 0)
+                || ((config->getVSTART() % egs) != 0) || (((egs * sew) / 8) > group_bytes))
+            {
+                return false;
+            }
+
+            if (vs_form)
+            {
+                const uint32_t num_regs = std::max<uint32_t>(1, config->getLMUL() / 8);
+                if ((vs2 >= vd) && (vs2 < (vd + num_regs)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Calls func(vd, vs2, vs1, num_egs, key_stride) on the body element groups of the current
+        // instruction. For .vs instructions every element group of vd uses element group 0 of vs2
+        // and key_stride is 0.
+        template <size_t EGS, bool VS_FORM, bool HAS_VS1, typename FuncT>
+        inline void execute(PegasusState* state, FuncT func)
+        {
+            const PegasusInstPtr & inst = state->getCurrentInst();
+            const VectorConfig* config = inst->getVectorConfig();
+            PegasusState::ArchRegisterFile & vec_reg_file = state->getVecRegisterFile();
+            const size_t vlenb = config->getVLEN() / 8;
+            const size_t elem_bytes = config->getSEW() / 8;
+            const size_t eg_bytes = EGS * elem_bytes;
+            const size_t vstart = config->getVSTART();
+            const size_t vl = config->getVL();
+            if (vstart >= vl)
+            {
+                return;
+            }
+
+            const size_t offset = vstart * elem_bytes;
+            const size_t num_bytes = (vl - vstart) * elem_bytes;
+            const size_t num_egs = num_bytes / eg_bytes;
+
+            alignas(64) uint8_t vd_buf[MAX_GROUP_BYTES];
+            alignas(64) uint8_t vs2_buf[MAX_GROUP_BYTES];
+            alignas(64) uint8_t vs1_buf[MAX_GROUP_BYTES];
+            readGroup(vec_reg_file, inst->getRd(), vlenb, offset, num_bytes, vd_buf);
+            if constexpr (VS_FORM)
+            {
+                readGroup(vec_reg_file, inst->getRs2(), vlenb, 0, eg_bytes, vs2_buf);
+            }
+            else
+            {
+                readGroup(vec_reg_file, inst->getRs2(), vlenb, offset, num_bytes, vs2_buf);
+            }
+            if constexpr (HAS_VS1)
+            {
+                readGroup(vec_reg_file, inst->getRs1(), vlenb, offset, num_bytes, vs1_buf);
+            }
+
+            func(vd_buf, vs2_buf, vs1_buf, num_egs, VS_FORM ? 0 : eg_bytes);
+
+            writeGroup(vec_reg_file, inst->getRd(), vlenb, offset, num_bytes, vd_buf);
+        }
+    } // namespace vcrypto
+} // namespace pegasus
@@ -90,12 +90,13 @@ namespace pegasus
 
         if constexpr (sizeof(XLEN) >= sizeof(AccessType))
         {
-            std::vector<uint8_t> buffer;
-            if (state->readMemory<AccessType>(paddr, buffer, MemAccessSource::INSTRUCTION) == false)
+            const std::optional<AccessType> mem_val =
+                state->readMemory<AccessType>(paddr, MemAccessSource::INSTRUCTION);
+            if (!mem_val)
             {
                 THROW_STORE_AMO_ACCESS;
             }
-            const AccessType temp = convertFromByteVector<AccessType>(buffer);
+            const AccessType temp = *mem_val;
             const AccessType comp = READ_INT_REG<XLEN>(state, inst->getRd());
             const AccessType swap = READ_INT_REG<XLEN>(state, inst->getRs2());
             if (temp == comp)
@@ -120,19 +121,21 @@ namespace pegasus
             sparta_assert(!(inst->getRs2() % 1), "rs2 value is not even.");
             sparta_assert(!(inst->getRd() % 1), "rd value is not even.");
 
-            std::vector<uint8_t> buffer;
-            if (state->readMemory<XLEN>(paddr, buffer, MemAccessSource::INSTRUCTION) == false)
+            const std::optional<XLEN> mem_val0 =
+                state->readMemory<XLEN>(paddr, MemAccessSource::INSTRUCTION);
+            if (!mem_val0)
             {
                 THROW_STORE_AMO_ACCESS;
             }
-            const XLEN temp0 = convertFromByteVector<XLEN>(buffer);
+            const XLEN temp0 = *mem_val0;
 
-            if (state->readMemory<XLEN>(paddr + sizeof(XLEN), buffer, MemAccessSource::INSTRUCTION)
-                == false)
+            const std::optional<XLEN> mem_val1 =
+                state->readMemory<XLEN>(paddr + sizeof(XLEN), MemAccessSource::INSTRUCTION);
+            if (!mem_val1)
             {
                 THROW_STORE_AMO_ACCESS;
             }
-            const XLEN temp1 = convertFromByteVector<XLEN>(buffer);
+            const XLEN temp1 = *mem_val1;
 
             const XLEN comp0 = inst->getRd() == 0 ? 0 : READ_INT_REG<XLEN>(state, inst->getRd());
             const XLEN comp1 =
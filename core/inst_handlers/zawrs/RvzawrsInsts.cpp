@@ -28,6 +28,12 @@ namespace pegasus
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
+        // Waiting on the reservation set registers with the shared system memory
+        if (SPARTA_EXPECT_FALSE(state->inParallelWindow()))
+        {
+            return state->endParallelWindow();
+        }
+
         state->pauseHart(SimPauseReason::WRS_NTO);
         state->registerWaitOnReservationSet();
 
@@ -39,6 +45,12 @@ namespace pegasus
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
+        // Waiting on the reservation set registers with the shared system memory
+        if (SPARTA_EXPECT_FALSE(state->inParallelWindow()))
+        {
+            return state->endParallelWindow();
+        }
+
         state->pauseHart(SimPauseReason::WRS_STO);
         state->registerWaitOnReservationSet();
 
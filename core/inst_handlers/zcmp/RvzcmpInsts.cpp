@@ -38,6 +38,23 @@ namespace pegasus
     template void RvzcmpInsts::getInstHandlers<RV32>(InstHandlers::InstHandlersMap &);
     template void RvzcmpInsts::getInstHandlers<RV64>(InstHandlers::InstHandlersMap &);
 
+    template <typename XLEN, bool IS_PUSH>
+    bool RvzcmpInsts::canAccessStackInParallel_(pegasus::PegasusState* state)
+    {
+        if (SPARTA_EXPECT_TRUE(!state->inParallelWindow()))
+        {
+            return true;
+        }
+
+        // The registers are saved to or restored from the bytes just below SP. Mavis includes
+        // the SP in the register lists.
+        const auto & opcode_info = state->getCurrentInst()->getMavisOpcodeInfo();
+        const size_t num_regs = IS_PUSH ? (opcode_info->getSourceOpInfoList().size() - 1)
+                                        : (opcode_info->getDestOpInfoList().size() - 1);
+        const size_t size = num_regs * sizeof(XLEN);
+        return state->canAccessInParallel(READ_INT_REG<XLEN>(state, SP) - size, size, IS_PUSH);
+    }
+
     template <typename XLEN> void RvzcmpInsts::pop_(pegasus::PegasusState* state)
     {
         const PegasusInstPtr & inst = state->getCurrentInst();
@@ -51,13 +68,13 @@ namespace pegasus
         {
             const auto dst = dst_reg_list[idx];
             addr -= sizeof(XLEN);
-            std::vector<uint8_t> buffer;
-            if (state->readMemory<XLEN>(addr, buffer, MemAccessSource::INSTRUCTION) == false)
+            const std::optional<XLEN> dst_reg_val =
+                state->readMemory<XLEN>(addr, MemAccessSource::INSTRUCTION);
+            if (!dst_reg_val)
             {
-                THROW_LOAD_ACCESS;
+                state->throwException(FaultCause::LOAD_ACCESS);
             }
-            const XLEN dst_reg_val = convertFromByteVector<XLEN>(buffer);
-            WRITE_INT_REG<XLEN>(state, dst.field_value, dst_reg_val);
+            WRITE_INT_REG<XLEN>(state, dst.field_value, *dst_reg_val);
         }
 
         // Update stack pointer
@@ -68,6 +85,11 @@ namespace pegasus
     Action::ItrType RvzcmpInsts::pushHandler_(pegasus::PegasusState* state,
                                               Action::ItrType action_it)
     {
+        if (SPARTA_EXPECT_FALSE(!canAccessStackInParallel_<XLEN, true>(state)))
+        {
+            return state->endParallelWindow();
+        }
+
         const PegasusInstPtr & inst = state->getCurrentInst();
 
         // Store RA (1) and 0-12 saved registers (8-9, 18-27) to the stack frame
@@ -96,6 +118,11 @@ namespace pegasus
     Action::ItrType RvzcmpInsts::popHandler_(pegasus::PegasusState* state,
                                              Action::ItrType action_it)
     {
+        if (SPARTA_EXPECT_FALSE(!canAccessStackInParallel_<XLEN, false>(state)))
+        {
+            return state->endParallelWindow();
+        }
+
         pop_<XLEN>(state);
         return ++action_it;
     }
@@ -104,6 +131,11 @@ namespace pegasus
     Action::ItrType RvzcmpInsts::popretHandler_(pegasus::PegasusState* state,
                                                 Action::ItrType action_it)
     {
+        if (SPARTA_EXPECT_FALSE(!canAccessStackInParallel_<XLEN, false>(state)))
+        {
+            return state->endParallelWindow();
+        }
+
         pop_<XLEN>(state);
 
         // Set PC to RA (1)
@@ -117,6 +149,11 @@ namespace pegasus
     Action::ItrType RvzcmpInsts::popretzHandler_(pegasus::PegasusState* state,
                                                  Action::ItrType action_it)
     {
+        if (SPARTA_EXPECT_FALSE(!canAccessStackInParallel_<XLEN, false>(state)))
+        {
+            return state->endParallelWindow();
+        }
+
         pop_<XLEN>(state);
 
         // Set PC to RA (1)
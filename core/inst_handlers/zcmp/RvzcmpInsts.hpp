@@ -17,6 +17,11 @@ namespace pegasus
         // Pop implementation
         template <typename XLEN> void pop_(pegasus::PegasusState* state);
 
+        // Whether the stack frame can be accessed in a parallel window, see
+        // PegasusState::canAccessInParallel()
+        template <typename XLEN, bool IS_PUSH>
+        bool canAccessStackInParallel_(pegasus::PegasusState* state);
+
         // cm.push
         template <typename XLEN>
         Action::ItrType pushHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
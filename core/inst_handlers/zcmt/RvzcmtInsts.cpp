@@ -89,12 +89,13 @@ namespace pegasus
 
         // Load jump address
         const auto & result = inst->getTranslationState()->getResult();
-        std::vector<uint8_t> buffer;
-        if (state->readMemory<XLEN>(result, buffer, MemAccessSource::INSTRUCTION) == false)
+        const std::optional<XLEN> mem_val =
+            state->readMemory<XLEN>(result, MemAccessSource::INSTRUCTION);
+        if (!mem_val)
         {
             THROW_LOAD_ACCESS;
         }
-        const XLEN jump_target = convertFromByteVector<XLEN>(buffer) & ~0x1;
+        const XLEN jump_target = *mem_val & ~0x1;
         inst->getTranslationState()->popResult();
 
         // Jump
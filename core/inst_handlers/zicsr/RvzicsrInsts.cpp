@@ -81,6 +81,12 @@ namespace pegasus
                                               XLEN, translate_types::TranslationStage::SUPERVISOR>,
                                           RvzicsrInsts>(nullptr, "satpUpdate"));
 
+        // Virtual Supervisor Trap Setup
+        csrUpdate_actions.emplace(
+            VSSTATUS,
+            pegasus::Action::createAction<&RvzicsrInsts::vsstatusUpdateHandler_<XLEN>,
+                                          RvzicsrInsts>(nullptr, "vsstatusUpdate"));
+
         // Virtual Supervisor Protection and Translation
         csrUpdate_actions.emplace(
             VSATP, pegasus::Action::createAction<
@@ -91,9 +97,8 @@ namespace pegasus
         // Guest Supervisor Protection and Translation
         csrUpdate_actions.emplace(
             HGATP,
-            pegasus::Action::createAction<
-                &RvzicsrInsts::atpUpdateHandler_<XLEN, translate_types::TranslationStage::GUEST>,
-                RvzicsrInsts>(nullptr, "hgatpUpdate"));
+            pegasus::Action::createAction<&RvzicsrInsts::hgatpUpdateHandler_<XLEN>, RvzicsrInsts>(
+                nullptr, "hgatpUpdate"));
 
         // Machine Trap Setup
         csrUpdate_actions.emplace(
@@ -113,11 +118,47 @@ namespace pegasus
         csrUpdate_actions.emplace(
             VSTVEC, pegasus::Action::createAction<&RvzicsrInsts::tvecUpdateHandler_<XLEN, VSTVEC>,
                                                   RvzicsrInsts>(nullptr, "vstvecUpdate"));
+
+        // Interrupts
+        csrUpdate_actions.emplace(
+            MIE, pegasus::Action::createAction<&RvzicsrInsts::interruptUpdateHandler_<XLEN, MIE>,
+                                               RvzicsrInsts>(nullptr, "mieUpdate"));
+        csrUpdate_actions.emplace(
+            SIE, pegasus::Action::createAction<&RvzicsrInsts::interruptUpdateHandler_<XLEN, SIE>,
+                                               RvzicsrInsts>(nullptr, "sieUpdate"));
+        csrUpdate_actions.emplace(
+            MIP, pegasus::Action::createAction<&RvzicsrInsts::interruptUpdateHandler_<XLEN, MIP>,
+                                               RvzicsrInsts>(nullptr, "mipUpdate"));
+        csrUpdate_actions.emplace(
+            SIP, pegasus::Action::createAction<&RvzicsrInsts::interruptUpdateHandler_<XLEN, SIP>,
+                                               RvzicsrInsts>(nullptr, "sipUpdate"));
+        csrUpdate_actions.emplace(
+            MIDELEG,
+            pegasus::Action::createAction<&RvzicsrInsts::interruptUpdateHandler_<XLEN, MIDELEG>,
+                                          RvzicsrInsts>(nullptr, "midelegUpdate"));
     }
 
     template void RvzicsrInsts::getCsrUpdateActions<RV32>(InstHandlers::CsrUpdateActionsMap &);
     template void RvzicsrInsts::getCsrUpdateActions<RV64>(InstHandlers::CsrUpdateActionsMap &);
 
+    template <typename XLEN>
+    void RvzicsrInsts::getCsrReadActions(InstHandlers::CsrReadActionsMap & csrRead_actions)
+    {
+        // The counters are brought up to date before they are read or written. MCOUNTINHIBIT is
+        // included so that the counts before an inhibit bit changes are not lost.
+        for (const uint32_t csr : {CYCLE, TIME, INSTRET, CYCLEH, TIMEH, INSTRETH, MCYCLE,
+                                   MINSTRET, MCYCLEH, MINSTRETH, MCOUNTINHIBIT})
+        {
+            csrRead_actions.emplace(
+                csr,
+                pegasus::Action::createAction<&RvzicsrInsts::counterReadHandler_<XLEN>,
+                                              RvzicsrInsts>(nullptr, "counterRead"));
+        }
+    }
+
+    template void RvzicsrInsts::getCsrReadActions<RV32>(InstHandlers::CsrReadActionsMap &);
+    template void RvzicsrInsts::getCsrReadActions<RV64>(InstHandlers::CsrReadActionsMap &);
+
     template <typename XLEN>
     Action::ItrType RvzicsrInsts::csrrcHandler_(pegasus::PegasusState* state,
                                                 Action::ItrType action_it)
@@ -322,23 +363,23 @@ namespace pegasus
                                                      Action::ItrType action_it)
     {
         // FFLAGS
-        const XLEN nx_val = READ_CSR_FIELD<XLEN>(state, FCSR, "NX");
-        WRITE_CSR_FIELD<XLEN>(state, FFLAGS, "NX", nx_val);
+        const XLEN nx_val = READ_CSR_FIELD<XLEN, FCSR, "NX">(state);
+        WRITE_CSR_FIELD<XLEN, FFLAGS, "NX">(state, nx_val);
 
-        const XLEN uf_val = READ_CSR_FIELD<XLEN>(state, FCSR, "UF");
-        WRITE_CSR_FIELD<XLEN>(state, FFLAGS, "UF", uf_val);
+        const XLEN uf_val = READ_CSR_FIELD<XLEN, FCSR, "UF">(state);
+        WRITE_CSR_FIELD<XLEN, FFLAGS, "UF">(state, uf_val);
 
-        const XLEN of_val = READ_CSR_FIELD<XLEN>(state, FCSR, "OF");
-        WRITE_CSR_FIELD<XLEN>(state, FFLAGS, "OF", of_val);
+        const XLEN of_val = READ_CSR_FIELD<XLEN, FCSR, "OF">(state);
+        WRITE_CSR_FIELD<XLEN, FFLAGS, "OF">(state, of_val);
 
-        const XLEN dz_val = READ_CSR_FIELD<XLEN>(state, FCSR, "DZ");
-        WRITE_CSR_FIELD<XLEN>(state, FFLAGS, "DZ", dz_val);
+        const XLEN dz_val = READ_CSR_FIELD<XLEN, FCSR, "DZ">(state);
+        WRITE_CSR_FIELD<XLEN, FFLAGS, "DZ">(state, dz_val);
 
-        const XLEN nv_val = READ_CSR_FIELD<XLEN>(state, FCSR, "NV");
-        WRITE_CSR_FIELD<XLEN>(state, FFLAGS, "NV", nv_val);
+        const XLEN nv_val = READ_CSR_FIELD<XLEN, FCSR, "NV">(state);
+        WRITE_CSR_FIELD<XLEN, FFLAGS, "NV">(state, nv_val);
 
         // FRM
-        const XLEN frm_val = READ_CSR_FIELD<XLEN>(state, FCSR, "frm");
+        const XLEN frm_val = READ_CSR_FIELD<XLEN, FCSR, "frm">(state);
         WRITE_CSR_REG<XLEN>(state, FRM, frm_val);
 
         set_softfloat_excpetionFlags<XLEN>(state);
@@ -351,20 +392,20 @@ namespace pegasus
                                                        Action::ItrType action_it)
     {
         // FCSR
-        const XLEN nx_val = READ_CSR_FIELD<XLEN>(state, FFLAGS, "NX");
-        WRITE_CSR_FIELD<XLEN>(state, FCSR, "NX", nx_val);
+        const XLEN nx_val = READ_CSR_FIELD<XLEN, FFLAGS, "NX">(state);
+        WRITE_CSR_FIELD<XLEN, FCSR, "NX">(state, nx_val);
 
-        const XLEN uf_val = READ_CSR_FIELD<XLEN>(state, FFLAGS, "UF");
-        WRITE_CSR_FIELD<XLEN>(state, FCSR, "UF", uf_val);
+        const XLEN uf_val = READ_CSR_FIELD<XLEN, FFLAGS, "UF">(state);
+        WRITE_CSR_FIELD<XLEN, FCSR, "UF">(state, uf_val);
 
-        const XLEN of_val = READ_CSR_FIELD<XLEN>(state, FFLAGS, "OF");
-        WRITE_CSR_FIELD<XLEN>(state, FCSR, "OF", of_val);
+        const XLEN of_val = READ_CSR_FIELD<XLEN, FFLAGS, "OF">(state);
+        WRITE_CSR_FIELD<XLEN, FCSR, "OF">(state, of_val);
 
-        const XLEN dz_val = READ_CSR_FIELD<XLEN>(state, FFLAGS, "DZ");
-        WRITE_CSR_FIELD<XLEN>(state, FCSR, "DZ", dz_val);
+        const XLEN dz_val = READ_CSR_FIELD<XLEN, FFLAGS, "DZ">(state);
+        WRITE_CSR_FIELD<XLEN, FCSR, "DZ">(state, dz_val);
 
-        const XLEN nv_val = READ_CSR_FIELD<XLEN>(state, FFLAGS, "NV");
-        WRITE_CSR_FIELD<XLEN>(state, FCSR, "NV", nv_val);
+        const XLEN nv_val = READ_CSR_FIELD<XLEN, FFLAGS, "NV">(state);
+        WRITE_CSR_FIELD<XLEN, FCSR, "NV">(state, nv_val);
 
         set_softfloat_excpetionFlags<XLEN>(state);
 
@@ -376,7 +417,7 @@ namespace pegasus
     {
         // FCSR
         const XLEN frm_val = READ_CSR_REG<XLEN>(state, FRM);
-        WRITE_CSR_FIELD<XLEN>(state, FCSR, "frm", frm_val);
+        WRITE_CSR_FIELD<XLEN, FCSR, "frm">(state, frm_val);
 
         return ++action_it;
     }
@@ -386,41 +427,41 @@ namespace pegasus
                                                         Action::ItrType action_it)
     {
         // Update shared fields only
-        const XLEN sie_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "sie");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "sie", sie_val);
+        const XLEN sie_val = READ_CSR_FIELD<XLEN, SSTATUS, "sie">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "sie">(state, sie_val);
 
-        const XLEN spie_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "spie");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "spie", spie_val);
+        const XLEN spie_val = READ_CSR_FIELD<XLEN, SSTATUS, "spie">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "spie">(state, spie_val);
 
-        const XLEN ube_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "ube");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "ube", ube_val);
+        const XLEN ube_val = READ_CSR_FIELD<XLEN, SSTATUS, "ube">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "ube">(state, ube_val);
 
-        const XLEN spp_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "spp");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "spp", spp_val);
+        const XLEN spp_val = READ_CSR_FIELD<XLEN, SSTATUS, "spp">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "spp">(state, spp_val);
 
-        const XLEN vs_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "vs");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "vs", vs_val);
+        const XLEN vs_val = READ_CSR_FIELD<XLEN, SSTATUS, "vs">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "vs">(state, vs_val);
 
-        const XLEN fs_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "fs");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "fs", fs_val);
+        const XLEN fs_val = READ_CSR_FIELD<XLEN, SSTATUS, "fs">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "fs">(state, fs_val);
 
-        const XLEN xs_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "xs");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "xs", xs_val);
+        const XLEN xs_val = READ_CSR_FIELD<XLEN, SSTATUS, "xs">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "xs">(state, xs_val);
 
-        const XLEN sum_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "sum");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "sum", sum_val);
+        const XLEN sum_val = READ_CSR_FIELD<XLEN, SSTATUS, "sum">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "sum">(state, sum_val);
 
-        const XLEN mxr_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "mxr");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "mxr", mxr_val);
+        const XLEN mxr_val = READ_CSR_FIELD<XLEN, SSTATUS, "mxr">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "mxr">(state, mxr_val);
 
         if constexpr (std::is_same_v<XLEN, RV64>)
         {
-            const XLEN uxl_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "uxl");
-            WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "uxl", uxl_val);
+            const XLEN uxl_val = READ_CSR_FIELD<XLEN, SSTATUS, "uxl">(state);
+            WRITE_CSR_FIELD<XLEN, MSTATUS, "uxl">(state, uxl_val);
         }
 
-        const XLEN sd_val = READ_CSR_FIELD<XLEN>(state, SSTATUS, "sd");
-        WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "sd", sd_val);
+        const XLEN sd_val = READ_CSR_FIELD<XLEN, SSTATUS, "sd">(state);
+        WRITE_CSR_FIELD<XLEN, MSTATUS, "sd">(state, sd_val);
 
         return mstatusUpdateHandler_<XLEN>(state, action_it);
     }
@@ -433,6 +474,25 @@ namespace pegasus
         return ++action_it;
     }
 
+    template <typename XLEN>
+    Action::ItrType RvzicsrInsts::vsstatusUpdateHandler_(pegasus::PegasusState* state,
+                                                         Action::ItrType action_it)
+    {
+        // VSSTATUS.SUM and VSSTATUS.MXR are part of the VS-stage translation context
+        state->updateTranslationMode<XLEN>(translate_types::TranslationStage::VIRTUAL_SUPERVISOR);
+        return ++action_it;
+    }
+
+    template <typename XLEN>
+    Action::ItrType RvzicsrInsts::hgatpUpdateHandler_(pegasus::PegasusState* state,
+                                                      Action::ItrType action_it)
+    {
+        // The VMID is part of the VS-stage translation context too
+        state->updateTranslationMode<XLEN>(translate_types::TranslationStage::VIRTUAL_SUPERVISOR);
+        state->updateTranslationMode<XLEN>(translate_types::TranslationStage::GUEST);
+        return ++action_it;
+    }
+
     template <typename XLEN>
     Action::ItrType RvzicsrInsts::mstatusUpdateHandler_(pegasus::PegasusState* state,
                                                         Action::ItrType action_it)
@@ -455,14 +515,14 @@ namespace pegasus
 
         if (mstatus_val & mstatus_fast_check_mask)
         {
-            WRITE_CSR_FIELD<XLEN>(state, MSTATUS, "sd", 0b1);
+            WRITE_CSR_FIELD<XLEN, MSTATUS, "sd">(state, 0b1);
         }
 
         auto & ext_manager = state->getExtensionManager();
         bool change_mavis_ctx = false;
 
         // If FS is set to 0 (off), all floating point extensions are disabled
-        const uint32_t fs_val = READ_CSR_FIELD<XLEN>(state, MSTATUS, "fs");
+        const uint32_t fs_val = READ_CSR_FIELD<XLEN, MSTATUS, "fs">(state);
         if (fs_val == 0)
         {
             std::vector<std::string> disabled_exts;
@@ -480,14 +540,14 @@ namespace pegasus
         else
         {
             std::vector<std::string> enabled_exts;
-            if (READ_CSR_FIELD<XLEN>(state, MISA, "f") == 0x1)
+            if (READ_CSR_FIELD<XLEN, MISA, "f">(state) == 0x1)
             {
                 if (!ext_manager.isEnabled("f"))
                 {
                     enabled_exts.emplace_back("f");
                 }
             }
-            if (READ_CSR_FIELD<XLEN>(state, MISA, "d") == 0x1)
+            if (READ_CSR_FIELD<XLEN, MISA, "d">(state) == 0x1)
             {
                 if (!ext_manager.isEnabled("d"))
                 {
@@ -508,6 +568,56 @@ namespace pegasus
         state->updateTranslationMode<XLEN>(translate_types::TranslationStage::VIRTUAL_SUPERVISOR);
         state->updateTranslationMode<XLEN>(translate_types::TranslationStage::GUEST);
 
+        // The MIE and SIE fields enable interrupts
+        state->requestInterruptCheck();
+
+        return ++action_it;
+    }
+
+    template <typename XLEN, uint32_t CSR_ADDR>
+    Action::ItrType RvzicsrInsts::interruptUpdateHandler_(pegasus::PegasusState* state,
+                                                          Action::ItrType action_it)
+    {
+        // SIE and SIP are the supervisor-level views of MIE and MIP. Only the interrupts
+        // delegated to S-mode by MIDELEG are visible in them.
+        constexpr XLEN S_INTERRUPTS = (XLEN(1) << 1) | (XLEN(1) << 5) | (XLEN(1) << 9);
+        constexpr XLEN SSIP = XLEN(1) << 1;
+        const XLEN s_mask = PEEK_CSR_REG<XLEN>(state, MIDELEG) & S_INTERRUPTS;
+        XLEN mie_val = PEEK_CSR_REG<XLEN>(state, MIE);
+        XLEN mip_val = PEEK_CSR_REG<XLEN>(state, MIP);
+        if constexpr (CSR_ADDR == SIE)
+        {
+            const XLEN sie_val = PEEK_CSR_REG<XLEN>(state, SIE);
+            mie_val = (mie_val & ~s_mask) | (sie_val & s_mask);
+            POKE_CSR_REG<XLEN>(state, MIE, mie_val);
+        }
+        else if constexpr (CSR_ADDR == SIP)
+        {
+            // Only SSIP is writable from S-mode
+            const XLEN sip_val = PEEK_CSR_REG<XLEN>(state, SIP);
+            mip_val = (mip_val & ~(SSIP & s_mask)) | (sip_val & SSIP & s_mask);
+            POKE_CSR_REG<XLEN>(state, MIP, mip_val);
+        }
+
+        // A MIDELEG write changes which bits of both views are visible
+        if constexpr ((CSR_ADDR == MIE) || (CSR_ADDR == SIE) || (CSR_ADDR == MIDELEG))
+        {
+            POKE_CSR_REG<XLEN>(state, SIE, mie_val & s_mask);
+        }
+        if constexpr ((CSR_ADDR == MIP) || (CSR_ADDR == SIP) || (CSR_ADDR == MIDELEG))
+        {
+            POKE_CSR_REG<XLEN>(state, SIP, mip_val & s_mask);
+        }
+
+        state->requestInterruptCheck();
+        return ++action_it;
+    }
+
+    template <typename XLEN>
+    Action::ItrType RvzicsrInsts::counterReadHandler_(pegasus::PegasusState* state,
+                                                      Action::ItrType action_it)
+    {
+        state->syncCounterCsrs();
         return ++action_it;
     }
 
@@ -541,7 +651,7 @@ namespace pegasus
                     // misalignment exception. Check if the next PC is not 32-bit aligned.
                     if ((ext == 'c') && ((state->getNextPc() & 0x3) != 0))
                     {
-                        WRITE_CSR_FIELD<XLEN>(state, MISA, "c", 0x1);
+                        WRITE_CSR_FIELD<XLEN, MISA, "c">(state, 0x1);
                     }
                     else
                     {
@@ -591,10 +701,10 @@ namespace pegasus
                                                      Action::ItrType action_it)
     {
         const TrapVectorMode mode_val =
-            (TrapVectorMode)READ_CSR_FIELD<XLEN>(state, TVEC_CSR_ADDR, "mode");
+            (TrapVectorMode)READ_CSR_FIELD<XLEN, TVEC_CSR_ADDR, "mode">(state);
         if (!state->getCore()->isTrapModeSupported(mode_val))
         {
-            WRITE_CSR_FIELD<XLEN>(state, TVEC_CSR_ADDR, "mode", 0);
+            WRITE_CSR_FIELD<XLEN, TVEC_CSR_ADDR, "mode">(state, 0);
         }
 
         return ++action_it;
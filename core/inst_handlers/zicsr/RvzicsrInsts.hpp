@@ -17,6 +17,9 @@ namespace pegasus
         template <typename XLEN>
         static void getCsrUpdateActions(InstHandlers::CsrUpdateActionsMap &);
 
+        template <typename XLEN>
+        static void getCsrReadActions(InstHandlers::CsrReadActionsMap &);
+
       private:
         template <typename XLEN>
         Action::ItrType csrrcHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
@@ -44,8 +47,15 @@ namespace pegasus
         Action::ItrType sstatusUpdateHandler_(pegasus::PegasusState* state,
                                               Action::ItrType action_it);
 
+        template <typename XLEN>
+        Action::ItrType vsstatusUpdateHandler_(pegasus::PegasusState* state,
+                                               Action::ItrType action_it);
+
         template <typename XLEN, translate_types::TranslationStage TYPE>
         Action::ItrType atpUpdateHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
+        template <typename XLEN>
+        Action::ItrType hgatpUpdateHandler_(pegasus::PegasusState* state,
+                                            Action::ItrType action_it);
 
         template <typename XLEN>
         Action::ItrType mstatusUpdateHandler_(pegasus::PegasusState* state,
@@ -55,5 +65,13 @@ namespace pegasus
 
         template <typename XLEN, uint32_t TVEC_CSR_ADDR>
         Action::ItrType tvecUpdateHandler_(pegasus::PegasusState* state, Action::ItrType action_it);
+
+        template <typename XLEN, uint32_t CSR_ADDR>
+        Action::ItrType interruptUpdateHandler_(pegasus::PegasusState* state,
+                                                Action::ItrType action_it);
+
+        template <typename XLEN>
+        Action::ItrType counterReadHandler_(pegasus::PegasusState* state,
+                                            Action::ItrType action_it);
     };
 } // namespace pegasus
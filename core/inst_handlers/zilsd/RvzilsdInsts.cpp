@@ -61,12 +61,13 @@ namespace pegasus
         PegasusTranslationState* translation_state = inst->getTranslationState();
 
         const auto & result = translation_state->getResult();
-        std::vector<uint8_t> buffer;
-        if (state->readMemory<uint64_t>(result, buffer, MemAccessSource::INSTRUCTION) == false)
+        const std::optional<uint64_t> mem_val =
+            state->readMemory<uint64_t>(result, MemAccessSource::INSTRUCTION);
+        if (!mem_val)
         {
             THROW_LOAD_ACCESS;
         }
-        const uint64_t val = convertFromByteVector<uint64_t>(buffer);
+        const uint64_t val = *mem_val;
         translation_state->popResult();
 
         // Write bits 31:0 to the lower-numbered register
@@ -1,5 +1,7 @@
 #include "core/inst_handlers/zvkned/RvzvknedInsts.hpp"
-#include "core/inst_handlers/i/RviInsts.hpp"
+#include "core/inst_handlers/vcrypto_helpers.hpp"
+#include "core/PegasusState.hpp"
+#include "core/Trap.hpp"
 #include "include/ActionTags.hpp"
 
 namespace pegasus
@@ -9,31 +11,103 @@ namespace pegasus
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
-        (void)inst_handlers;
-        // inst_handlers.emplace("vaesdf_vs", pegasus::Action::createAction<&RvzvknedInsts::,
-        // RvzvknedInsts>("vaesdf_vs", ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesdf_vv",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesdf_vv",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesdm_vs",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesdm_vs",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesdm_vv",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesdm_vv",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesef_vs",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesef_vs",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesef_vv",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesef_vv",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesem_vs",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesem_vs",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesem_vv",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesem_vv",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaeskf1_vi",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaeskf1_vi",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaeskf2_vi",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaeskf2_vi",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vaesz_vs",
-        // pegasus::Action::createAction<&RvzvknedInsts::, RvzvknedInsts>("vaesz_vs",
-        // ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesdf.vs",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesdf, true>,
+                RvzvknedInsts>(nullptr, "vaesdf.vs", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesdf.vv",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesdf, false>,
+                RvzvknedInsts>(nullptr, "vaesdf.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesdm.vs",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesdm, true>,
+                RvzvknedInsts>(nullptr, "vaesdm.vs", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesdm.vv",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesdm, false>,
+                RvzvknedInsts>(nullptr, "vaesdm.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesef.vs",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesef, true>,
+                RvzvknedInsts>(nullptr, "vaesef.vs", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesef.vv",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesef, false>,
+                RvzvknedInsts>(nullptr, "vaesef.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesem.vs",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesem, true>,
+                RvzvknedInsts>(nullptr, "vaesem.vs", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesem.vv",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesem, false>,
+                RvzvknedInsts>(nullptr, "vaesem.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaeskf1.vi",
+            Action::createAction<&RvzvknedInsts::vaesKeyHandler_<XLEN, &VecCryptoEngine::aeskf1>,
+                                 RvzvknedInsts>(nullptr, "vaeskf1.vi", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaeskf2.vi",
+            Action::createAction<&RvzvknedInsts::vaesKeyHandler_<XLEN, &VecCryptoEngine::aeskf2>,
+                                 RvzvknedInsts>(nullptr, "vaeskf2.vi", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vaesz.vs",
+            Action::createAction<
+                &RvzvknedInsts::vaesRoundHandler_<XLEN, &VecCryptoEngine::aesz, true>,
+                RvzvknedInsts>(nullptr, "vaesz.vs", ActionTags::EXECUTE_TAG));
     }
 
     template void RvzvknedInsts::getInstHandlers<RV32>(InstHandlers::InstHandlersMap &);
     template void RvzvknedInsts::getInstHandlers<RV64>(InstHandlers::InstHandlersMap &);
+
+    // EGW=128: four 32-bit elements per element group
+    static constexpr size_t AES_SEW = 32;
+    static constexpr size_t AES_EGS = 4;
+
+    template <typename XLEN, auto ENGINE_FUNC, bool VS_FORM>
+    Action::ItrType RvzvknedInsts::vaesRoundHandler_(PegasusState* state,
+                                                     Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        if (!vcrypto::isLegal(inst->getVectorConfig(), AES_SEW, AES_EGS, inst->getRd(),
+                              inst->getRs2(), VS_FORM))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        vcrypto::execute<AES_EGS, VS_FORM, false>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t*, size_t num_egs,
+                       size_t key_stride) { (engine.*ENGINE_FUNC)(vd, vs2, num_egs, key_stride); });
+
+        return ++action_it;
+    }
+
+    template <typename XLEN, auto ENGINE_FUNC>
+    Action::ItrType RvzvknedInsts::vaesKeyHandler_(PegasusState* state, Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        if (!vcrypto::isLegal(inst->getVectorConfig(), AES_SEW, AES_EGS, inst->getRd(),
+                              inst->getRs2(), false))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        const uint32_t uimm = inst->getImmediate();
+        vcrypto::execute<AES_EGS, false, false>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t*, size_t num_egs, size_t)
+            { (engine.*ENGINE_FUNC)(vd, vs2, num_egs, uimm); });
+
+        return ++action_it;
+    }
 } // namespace pegasus
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Action.hpp"
 #include "core/InstHandlers.hpp"
 
 namespace pegasus
@@ -12,5 +13,14 @@ namespace pegasus
         using base_type = RvzvknedInsts;
 
         template <typename XLEN> static void getInstHandlers(InstHandlers::InstHandlersMap &);
+
+      private:
+        // AES round, ENGINE_FUNC is a VecCryptoEngine member
+        template <typename XLEN, auto ENGINE_FUNC, bool VS_FORM>
+        Action::ItrType vaesRoundHandler_(PegasusState* state, Action::ItrType action_it);
+
+        // AES-128/AES-256 forward key schedule
+        template <typename XLEN, auto ENGINE_FUNC>
+        Action::ItrType vaesKeyHandler_(PegasusState* state, Action::ItrType action_it);
     };
 } // namespace pegasus
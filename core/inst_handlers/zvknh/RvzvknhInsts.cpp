@@ -1,5 +1,7 @@
 #include "core/inst_handlers/zvknh/RvzvknhInsts.hpp"
-#include "core/inst_handlers/i/RviInsts.hpp"
+#include "core/inst_handlers/vcrypto_helpers.hpp"
+#include "core/PegasusState.hpp"
+#include "core/Trap.hpp"
 #include "include/ActionTags.hpp"
 
 namespace pegasus
@@ -9,15 +11,46 @@ namespace pegasus
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
-        (void)inst_handlers;
-        // inst_handlers.emplace("vsha2ch_vv", pegasus::Action::createAction<&RvzvknhInsts::,
-        // RvzvknhInsts>("vsha2ch_vv", ActionTags::EXECUTE_TAG));
-        // inst_handlers.emplace("vsha2cl_vv", pegasus::Action::createAction<&RvzvknhInsts::,
-        // RvzvknhInsts>("vsha2cl_vv", ActionTags::EXECUTE_TAG));
-        // inst_handlers.emplace("vsha2ms_vv", pegasus::Action::createAction<&RvzvknhInsts::,
-        // RvzvknhInsts>("vsha2ms_vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsha2ch.vv",
+            Action::createAction<&RvzvknhInsts::vsha2Handler_<XLEN, &VecCryptoEngine::sha256ch,
+                                                              &VecCryptoEngine::sha512ch>,
+                                 RvzvknhInsts>(nullptr, "vsha2ch.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsha2cl.vv",
+            Action::createAction<&RvzvknhInsts::vsha2Handler_<XLEN, &VecCryptoEngine::sha256cl,
+                                                              &VecCryptoEngine::sha512cl>,
+                                 RvzvknhInsts>(nullptr, "vsha2cl.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsha2ms.vv",
+            Action::createAction<&RvzvknhInsts::vsha2Handler_<XLEN, &VecCryptoEngine::sha256ms,
+                                                              &VecCryptoEngine::sha512ms>,
+                                 RvzvknhInsts>(nullptr, "vsha2ms.vv", ActionTags::EXECUTE_TAG));
     }
 
     template void RvzvknhInsts::getInstHandlers<RV32>(InstHandlers::InstHandlersMap &);
     template void RvzvknhInsts::getInstHandlers<RV64>(InstHandlers::InstHandlersMap &);
+
+    template <typename XLEN, auto SHA256_FUNC, auto SHA512_FUNC>
+    Action::ItrType RvzvknhInsts::vsha2Handler_(PegasusState* state, Action::ItrType action_it)
+    {
+        static constexpr size_t SHA2_EGS = 4;
+
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        const VectorConfig* config = inst->getVectorConfig();
+        const size_t sew = config->getSEW();
+        if (((sew != 32) && (sew != 64))
+            || !vcrypto::isLegal(config, sew, SHA2_EGS, inst->getRd(), inst->getRs2(), false))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        const auto func = (sew == 32) ? engine.*SHA256_FUNC : engine.*SHA512_FUNC;
+        vcrypto::execute<SHA2_EGS, false, true>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t* vs1, size_t num_egs, size_t)
+            { func(vd, vs2, vs1, num_egs); });
+
+        return ++action_it;
+    }
 } // namespace pegasus
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Action.hpp"
 #include "core/InstHandlers.hpp"
 
 namespace pegasus
@@ -12,5 +13,11 @@ namespace pegasus
         using base_type = RvzvknhInsts;
 
         template <typename XLEN> static void getInstHandlers(InstHandlers::InstHandlersMap &);
+
+      private:
+        // SHA-2 compression or message schedule. SEW=32 is SHA-256 (Zvknha), SEW=64 is SHA-512
+        // (Zvknhb).
+        template <typename XLEN, auto SHA256_FUNC, auto SHA512_FUNC>
+        Action::ItrType vsha2Handler_(PegasusState* state, Action::ItrType action_it);
     };
 } // namespace pegasus
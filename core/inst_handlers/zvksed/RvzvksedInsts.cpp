@@ -1,5 +1,7 @@
 #include "core/inst_handlers/zvksed/RvzvksedInsts.hpp"
-#include "core/inst_handlers/i/RviInsts.hpp"
+#include "core/inst_handlers/vcrypto_helpers.hpp"
+#include "core/PegasusState.hpp"
+#include "core/Trap.hpp"
 #include "include/ActionTags.hpp"
 
 namespace pegasus
@@ -9,15 +11,61 @@ namespace pegasus
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
-        (void)inst_handlers;
-        // inst_handlers.emplace("vsm4k_vi", pegasus::Action::createAction<&RvzvksedInsts::,
-        // RvzvksedInsts>("vsm4k_vi", ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vsm4r_vv",
-        // pegasus::Action::createAction<&RvzvksedInsts::, RvzvksedInsts>("vsm4r_vv",
-        // ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vsm4r_vs",
-        // pegasus::Action::createAction<&RvzvksedInsts::, RvzvksedInsts>("vsm4r_vs",
-        // ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsm4k.vi",
+            Action::createAction<&RvzvksedInsts::vsm4kHandler_<XLEN>, RvzvksedInsts>(
+                nullptr, "vsm4k.vi", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsm4r.vv",
+            Action::createAction<&RvzvksedInsts::vsm4rHandler_<XLEN, false>, RvzvksedInsts>(
+                nullptr, "vsm4r.vv", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsm4r.vs",
+            Action::createAction<&RvzvksedInsts::vsm4rHandler_<XLEN, true>, RvzvksedInsts>(
+                nullptr, "vsm4r.vs", ActionTags::EXECUTE_TAG));
     }
 
     template void RvzvksedInsts::getInstHandlers<RV32>(InstHandlers::InstHandlersMap &);
     template void RvzvksedInsts::getInstHandlers<RV64>(InstHandlers::InstHandlersMap &);
+
+    // EGW=128: four 32-bit elements per element group
+    static constexpr size_t SM4_SEW = 32;
+    static constexpr size_t SM4_EGS = 4;
+
+    template <typename XLEN>
+    Action::ItrType RvzvksedInsts::vsm4kHandler_(PegasusState* state, Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        if (!vcrypto::isLegal(inst->getVectorConfig(), SM4_SEW, SM4_EGS, inst->getRd(),
+                              inst->getRs2(), false))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        const uint32_t uimm = inst->getImmediate();
+        vcrypto::execute<SM4_EGS, false, false>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t*, size_t num_egs, size_t)
+            { engine.sm4k(vd, vs2, num_egs, uimm); });
+
+        return ++action_it;
+    }
+
+    template <typename XLEN, bool VS_FORM>
+    Action::ItrType RvzvksedInsts::vsm4rHandler_(PegasusState* state, Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        if (!vcrypto::isLegal(inst->getVectorConfig(), SM4_SEW, SM4_EGS, inst->getRd(),
+                              inst->getRs2(), VS_FORM))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        vcrypto::execute<SM4_EGS, VS_FORM, false>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t*, size_t num_egs,
+                       size_t key_stride) { engine.sm4r(vd, vs2, num_egs, key_stride); });
+
+        return ++action_it;
+    }
 } // namespace pegasus
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Action.hpp"
 #include "core/InstHandlers.hpp"
 
 namespace pegasus
@@ -12,5 +13,14 @@ namespace pegasus
         using base_type = RvzvksedInsts;
 
         template <typename XLEN> static void getInstHandlers(InstHandlers::InstHandlersMap &);
+
+      private:
+        // SM4 key schedule (four round keys)
+        template <typename XLEN>
+        Action::ItrType vsm4kHandler_(PegasusState* state, Action::ItrType action_it);
+
+        // SM4 cipher (four rounds)
+        template <typename XLEN, bool VS_FORM>
+        Action::ItrType vsm4rHandler_(PegasusState* state, Action::ItrType action_it);
     };
 } // namespace pegasus
@@ -1,5 +1,7 @@
 #include "core/inst_handlers/zvksh/RvzvkshInsts.hpp"
-#include "core/inst_handlers/i/RviInsts.hpp"
+#include "core/inst_handlers/vcrypto_helpers.hpp"
+#include "core/PegasusState.hpp"
+#include "core/Trap.hpp"
 #include "include/ActionTags.hpp"
 
 namespace pegasus
@@ -9,13 +11,55 @@ namespace pegasus
     {
         static_assert(std::is_same_v<XLEN, RV64> || std::is_same_v<XLEN, RV32>);
 
-        (void)inst_handlers;
-        // inst_handlers.emplace("vsm3c_vi", pegasus::Action::createAction<&RvzvkshInsts::,
-        // RvzvkshInsts>("vsm3c_vi", ActionTags::EXECUTE_TAG)); inst_handlers.emplace("vsm3me_vv",
-        // pegasus::Action::createAction<&RvzvkshInsts::, RvzvkshInsts>("vsm3me_vv",
-        // ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsm3c.vi", Action::createAction<&RvzvkshInsts::vsm3cHandler_<XLEN>, RvzvkshInsts>(
+                            nullptr, "vsm3c.vi", ActionTags::EXECUTE_TAG));
+        inst_handlers.emplace(
+            "vsm3me.vv", Action::createAction<&RvzvkshInsts::vsm3meHandler_<XLEN>, RvzvkshInsts>(
+                             nullptr, "vsm3me.vv", ActionTags::EXECUTE_TAG));
     }
 
     template void RvzvkshInsts::getInstHandlers<RV32>(InstHandlers::InstHandlersMap &);
     template void RvzvkshInsts::getInstHandlers<RV64>(InstHandlers::InstHandlersMap &);
+
+    // EGW=256: eight 32-bit elements per element group
+    static constexpr size_t SM3_SEW = 32;
+    static constexpr size_t SM3_EGS = 8;
+
+    template <typename XLEN>
+    Action::ItrType RvzvkshInsts::vsm3cHandler_(PegasusState* state, Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        if (!vcrypto::isLegal(inst->getVectorConfig(), SM3_SEW, SM3_EGS, inst->getRd(),
+                              inst->getRs2(), false))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        const uint32_t uimm = inst->getImmediate();
+        vcrypto::execute<SM3_EGS, false, false>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t*, size_t num_egs, size_t)
+            { engine.sm3c(vd, vs2, num_egs, uimm); });
+
+        return ++action_it;
+    }
+
+    template <typename XLEN>
+    Action::ItrType RvzvkshInsts::vsm3meHandler_(PegasusState* state, Action::ItrType action_it)
+    {
+        const PegasusInstPtr & inst = state->getCurrentInst();
+        if (!vcrypto::isLegal(inst->getVectorConfig(), SM3_SEW, SM3_EGS, inst->getRd(),
+                              inst->getRs2(), false))
+        {
+            THROW_ILLEGAL_INST;
+        }
+
+        const VecCryptoEngine & engine = state->getVecCryptoEngine();
+        vcrypto::execute<SM3_EGS, false, true>(
+            state, [&](uint8_t* vd, const uint8_t* vs2, const uint8_t* vs1, size_t num_egs, size_t)
+            { engine.sm3me(vd, vs2, vs1, num_egs); });
+
+        return ++action_it;
+    }
 } // namespace pegasus
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Action.hpp"
 #include "core/InstHandlers.hpp"
 
 namespace pegasus
@@ -12,5 +13,14 @@ namespace pegasus
         using base_type = RvzvkshInsts;
 
         template <typename XLEN> static void getInstHandlers(InstHandlers::InstHandlersMap &);
+
+      private:
+        // SM3 compression (two rounds)
+        template <typename XLEN>
+        Action::ItrType vsm3cHandler_(PegasusState* state, Action::ItrType action_it);
+
+        // SM3 message expansion (eight words)
+        template <typename XLEN>
+        Action::ItrType vsm3meHandler_(PegasusState* state, Action::ItrType action_it);
     };
 } // namespace pegasus
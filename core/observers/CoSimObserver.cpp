@@ -184,6 +184,8 @@ namespace pegasus::cosim
     {
         auto & last_event = last_event_.getValue();
         sparta_assert(last_event.isDone(), "Last Event is not done yet!");
+        // Checkpoints must hold up to date counter CSRs to be reloaded with the inst count
+        state->syncCounterCsrs();
         last_event.event_uid_ = checkpointer_->getFastCheckpointer().createCheckpoint();
 
         COSIMLOG(last_event);
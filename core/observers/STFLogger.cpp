@@ -8,7 +8,7 @@
 namespace pegasus
 {
     STFLogger::STFLogger(const uint32_t reg_width, uint64_t inital_pc, const std::string & filename,
-                         PegasusState* state) :
+                         size_t buffer_size, PegasusState* state) :
         Observer((reg_width == 32) ? ObserverMode::RV32 : ObserverMode::RV64)
     {
         try
@@ -49,6 +49,9 @@ namespace pegasus
         stf_writer_.setISAExtendedInfo(isa);
         stf_writer_.setHeaderPC(inital_pc);
         stf_writer_.finalizeHeader();
+
+        // The writer thread (if any) owns the STF writer from here on
+        records_ = std::make_unique<STFRecordWriter>(stf_writer_, buffer_size);
         if (state->getXlen() == 32)
         {
             recordRegState_<uint32_t>(state);
@@ -57,6 +60,7 @@ namespace pegasus
         {
             recordRegState_<uint64_t>(state);
         }
+        records_->endInstruction();
     }
 
     template <typename XLEN, typename F>
@@ -67,9 +71,9 @@ namespace pegasus
             const auto stf_reg_type = get_stf_reg_type(src_reg.reg_id.reg_type);
             if (src_reg.reg_id.reg_type != RegType::VECTOR)
             {
-                stf_writer_ << stf::InstRegRecord(src_reg.reg_id.reg_num, stf_reg_type,
-                                                  stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
-                                                  src_reg.reg_value.getValue<XLEN>());
+                records_->addReg(src_reg.reg_id.reg_num, stf_reg_type,
+                                 stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
+                                 src_reg.reg_value.getValue<XLEN>());
             }
             else
             {
@@ -78,25 +82,25 @@ namespace pegasus
                 for (uint32_t i = 0; i < reg_count; ++i)
                 {
                     uint32_t phys = src_reg.reg_id.reg_num + i;
-                    stf_writer_ << stf::InstRegRecord(
-                        phys, stf_reg_type, stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
-                        src_reg.lmul_values[i].getValueVector<uint64_t>());
+                    records_->addVectorReg(phys, stf_reg_type,
+                                           stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
+                                           src_reg.lmul_values[i].getByteVector());
                 }
             }
         }
 
         for (const auto & [csr_num, csr_read] : csr_reads_)
         {
-            stf_writer_ << stf::InstRegRecord(csr_num, stf::Registers::STF_REG_TYPE::CSR,
-                                              stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
-                                              csr_read.template getRegValue<XLEN>());
+            records_->addReg(csr_num, stf::Registers::STF_REG_TYPE::CSR,
+                             stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
+                             csr_read.template getRegValue<XLEN>());
         }
 
         for (const auto & [csr_num, csr_write] : csr_writes_)
         {
-            stf_writer_ << stf::InstRegRecord(csr_num, stf::Registers::STF_REG_TYPE::CSR,
-                                              stf::Registers::STF_REG_OPERAND_TYPE::REG_DEST,
-                                              csr_write.template getRegValue<XLEN>());
+            records_->addReg(csr_num, stf::Registers::STF_REG_TYPE::CSR,
+                             stf::Registers::STF_REG_OPERAND_TYPE::REG_DEST,
+                             csr_write.template getRegValue<XLEN>());
         }
 
         for (const auto & dst_reg : dst_regs_)
@@ -104,9 +108,9 @@ namespace pegasus
             const auto stf_reg_type = get_stf_reg_type(dst_reg.reg_id.reg_type);
             if (dst_reg.reg_id.reg_type != RegType::VECTOR)
             {
-                stf_writer_ << stf::InstRegRecord(dst_reg.reg_id.reg_num, stf_reg_type,
-                                                  stf::Registers::STF_REG_OPERAND_TYPE::REG_DEST,
-                                                  readScalarRegister_<XLEN>(state, dst_reg.reg_id));
+                records_->addReg(dst_reg.reg_id.reg_num, stf_reg_type,
+                                 stf::Registers::STF_REG_OPERAND_TYPE::REG_DEST,
+                                 readScalarRegister_<XLEN>(state, dst_reg.reg_id));
             }
             else
             {
@@ -115,7 +119,7 @@ namespace pegasus
                 for (uint32_t i = 0; i < reg_count; ++i)
                 {
                     uint32_t phys = dst_reg.reg_id.reg_num + i;
-                    stf_writer_ << stf::InstRegRecord(
+                    records_->addVectorReg(
                         phys, stf_reg_type, stf::Registers::STF_REG_OPERAND_TYPE::REG_DEST,
                         readVectorRegister_(
                             state, RegId{RegType::VECTOR, phys, "V" + std::to_string(phys)}));
@@ -128,128 +132,114 @@ namespace pegasus
         {
             if (state->getCurrentInst()->isVectorInstMasked())
             {
-                stf_writer_ << stf::InstRegRecord(
+                records_->addVectorReg(
                     pegasus::V0, stf::Registers::STF_REG_TYPE::VECTOR,
                     stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
                     readVectorRegister_(state, RegId{RegType::VECTOR, pegasus::V0, "V0"}));
             }
 
-            stf_writer_ << stf::InstRegRecord(VL, stf::Registers::STF_REG_TYPE::CSR,
-                                              stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
-                                              READ_CSR_REG<XLEN>(state, VL));
+            records_->addReg(VL, stf::Registers::STF_REG_TYPE::CSR,
+                             stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
+                             READ_CSR_REG<XLEN>(state, VL));
 
-            stf_writer_ << stf::InstRegRecord(VTYPE, stf::Registers::STF_REG_TYPE::CSR,
-                                              stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
-                                              READ_CSR_REG<XLEN>(state, VTYPE));
+            records_->addReg(VTYPE, stf::Registers::STF_REG_TYPE::CSR,
+                             stf::Registers::STF_REG_OPERAND_TYPE::REG_SOURCE,
+                             READ_CSR_REG<XLEN>(state, VTYPE));
         }
     }
 
     template <typename XLEN> void STFLogger::writeEventRecord_(PegasusState* state)
     {
-        stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::MODE_CHANGE,
-                                        static_cast<uint32_t>(state->getPrivMode()));
+        records_->addEvent(stf::EventRecord::TYPE::MODE_CHANGE,
+                           static_cast<uint32_t>(state->getPrivMode()));
 
         if (fault_cause_.isValid())
         {
             switch (fault_cause_.getValue())
             {
                 case FaultCause::INST_ADDR_MISALIGNED:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::INST_ADDR_MISALIGN,
-                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)));
+                    records_->addEvent(stf::EventRecord::TYPE::INST_ADDR_MISALIGN,
+                                       static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)));
                     break;
 
                 case FaultCause::INST_ACCESS:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::INST_ADDR_FAULT,
-                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)));
+                    records_->addEvent(stf::EventRecord::TYPE::INST_ADDR_FAULT,
+                                       static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)));
                     break;
 
                 case FaultCause::INST_PAGE_FAULT:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::INST_PAGE_FAULT,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen())});
+                    records_->addEvent(stf::EventRecord::TYPE::INST_PAGE_FAULT,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen())});
                     break;
 
                 case FaultCause::LOAD_ADDR_MISALIGNED:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::LOAD_ADDR_MISALIGN,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen()),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
+                    records_->addEvent(stf::EventRecord::TYPE::LOAD_ADDR_MISALIGN,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen()),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
                     break;
 
                 case FaultCause::LOAD_ACCESS:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::LOAD_ACCESS_FAULT,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen()),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
+                    records_->addEvent(stf::EventRecord::TYPE::LOAD_ACCESS_FAULT,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen()),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
                     break;
 
                 case FaultCause::STORE_AMO_ADDR_MISALIGNED:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::STORE_ADDR_MISALIGN,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen()),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
+                    records_->addEvent(stf::EventRecord::TYPE::STORE_ADDR_MISALIGN,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen()),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
                     break;
 
                 case FaultCause::STORE_AMO_ACCESS:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::STORE_ACCESS_FAULT,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen()),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
+                    records_->addEvent(stf::EventRecord::TYPE::STORE_ACCESS_FAULT,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen()),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
                     break;
 
                 case FaultCause::LOAD_PAGE_FAULT:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::LOAD_PAGE_FAULT,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen()),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
+                    records_->addEvent(stf::EventRecord::TYPE::LOAD_PAGE_FAULT,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen()),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
                     break;
 
                 case FaultCause::STORE_AMO_PAGE_FAULT:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::STORE_PAGE_FAULT,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(state->getXlen()),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
+                    records_->addEvent(stf::EventRecord::TYPE::STORE_PAGE_FAULT,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(state->getXlen()),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL))});
                     break;
 
                 case FaultCause::ILLEGAL_INST:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::ILLEGAL_INST,
-                        {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
-                         static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL)),
-                         static_cast<XLEN>(state->getXlen())});
+                    records_->addEvent(stf::EventRecord::TYPE::ILLEGAL_INST,
+                                       {static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)),
+                                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MTVAL)),
+                                        static_cast<XLEN>(state->getXlen())});
                     break;
 
                 case FaultCause::BREAKPOINT:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::BREAKPOINT,
-                        static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)));
+                    records_->addEvent(stf::EventRecord::TYPE::BREAKPOINT,
+                                       static_cast<XLEN>(READ_CSR_REG<XLEN>(state, MEPC)));
                     break;
 
                 case FaultCause::USER_ECALL:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::USER_ECALL,
-                        static_cast<XLEN>(READ_INT_REG<XLEN>(state, 17)));
+                    records_->addEvent(stf::EventRecord::TYPE::USER_ECALL,
+                                       static_cast<XLEN>(READ_INT_REG<XLEN>(state, 17)));
                     break;
 
                 case FaultCause::SUPERVISOR_ECALL:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::SUPERVISOR_ECALL,
-                        static_cast<XLEN>(READ_INT_REG<XLEN>(state, 17)));
+                    records_->addEvent(stf::EventRecord::TYPE::SUPERVISOR_ECALL,
+                                       static_cast<XLEN>(READ_INT_REG<XLEN>(state, 17)));
                     break;
 
                 case FaultCause::MACHINE_ECALL:
-                    stf_writer_ << stf::EventRecord(
-                        stf::EventRecord::TYPE::MACHINE_ECALL,
-                        static_cast<XLEN>(READ_INT_REG<XLEN>(state, 17)));
+                    records_->addEvent(stf::EventRecord::TYPE::MACHINE_ECALL,
+                                       static_cast<XLEN>(READ_INT_REG<XLEN>(state, 17)));
                     break;
 
                 default:
@@ -261,38 +251,38 @@ namespace pegasus
             switch (interrupt_cause_.getValue())
             {
                 case InterruptCause::SUPERVISOR_SOFTWARE:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_SUPERVISOR_SOFTWARE,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_SUPERVISOR_SOFTWARE,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 case InterruptCause::MACHINE_SOFTWARE:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_MACHINE_SOFTWARE,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_MACHINE_SOFTWARE,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 case InterruptCause::SUPERVISOR_TIMER:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_SUPERVISOR_TIMER,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_SUPERVISOR_TIMER,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 case InterruptCause::MACHINE_TIMER:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_MACHINE_TIMER,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_MACHINE_TIMER,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 case InterruptCause::SUPERVISOR_EXTERNAL:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_USER_EXT,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_USER_EXT,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 case InterruptCause::MACHINE_EXTERNAL:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_MACHINE_EXT,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_MACHINE_EXT,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 case InterruptCause::COUNTER_OVERFLOW:
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::INT_USER_SOFTWARE,
-                                                    {static_cast<XLEN>(0)});
+                    records_->addEvent(stf::EventRecord::TYPE::INT_USER_SOFTWARE,
+                                       {static_cast<XLEN>(0)});
                     break;
 
                 default:
@@ -300,24 +290,21 @@ namespace pegasus
             }
         }
 
-        stf_writer_ << stf::EventPCTargetRecord(
-            static_cast<uint64_t>(READ_CSR_REG<XLEN>(state, MTVEC)));
+        records_->addEventPCTarget(static_cast<uint64_t>(READ_CSR_REG<XLEN>(state, MTVEC)));
     }
 
     void STFLogger::postExecute_(PegasusState* state)
     {
         for (const auto & mem_write : mem_writes_)
         {
-            stf_writer_ << stf::InstMemAccessRecord(mem_write.paddr, mem_write.size, 0,
-                                                    stf::INST_MEM_ACCESS::WRITE);
-            stf_writer_ << stf::InstMemContentRecord(mem_write.mem_value.getValue<uint64_t>());
+            records_->addMemAccess(mem_write.paddr, mem_write.size, stf::INST_MEM_ACCESS::WRITE);
+            records_->addMemContent(mem_write.mem_value.getValue<uint64_t>());
         }
 
         for (const auto & mem_read : mem_reads_)
         {
-            stf_writer_ << stf::InstMemAccessRecord(mem_read.paddr, mem_read.size, 0,
-                                                    stf::INST_MEM_ACCESS::READ);
-            stf_writer_ << stf::InstMemContentRecord(mem_read.mem_value.getValue<uint64_t>());
+            records_->addMemAccess(mem_read.paddr, mem_read.size, stf::INST_MEM_ACCESS::READ);
+            records_->addMemContent(mem_read.mem_value.getValue<uint64_t>());
         }
 
         auto get_stf_reg_type = [](const RegType reg_type)
@@ -358,13 +345,13 @@ namespace pegasus
             {
                 if (state->getCurrentInst()->isReturnInst())
                 {
-                    stf_writer_ << stf::EventRecord(stf::EventRecord::TYPE::MODE_CHANGE,
-                                                    static_cast<uint32_t>(state->getPrivMode()));
-                    stf_writer_ << stf::EventPCTargetRecord(state->getNextPc());
+                    records_->addEvent(stf::EventRecord::TYPE::MODE_CHANGE,
+                                       static_cast<uint32_t>(state->getPrivMode()));
+                    records_->addEventPCTarget(state->getNextPc());
                 }
                 else
                 {
-                    stf_writer_ << stf::InstPCTargetRecord(state->getNextPc());
+                    records_->addInstPCTarget(state->getNextPc());
                 }
             }
         }
@@ -395,12 +382,13 @@ namespace pegasus
 
         if (opcode_size == 2)
         {
-            stf_writer_ << stf::InstOpcode16Record(opcode);
+            records_->addOpcode16(opcode);
         }
         else
         {
-            stf_writer_ << stf::InstOpcode32Record(opcode);
+            records_->addOpcode32(opcode);
         }
+        records_->endInstruction();
     }
 
     template <typename XLEN> void STFLogger::recordRegState_(PegasusState* state)
@@ -408,34 +396,35 @@ namespace pegasus
         // Recording int registers
         for (uint64_t i = 0; i < 32; ++i)
         {
-            stf_writer_ << stf::InstRegRecord(i, stf::Registers::STF_REG_TYPE::INTEGER,
-                                              stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
-                                              READ_INT_REG<XLEN>(state, i));
+            records_->addReg(i, stf::Registers::STF_REG_TYPE::INTEGER,
+                             stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
+                             READ_INT_REG<XLEN>(state, i));
         }
         // Recording fp registers
         for (uint64_t i = 0; i < state->getFpRegisterSet()->getNumRegisters(); ++i)
         {
-            stf_writer_ << stf::InstRegRecord(i, stf::Registers::STF_REG_TYPE::FLOATING_POINT,
-                                              stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
-                                              READ_FP_REG<XLEN>(state, i));
+            records_->addReg(i, stf::Registers::STF_REG_TYPE::FLOATING_POINT,
+                             stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
+                             READ_FP_REG<XLEN>(state, i));
         }
         // Recording vector registers
         for (uint32_t i = 0; i < state->getVecRegisterSet()->getNumRegisters(); ++i)
         {
-            stf_writer_ << stf::InstRegRecord(
+            records_->addVectorReg(
                 i, stf::Registers::STF_REG_TYPE::VECTOR,
                 stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
                 readVectorRegister_(state, RegId{RegType::VECTOR, i, "V" + std::to_string(i)}));
         }
         // Recording csr Registers
+        state->syncCounterCsrs();
         auto csr_rset = state->getCsrRegisterSet();
         for (size_t i = 0; i < csr_rset->getNumRegisters(); ++i)
         {
             if (auto reg = csr_rset->getRegister(i))
             {
-                stf_writer_ << stf::InstRegRecord(i, stf::Registers::STF_REG_TYPE::CSR,
-                                                  stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
-                                                  reg->dmiRead<XLEN>());
+                records_->addReg(i, stf::Registers::STF_REG_TYPE::CSR,
+                                 stf::Registers::STF_REG_OPERAND_TYPE::REG_STATE,
+                                 reg->dmiRead<XLEN>());
             }
         }
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/observers/Observer.hpp"
+#include "core/observers/STFRecordWriter.hpp"
 #include "stf_record_types.hpp"
 #include "stf_writer.hpp"
 #include "core/PegasusInst.hpp"
@@ -16,13 +17,19 @@ namespace pegasus
          * \param reg_width Register width (32 or 64)
          * \param initial_pc Initial program counter
          * \param filename Name of the file the trace will be written to
+         * \param buffer_size Memory budget in bytes for records buffered for a background
+         *                    writer thread (0 writes the trace on the simulation thread)
          * \param state PegasusState used to populate initial register values
          */
         STFLogger(const uint32_t reg_width, uint64_t initial_pc, const std::string & filename,
-                  PegasusState* state);
+                  size_t buffer_size, PegasusState* state);
 
       private:
         stf::STFWriter stf_writer_;
+
+        // Declared after the STF writer so the buffered records are written before it closes
+        std::unique_ptr<STFRecordWriter> records_;
+
         void postExecute_(PegasusState* state) override;
         template <typename XLEN> void recordRegState_(PegasusState* state);
         void writeInstruction_(const PegasusInst* inst);
@@ -0,0 +1,297 @@
+#include "core/observers/STFRecordWriter.hpp"
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace pegasus
+{
+    STFRecordWriter::STFRecordWriter(stf::STFWriter & writer, size_t buffer_size) :
+        writer_(writer),
+        batch_size_(buffer_size / NUM_BATCHES)
+    {
+        sparta_assert((buffer_size == 0) || (batch_size_ != 0),
+                      "STF writer buffer size is too small: " << buffer_size);
+
+        // Allocate all of the batches up front so the buffer stays within its budget
+        batches_.resize(isThreaded() ? NUM_BATCHES : 1);
+        for (auto & batch : batches_)
+        {
+            batch.records.reserve(batch_size_ / sizeof(Record) + 1);
+            batch.data.reserve(batch_size_ / sizeof(uint64_t) + 1);
+            free_batches_.push_back(&batch);
+        }
+        current_ = free_batches_.front();
+        free_batches_.pop_front();
+
+        if (isThreaded())
+        {
+            writer_thread_ = std::thread([this]() { run_(); });
+        }
+    }
+
+    STFRecordWriter::~STFRecordWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::exception & ex)
+        {
+            std::cerr << "STF writer failed: " << ex.what() << std::endl;
+        }
+
+        if (writer_thread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = true;
+            }
+            cond_.notify_all();
+            writer_thread_.join();
+        }
+    }
+
+    void STFRecordWriter::addReg(uint32_t num, stf::Registers::STF_REG_TYPE reg_type,
+                                 stf::Registers::STF_REG_OPERAND_TYPE operand_type,
+                                 uint64_t value)
+    {
+        Record & rec = addRecord_(Record::Type::INST_REG);
+        rec.reg_type = reg_type;
+        rec.operand_type = operand_type;
+        rec.num = num;
+        rec.value = value;
+    }
+
+    void STFRecordWriter::addVectorReg(uint32_t num, stf::Registers::STF_REG_TYPE reg_type,
+                                       stf::Registers::STF_REG_OPERAND_TYPE operand_type,
+                                       const std::vector<uint8_t> & bytes)
+    {
+        sparta_assert(bytes.size() % sizeof(uint64_t) == 0,
+                      "Vector register size is not a multiple of 8 bytes: " << bytes.size());
+        Record & rec = addRecord_(Record::Type::INST_VEC_REG);
+        rec.reg_type = reg_type;
+        rec.operand_type = operand_type;
+        rec.num = num;
+        rec.num_data = bytes.size() / sizeof(uint64_t);
+        rec.value = current_->data.size();
+
+        // Same as RegValue::getValueVector<uint64_t>() on a little-endian host
+        current_->data.resize(current_->data.size() + rec.num_data);
+        std::memcpy(current_->data.data() + rec.value, bytes.data(), bytes.size());
+    }
+
+    void STFRecordWriter::addVectorReg(uint32_t num, stf::Registers::STF_REG_TYPE reg_type,
+                                       stf::Registers::STF_REG_OPERAND_TYPE operand_type,
+                                       const std::vector<uint64_t> & values)
+    {
+        Record & rec = addRecord_(Record::Type::INST_VEC_REG);
+        rec.reg_type = reg_type;
+        rec.operand_type = operand_type;
+        rec.num = num;
+        rec.num_data = values.size();
+        rec.value = current_->data.size();
+        current_->data.insert(current_->data.end(), values.begin(), values.end());
+    }
+
+    void STFRecordWriter::addMemAccess(uint64_t addr, uint32_t size,
+                                       stf::INST_MEM_ACCESS access_type)
+    {
+        Record & rec = addRecord_(Record::Type::INST_MEM_ACCESS);
+        rec.access_type = access_type;
+        rec.num = size;
+        rec.value = addr;
+    }
+
+    void STFRecordWriter::addMemContent(uint64_t value)
+    {
+        addRecord_(Record::Type::INST_MEM_CONTENT).value = value;
+    }
+
+    void STFRecordWriter::addEvent(stf::EventRecord::TYPE event_type, uint64_t data)
+    {
+        Record & rec = addRecord_(Record::Type::EVENT);
+        rec.event_type = event_type;
+        rec.value = data;
+    }
+
+    void STFRecordWriter::addEvent(stf::EventRecord::TYPE event_type,
+                                   std::initializer_list<uint64_t> data)
+    {
+        Record & rec = addRecord_(Record::Type::EVENT_DATA);
+        rec.event_type = event_type;
+        rec.num_data = data.size();
+        rec.value = current_->data.size();
+        current_->data.insert(current_->data.end(), data.begin(), data.end());
+    }
+
+    void STFRecordWriter::addEventPCTarget(uint64_t pc)
+    {
+        addRecord_(Record::Type::EVENT_PC_TARGET).value = pc;
+    }
+
+    void STFRecordWriter::addInstPCTarget(uint64_t pc)
+    {
+        addRecord_(Record::Type::INST_PC_TARGET).value = pc;
+    }
+
+    void STFRecordWriter::addOpcode16(uint32_t opcode)
+    {
+        addRecord_(Record::Type::INST_OPCODE16).value = opcode;
+    }
+
+    void STFRecordWriter::addOpcode32(uint32_t opcode)
+    {
+        addRecord_(Record::Type::INST_OPCODE32).value = opcode;
+    }
+
+    void STFRecordWriter::flush()
+    {
+        if (!isThreaded())
+        {
+            write_(*current_);
+            current_->clear();
+            return;
+        }
+
+        if (!current_->records.empty())
+        {
+            submit_();
+        }
+
+        // Wait for the writer thread to finish all of the submitted batches
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return full_batches_.empty() && !writing_; });
+        rethrowWriterException_();
+    }
+
+    void STFRecordWriter::write_(const Batch & batch)
+    {
+        auto get_data = [&batch](const Record & rec)
+        {
+            const auto begin = batch.data.begin() + rec.value;
+            return std::vector<uint64_t>(begin, begin + rec.num_data);
+        };
+
+        for (const auto & rec : batch.records)
+        {
+            switch (rec.type)
+            {
+                case Record::Type::INST_REG:
+                    writer_ << stf::InstRegRecord(rec.num, rec.reg_type, rec.operand_type,
+                                                  rec.value);
+                    break;
+
+                case Record::Type::INST_VEC_REG:
+                    writer_ << stf::InstRegRecord(rec.num, rec.reg_type, rec.operand_type,
+                                                  get_data(rec));
+                    break;
+
+                case Record::Type::INST_MEM_ACCESS:
+                    writer_ << stf::InstMemAccessRecord(rec.value, rec.num, 0, rec.access_type);
+                    break;
+
+                case Record::Type::INST_MEM_CONTENT:
+                    writer_ << stf::InstMemContentRecord(rec.value);
+                    break;
+
+                case Record::Type::EVENT:
+                    writer_ << stf::EventRecord(rec.event_type, rec.value);
+                    break;
+
+                case Record::Type::EVENT_DATA:
+                    writer_ << stf::EventRecord(rec.event_type, get_data(rec));
+                    break;
+
+                case Record::Type::EVENT_PC_TARGET:
+                    writer_ << stf::EventPCTargetRecord(rec.value);
+                    break;
+
+                case Record::Type::INST_PC_TARGET:
+                    writer_ << stf::InstPCTargetRecord(rec.value);
+                    break;
+
+                case Record::Type::INST_OPCODE16:
+                    writer_ << stf::InstOpcode16Record(static_cast<uint32_t>(rec.value));
+                    break;
+
+                case Record::Type::INST_OPCODE32:
+                    writer_ << stf::InstOpcode32Record(static_cast<uint32_t>(rec.value));
+                    break;
+            }
+        }
+    }
+
+    void STFRecordWriter::submit_()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        rethrowWriterException_();
+
+        full_batches_.push_back(current_);
+        current_ = nullptr;
+        cond_.notify_all();
+
+        // Backpressure: wait for the writer thread to free up a batch
+        if (free_batches_.empty())
+        {
+            ++num_stalls_;
+            cond_.wait(lock, [this]() { return !free_batches_.empty(); });
+        }
+        current_ = free_batches_.front();
+        free_batches_.pop_front();
+    }
+
+    void STFRecordWriter::run_()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            cond_.wait(lock, [this]() { return !full_batches_.empty() || done_; });
+            if (full_batches_.empty())
+            {
+                return;
+            }
+
+            Batch* batch = full_batches_.front();
+            full_batches_.pop_front();
+            writing_ = true;
+            const bool failed = writer_failed_;
+            lock.unlock();
+
+            // Keep dropping batches after a failure so the simulation thread can't block
+            std::exception_ptr exception;
+            if (!failed)
+            {
+                try
+                {
+                    write_(*batch);
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+            }
+            batch->clear();
+
+            lock.lock();
+            if (exception)
+            {
+                writer_exception_ = exception;
+                writer_failed_ = true;
+            }
+            writing_ = false;
+            free_batches_.push_back(batch);
+            cond_.notify_all();
+        }
+    }
+
+    void STFRecordWriter::rethrowWriterException_()
+    {
+        if (writer_exception_)
+        {
+            std::rethrow_exception(std::exchange(writer_exception_, nullptr));
+        }
+    }
+} // namespace pegasus
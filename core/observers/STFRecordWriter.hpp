@@ -0,0 +1,185 @@
+#pragma once
+
+#include "stf_record_types.hpp"
+#include "stf_writer.hpp"
+
+#include <condition_variable>
+#include <cinttypes>
+#include <deque>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pegasus
+{
+    /*!
+     * \class STFRecordWriter
+     * \brief Buffers the STF records of the STFLogger and writes them to the STF writer
+     *
+     * Records are packed into compact structs in preallocated batches. With a buffer size
+     * of 0 the records of each instruction are written on the simulation thread as soon as
+     * the instruction is done. Otherwise the buffer is split into NUM_BATCHES batches which
+     * are handed to a writer thread when full; the writer thread converts the records and
+     * streams them into the STF writer (and its compressor). When all batches are waiting
+     * to be written the simulation thread blocks until one is free again.
+     *
+     * Both modes write the same records in the same order, so the traces are identical.
+     */
+    class STFRecordWriter
+    {
+      public:
+        /*!
+         * \param writer Opened STF writer with a finalized header
+         * \param buffer_size Memory budget for buffered records in bytes (0 to write the
+         *                    records on the calling thread)
+         */
+        STFRecordWriter(stf::STFWriter & writer, size_t buffer_size);
+
+        //! Writes the remaining records and stops the writer thread
+        ~STFRecordWriter();
+
+        STFRecordWriter(const STFRecordWriter &) = delete;
+        STFRecordWriter & operator=(const STFRecordWriter &) = delete;
+
+        void addReg(uint32_t num, stf::Registers::STF_REG_TYPE reg_type,
+                    stf::Registers::STF_REG_OPERAND_TYPE operand_type, uint64_t value);
+
+        //! Vector register from its little-endian bytes (a multiple of 8 bytes)
+        void addVectorReg(uint32_t num, stf::Registers::STF_REG_TYPE reg_type,
+                          stf::Registers::STF_REG_OPERAND_TYPE operand_type,
+                          const std::vector<uint8_t> & bytes);
+
+        void addVectorReg(uint32_t num, stf::Registers::STF_REG_TYPE reg_type,
+                          stf::Registers::STF_REG_OPERAND_TYPE operand_type,
+                          const std::vector<uint64_t> & values);
+
+        void addMemAccess(uint64_t addr, uint32_t size, stf::INST_MEM_ACCESS access_type);
+
+        void addMemContent(uint64_t value);
+
+        void addEvent(stf::EventRecord::TYPE event_type, uint64_t data);
+
+        void addEvent(stf::EventRecord::TYPE event_type, std::initializer_list<uint64_t> data);
+
+        void addEventPCTarget(uint64_t pc);
+
+        void addInstPCTarget(uint64_t pc);
+
+        void addOpcode16(uint32_t opcode);
+
+        void addOpcode32(uint32_t opcode);
+
+        //! Called after the last record of an instruction
+        void endInstruction()
+        {
+            if (!isThreaded())
+            {
+                write_(*current_);
+                current_->clear();
+            }
+            else if (current_->getNumBytes() >= batch_size_)
+            {
+                submit_();
+            }
+        }
+
+        //! Write all buffered records and wait for the writer thread to finish them
+        void flush();
+
+        bool isThreaded() const { return batch_size_ != 0; }
+
+        //! Number of times the simulation thread waited for the writer thread
+        uint64_t getNumStalls() const { return num_stalls_; }
+
+        //! Number of batches buffered by the writer thread
+        static constexpr size_t NUM_BATCHES = 4;
+
+      private:
+        struct Record
+        {
+            enum class Type : uint8_t
+            {
+                INST_REG,
+                INST_VEC_REG,
+                INST_MEM_ACCESS,
+                INST_MEM_CONTENT,
+                EVENT,
+                EVENT_DATA,
+                EVENT_PC_TARGET,
+                INST_PC_TARGET,
+                INST_OPCODE16,
+                INST_OPCODE32
+            };
+
+            Type type;
+            stf::Registers::STF_REG_TYPE reg_type;
+            stf::Registers::STF_REG_OPERAND_TYPE operand_type;
+            stf::INST_MEM_ACCESS access_type;
+            stf::EventRecord::TYPE event_type;
+
+            //! Register number or memory access size
+            uint32_t num;
+
+            //! Number of values stored in the batch data (vector registers and event data)
+            uint32_t num_data;
+
+            //! Value, address, PC or opcode; offset into the batch data when num_data > 0
+            uint64_t value;
+        };
+
+        struct Batch
+        {
+            std::vector<Record> records;
+            std::vector<uint64_t> data;
+
+            size_t getNumBytes() const
+            {
+                return records.size() * sizeof(Record) + data.size() * sizeof(uint64_t);
+            }
+
+            void clear()
+            {
+                records.clear();
+                data.clear();
+            }
+        };
+
+        Record & addRecord_(Record::Type type)
+        {
+            Record & rec = current_->records.emplace_back();
+            rec.type = type;
+            rec.num_data = 0;
+            return rec;
+        }
+
+        //! Convert a batch to STF records
+        void write_(const Batch & batch);
+
+        //! Hand the current batch to the writer thread and get a free one
+        void submit_();
+
+        void run_();
+
+        void rethrowWriterException_();
+
+        stf::STFWriter & writer_;
+        const size_t batch_size_;
+
+        std::vector<Batch> batches_;
+        Batch* current_ = nullptr;
+
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        std::deque<Batch*> free_batches_;
+        std::deque<Batch*> full_batches_;
+        bool writing_ = false;
+        bool done_ = false;
+        bool writer_failed_ = false;
+        std::exception_ptr writer_exception_;
+        uint64_t num_stalls_ = 0;
+
+        std::thread writer_thread_;
+    };
+} // namespace pegasus
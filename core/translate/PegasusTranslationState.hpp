@@ -131,6 +131,13 @@ namespace pegasus
             return results_[results_cnt_ - 1];
         }
 
+        // Results in the order they were set, regardless of how many have been popped since
+        const TranslationResult & getResult(const uint32_t idx) const
+        {
+            sparta_assert(idx < results_cnt_);
+            return results_[idx];
+        }
+
         void popResult()
         {
             sparta_assert(results_cnt_ > 0);
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "include/PegasusTypes.hpp"
+#include "include/PegasusTranslateTypes.hpp"
+
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/StatisticSet.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace pegasus
+{
+    /*!
+     * \class TLB
+     * \brief Direct-mapped software TLB for a single translation stage
+     *
+     * Caches the leaf PTE permissions and page size of successful page walks so repeated
+     * accesses to the same page do not have to walk the page table again. Entries are indexed
+     * by the 4K VPN of the access; superpages are cached per 4K VPN that touches them.
+     *
+     * The entire TLB is flushed when the translation context (atp CSR, VMID, SUM or MXR)
+     * changes. Privilege mode is not part of the context since permissions are checked against
+     * the current privilege mode on every hit.
+     */
+    class TLB
+    {
+      private:
+        static constexpr uint32_t getAccessBit_(const translate_types::AccessType type)
+        {
+            return 1u << static_cast<uint32_t>(type);
+        }
+
+      public:
+        struct TLBEntry {
+            bool valid = false;
+            // Global mappings are retained by ASID-specific flushes
+            bool global = false;
+            // PTE U bit
+            bool user = false;
+            // Access types allowed by the R/W/X/A/D bits of the leaf PTE
+            uint32_t access_mask = 0;
+            // ASID (S-stage and VS-stage) or VMID (G-stage)
+            uint32_t asid = 0;
+            // Page walk level of the leaf PTE (1 for 4K pages)
+            uint32_t level = 0;
+            Addr va_base = 0;
+            Addr pa_base = 0;
+            Addr page_offset_mask = 0;
+
+            bool contains(const Addr vaddr) const
+            {
+                return valid && ((vaddr & ~page_offset_mask) == va_base);
+            }
+
+            bool canAccess(const translate_types::AccessType type) const
+            {
+                return access_mask & getAccessBit_(type);
+            }
+        };
+
+        // Translation context the cached entries were created under
+        struct Context {
+            uint64_t atp = 0;
+            // ASID (S-stage and VS-stage) or VMID (G-stage) that new entries are tagged with
+            uint32_t asid = 0;
+            uint32_t vmid = 0;
+            bool sum = false;
+            bool mxr = false;
+
+            bool operator==(const Context & other) const = default;
+        };
+
+        TLB(sparta::StatisticSet* stats, const std::string & name, const uint32_t num_entries) :
+            entries_(num_entries),
+            index_mask_(num_entries ? (num_entries - 1) : 0),
+            hits_(stats, name + "_hits", "Number of " + name + " hits",
+                  sparta::Counter::COUNT_NORMAL),
+            misses_(stats, name + "_misses", "Number of " + name + " misses",
+                    sparta::Counter::COUNT_NORMAL),
+            flushes_(stats, name + "_flushes", "Number of " + name + " flushes",
+                     sparta::Counter::COUNT_NORMAL)
+        {
+            sparta_assert((num_entries & index_mask_) == 0,
+                          "Number of TLB entries must be a power of 2: " << num_entries);
+        }
+
+        bool isEnabled() const { return !entries_.empty(); }
+
+        uint32_t getNumEntries() const { return entries_.size(); }
+
+        const Context & getContext() const { return context_; }
+
+        // Update the translation context, flushing the TLB if it has changed
+        void setContext(const Context & context)
+        {
+            if (context_ != context)
+            {
+                context_ = context;
+                flush();
+            }
+        }
+
+        // Returns the cached entry for vaddr if it exists and allows the access. The permission
+        // checks mirror the leaf PTE checks done by the page walk in Translate::translate_.
+        const TLBEntry* lookup(const Addr vaddr, const translate_types::AccessType type,
+                               const PrivMode priv_mode)
+        {
+            if (SPARTA_EXPECT_FALSE(!isEnabled()))
+            {
+                return nullptr;
+            }
+
+            const TLBEntry & entry = entries_[getIndex_(vaddr)];
+            if (entry.contains(vaddr) && entry.canAccess(type)
+                && (context_.sum || entry.user || (priv_mode == PrivMode::SUPERVISOR)))
+            {
+                ++hits_;
+                return &entry;
+            }
+
+            ++misses_;
+            return nullptr;
+        }
+
+        // Cache the result of a successful page walk. pte must be the leaf PTE value after any
+        // A/D bit updates.
+        void insert(const Addr vaddr, const Addr paddr, const Addr page_offset_mask,
+                    const uint32_t level, const uint64_t pte)
+        {
+            if (SPARTA_EXPECT_FALSE(!isEnabled()))
+            {
+                return;
+            }
+
+            namespace PteFields = translate_types::Sv32::PteFields;
+            const bool accessed = pte & PteFields::accessed.bitmask;
+            const bool dirty = pte & PteFields::dirty.bitmask;
+
+            TLBEntry & entry = entries_[getIndex_(vaddr)];
+            entry.valid = true;
+            entry.global = pte & PteFields::global.bitmask;
+            entry.user = pte & PteFields::user.bitmask;
+            entry.access_mask = 0;
+            if (accessed && (pte & PteFields::execute.bitmask))
+            {
+                entry.access_mask |= getAccessBit_(translate_types::AccessType::EXECUTE);
+            }
+            if (accessed && (pte & PteFields::read.bitmask))
+            {
+                entry.access_mask |= getAccessBit_(translate_types::AccessType::LOAD);
+            }
+            if (accessed && dirty && (pte & PteFields::write.bitmask))
+            {
+                entry.access_mask |= getAccessBit_(translate_types::AccessType::STORE);
+            }
+            entry.asid = context_.asid;
+            entry.level = level;
+            entry.page_offset_mask = page_offset_mask;
+            entry.va_base = vaddr & ~page_offset_mask;
+            entry.pa_base = paddr & ~page_offset_mask;
+        }
+
+        // Invalidate all entries
+        void flush()
+        {
+            for (auto & entry : entries_)
+            {
+                entry.valid = false;
+            }
+            ++flushes_;
+        }
+
+        // Invalidate entries matching the virtual address and/or ASID. Follows the sfence.vma
+        // semantics: global entries are only invalidated if no ASID is given.
+        void flush(const std::optional<Addr> & vaddr, const std::optional<uint32_t> & asid)
+        {
+            if (!vaddr && !asid)
+            {
+                flush();
+                return;
+            }
+
+            for (auto & entry : entries_)
+            {
+                if (vaddr && !entry.contains(*vaddr))
+                {
+                    continue;
+                }
+                if (asid && (entry.global || (entry.asid != *asid)))
+                {
+                    continue;
+                }
+                entry.valid = false;
+            }
+            ++flushes_;
+        }
+
+      private:
+        std::vector<TLBEntry> entries_;
+        const uint32_t index_mask_;
+        Context context_;
+
+        sparta::Counter hits_;
+        sparta::Counter misses_;
+        sparta::Counter flushes_;
+
+        uint32_t getIndex_(const Addr vaddr) const
+        {
+            // Smallest page size is 4K for both RV32 and RV64
+            constexpr uint64_t PAGESHIFT = 12;
+            return (vaddr >> PAGESHIFT) & index_mask_;
+        }
+    };
+} // namespace pegasus
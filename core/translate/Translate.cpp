@@ -13,8 +13,11 @@
 namespace pegasus
 {
 
-    Translate::Translate(sparta::TreeNode* translate_node, const TranslateParameters*) :
-        sparta::Unit(translate_node)
+    Translate::Translate(sparta::TreeNode* translate_node, const TranslateParameters* p) :
+        sparta::Unit(translate_node),
+        s_stage_tlb_(&unit_stat_set_, "s_stage_tlb", p->tlb_entries),
+        vs_stage_tlb_(&unit_stat_set_, "vs_stage_tlb", p->tlb_entries),
+        g_stage_tlb_(&unit_stat_set_, "g_stage_tlb", p->tlb_entries)
     {
         registerTranslateActions_<translate_types::TranslationStage::SUPERVISOR>(
             rv32_s_stage_translation_actions_, rv64_s_stage_translation_actions_,
@@ -27,6 +30,10 @@ namespace pegasus
             ActionTags::INST_G_STAGE_TRANSLATE_TAG, ActionTags::DATA_G_STAGE_TRANSLATE_TAG);
 
         // Assume we are booting in RV64 Machine mode with translation disabled
+        for (uint32_t stage_idx = 0; stage_idx < translate_types::N_TRANS_STAGES; ++stage_idx)
+        {
+            translation_config_ |= TRANSLATION_CONFIG_RV64 << (stage_idx * 8);
+        }
         execute_translate_action_group_.addAction(
             getTranslateAction_<RV64, translate_types::TranslationStage::SUPERVISOR>(
                 translate_types::AccessType::EXECUTE, translate_types::TranslationMode::BAREMETAL));
@@ -65,6 +72,13 @@ namespace pegasus
         sparta_assert(mode != translate_types::TranslationMode::INVALID);
         sparta_assert(ls_mode != translate_types::TranslationMode::INVALID);
 
+        const uint32_t stage_shift = static_cast<uint32_t>(STAGE) * 8;
+        const uint32_t stage_config = static_cast<uint32_t>(mode)
+                                      | (static_cast<uint32_t>(ls_mode) << 3)
+                                      | (std::is_same_v<XLEN, RV64> ? TRANSLATION_CONFIG_RV64 : 0);
+        translation_config_ &= ~(0xffu << stage_shift);
+        translation_config_ |= stage_config << stage_shift;
+
         if constexpr (STAGE == translate_types::TranslationStage::SUPERVISOR)
         {
             execute_translate_action_group_.replaceAction(
@@ -182,23 +196,39 @@ namespace pegasus
             return setResult_<XLEN, STAGE, MODE, TYPE>(translation_state, action_it, vaddr);
         }
 
+        // Check the TLB before walking the page table
+        TLB* tlb = getTLB(STAGE);
+        if (const TLB::TLBEntry* entry = tlb->lookup(vaddr, TYPE, priv_mode); entry)
+        {
+            const Addr paddr = entry->pa_base | (vaddr & entry->page_offset_mask);
+            DLOG("TLB hit: " << HEX(paddr, width));
+            return setResult_<XLEN, STAGE, MODE, TYPE>(translation_state, action_it, paddr,
+                                                       entry->level);
+        }
+
         // Smallest page size is 4K for both RV32 and RV64
         constexpr uint64_t PAGESHIFT = 12; // 4096
-        const uint32_t ATP_CSR = getAtpCsr(STAGE);
-        uint64_t ppn = READ_CSR_FIELD<XLEN>(state, ATP_CSR, "ppn") << PAGESHIFT;
+        constexpr uint32_t ATP_CSR = getAtpCsr(STAGE);
+        uint64_t ppn = READ_CSR_FIELD<XLEN, ATP_CSR, "ppn">(state) << PAGESHIFT;
         while (level > 0)
         {
             // Read PTE from memory
             const auto indexed_level = level - 1;
             const auto & vpn_field = translate_types::getVpnField<MODE>(indexed_level);
             const uint64_t pte_paddr = ppn + vpn_field.calcPTEOffset(vaddr) * sizeof(XLEN);
-            std::vector<uint8_t> buffer;
-            if (state->readMemory<XLEN>(pte_paddr, buffer, MemAccessSource::HARDWARE) == false)
+            // Page tables outside of plain memory are walked when the hart runs alone
+            if (SPARTA_EXPECT_FALSE(!state->canAccessInParallel(pte_paddr, sizeof(XLEN), true)))
+            {
+                return state->endParallelWindow();
+            }
+            const std::optional<XLEN> pte_val =
+                state->readMemory<XLEN>(pte_paddr, MemAccessSource::HARDWARE);
+            if (!pte_val)
             {
                 DLOG("Translation FAILED! Failed to read PTE");
                 break;
             }
-            PageTableEntry<XLEN, MODE> pte = convertFromByteVector<XLEN>(buffer);
+            PageTableEntry<XLEN, MODE> pte = *pte_val;
             DLOG_CODE_BLOCK(DLOG_OUTPUT("Level " << level << " Page Walk");
                             DLOG_OUTPUT("    Addr: " << HEX(pte_paddr, width));
                             DLOG_OUTPUT("     PTE: " << pte););
@@ -245,7 +275,10 @@ namespace pegasus
 
                 // If the SUM bit is set, Supervisor mode software is allowed to access User mode
                 // pages
-                const uint32_t sum_val = READ_CSR_FIELD<XLEN>(state, MSTATUS, "sum");
+                const uint32_t sum_val =
+                    (STAGE == translate_types::TranslationStage::VIRTUAL_SUPERVISOR)
+                        ? READ_CSR_FIELD<XLEN, VSSTATUS, "sum">(state)
+                        : READ_CSR_FIELD<XLEN, MSTATUS, "sum">(state);
                 if ((sum_val == 0) && (false == pte.isUserMode())
                     && (priv_mode != PrivMode::SUPERVISOR))
                 {
@@ -278,7 +311,7 @@ namespace pegasus
                 if (false == pte.isAccessable(is_store))
                 {
                     // See if we're required to update access bits in the PTE
-                    if (READ_CSR_FIELD<XLEN>(state, MENVCFG, "adue"))
+                    if (READ_CSR_FIELD<XLEN, MENVCFG, "adue">(state))
                     {
                         if constexpr (is_store)
                         {
@@ -310,6 +343,7 @@ namespace pegasus
                 const Addr page_offset_mask =
                     translate_types::getPageOffsetMask<MODE>(indexed_level);
                 paddr |= page_offset_mask & vaddr;
+                tlb->insert(vaddr, paddr, page_offset_mask, level, pte.getPte());
 
                 // Set result and determine whether to keep going or perform translation again
                 return setResult_<XLEN, STAGE, MODE, TYPE>(translation_state, action_it, paddr,
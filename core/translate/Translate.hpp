@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/ActionGroup.hpp"
+#include "core/translate/TLB.hpp"
 #include "include/PegasusTypes.hpp"
 
 #include "include/PegasusTranslateTypes.hpp"
@@ -29,6 +30,9 @@ namespace pegasus
         {
           public:
             TranslateParameters(sparta::TreeNode* node) : sparta::ParameterSet(node) {}
+
+            PARAMETER(uint32_t, tlb_entries, 256,
+                      "Number of entries in each software TLB (power of 2, 0 to disable)")
         };
 
         Translate(sparta::TreeNode* translate_node, const TranslateParameters* p);
@@ -64,9 +68,30 @@ namespace pegasus
         void updateTranslationMode(const translate_types::TranslationMode mode,
                                    const translate_types::TranslationMode ls_mode);
 
-        inline static int32_t getAtpCsr(const translate_types::TranslationStage stage)
+        // Encodes the XLEN and translation modes of every stage. Changes whenever the Actions in the
+        // translate ActionGroups are replaced.
+        uint32_t getTranslationConfig() const { return translation_config_; }
+
+        TLB* getTLB(const translate_types::TranslationStage stage)
+        {
+            switch (stage)
+            {
+                case translate_types::TranslationStage::SUPERVISOR:
+                    return &s_stage_tlb_;
+                case translate_types::TranslationStage::VIRTUAL_SUPERVISOR:
+                    return &vs_stage_tlb_;
+                case translate_types::TranslationStage::GUEST:
+                    return &g_stage_tlb_;
+                case translate_types::TranslationStage::INVALID:
+                    break;
+            }
+            sparta_assert(false, "Translation stage cannot be INVALID!");
+            return nullptr;
+        }
+
+        inline static constexpr uint32_t getAtpCsr(const translate_types::TranslationStage stage)
         {
-            static const std::array<uint32_t, translate_types::N_TRANS_STAGES> atp_csrs = {
+            constexpr std::array<uint32_t, translate_types::N_TRANS_STAGES> atp_csrs = {
                 SATP, VSATP, HGATP};
             return atp_csrs.at(static_cast<uint32_t>(stage));
         }
@@ -76,6 +101,15 @@ namespace pegasus
         std::array<translate_types::TranslationMode, translate_types::N_TRANS_STAGES> mmu_modes_;
         std::array<translate_types::TranslationMode, translate_types::N_TRANS_STAGES> ls_mmu_modes_;
 
+        // 8 bits per stage: mode (bits 0-2), ls_mode (bits 3-5) and RV64 (bit 6)
+        static constexpr uint32_t TRANSLATION_CONFIG_RV64 = 1 << 6;
+        uint32_t translation_config_ = 0;
+
+        // Software TLBs for each stage (S-Stage, VS-Stage and G-Stage)
+        TLB s_stage_tlb_;
+        TLB vs_stage_tlb_;
+        TLB g_stage_tlb_;
+
         // Translate ActionGroups
         ActionGroup execute_translate_action_group_{"Execute (Inst) Translate"};
         ActionGroup load_translate_action_group_{"Load Translate"};
@@ -1,4 +1,5 @@
 #include "cosim/CoSimEventPipeline.hpp"
+#include "cosim/EventCodec.hpp"
 #include "core/observers/CoSimObserver.hpp"
 #include "core/PegasusState.hpp"
 #include "core/PegasusCore.hpp"
@@ -6,27 +7,52 @@
 #include "simdb/pipeline/PipelineManager.hpp"
 #include "simdb/pipeline/AsyncDatabaseAccessor.hpp"
 #include "simdb/pipeline/Stage.hpp"
-#include "simdb/utils/Compress.hpp"
+#include "sim/PegasusSimParameters.hpp"
 #include "sparta/serialization/checkpoint/CherryPickFastCheckpointer.hpp"
 #include "softfloat.h"
 
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/serialization/deque.hpp>
-#include <boost/serialization/vector.hpp>
-#include <boost/serialization/utility.hpp>
-#include <boost/iostreams/device/back_inserter.hpp>
-#include <boost/iostreams/stream.hpp>
-
 namespace pegasus::cosim
 {
+    namespace
+    {
+        // Find an event in a window of events sorted by euid
+        template <typename EventListT>
+        auto findEvent(EventListT & evts, uint64_t euid) -> decltype(&evts.front())
+        {
+            if (!evts.empty())
+            {
+                auto index = euid - evts.front().getEuid();
+
+                // Optimistically check the calculated index first (no flushes so far).
+                if (index < evts.size() && evts[index].getEuid() == euid)
+                {
+                    return &evts[index];
+                }
+
+                // Iterate through the list to find the event (we have done some flushes).
+                for (auto & evt : evts)
+                {
+                    if (evt.getEuid() == euid)
+                    {
+                        return &evt;
+                    }
+                }
+            }
+
+            return nullptr;
+        }
+    } // namespace
 
     CoSimEventPipeline::CoSimEventPipeline(simdb::DatabaseManager* db_mgr, CoreId core_id,
                                            HartId hart_id, PegasusState* state) :
         db_mgr_(db_mgr),
         core_id_(core_id),
         hart_id_(hart_id),
-        state_(state)
+        state_(state),
+        event_format_(EventCodec::getFormat(
+            PegasusSimParameters::getParameter<std::string>(state, "cosim_event_codec"))),
+        event_compressor_(
+            PegasusSimParameters::getParameter<std::string>(state, "cosim_event_compression"))
     {
         auto & ext_mgr = state->getExtensionManager();
 
@@ -73,6 +99,12 @@ namespace pegasus::cosim
         tbl.addColumn("CoreId", dt::uint32_t);
         tbl.addColumn("HartId", dt::uint32_t);
 
+        // EventFormat the blob was encoded with (see EventCodec)
+        tbl.addColumn("FormatVersion", dt::uint32_t);
+
+        // CompressionCodec the blob was compressed with (see EventCompressor)
+        tbl.addColumn("Compression", dt::uint32_t);
+
         // The compressed event data blob
         tbl.addColumn("ZlibBlob", dt::blob_t);
 
@@ -80,6 +112,12 @@ namespace pegasus::cosim
         tbl.createCompoundIndexOn(
             {"StartEuid", "EndEuid", "StartArchId", "EndArchId", "CoreId", "HartId"});
 
+        // Zstd dictionary used by the CompressionCodec::ZSTD_DICT blobs of each core/hart
+        auto & dict_tbl = schema.addTable("EventDictionaries");
+        dict_tbl.addColumn("CoreId", dt::uint32_t);
+        dict_tbl.addColumn("HartId", dt::uint32_t);
+        dict_tbl.addColumn("DictBlob", dt::blob_t);
+
         // Support for CoSimEventReplayer.
         auto add_ptree_table = [&](const std::string & table_name)
         {
@@ -204,18 +242,20 @@ namespace pegasus::cosim
                 serialized.end_arch_id = evts.back().getArchId();
                 serialized.core_id = pipeline_->core_id_;
                 serialized.hart_id = pipeline_->hart_id_;
+                serialized.format = pipeline_->event_format_;
 
-                namespace bio = boost::iostreams;
-                bio::back_insert_device<std::vector<char>> inserter(serialized.evt_bytes);
-                bio::stream<bio::back_insert_device<std::vector<char>>> os(inserter);
-                boost::archive::binary_oarchive oa(os);
-                oa << evts;
-                os.flush();
+                // Encode and compress the events. The number of windows still waiting in
+                // the input queue drives the adaptive compression policy.
+                std::vector<char> encoded_bytes;
+                EventCodec::encode(evts, serialized.format, encoded_bytes);
 
-                // Compress the byte buffer
-                std::vector<char> compressed_bytes;
-                simdb::compressData(serialized.evt_bytes, compressed_bytes);
-                std::swap(serialized.evt_bytes, compressed_bytes);
+                auto & compressor = pipeline_->event_compressor_;
+                serialized.codec =
+                    compressor.compress(encoded_bytes, input_queue_->size(), serialized.evt_bytes);
+                if (serialized.codec == CompressionCodec::ZSTD_DICT)
+                {
+                    serialized.dict = compressor.getDictionary();
+                }
 
                 // Send down the pipeline
                 output_queue_->emplace(std::move(serialized));
@@ -254,18 +294,10 @@ namespace pegasus::cosim
                         return false;
                     }
 
-                    // Undo zlib
-                    std::vector<char> uncompressed;
-                    simdb::decompressData(evts.evt_bytes, uncompressed);
-
-                    // Undo boost::serialization
-                    namespace bio = boost::iostreams;
-                    bio::array_source src(uncompressed.data(), uncompressed.size());
-                    bio::stream<bio::array_source> is(src);
-                    boost::archive::binary_iarchive ia(is);
-
+                    // Undo zlib and the event encoding
                     EventList orig_evts;
-                    ia >> orig_evts;
+                    EventCodec::decompress(evts.evt_bytes, evts.format, evts.codec,
+                                           evts.dict.get(), orig_evts);
 
                     // Note that the euids are not necessarily contiguous in the EventList,
                     // so we have to iterate through to find the event with the given euid.
@@ -328,11 +360,24 @@ namespace pegasus::cosim
             SerializedEvtsBuffer serialized;
             if (input_queue_->try_pop(serialized))
             {
+                // The dictionary has to be on disk before the first blob which uses it
+                if (serialized.dict && !dict_written_)
+                {
+                    auto dict_inserter = getTableInserter_("EventDictionaries");
+                    dict_inserter->createRecordWithColValues(serialized.core_id,
+                                                             serialized.hart_id,
+                                                             serialized.dict->getBytes());
+                    dict_written_ = true;
+                }
+
                 auto inserter = getTableInserter_("CompressedEvents");
-                inserter->createRecordWithColValues(serialized.start_euid, serialized.end_euid,
-                                                    serialized.start_arch_id,
-                                                    serialized.end_arch_id, serialized.core_id,
-                                                    serialized.hart_id, serialized.evt_bytes);
+                const int row_id = inserter->createRecordWithColValues(
+                    serialized.start_euid, serialized.end_euid, serialized.start_arch_id,
+                    serialized.end_arch_id, serialized.core_id, serialized.hart_id,
+                    static_cast<uint32_t>(serialized.format),
+                    static_cast<uint32_t>(serialized.codec), serialized.evt_bytes);
+
+                pipeline_->indexWindow_(serialized.start_euid, serialized.end_euid, row_id);
                 action = simdb::pipeline::PipelineAction::PROCEED;
             }
 
@@ -341,6 +386,7 @@ namespace pegasus::cosim
 
         simdb::ConcurrentQueue<SerializedEvtsBuffer>* input_queue_ = nullptr;
         CoSimEventPipeline* pipeline_ = nullptr;
+        bool dict_written_ = false;
     };
 
     void CoSimEventPipeline::createPipeline(simdb::pipeline::PipelineManager* pipeline_mgr)
@@ -587,6 +633,7 @@ namespace pegasus::cosim
             auto euid = reload_evt.getEuid();
             auto checkpointer = observer->getCheckpointer();
             checkpointer->getFastCheckpointer().loadCheckpoint(euid);
+            state->rebaseCounterCsrs();
 
             last_event_uid_ = euid;
 
@@ -615,6 +662,7 @@ namespace pegasus::cosim
             sim_state->current_opcode = reload_evt.getOpcode();
             sim_state->current_uid = reload_evt.getSimStateCurrentUID();
             sim_state->inst_count = reload_evt.getSimStateCurrentUID();
+            state->rebaseCounterCsrs();
 
             // Now that the ArchData is reloaded, we can safely update the MMU mode.
             if (change_mmu_mode)
@@ -670,6 +718,7 @@ namespace pegasus::cosim
             sim_state->sim_pause_reason = SimPauseReason::INVALID;
             sim_state->test_passed = true;
             sim_state->workload_exit_code = 0;
+            state->rebaseCounterCsrs();
 
             // sim_stopped is left alone since it is set
             // to true as early as bindTree(), and flushing
@@ -756,12 +805,56 @@ namespace pegasus::cosim
         {
             auto avg_latency_us = avg_us_recreating_evts_from_disk_.mean();
             std::cout << "    From disk:  " << avg_us_recreating_evts_from_disk_.count();
-            std::cout << " (avg latency " << size_t(avg_latency_us) << " microseconds)\n\n";
+            std::cout << " (avg latency " << size_t(avg_latency_us) << " microseconds)\n";
         }
         else
         {
-            std::cout << "    From disk:  0\n\n";
+            std::cout << "    From disk:  0\n";
+        }
+
+        const size_t num_window_accesses = num_window_cache_hits_ + num_window_cache_misses_;
+        if (num_window_accesses)
+        {
+            std::cout << "        Window cache:  " << num_window_cache_hits_ << " hits, "
+                      << num_window_cache_misses_ << " misses ("
+                      << size_t(100.0 * num_window_cache_hits_ / num_window_accesses)
+                      << "% hit rate)\n";
+            std::cout << "        Prefetched:    " << num_windows_prefetched_ << " windows ("
+                      << num_prefetched_windows_used_ << " used)\n";
+            std::cout << "        Not indexed:   " << num_window_index_misses_ << "\n";
         }
+
+        std::cout << "Event compression for core " << core_id_ << ", hart " << hart_id_ << ": "
+                  << event_compressor_.getNumBytesIn() << " -> "
+                  << event_compressor_.getNumBytesOut() << " bytes\n";
+        for (const auto codec : {CompressionCodec::ZLIB, CompressionCodec::LZ4,
+                                 CompressionCodec::ZSTD, CompressionCodec::ZSTD_DICT})
+        {
+            if (const size_t num_windows = event_compressor_.getNumWindows(codec))
+            {
+                std::cout << "    " << codec << ": " << num_windows << " windows\n";
+            }
+        }
+        std::cout << "\n";
+    }
+
+    std::shared_ptr<const EventDictionary>
+    CoSimEventPipeline::loadDictionary_(simdb::DatabaseManager* db_mgr, CoreId core_id,
+                                        HartId hart_id)
+    {
+        auto query = db_mgr->createQuery("EventDictionaries");
+        query->addConstraintForInt("CoreId", simdb::Constraints::EQUAL, (int)core_id);
+        query->addConstraintForInt("HartId", simdb::Constraints::EQUAL, (int)hart_id);
+
+        std::vector<char> dict_bytes;
+        query->select("DictBlob", dict_bytes);
+
+        auto result_set = query->getResultSet();
+        if (!result_set.getNextRecord())
+        {
+            return nullptr;
+        }
+        return std::make_shared<const EventDictionary>(std::move(dict_bytes));
     }
 
     size_t CoSimEventPipeline::getNumSnooped() const
@@ -777,38 +870,13 @@ namespace pegasus::cosim
 
     const Event* CoSimEventPipeline::getEventFromCache_(uint64_t euid)
     {
-        auto get_from = [euid](const EventList & evts) -> const Event*
-        {
-            if (!evts.empty())
-            {
-                auto index = euid - evts.front().getEuid();
-
-                // Optimistically check the calculated index first (no flushes so far).
-                if (index < evts.size() && evts[index].getEuid() == euid)
-                {
-                    return &evts[index];
-                }
-
-                // Iterate through the list to find the event (we have done some flushes).
-                for (const auto & evt : evts)
-                {
-                    if (evt.getEuid() == euid)
-                    {
-                        return &evt;
-                    }
-                }
-            }
-
-            return nullptr;
-        };
-
-        if (const Event* evt = get_from(uncommitted_evts_buffer_))
+        if (const Event* evt = findEvent(std::as_const(uncommitted_evts_buffer_), euid))
         {
             ++num_evts_retrieved_from_cache_;
             return evt;
         }
 
-        if (const Event* evt = get_from(committed_evts_buffer_))
+        if (const Event* evt = findEvent(std::as_const(committed_evts_buffer_), euid))
         {
             ++num_evts_retrieved_from_cache_;
             return evt;
@@ -841,21 +909,157 @@ namespace pegasus::cosim
         return snooped_event;
     }
 
-    std::unique_ptr<Event> CoSimEventPipeline::recreateEventFromDisk_(uint64_t euid)
+    std::shared_ptr<Event> CoSimEventPipeline::getEventFromWindowCache_(uint64_t euid)
     {
-        std::vector<char> compressed_evts_bytes;
+        for (auto it = window_cache_.begin(); it != window_cache_.end(); ++it)
+        {
+            if (euid < it->start_euid || euid > it->end_euid)
+            {
+                continue;
+            }
+
+            Event* evt = findEvent(*it->evts, euid);
+            if (!evt)
+            {
+                return nullptr;
+            }
+
+            ++num_window_cache_hits_;
+            if (it->prefetched)
+            {
+                ++num_prefetched_windows_used_;
+                it->prefetched = false;
+            }
+            last_window_end_euid_ = it->end_euid;
+
+            // Move to the front of the LRU list
+            window_cache_.splice(window_cache_.begin(), window_cache_, it);
+
+            // Share ownership of the window with the returned event
+            return std::shared_ptr<Event>(window_cache_.front().evts, evt);
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<Event> CoSimEventPipeline::recreateEventFromDisk_(uint64_t euid)
+    {
+        ++num_window_cache_misses_;
+
+        auto is_cached = [this](uint64_t end_euid)
+        {
+            for (const auto & window : window_cache_)
+            {
+                if (window.end_euid == end_euid)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // Look up the row of the event's window. If the previous window access was
+        // to a neighboring window, also read the next windows in that direction.
+        std::vector<int> row_ids;
+        {
+            std::lock_guard<std::mutex> lock(window_index_mutex_);
+            auto it = window_index_.lower_bound(euid);
+            if ((it != window_index_.end()) && (it->second.start_euid <= euid))
+            {
+                row_ids.emplace_back(it->second.row_id);
+
+                if (last_window_end_euid_.isValid())
+                {
+                    const uint64_t last_end_euid = last_window_end_euid_.getValue();
+                    const bool forward =
+                        (it != window_index_.begin()) && (std::prev(it)->first == last_end_euid);
+                    const bool backward = (std::next(it) != window_index_.end())
+                                          && (std::next(it)->first == last_end_euid);
+
+                    auto prefetch_it = it;
+                    for (size_t i = 0; (forward || backward) && (i < NUM_PREFETCH_WINDOWS); ++i)
+                    {
+                        if (forward && (++prefetch_it == window_index_.end()))
+                        {
+                            break;
+                        }
+                        if (backward && (prefetch_it-- == window_index_.begin()))
+                        {
+                            break;
+                        }
+                        if (!is_cached(prefetch_it->first))
+                        {
+                            row_ids.emplace_back(prefetch_it->second.row_id);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                ++num_window_index_misses_;
+            }
+        }
+
+        struct WindowBlob
+        {
+            uint64_t start_euid = 0;
+            uint64_t end_euid = 0;
+            uint32_t format_version = 0;
+            uint32_t compression = 0;
+            std::vector<char> compressed_evts_bytes;
+        };
+        std::vector<WindowBlob> blobs;
 
         auto query_func = [&](simdb::DatabaseManager* db_mgr)
         {
-            auto query = db_mgr->createQuery("CompressedEvents");
-            query->addConstraintForUInt64("StartEuid", simdb::Constraints::LESS_EQUAL, euid);
-            query->addConstraintForUInt64("EndEuid", simdb::Constraints::GREATER_EQUAL, euid);
-            query->addConstraintForInt("CoreId", simdb::Constraints::EQUAL, (int)core_id_);
-            query->addConstraintForInt("HartId", simdb::Constraints::EQUAL, (int)hart_id_);
-            query->select("ZlibBlob", compressed_evts_bytes);
-
-            auto result_set = query->getResultSet();
-            result_set.getNextRecord();
+            // Returns false if there is no such window
+            auto read_window = [&](auto & query)
+            {
+                WindowBlob blob;
+                query->select("StartEuid", blob.start_euid);
+                query->select("EndEuid", blob.end_euid);
+                query->select("FormatVersion", blob.format_version);
+                query->select("Compression", blob.compression);
+                query->select("ZlibBlob", blob.compressed_evts_bytes);
+
+                auto result_set = query->getResultSet();
+                if (!result_set.getNextRecord())
+                {
+                    return false;
+                }
+
+                if ((static_cast<CompressionCodec>(blob.compression)
+                     == CompressionCodec::ZSTD_DICT)
+                    && !disk_dictionary_)
+                {
+                    disk_dictionary_ = loadDictionary_(db_mgr, core_id_, hart_id_);
+                }
+                blobs.emplace_back(std::move(blob));
+                return true;
+            };
+
+            if (row_ids.empty())
+            {
+                // Not in the index, fall back to the euid range query
+                auto query = db_mgr->createQuery("CompressedEvents");
+                query->addConstraintForUInt64("StartEuid", simdb::Constraints::LESS_EQUAL, euid);
+                query->addConstraintForUInt64("EndEuid", simdb::Constraints::GREATER_EQUAL,
+                                              euid);
+                query->addConstraintForInt("CoreId", simdb::Constraints::EQUAL, (int)core_id_);
+                query->addConstraintForInt("HartId", simdb::Constraints::EQUAL, (int)hart_id_);
+                read_window(query);
+                return;
+            }
+
+            for (const int row_id : row_ids)
+            {
+                auto query = db_mgr->createQuery("CompressedEvents");
+                query->addConstraintForInt("Id", simdb::Constraints::EQUAL, row_id);
+                if (!read_window(query))
+                {
+                    break;
+                }
+            }
         };
 
         // Keep track of how long we spend recreating events from disk
@@ -867,39 +1071,49 @@ namespace pegasus::cosim
         auto db_accessor = pipeline_mgr_->getAsyncDatabaseAccessor();
         db_accessor->eval(query_func);
 
-        if (compressed_evts_bytes.empty())
+        if (blobs.empty())
         {
             return nullptr;
         }
 
-        // "Undo" the pipeline transforms. Start by undoing zlib.
-        std::vector<char> uncompressed_evts_bytes;
-        simdb::decompressData(compressed_evts_bytes, uncompressed_evts_bytes);
-
-        // Now undo boost::serialization
-        namespace bio = boost::iostreams;
-        bio::array_source src(uncompressed_evts_bytes.data(), uncompressed_evts_bytes.size());
-        bio::stream<bio::array_source> is(src);
-        boost::archive::binary_iarchive ia(is);
-
-        EventList evts;
-        ia >> evts;
-
-        // If we got this far, the event uid must be within the returned list
-        for (const auto & evt : evts)
+        // "Undo" the pipeline transforms (compression and the event encoding) and put
+        // the windows in the cache. The requested window is the first one.
+        for (auto rit = blobs.rbegin(); rit != blobs.rend(); ++rit)
         {
-            if (evt.getEuid() == euid)
+            DecodedWindow window;
+            window.start_euid = rit->start_euid;
+            window.end_euid = rit->end_euid;
+            window.evts = std::make_shared<EventList>();
+            window.prefetched = (rit != std::prev(blobs.rend()));
+            EventCodec::decompress(rit->compressed_evts_bytes,
+                                   static_cast<EventFormat>(rit->format_version),
+                                   static_cast<CompressionCodec>(rit->compression),
+                                   disk_dictionary_.get(), *window.evts);
+
+            num_windows_prefetched_ += window.prefetched;
+            window_cache_.emplace_front(std::move(window));
+            if (window_cache_.size() > NUM_CACHED_WINDOWS)
             {
-                // Record how long this took
-                auto end = std::chrono::high_resolution_clock::now();
-                std::chrono::duration<double> dur = end - start;
-                auto us = std::chrono::duration_cast<std::chrono::microseconds>(dur).count();
+                window_cache_.pop_back();
+            }
+        }
+
+        // If we got this far, the event uid must be within the requested window
+        auto & window = window_cache_.front();
+        if (Event* evt = findEvent(*window.evts, euid))
+        {
+            last_window_end_euid_ = window.end_euid;
 
-                // Add to the running mean
-                avg_us_recreating_evts_from_disk_.add(us);
+            // Record how long this took
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> dur = end - start;
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(dur).count();
 
-                return std::make_unique<Event>(evt);
-            }
+            // Add to the running mean
+            avg_us_recreating_evts_from_disk_.add(us);
+
+            // Share ownership of the window with the returned event
+            return std::shared_ptr<Event>(window.evts, evt);
         }
 
         throw simdb::DBException("Internal error occurred. Cannot find event with uid ")
@@ -907,6 +1121,12 @@ namespace pegasus::cosim
             << db_mgr_->getDatabaseFilePath() << "'.";
     }
 
+    void CoSimEventPipeline::indexWindow_(uint64_t start_euid, uint64_t end_euid, int row_id)
+    {
+        std::lock_guard<std::mutex> lock(window_index_mutex_);
+        window_index_[end_euid] = WindowRow{start_euid, row_id};
+    }
+
     void CoSimEventPipeline::ensureOnlyOneLastEventOnDisk_()
     {
         // We are going to load event windows into memory until we find one that does
@@ -919,9 +1139,10 @@ namespace pegasus::cosim
         class LastEventWindow
         {
           public:
-            LastEventWindow(uint32_t core_id, uint32_t hart_id) :
+            LastEventWindow(uint32_t core_id, uint32_t hart_id, EventFormat format) :
                 core_id_(core_id),
-                hart_id_(hart_id)
+                hart_id_(hart_id),
+                format_(format)
             {
             }
 
@@ -983,23 +1204,20 @@ namespace pegasus::cosim
                 serialized.end_arch_id = evts_.back().getArchId();
                 serialized.core_id = core_id_;
                 serialized.hart_id = hart_id_;
+                serialized.format = format_;
 
-                namespace bio = boost::iostreams;
-                bio::back_insert_device<std::vector<char>> inserter(serialized.evt_bytes);
-                bio::stream<bio::back_insert_device<std::vector<char>>> os(inserter);
-                boost::archive::binary_oarchive oa(os);
-                oa << evts_;
-                os.flush();
-
-                // Compress the byte buffer
-                std::vector<char> compressed_bytes;
-                simdb::compressData(serialized.evt_bytes, compressed_bytes);
-                std::swap(serialized.evt_bytes, compressed_bytes);
+                // Encode and compress the events. This is a single window written once at
+                // the end of simulation, so it always uses zlib.
+                serialized.codec = CompressionCodec::ZLIB;
+                EventCodec::compress(evts_, serialized.format, serialized.codec, nullptr,
+                                     serialized.evt_bytes);
 
                 db_mgr->INSERT(SQL_TABLE("CompressedEvents"),
                                SQL_VALUES(serialized.start_euid, serialized.end_euid,
                                           serialized.start_arch_id, serialized.end_arch_id,
                                           serialized.core_id, serialized.hart_id,
+                                          static_cast<uint32_t>(serialized.format),
+                                          static_cast<uint32_t>(serialized.codec),
                                           serialized.evt_bytes));
             }
 
@@ -1007,10 +1225,11 @@ namespace pegasus::cosim
             EventList evts_;
             const uint32_t core_id_;
             const uint32_t hart_id_;
+            const EventFormat format_;
             uint64_t start_euid_ = std::numeric_limits<uint64_t>::max();
             uint64_t end_euid_ = 0;
             std::vector<int> db_ids_to_delete_;
-        } last_event_window{core_id_, hart_id_};
+        } last_event_window{core_id_, hart_id_, event_format_};
 
         auto query = db_mgr_->createQuery("CompressedEvents");
 
@@ -1023,6 +1242,12 @@ namespace pegasus::cosim
         query->addConstraintForInt("CoreId", simdb::Constraints::EQUAL, (int)core_id_);
         query->addConstraintForInt("HartId", simdb::Constraints::EQUAL, (int)hart_id_);
 
+        uint32_t format_version;
+        query->select("FormatVersion", format_version);
+
+        uint32_t compression;
+        query->select("Compression", compression);
+
         std::vector<char> compressed_evts_bytes;
         query->select("ZlibBlob", compressed_evts_bytes);
 
@@ -1032,20 +1257,15 @@ namespace pegasus::cosim
         query->orderBy("EndEuid", simdb::QueryOrder::DESC);
         auto result_set = query->getResultSet();
 
+        const auto dict = loadDictionary_(db_mgr_, core_id_, hart_id_);
+
         while (result_set.getNextRecord())
         {
-            // "Undo" the pipeline transforms. Start by undoing zlib.
-            std::vector<char> uncompressed_evts_bytes;
-            simdb::decompressData(compressed_evts_bytes, uncompressed_evts_bytes);
-
-            // Now undo boost::serialization
-            namespace bio = boost::iostreams;
-            bio::array_source src(uncompressed_evts_bytes.data(), uncompressed_evts_bytes.size());
-            bio::stream<bio::array_source> is(src);
-            boost::archive::binary_iarchive ia(is);
-
+            // "Undo" the pipeline transforms (zlib and the event encoding)
             EventList evts;
-            ia >> evts;
+            EventCodec::decompress(compressed_evts_bytes,
+                                   static_cast<EventFormat>(format_version),
+                                   static_cast<CompressionCodec>(compression), dict.get(), evts);
 
             // If the first event in this window does not have the exit code, don't continue
             auto stop = !evts.front().isLastEvent();
@@ -1060,6 +1280,15 @@ namespace pegasus::cosim
         }
 
         last_event_window.overwriteLastWindow(db_mgr_);
+
+        // The last windows were rewritten as a new row. Drop anything we know about
+        // the old rows; lookups fall back to the euid range query from now on.
+        {
+            std::lock_guard<std::mutex> lock(window_index_mutex_);
+            window_index_.clear();
+        }
+        window_cache_.clear();
+        last_window_end_euid_.clearValid();
     }
 
     const Event* EventAccessor::operator->() { return get(); }
@@ -1077,6 +1306,15 @@ namespace pegasus::cosim
             return evt;
         }
 
+        // Events on disk are never in the pipeline, so check the windows we
+        // already read back before snooping the pipeline.
+        if (auto evt = evt_pipeline_->getEventFromWindowCache_(euid_))
+        {
+            ++num_from_disk_;
+            recreated_evt_ = std::move(evt);
+            return recreated_evt_.get();
+        }
+
         // Disable pipeline tasks while we try to find the event from the
         // pipeline, or falling back to running a DB query. The tasks will
         // be re-enabled when this object goes out of scope.
@@ -8,6 +8,10 @@
 #include "cosim/EventAccessor.hpp"
 #include "cosim/Event.hpp"
 #include "cosim/CoSimApi.hpp"
+#include "cosim/EventCodec.hpp"
+#include <list>
+#include <map>
+#include <mutex>
 #include <unordered_set>
 
 namespace simdb::pipeline
@@ -159,13 +163,28 @@ namespace pegasus::cosim
         /// Recreate an old event from the pipeline when it is no longer in the cache.
         std::unique_ptr<Event> recreateEventFromPipeline_(uint64_t euid);
 
+        /// Get an old event from the decoded disk windows we are holding onto.
+        /// Returns null if the event's window is not in the window cache.
+        std::shared_ptr<Event> getEventFromWindowCache_(uint64_t euid);
+
         /// Recreate an old event from disk when it is no longer in the cache.
-        std::unique_ptr<Event> recreateEventFromDisk_(uint64_t euid);
+        /// The event's window (and the next windows in the access direction)
+        /// are added to the window cache.
+        std::shared_ptr<Event> recreateEventFromDisk_(uint64_t euid);
+
+        /// Called by the EventWriterStage on the DB thread after a window
+        /// was written to the CompressedEvents table.
+        void indexWindow_(uint64_t start_euid, uint64_t end_euid, int row_id);
 
         /// On postTeardown, ensure that all but the last event on disk
         /// says isLastEvent()=true.
         void ensureOnlyOneLastEventOnDisk_();
 
+        /// Load the Zstd dictionary of the given core/hart. Returns null if the
+        /// core/hart never wrote a dictionary.
+        static std::shared_ptr<const EventDictionary>
+        loadDictionary_(simdb::DatabaseManager* db_mgr, CoreId core_id, HartId hart_id);
+
         /// SimDB instance.
         simdb::DatabaseManager* db_mgr_ = nullptr;
 
@@ -186,6 +205,16 @@ namespace pegasus::cosim
         /// CoSimObserver associated with this pipeline.
         CoSimObserver* observer_ = nullptr;
 
+        /// Format used to encode new event windows ("cosim_event_codec" sim parameter).
+        const EventFormat event_format_;
+
+        /// Compresses new event windows ("cosim_event_compression" sim parameter).
+        /// Only used by the EventCompressorStage.
+        EventCompressor event_compressor_;
+
+        /// Dictionary used to read ZSTD_DICT windows back from disk (loaded on first use).
+        std::shared_ptr<const EventDictionary> disk_dictionary_;
+
         /// Flag which prevents us from updating the enabled extensions baseline
         /// during a flush operation.
         bool flushing_ = false;
@@ -219,6 +248,41 @@ namespace pegasus::cosim
         /// Event recreated from the pipeline snoopers.
         std::unique_ptr<Event> snooped_event_;
 
+        /// Location of a window in the CompressedEvents table.
+        struct WindowRow
+        {
+            uint64_t start_euid = 0;
+            int row_id = 0;
+        };
+
+        /// Index of the windows written to disk, keyed by their end euid. Lets us
+        /// find a window with a primary key lookup instead of an euid range query.
+        /// Filled in by the EventWriterStage, hence the mutex.
+        std::map<uint64_t, WindowRow> window_index_;
+        std::mutex window_index_mutex_;
+
+        /// Window read back from disk and decoded.
+        struct DecodedWindow
+        {
+            uint64_t start_euid = 0;
+            uint64_t end_euid = 0;
+            std::shared_ptr<EventList> evts;
+            bool prefetched = false;
+        };
+
+        /// LRU cache of decoded windows (most recently used first). Events are
+        /// returned by aliasing the window's shared_ptr, so evicting a window
+        /// does not invalidate events handed out by EventAccessors.
+        std::list<DecodedWindow> window_cache_;
+        static constexpr size_t NUM_CACHED_WINDOWS = 16;
+
+        /// When consecutive disk accesses hit neighboring windows, this many
+        /// windows beyond the requested one are read in the same DB query.
+        static constexpr size_t NUM_PREFETCH_WINDOWS = 4;
+
+        /// End euid of the last window accessed through the window cache.
+        sparta::utils::ValidValue<uint64_t> last_window_end_euid_;
+
         /// Has the simulation been stopped?
         bool sim_stopped_ = false;
 
@@ -228,6 +292,11 @@ namespace pegasus::cosim
         simdb::RunningMean avg_us_recreating_evts_from_pipeline_;
         size_t num_pipeline_evts_snooped_in_serialize_queue_ = 0;
         size_t num_pipeline_evts_snooped_in_db_queue_ = 0;
+        size_t num_window_cache_hits_ = 0;
+        size_t num_window_cache_misses_ = 0;
+        size_t num_window_index_misses_ = 0;
+        size_t num_windows_prefetched_ = 0;
+        size_t num_prefetched_windows_used_ = 0;
 
         /// Structure which holds a range of events serialized to a byte buffer.
         struct SerializedEvtsBuffer
@@ -239,6 +308,9 @@ namespace pegasus::cosim
             uint64_t end_arch_id = UINT64_MAX;
             CoreId core_id = UINT32_MAX;
             HartId hart_id = UINT32_MAX;
+            EventFormat format = EventFormat::COMPACT_V1;
+            CompressionCodec codec = CompressionCodec::ZLIB;
+            std::shared_ptr<const EventDictionary> dict;
         };
 
         friend class EventCompressorStage;
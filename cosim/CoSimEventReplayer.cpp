@@ -1,21 +1,17 @@
 #include "cosim/CoSimEventReplayer.hpp"
 #include "cosim/CoSimEventPipeline.hpp"
 #include "cosim/Event.hpp"
+#include "cosim/EventCodec.hpp"
 #include "sim/PegasusSim.hpp"
 #include "core/PegasusCore.hpp"
 #include "core/PegasusState.hpp"
 #include "sparta/app/SimulationConfiguration.hpp"
 #include "simdb/sqlite/DatabaseManager.hpp"
-#include "simdb/utils/Compress.hpp"
 #include "softfloat.h"
 
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/serialization/deque.hpp>
-#include <boost/serialization/vector.hpp>
-#include <boost/serialization/utility.hpp>
-#include <boost/iostreams/device/back_inserter.hpp>
-#include <boost/iostreams/stream.hpp>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
 
 namespace pegasus::cosim
 {
@@ -139,9 +135,23 @@ namespace pegasus::cosim
             apply_<uint64_t>(*event, state);
         }
 
+        restoreSoftFloatState(core_id, hart_id);
         return true;
     }
 
+    void CoSimEventReplayer::restoreSoftFloatState(CoreId core_id, HartId hart_id) const
+    {
+        const auto & event = last_event_.at(core_id).at(hart_id);
+        if (event)
+        {
+            const auto & flags = event->end_softfloat_flags_;
+            softfloat_roundingMode = flags.softfloat_roundingMode;
+            softfloat_detectTininess = flags.softfloat_detectTininess;
+            softfloat_exceptionFlags = flags.softfloat_exceptionFlags;
+            extF80_roundingPrecision = flags.extF80_roundingPrecision;
+        }
+    }
+
     const Event* CoSimEventReplayer::getLastEvent(CoreId core_id, HartId hart_id) const
     {
         return last_event_.at(core_id).at(hart_id).get();
@@ -173,13 +183,37 @@ namespace pegasus::cosim
             return std::make_shared<Event>(*evt);
         }
 
+        // Cache the window; the next requested event will usually be in it
+        if (!loadWindow_("StartArchId", "EndArchId", arch_id, core_id, hart_id))
+        {
+            return nullptr;
+        }
+
+        // If we got this far, the event uid must be within the returned list
+        if (auto evt = get_from_cache())
+        {
+            return std::make_shared<Event>(*evt);
+        }
+
+        throw simdb::DBException("Internal error occurred. Cannot find event with arch ID ")
+            << arch_id << ". Core " << core_id << ", hart " << hart_id << ", database '"
+            << db_mgr_->getDatabaseFilePath() << "'.";
+    }
+
+    bool CoSimEventReplayer::loadWindow_(const char* start_column, const char* end_column,
+                                         uint64_t id, CoreId core_id, HartId hart_id)
+    {
         std::vector<char> compressed_evts_bytes;
+        uint32_t format_version = 0;
+        uint32_t compression = 0;
 
         auto query = db_mgr_->createQuery("CompressedEvents");
-        query->addConstraintForUInt64("StartArchId", simdb::Constraints::LESS_EQUAL, arch_id);
-        query->addConstraintForUInt64("EndArchId", simdb::Constraints::GREATER_EQUAL, arch_id);
+        query->addConstraintForUInt64(start_column, simdb::Constraints::LESS_EQUAL, id);
+        query->addConstraintForUInt64(end_column, simdb::Constraints::GREATER_EQUAL, id);
         query->addConstraintForInt("CoreId", simdb::Constraints::EQUAL, (int)core_id);
         query->addConstraintForInt("HartId", simdb::Constraints::EQUAL, (int)hart_id);
+        query->select("FormatVersion", format_version);
+        query->select("Compression", compression);
         query->select("ZlibBlob", compressed_evts_bytes);
 
         auto result_set = query->getResultSet();
@@ -187,35 +221,210 @@ namespace pegasus::cosim
 
         if (compressed_evts_bytes.empty())
         {
-            return nullptr;
+            return false;
         }
 
-        // "Undo" the pipeline transforms. Start by undoing zlib.
-        std::vector<char> uncompressed_evts_bytes;
-        simdb::decompressData(compressed_evts_bytes, uncompressed_evts_bytes);
+        // "Undo" the pipeline transforms (compression and the event encoding)
+        const auto codec = static_cast<CompressionCodec>(compression);
+        std::shared_ptr<const EventDictionary> dict;
+        if (codec == CompressionCodec::ZSTD_DICT)
+        {
+            auto & cached_dict = dictionaries_[{core_id, hart_id}];
+            if (!cached_dict)
+            {
+                cached_dict = CoSimEventPipeline::loadDictionary_(db_mgr_.get(), core_id, hart_id);
+            }
+            dict = cached_dict;
+        }
+        EventCodec::decompress(compressed_evts_bytes, static_cast<EventFormat>(format_version),
+                               codec, dict.get(), cached_window_);
+        return true;
+    }
 
-        // Now undo boost::serialization
-        namespace bio = boost::iostreams;
-        bio::array_source src(uncompressed_evts_bytes.data(), uncompressed_evts_bytes.size());
-        bio::stream<bio::array_source> is(src);
-        boost::archive::binary_iarchive ia(is);
+    std::vector<uint64_t> CoSimEventReplayer::getWindowStartArchIds_(CoreId core_id,
+                                                                     HartId hart_id)
+    {
+        uint64_t start_arch_id = 0;
 
-        // Get the EventList and cache it; the next requested event will usually be in the cache
-        ia >> cached_window_;
+        auto query = db_mgr_->createQuery("CompressedEvents");
+        query->addConstraintForInt("CoreId", simdb::Constraints::EQUAL, (int)core_id);
+        query->addConstraintForInt("HartId", simdb::Constraints::EQUAL, (int)hart_id);
+        query->select("StartArchId", start_arch_id);
+        query->orderBy("StartArchId", simdb::QueryOrder::ASC);
 
-        // If we got this far, the event uid must be within the returned list
-        if (auto evt = get_from_cache())
+        std::vector<uint64_t> start_arch_ids;
+        auto result_set = query->getResultSet();
+        while (result_set.getNextRecord())
         {
-            return std::make_shared<Event>(*evt);
+            start_arch_ids.emplace_back(start_arch_id);
         }
+        return start_arch_ids;
+    }
 
-        throw simdb::DBException("Internal error occurred. Cannot find event with arch ID ")
-            << arch_id << ". Core " << core_id << ", hart " << hart_id << ", database '"
-            << db_mgr_->getDatabaseFilePath() << "'.";
+    void CoSimEventReplayer::seek(CoreId core_id, HartId hart_id, uint64_t arch_id)
+    {
+        if (arch_id < next_arch_id_)
+        {
+            throw sparta::SpartaException("Cannot seek backwards to arch ID ")
+                << arch_id << " (next arch ID is " << next_arch_id_
+                << "). Create a new CoSimEventReplayer instead.";
+        }
+
+        if (arch_id >= num_events_on_disk_)
+        {
+            throw sparta::SpartaException("Cannot seek to arch ID ")
+                << arch_id << ", there are only " << num_events_on_disk_ << " events on disk";
+        }
+
+        // Find the start of the target's window. The checkpointer committed a branch there.
+        const auto start_arch_ids = getWindowStartArchIds_(core_id, hart_id);
+        auto it = std::upper_bound(start_arch_ids.begin(), start_arch_ids.end(), arch_id);
+        uint64_t window_start = next_arch_id_;
+        if (it != start_arch_ids.begin())
+        {
+            window_start = std::max(*std::prev(it), next_arch_id_);
+        }
+
+        // Step through the checkpoints up to the window start. Registers and memory come
+        // from the checkpoints; only the extension changes (which are not checkpointed)
+        // have to be applied along the way. The last event is applied in full.
+        auto state = pegasus_sim_->getPegasusCore(core_id)->getPegasusState(hart_id);
+        auto replayer = checkpoint_replayers_.at(core_id).at(hart_id);
+        while (next_arch_id_ < window_start)
+        {
+            auto event = recreateEventFromDisk_(next_arch_id_++, core_id, hart_id);
+            replayer->step();
+
+            if (next_arch_id_ < window_start)
+            {
+                applyExtensionChanges_(*event, state);
+            }
+            else
+            {
+                last_event_.at(core_id).at(hart_id) = event;
+                if (reg_width_ == 8)
+                {
+                    apply_<uint32_t>(*event, state, true /*force mmu update*/);
+                }
+                else
+                {
+                    apply_<uint64_t>(*event, state, true /*force mmu update*/);
+                }
+                restoreSoftFloatState(core_id, hart_id);
+            }
+        }
+
+        // Replay the tail of the window
+        while (next_arch_id_ < arch_id)
+        {
+            step(core_id, hart_id);
+        }
+    }
+
+    void CoSimEventReplayer::seekToEuid(CoreId core_id, HartId hart_id, uint64_t euid)
+    {
+        if (loadWindow_("StartEuid", "EndEuid", euid, core_id, hart_id))
+        {
+            for (const auto & evt : cached_window_)
+            {
+                if (evt.getEuid() == euid)
+                {
+                    seek(core_id, hart_id, evt.getArchId());
+                    return;
+                }
+            }
+        }
+
+        throw sparta::SpartaException("Cannot seek to event uid ")
+            << euid << ", it is not on disk. Core " << core_id << ", hart " << hart_id;
+    }
+
+    std::vector<CoSimEventReplayer::Mismatch>
+    CoSimEventReplayer::checkConsistency(CoreId core_id, HartId hart_id, uint64_t num_events)
+    {
+        std::vector<Mismatch> mismatches;
+        for (uint64_t i = 0; i < num_events; ++i)
+        {
+            if (!step(core_id, hart_id))
+            {
+                break;
+            }
+
+            const auto event_mismatches = checkLastEvent(core_id, hart_id);
+            mismatches.insert(mismatches.end(), event_mismatches.begin(),
+                              event_mismatches.end());
+        }
+
+        return mismatches;
+    }
+
+    std::vector<CoSimEventReplayer::Mismatch>
+    CoSimEventReplayer::checkLastEvent(CoreId core_id, HartId hart_id) const
+    {
+        std::vector<Mismatch> mismatches;
+        const auto & event = last_event_.at(core_id).at(hart_id);
+        if (event == nullptr)
+        {
+            return mismatches;
+        }
+
+        auto state = pegasus_sim_->getPegasusCore(core_id)->getPegasusState(hart_id);
+        if (reg_width_ == 8)
+        {
+            checkRegisterWrites_<uint32_t>(*event, state, mismatches);
+        }
+        else
+        {
+            checkRegisterWrites_<uint64_t>(*event, state, mismatches);
+        }
+        return mismatches;
+    }
+
+    template <typename XLEN>
+    void CoSimEventReplayer::checkRegisterWrites_(const Event & evt, PegasusState* state,
+                                                  std::vector<Mismatch> & mismatches)
+    {
+        std::vector<uint8_t> actual_value;
+        for (const auto & reg_write : evt.getRegisterWrites())
+        {
+            // CSR writes can be masked or aliased by later writes of the same instruction
+            if ((reg_write.reg_id.reg_type != RegType::INTEGER)
+                && (reg_write.reg_id.reg_type != RegType::FLOATING_POINT))
+            {
+                continue;
+            }
+
+            sparta::Register* reg = state->findRegister(reg_write.reg_id);
+            if (reg == nullptr)
+            {
+                continue;
+            }
+
+            actual_value.resize(reg->getNumBytes());
+            reg->peek(actual_value.data(), actual_value.size(), 0);
+
+            const size_t num_bytes = std::min(actual_value.size(), reg_write.value.size());
+            if (!std::equal(actual_value.begin(), actual_value.begin() + num_bytes,
+                            reg_write.value.begin()))
+            {
+                XLEN expected = 0;
+                XLEN actual = 0;
+                std::memcpy(&expected, reg_write.value.data(),
+                            std::min(sizeof(XLEN), reg_write.value.size()));
+                std::memcpy(&actual, actual_value.data(),
+                            std::min(sizeof(XLEN), actual_value.size()));
+
+                std::ostringstream oss;
+                oss << "Register " << reg_write.reg_id.reg_name << " holds 0x" << std::hex
+                    << actual << " but the event wrote 0x" << expected;
+                mismatches.emplace_back(Mismatch{evt.getEuid(), evt.getArchId(), oss.str()});
+            }
+        }
     }
 
     template <typename XLEN>
-    void CoSimEventReplayer::apply_(const Event & reload_evt, PegasusState* state)
+    void CoSimEventReplayer::apply_(const Event & reload_evt, PegasusState* state,
+                                    bool force_mmu_update)
     {
         static_assert(std::is_same_v<XLEN, uint32_t> || std::is_same_v<XLEN, uint64_t>);
 
@@ -236,12 +445,6 @@ namespace pegasus::cosim
             state->getCore()->getReservation(hart_id).clearValid();
         }
 
-        // softfloat
-        softfloat_roundingMode = reload_evt.end_softfloat_flags_.softfloat_roundingMode;
-        softfloat_detectTininess = reload_evt.end_softfloat_flags_.softfloat_detectTininess;
-        softfloat_exceptionFlags = reload_evt.end_softfloat_flags_.softfloat_exceptionFlags;
-        extF80_roundingPrecision = reload_evt.end_softfloat_flags_.extF80_roundingPrecision;
-
         // sim state
         auto sim_state = state->getSimState();
         sim_state->reset();
@@ -254,9 +457,10 @@ namespace pegasus::cosim
             sim_state->workload_exit_code = reload_evt.getWorkloadExitCode();
             sim_state->test_passed = sim_state->workload_exit_code == 0;
         }
+        state->rebaseCounterCsrs();
 
         // mmu mode / translation mode
-        bool change_mmu_mode = false;
+        bool change_mmu_mode = force_mmu_update;
         change_mmu_mode |= reload_evt.curr_priv_ != reload_evt.next_priv_;
         change_mmu_mode |= reload_evt.curr_ldst_priv_ != reload_evt.next_ldst_priv_;
         if (!change_mmu_mode && reload_evt.inst_csr_ != std::numeric_limits<uint32_t>::max())
@@ -294,6 +498,11 @@ namespace pegasus::cosim
         }
 
         // enabled extensions
+        applyExtensionChanges_(reload_evt, state);
+    }
+
+    void CoSimEventReplayer::applyExtensionChanges_(const Event & reload_evt, PegasusState* state)
+    {
         std::vector<std::string> exts_to_enable;
         std::vector<std::string> exts_to_disable;
         const auto & ext_changes = reload_evt.extension_changes_;
@@ -4,7 +4,10 @@
 #include "cosim/CoSimApi.hpp"
 #include "sparta/utils/ValidValue.hpp"
 #include "sparta/serialization/checkpoint/CherryPickFastCheckpointer.hpp"
+#include <limits>
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace sparta
@@ -33,6 +36,7 @@ namespace pegasus::cosim
 
     class CoSimEventPipeline;
     class Event;
+    class EventDictionary;
 
     class CoSimEventReplayer
     {
@@ -47,14 +51,73 @@ namespace pegasus::cosim
 
         const Event* getLastEvent(CoreId core_id, HartId hart_id) const;
 
+        /// Total number of events in the database
+        uint64_t getNumEventsOnDisk() const { return num_events_on_disk_; }
+
+        /// Arch ID of the event the next step() will replay
+        uint64_t getNextArchId() const { return next_arch_id_; }
+
+        /// Position the replayer so that the next step() replays the event with the given
+        /// arch ID. Up to the start of the target's window (where the pipeline committed a
+        /// checkpoint branch) only the checkpoints and the extension changes are replayed;
+        /// the events from there to the target are replayed in full.
+        /// Seeking backwards is not supported; create a new replayer instead.
+        void seek(CoreId core_id, HartId hart_id, uint64_t arch_id);
+
+        /// Same as seek(), for the event with the given event uid
+        void seekToEuid(CoreId core_id, HartId hart_id, uint64_t euid);
+
+        /// Inconsistency found by checkConsistency()
+        struct Mismatch
+        {
+            uint64_t euid = 0;
+            uint64_t arch_id = 0;
+            std::string description;
+        };
+
+        /// Replay up to 'num_events' events and check that every integer and FP register
+        /// written by an event holds the written value after the event is applied. The
+        /// instructions are not executed again: this checks that the event log and the
+        /// checkpoints recorded with it agree, not that the simulation was correct.
+        std::vector<Mismatch>
+        checkConsistency(CoreId core_id, HartId hart_id,
+                         uint64_t num_events = std::numeric_limits<uint64_t>::max());
+
+        /// Check that every integer and FP register written by the last event replayed on the
+        /// core/hart holds the written value. checkConsistency() does this after every step.
+        std::vector<Mismatch> checkLastEvent(CoreId core_id, HartId hart_id) const;
+
+        /// SoftFloat keeps its rounding mode and exception flags in process-wide globals, so
+        /// they are not part of the replayed PegasusSim. Write the values at the end of the
+        /// last event replayed on the core/hart to the globals. step() and seek() do this.
+        void restoreSoftFloatState(CoreId core_id, HartId hart_id) const;
+
       private:
         std::shared_ptr<Event> recreateEventFromDisk_(uint64_t arch_id, CoreId core_id,
                                                       HartId hart_id);
 
+        /// Load and decode the window whose [start_column, end_column] range contains
+        /// 'id' into cached_window_. Returns false if there is no such window.
+        bool loadWindow_(const char* start_column, const char* end_column, uint64_t id,
+                         CoreId core_id, HartId hart_id);
+
+        /// Get the start arch ID of every window of the core/hart, in order
+        std::vector<uint64_t> getWindowStartArchIds_(CoreId core_id, HartId hart_id);
+
         using CheckpointReplayer = sparta::serialization::checkpoint::CherryPickFastCheckpointer::
             DatabaseCheckpointReplayer;
 
-        template <typename XLEN> static void apply_(const Event & reload_evt, PegasusState* state);
+        /// Apply the event's changes that are not in the checkpoints. After a seek the
+        /// translation mode is updated even if the event did not change it.
+        template <typename XLEN>
+        static void apply_(const Event & reload_evt, PegasusState* state,
+                           bool force_mmu_update = false);
+
+        static void applyExtensionChanges_(const Event & reload_evt, PegasusState* state);
+
+        template <typename XLEN>
+        static void checkRegisterWrites_(const Event & evt, PegasusState* state,
+                                         std::vector<Mismatch> & mismatches);
 
         std::shared_ptr<simdb::DatabaseManager> db_mgr_;
         std::shared_ptr<sparta::Scheduler> scheduler_;
@@ -67,6 +130,9 @@ namespace pegasus::cosim
         uint64_t num_events_on_disk_ = 0;
         size_t reg_width_ = 0;
         EventList cached_window_;
+
+        // Zstd dictionaries of each core/hart, loaded on first use
+        std::map<std::pair<CoreId, HartId>, std::shared_ptr<const EventDictionary>> dictionaries_;
     };
 
 } // namespace pegasus::cosim
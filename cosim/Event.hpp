@@ -23,6 +23,7 @@ namespace pegasus::cosim
     class CoSimEventPipeline;
     class CoSimObserver;
     class CoSimEventReplayer;
+    class EventCodec;
 
     /*!
      * \class Event
@@ -419,6 +420,8 @@ namespace pegasus::cosim
           private:
             std::pair<sparta::utils::ValidValue<uint64_t>, sparta::utils::ValidValue<uint64_t>>
                 diff_;
+
+            friend class EventCodec;
         };
 
         ECallX10Changes ecall_x10_changes_;
@@ -513,6 +516,7 @@ namespace pegasus::cosim
         friend class CoSimEventPipeline;
         friend class EventCompressorStage;
         friend class CoSimEventReplayer;
+        friend class EventCodec;
     };
 
     inline std::ostream & operator<<(std::ostream & os, const Event::Type & type)
@@ -0,0 +1,801 @@
+#include "cosim/EventCodec.hpp"
+#include "sparta/utils/SpartaException.hpp"
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/deque.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <cstring>
+#include <unordered_map>
+
+namespace pegasus::cosim
+{
+    namespace
+    {
+        // Bits of the per-event mask of fields which differ from their prediction. The fields
+        // which change most often get the low bits so the mask usually fits in a single byte.
+        enum Field : uint32_t
+        {
+            OPCODE,
+            DASM,
+            OPCODE_SIZE,
+            INST_TYPE,
+            NEXT_PC,
+            CURR_PC,
+            INST_CSR,
+            EUID,
+            SIM_UID,
+            TYPE,
+            CORE_ID,
+            HART_ID,
+            EXIT_CODE,
+            ARCH_ID,
+            ALT_NEXT_PC,
+            CURR_PRIV,
+            NEXT_PRIV,
+            CURR_LDST_PRIV,
+            NEXT_LDST_PRIV,
+            EXCP_TYPE,
+            EXCP_CODE,
+            PREV_EXCP_CODE,
+            START_RESV,
+            END_RESV,
+            START_SF_FLAGS,
+            END_SF_FLAGS,
+            X10_BEFORE,
+            X10_AFTER
+        };
+
+        // Bits of the per-event flags. They are stored XOR'd with the previous event's flags.
+        enum Flag : uint32_t
+        {
+            EUID_VALID,
+            DONE,
+            EXIT_CODE_VALID,
+            IN_ROI,
+            ENTERING_ROI,
+            EXITING_ROI,
+            CHANGE_OF_FLOW,
+            START_RESV_VALID,
+            END_RESV_VALID,
+            X10_BEFORE_VALID,
+            X10_AFTER_VALID,
+            HAS_REG_READS,
+            HAS_REG_WRITES,
+            HAS_MEM_READS,
+            HAS_MEM_WRITES,
+            HAS_EXT_CHANGES
+        };
+
+        static_assert(translate_types::N_TRANS_STAGES * 4 <= 64);
+
+        inline uint64_t zigzag(uint64_t delta)
+        {
+            return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+        }
+
+        inline uint64_t unzigzag(uint64_t val) { return (val >> 1) ^ (~(val & 1) + 1); }
+
+        template <size_t N> uint64_t packPrivModes(const std::array<PrivMode, N> & privs)
+        {
+            uint64_t packed = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                packed |= static_cast<uint64_t>(privs[i]) << (4 * i);
+            }
+            return packed;
+        }
+
+        template <size_t N> void unpackPrivModes(uint64_t packed, std::array<PrivMode, N> & privs)
+        {
+            for (size_t i = 0; i < N; ++i)
+            {
+                privs[i] = static_cast<PrivMode>((packed >> (4 * i)) & 0xf);
+            }
+        }
+
+        template <typename FlagsT> uint64_t packSoftfloatFlags(const FlagsT & flags)
+        {
+            return static_cast<uint64_t>(flags.softfloat_roundingMode)
+                   | (static_cast<uint64_t>(flags.softfloat_detectTininess) << 8)
+                   | (static_cast<uint64_t>(flags.softfloat_exceptionFlags) << 16)
+                   | (static_cast<uint64_t>(flags.extF80_roundingPrecision) << 24);
+        }
+
+        template <typename FlagsT> void unpackSoftfloatFlags(uint64_t packed, FlagsT & flags)
+        {
+            flags.softfloat_roundingMode = packed & 0xff;
+            flags.softfloat_detectTininess = (packed >> 8) & 0xff;
+            flags.softfloat_exceptionFlags = (packed >> 16) & 0xff;
+            flags.extF80_roundingPrecision = (packed >> 24) & 0xff;
+        }
+
+        class ByteWriter
+        {
+          public:
+            explicit ByteWriter(std::vector<char> & bytes) : bytes_(bytes) {}
+
+            void writeVarint(uint64_t val)
+            {
+                while (val >= 0x80)
+                {
+                    bytes_.push_back(static_cast<char>((val & 0x7f) | 0x80));
+                    val >>= 7;
+                }
+                bytes_.push_back(static_cast<char>(val));
+            }
+
+            void writeDelta(uint64_t val, uint64_t pred) { writeVarint(zigzag(val - pred)); }
+
+            void writeBytes(const void* data, size_t size)
+            {
+                const char* begin = static_cast<const char*>(data);
+                bytes_.insert(bytes_.end(), begin, begin + size);
+            }
+
+            void writeString(const std::string & str)
+            {
+                writeVarint(str.size());
+                writeBytes(str.data(), str.size());
+            }
+
+            // Values of up to 8 bytes (integer registers, most memory accesses) are stored as
+            // a varint, anything larger is stored raw
+            void writeValue(const std::vector<uint8_t> & value)
+            {
+                writeVarint(value.size());
+                if (value.size() <= sizeof(uint64_t))
+                {
+                    uint64_t val = 0;
+                    std::memcpy(&val, value.data(), value.size());
+                    writeVarint(val);
+                }
+                else
+                {
+                    writeBytes(value.data(), value.size());
+                }
+            }
+
+          private:
+            std::vector<char> & bytes_;
+        };
+
+        class ByteReader
+        {
+          public:
+            explicit ByteReader(const std::vector<char> & bytes) : bytes_(bytes) {}
+
+            uint64_t readVarint()
+            {
+                uint64_t val = 0;
+                for (uint32_t shift = 0; shift < 64; shift += 7)
+                {
+                    checkAvailable_(1);
+                    const uint8_t byte = static_cast<uint8_t>(bytes_[pos_++]);
+                    val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        return val;
+                    }
+                }
+                throw sparta::SpartaException("Corrupt compact event data: varint too long");
+            }
+
+            uint64_t readDelta(uint64_t pred) { return pred + unzigzag(readVarint()); }
+
+            void readBytes(void* data, size_t size)
+            {
+                checkAvailable_(size);
+                std::memcpy(data, bytes_.data() + pos_, size);
+                pos_ += size;
+            }
+
+            std::string readString()
+            {
+                const size_t size = readVarint();
+                checkAvailable_(size);
+                std::string str(bytes_.data() + pos_, size);
+                pos_ += size;
+                return str;
+            }
+
+            void readValue(std::vector<uint8_t> & value)
+            {
+                const size_t size = readVarint();
+                if (size <= sizeof(uint64_t))
+                {
+                    const uint64_t val = readVarint();
+                    value.resize(size);
+                    std::memcpy(value.data(), &val, size);
+                }
+                else
+                {
+                    checkAvailable_(size);
+                    value.assign(bytes_.data() + pos_, bytes_.data() + pos_ + size);
+                    pos_ += size;
+                }
+            }
+
+            bool atEnd() const { return pos_ == bytes_.size(); }
+
+          private:
+            void checkAvailable_(size_t size) const
+            {
+                if (size > (bytes_.size() - pos_))
+                {
+                    throw sparta::SpartaException("Corrupt compact event data: read past the end "
+                                                  "of a ")
+                        << bytes_.size() << " byte window";
+                }
+            }
+
+            const std::vector<char> & bytes_;
+            size_t pos_ = 0;
+        };
+    } // namespace
+
+    /// Per-window state shared by the compact encoder and decoder. Tables are rebuilt for
+    /// every window so that each blob can be decoded on its own.
+    struct EventCodec::CompactWindow
+    {
+        ByteWriter* writer = nullptr;
+        ByteReader* reader = nullptr;
+
+        // Interned strings (disassembly and extension names)
+        std::unordered_map<std::string, uint32_t> string_ids;
+        std::vector<std::string> strings;
+
+        // Interned register IDs, looked up by (type, num) when encoding
+        std::unordered_map<uint64_t, uint32_t> reg_ids;
+        std::vector<RegId> regs;
+
+        // Last value seen for each interned register
+        std::vector<std::vector<uint8_t>> reg_values;
+
+        // Last memory access physical address
+        Addr paddr = 0;
+
+        // Field deltas of the event being encoded; written after the field mask
+        std::vector<char> scratch;
+
+        void writeStringRef(ByteWriter & out, const std::string & str)
+        {
+            auto [it, inserted] = string_ids.emplace(str, strings.size());
+            out.writeVarint(it->second);
+            if (inserted)
+            {
+                strings.emplace_back(str);
+                out.writeString(str);
+            }
+        }
+
+        const std::string & readStringRef()
+        {
+            const uint64_t id = reader->readVarint();
+            if (id == strings.size())
+            {
+                strings.emplace_back(reader->readString());
+            }
+            else if (id > strings.size())
+            {
+                throw sparta::SpartaException("Corrupt compact event data: bad string id ") << id;
+            }
+            return strings[id];
+        }
+
+        static uint64_t getRegKey(const RegId & reg_id)
+        {
+            return (static_cast<uint64_t>(reg_id.reg_type) << 32) | reg_id.reg_num;
+        }
+
+        // Returns regs.size() if the register has not been seen in this window
+        uint32_t findReg(const RegId & reg_id) const
+        {
+            auto it = reg_ids.find(getRegKey(reg_id));
+            if (it == reg_ids.end())
+            {
+                return regs.size();
+            }
+            else if (regs[it->second].reg_name == reg_id.reg_name)
+            {
+                return it->second;
+            }
+            return std::find(regs.begin(), regs.end(), reg_id) - regs.begin();
+        }
+
+        const std::vector<uint8_t> & getLastValue(uint32_t idx) const
+        {
+            static const std::vector<uint8_t> unknown;
+            return (idx < reg_values.size()) ? reg_values[idx] : unknown;
+        }
+
+        // The register reference is the table index shifted left by one with 'tag' in bit 0.
+        // A register seen for the first time in this window is followed by its definition.
+        void writeRegRef(uint32_t idx, const RegId & reg_id, bool tag)
+        {
+            writer->writeVarint((static_cast<uint64_t>(idx) << 1) | tag);
+            if (idx == regs.size())
+            {
+                writer->writeVarint(static_cast<uint64_t>(reg_id.reg_type));
+                writer->writeVarint(reg_id.reg_num);
+                writer->writeString(reg_id.reg_name);
+                reg_ids.emplace(getRegKey(reg_id), idx);
+                regs.emplace_back(reg_id);
+                reg_values.emplace_back();
+            }
+        }
+
+        uint32_t readRegRef(bool & tag)
+        {
+            const uint64_t ref = reader->readVarint();
+            const uint64_t idx = ref >> 1;
+            tag = ref & 1;
+            if (idx == regs.size())
+            {
+                RegId reg_id;
+                reg_id.reg_type = static_cast<RegType>(reader->readVarint());
+                reg_id.reg_num = reader->readVarint();
+                reg_id.reg_name = reader->readString();
+                regs.emplace_back(std::move(reg_id));
+                reg_values.emplace_back();
+            }
+            else if (idx > regs.size())
+            {
+                throw sparta::SpartaException("Corrupt compact event data: bad register id ")
+                    << idx;
+            }
+            return idx;
+        }
+    };
+
+    EventFormat EventCodec::getFormat(const std::string & name)
+    {
+        if (name == "boost")
+        {
+            return EventFormat::BOOST;
+        }
+        else if (name == "compact")
+        {
+            return EventFormat::COMPACT_V1;
+        }
+        throw sparta::SpartaException("Unknown cosim event codec '")
+            << name << "'. Valid codecs are 'boost' and 'compact'.";
+    }
+
+    void EventCodec::encode(const EventList & evts, EventFormat format, std::vector<char> & bytes)
+    {
+        bytes.clear();
+        switch (format)
+        {
+            case EventFormat::BOOST:
+            {
+                namespace bio = boost::iostreams;
+                bio::back_insert_device<std::vector<char>> inserter(bytes);
+                bio::stream<bio::back_insert_device<std::vector<char>>> os(inserter);
+                boost::archive::binary_oarchive oa(os);
+                oa << evts;
+                os.flush();
+                return;
+            }
+            case EventFormat::COMPACT_V1:
+            {
+                ByteWriter out(bytes);
+                out.writeVarint(evts.size());
+
+                CompactWindow window;
+                window.writer = &out;
+                const Event initial{};
+                const Event* prev = &initial;
+                for (const auto & evt : evts)
+                {
+                    encodeCompact_(evt, *prev, window);
+                    prev = &evt;
+                }
+                return;
+            }
+        }
+        throw sparta::SpartaException("Unknown event format ") << static_cast<uint32_t>(format);
+    }
+
+    void EventCodec::decode(const std::vector<char> & bytes, EventFormat format, EventList & evts)
+    {
+        evts.clear();
+        switch (format)
+        {
+            case EventFormat::BOOST:
+            {
+                namespace bio = boost::iostreams;
+                bio::array_source src(bytes.data(), bytes.size());
+                bio::stream<bio::array_source> is(src);
+                boost::archive::binary_iarchive ia(is);
+                ia >> evts;
+                return;
+            }
+            case EventFormat::COMPACT_V1:
+            {
+                ByteReader in(bytes);
+                const uint64_t num_evts = in.readVarint();
+
+                CompactWindow window;
+                window.reader = &in;
+                const Event initial{};
+                for (uint64_t i = 0; i < num_evts; ++i)
+                {
+                    Event evt;
+                    decodeCompact_(evt, evts.empty() ? initial : evts.back(), window);
+                    evts.emplace_back(std::move(evt));
+                }
+
+                if (!in.atEnd())
+                {
+                    throw sparta::SpartaException(
+                        "Corrupt compact event data: trailing bytes after ")
+                        << num_evts << " events";
+                }
+                return;
+            }
+        }
+        throw sparta::SpartaException("Unknown event format ") << static_cast<uint32_t>(format);
+    }
+
+    void EventCodec::compress(const EventList & evts, EventFormat format, CompressionCodec codec,
+                              const EventDictionary* dict, std::vector<char> & bytes)
+    {
+        std::vector<char> uncompressed_bytes;
+        encode(evts, format, uncompressed_bytes);
+        EventCompressor::compress(uncompressed_bytes, codec, 0, dict, bytes);
+    }
+
+    void EventCodec::decompress(const std::vector<char> & bytes, EventFormat format,
+                                CompressionCodec codec, const EventDictionary* dict,
+                                EventList & evts)
+    {
+        std::vector<char> uncompressed_bytes;
+        EventCompressor::decompress(bytes, codec, dict, uncompressed_bytes);
+        decode(uncompressed_bytes, format, evts);
+    }
+
+    uint32_t EventCodec::getFlags_(const Event & evt)
+    {
+        const auto & x10_diff = evt.ecall_x10_changes_.diff_;
+        return (evt.event_uid_.isValid() << EUID_VALID) | (evt.done_ << DONE)
+               | (evt.workload_exit_code_.isValid() << EXIT_CODE_VALID)
+               | (evt.is_in_region_of_interest_ << IN_ROI)
+               | (evt.is_entering_region_of_interest_ << ENTERING_ROI)
+               | (evt.is_exiting_region_of_interest_ << EXITING_ROI)
+               | (evt.is_change_of_flow_ << CHANGE_OF_FLOW)
+               | (evt.start_reservation_.isValid() << START_RESV_VALID)
+               | (evt.end_reservation_.isValid() << END_RESV_VALID)
+               | (x10_diff.first.isValid() << X10_BEFORE_VALID)
+               | (x10_diff.second.isValid() << X10_AFTER_VALID)
+               | (!evt.register_reads_.empty() << HAS_REG_READS)
+               | (!evt.register_writes_.empty() << HAS_REG_WRITES)
+               | (!evt.memory_reads_.empty() << HAS_MEM_READS)
+               | (!evt.memory_writes_.empty() << HAS_MEM_WRITES)
+               | (!evt.extension_changes_.empty() << HAS_EXT_CHANGES);
+    }
+
+    void EventCodec::encodeCompact_(const Event & evt, const Event & prev, CompactWindow & window)
+    {
+        ByteWriter & out = *window.writer;
+        const uint32_t flags = getFlags_(evt);
+
+        window.scratch.clear();
+        ByteWriter fields(window.scratch);
+        uint64_t mask = 0;
+        auto field = [&](Field f, uint64_t val, uint64_t pred)
+        {
+            if (val != pred)
+            {
+                mask |= 1ull << f;
+                fields.writeDelta(val, pred);
+            }
+        };
+
+        // The decoder recreates the fields in this order, so a prediction can only use fields
+        // of the previous event and fields of this event that come before it
+        if (evt.event_uid_.isValid())
+        {
+            field(EUID, evt.getEuid(), prev.event_uid_.isValid() ? prev.getEuid() + 1 : 0);
+        }
+        field(SIM_UID, evt.sim_state_current_uid_, prev.sim_state_current_uid_ + 1);
+        field(TYPE, static_cast<uint64_t>(evt.type_), static_cast<uint64_t>(prev.type_));
+        field(CORE_ID, evt.core_id_, prev.core_id_);
+        field(HART_ID, evt.hart_id_, prev.hart_id_);
+        if (evt.workload_exit_code_.isValid())
+        {
+            field(EXIT_CODE, static_cast<int64_t>(evt.getWorkloadExitCode()), 0);
+        }
+        field(ARCH_ID, evt.arch_id_, prev.arch_id_ + 1);
+        field(OPCODE, evt.opcode_, prev.opcode_);
+        field(OPCODE_SIZE, evt.opcode_size_, prev.opcode_size_);
+        field(INST_TYPE, static_cast<uint64_t>(evt.inst_type_),
+              static_cast<uint64_t>(prev.inst_type_));
+        field(CURR_PC, evt.curr_pc_, prev.next_pc_);
+        field(NEXT_PC, evt.next_pc_, evt.curr_pc_ + evt.opcode_size_);
+        field(ALT_NEXT_PC, evt.alternate_next_pc_, prev.alternate_next_pc_);
+        field(CURR_PRIV, static_cast<uint64_t>(evt.curr_priv_),
+              static_cast<uint64_t>(prev.next_priv_));
+        field(NEXT_PRIV, static_cast<uint64_t>(evt.next_priv_),
+              static_cast<uint64_t>(evt.curr_priv_));
+        field(CURR_LDST_PRIV, packPrivModes(evt.curr_ldst_priv_),
+              packPrivModes(prev.next_ldst_priv_));
+        field(NEXT_LDST_PRIV, packPrivModes(evt.next_ldst_priv_),
+              packPrivModes(evt.curr_ldst_priv_));
+        field(EXCP_TYPE, static_cast<uint64_t>(evt.excp_type_),
+              static_cast<uint64_t>(prev.excp_type_));
+        field(EXCP_CODE, evt.excp_code_, prev.excp_code_);
+        field(PREV_EXCP_CODE, evt.prev_excp_code_, prev.prev_excp_code_);
+        field(INST_CSR, evt.inst_csr_, prev.inst_csr_);
+        if (evt.start_reservation_.isValid())
+        {
+            const bool prev_valid = prev.end_reservation_.isValid();
+            field(START_RESV, evt.start_reservation_.getValue(),
+                  prev_valid ? prev.end_reservation_.getValue() : 0);
+        }
+        if (evt.end_reservation_.isValid())
+        {
+            const bool start_valid = evt.start_reservation_.isValid();
+            field(END_RESV, evt.end_reservation_.getValue(),
+                  start_valid ? evt.start_reservation_.getValue() : 0);
+        }
+        field(START_SF_FLAGS, packSoftfloatFlags(evt.start_softfloat_flags_),
+              packSoftfloatFlags(prev.end_softfloat_flags_));
+        field(END_SF_FLAGS, packSoftfloatFlags(evt.end_softfloat_flags_),
+              packSoftfloatFlags(evt.start_softfloat_flags_));
+        const auto & x10_diff = evt.ecall_x10_changes_.diff_;
+        if (x10_diff.first.isValid())
+        {
+            field(X10_BEFORE, x10_diff.first.getValue(), 0);
+        }
+        if (x10_diff.second.isValid())
+        {
+            field(X10_AFTER, x10_diff.second.getValue(),
+                  x10_diff.first.isValid() ? x10_diff.first.getValue() : 0);
+        }
+        if (evt.dasm_string_ != prev.dasm_string_)
+        {
+            mask |= 1ull << DASM;
+            window.writeStringRef(fields, evt.dasm_string_);
+        }
+
+        out.writeVarint(flags ^ getFlags_(prev));
+        out.writeVarint(mask);
+        out.writeBytes(window.scratch.data(), window.scratch.size());
+
+        // Register accesses. Bit 0 of the register reference says whether the value (reads)
+        // or the previous value (writes) differs from the last value seen for that register.
+        if (flags & (1u << HAS_REG_READS))
+        {
+            out.writeVarint(evt.register_reads_.size());
+            for (const auto & read : evt.register_reads_)
+            {
+                const uint32_t idx = window.findReg(read.reg_id);
+                const bool explicit_value = read.value != window.getLastValue(idx);
+                window.writeRegRef(idx, read.reg_id, explicit_value);
+                if (explicit_value)
+                {
+                    out.writeValue(read.value);
+                    window.reg_values[idx] = read.value;
+                }
+            }
+        }
+        if (flags & (1u << HAS_REG_WRITES))
+        {
+            out.writeVarint(evt.register_writes_.size());
+            for (const auto & write : evt.register_writes_)
+            {
+                const uint32_t idx = window.findReg(write.reg_id);
+                const bool explicit_prev = write.prev_value != window.getLastValue(idx);
+                window.writeRegRef(idx, write.reg_id, explicit_prev);
+                if (explicit_prev)
+                {
+                    out.writeValue(write.prev_value);
+                }
+                out.writeValue(write.value);
+                window.reg_values[idx] = write.value;
+            }
+        }
+
+        // Memory accesses. Physical addresses are stored relative to the previous access and
+        // virtual addresses relative to the physical address.
+        auto write_mem_access = [&](const Event::MemReadAccess & access)
+        {
+            out.writeVarint(static_cast<uint64_t>(access.source));
+            out.writeDelta(access.paddr, window.paddr);
+            out.writeDelta(access.vaddr, access.paddr);
+            out.writeVarint(access.size);
+            out.writeValue(access.value);
+            window.paddr = access.paddr;
+        };
+        if (flags & (1u << HAS_MEM_READS))
+        {
+            out.writeVarint(evt.memory_reads_.size());
+            for (const auto & read : evt.memory_reads_)
+            {
+                write_mem_access(read);
+            }
+        }
+        if (flags & (1u << HAS_MEM_WRITES))
+        {
+            out.writeVarint(evt.memory_writes_.size());
+            for (const auto & write : evt.memory_writes_)
+            {
+                write_mem_access(write);
+                out.writeValue(write.prev_value);
+            }
+        }
+
+        if (flags & (1u << HAS_EXT_CHANGES))
+        {
+            out.writeVarint(evt.extension_changes_.size());
+            for (const auto & change : evt.extension_changes_)
+            {
+                out.writeVarint(change.extensions.size());
+                for (const auto & ext : change.extensions)
+                {
+                    window.writeStringRef(out, ext);
+                }
+                out.writeVarint(change.enabled);
+            }
+        }
+    }
+
+    void EventCodec::decodeCompact_(Event & evt, const Event & prev, CompactWindow & window)
+    {
+        ByteReader & in = *window.reader;
+        const uint32_t flags = in.readVarint() ^ getFlags_(prev);
+        const uint64_t mask = in.readVarint();
+        auto has_flag = [flags](Flag f) { return (flags & (1u << f)) != 0; };
+        auto field = [&](Field f, uint64_t pred)
+        { return (mask & (1ull << f)) ? in.readDelta(pred) : pred; };
+
+        if (has_flag(EUID_VALID))
+        {
+            evt.event_uid_ = field(EUID, prev.event_uid_.isValid() ? prev.getEuid() + 1 : 0);
+        }
+        evt.sim_state_current_uid_ = field(SIM_UID, prev.sim_state_current_uid_ + 1);
+        evt.type_ = static_cast<Event::Type>(field(TYPE, static_cast<uint64_t>(prev.type_)));
+        evt.core_id_ = field(CORE_ID, prev.core_id_);
+        evt.hart_id_ = field(HART_ID, prev.hart_id_);
+        evt.done_ = has_flag(DONE);
+        if (has_flag(EXIT_CODE_VALID))
+        {
+            evt.workload_exit_code_ = static_cast<int>(static_cast<int64_t>(field(EXIT_CODE, 0)));
+        }
+        evt.is_in_region_of_interest_ = has_flag(IN_ROI);
+        evt.is_entering_region_of_interest_ = has_flag(ENTERING_ROI);
+        evt.is_exiting_region_of_interest_ = has_flag(EXITING_ROI);
+        evt.arch_id_ = field(ARCH_ID, prev.arch_id_ + 1);
+        evt.opcode_ = field(OPCODE, prev.opcode_);
+        evt.opcode_size_ = field(OPCODE_SIZE, prev.opcode_size_);
+        evt.inst_type_ =
+            static_cast<InstType>(field(INST_TYPE, static_cast<uint64_t>(prev.inst_type_)));
+        evt.is_change_of_flow_ = has_flag(CHANGE_OF_FLOW);
+        evt.curr_pc_ = field(CURR_PC, prev.next_pc_);
+        evt.next_pc_ = field(NEXT_PC, evt.curr_pc_ + evt.opcode_size_);
+        evt.alternate_next_pc_ = field(ALT_NEXT_PC, prev.alternate_next_pc_);
+        evt.curr_priv_ =
+            static_cast<PrivMode>(field(CURR_PRIV, static_cast<uint64_t>(prev.next_priv_)));
+        evt.next_priv_ =
+            static_cast<PrivMode>(field(NEXT_PRIV, static_cast<uint64_t>(evt.curr_priv_)));
+        unpackPrivModes(field(CURR_LDST_PRIV, packPrivModes(prev.next_ldst_priv_)),
+                        evt.curr_ldst_priv_);
+        unpackPrivModes(field(NEXT_LDST_PRIV, packPrivModes(evt.curr_ldst_priv_)),
+                        evt.next_ldst_priv_);
+        evt.excp_type_ =
+            static_cast<ExcpType>(field(EXCP_TYPE, static_cast<uint64_t>(prev.excp_type_)));
+        evt.excp_code_ = field(EXCP_CODE, prev.excp_code_);
+        evt.prev_excp_code_ = field(PREV_EXCP_CODE, prev.prev_excp_code_);
+        evt.inst_csr_ = field(INST_CSR, prev.inst_csr_);
+        if (has_flag(START_RESV_VALID))
+        {
+            const bool prev_valid = prev.end_reservation_.isValid();
+            evt.start_reservation_ =
+                field(START_RESV, prev_valid ? prev.end_reservation_.getValue() : 0);
+        }
+        if (has_flag(END_RESV_VALID))
+        {
+            const bool start_valid = evt.start_reservation_.isValid();
+            evt.end_reservation_ =
+                field(END_RESV, start_valid ? evt.start_reservation_.getValue() : 0);
+        }
+        unpackSoftfloatFlags(
+            field(START_SF_FLAGS, packSoftfloatFlags(prev.end_softfloat_flags_)),
+            evt.start_softfloat_flags_);
+        unpackSoftfloatFlags(field(END_SF_FLAGS, packSoftfloatFlags(evt.start_softfloat_flags_)),
+                             evt.end_softfloat_flags_);
+        auto & x10_diff = evt.ecall_x10_changes_.diff_;
+        if (has_flag(X10_BEFORE_VALID))
+        {
+            x10_diff.first = field(X10_BEFORE, 0);
+        }
+        if (has_flag(X10_AFTER_VALID))
+        {
+            x10_diff.second =
+                field(X10_AFTER, x10_diff.first.isValid() ? x10_diff.first.getValue() : 0);
+        }
+        evt.dasm_string_ = (mask & (1ull << DASM)) ? window.readStringRef() : prev.dasm_string_;
+
+        if (has_flag(HAS_REG_READS))
+        {
+            evt.register_reads_.resize(in.readVarint());
+            for (auto & read : evt.register_reads_)
+            {
+                bool explicit_value;
+                const uint32_t idx = window.readRegRef(explicit_value);
+                read.reg_id = window.regs[idx];
+                if (explicit_value)
+                {
+                    in.readValue(window.reg_values[idx]);
+                }
+                read.value = window.reg_values[idx];
+            }
+        }
+        if (has_flag(HAS_REG_WRITES))
+        {
+            evt.register_writes_.resize(in.readVarint());
+            for (auto & write : evt.register_writes_)
+            {
+                bool explicit_prev;
+                const uint32_t idx = window.readRegRef(explicit_prev);
+                write.reg_id = window.regs[idx];
+                if (explicit_prev)
+                {
+                    in.readValue(write.prev_value);
+                }
+                else
+                {
+                    write.prev_value = window.reg_values[idx];
+                }
+                in.readValue(write.value);
+                window.reg_values[idx] = write.value;
+            }
+        }
+
+        auto read_mem_access = [&](Event::MemReadAccess & access)
+        {
+            access.source = static_cast<MemAccessSource>(in.readVarint());
+            access.paddr = in.readDelta(window.paddr);
+            access.vaddr = in.readDelta(access.paddr);
+            access.size = in.readVarint();
+            in.readValue(access.value);
+            window.paddr = access.paddr;
+        };
+        if (has_flag(HAS_MEM_READS))
+        {
+            evt.memory_reads_.resize(in.readVarint());
+            for (auto & read : evt.memory_reads_)
+            {
+                read_mem_access(read);
+            }
+        }
+        if (has_flag(HAS_MEM_WRITES))
+        {
+            evt.memory_writes_.resize(in.readVarint());
+            for (auto & write : evt.memory_writes_)
+            {
+                read_mem_access(write);
+                in.readValue(write.prev_value);
+            }
+        }
+
+        if (has_flag(HAS_EXT_CHANGES))
+        {
+            evt.extension_changes_.resize(in.readVarint());
+            for (auto & change : evt.extension_changes_)
+            {
+                change.extensions.resize(in.readVarint());
+                for (auto & ext : change.extensions)
+                {
+                    ext = window.readStringRef();
+                }
+                change.enabled = in.readVarint() != 0;
+            }
+        }
+    }
+} // namespace pegasus::cosim
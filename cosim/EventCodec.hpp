@@ -0,0 +1,57 @@
+#pragma once
+
+#include "cosim/CoSimApi.hpp"
+#include "cosim/EventCompression.hpp"
+
+#include <string>
+#include <vector>
+
+namespace pegasus::cosim
+{
+    /// Binary formats for a window of events stored in the CompressedEvents table.
+    /// Every row records the format it was written with (FormatVersion column), so
+    /// databases written with either format can be read back.
+    enum class EventFormat : uint32_t
+    {
+        BOOST = 0,     //!< boost::serialization binary archive
+        COMPACT_V1 = 1 //!< Varint/delta encoding (see EventCodec.cpp)
+    };
+
+    /// Encodes and decodes EventLists for the CoSimEventPipeline and the CoSimEventReplayer.
+    ///
+    /// The compact format is written in a single pass over the window. Each event stores
+    /// a bitmask of the fields that differ from a prediction made from the previous event
+    /// (next PC = PC + opcode size, euid/arch ID + 1, ...) followed by the zigzag varint
+    /// deltas of only those fields. Disassembly strings, extension names and register IDs
+    /// are interned in per-window tables, and register write "previous values" are
+    /// predicted from the last value seen for that register in the window.
+    class EventCodec
+    {
+      public:
+        /// Get the format for a "cosim_event_codec" parameter value ("boost" or "compact")
+        static EventFormat getFormat(const std::string & name);
+
+        /// Serialize the events to a byte buffer (not compressed)
+        static void encode(const EventList & evts, EventFormat format, std::vector<char> & bytes);
+
+        /// Recreate the events from a byte buffer created by encode()
+        static void decode(const std::vector<char> & bytes, EventFormat format, EventList & evts);
+
+        /// encode() followed by compression with the given codec
+        static void compress(const EventList & evts, EventFormat format, CompressionCodec codec,
+                             const EventDictionary* dict, std::vector<char> & bytes);
+
+        /// Undo the compression, then decode()
+        static void decompress(const std::vector<char> & bytes, EventFormat format,
+                               CompressionCodec codec, const EventDictionary* dict,
+                               EventList & evts);
+
+      private:
+        struct CompactWindow;
+
+        static uint32_t getFlags_(const Event & evt);
+
+        static void encodeCompact_(const Event & evt, const Event & prev, CompactWindow & window);
+        static void decodeCompact_(Event & evt, const Event & prev, CompactWindow & window);
+    };
+} // namespace pegasus::cosim
@@ -0,0 +1,401 @@
+#include "cosim/EventCompression.hpp"
+#include "simdb/utils/Compress.hpp"
+#include "sparta/utils/SpartaException.hpp"
+
+#include <cstring>
+
+#ifdef PEGASUS_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef PEGASUS_HAVE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+namespace pegasus::cosim
+{
+    std::ostream & operator<<(std::ostream & os, CompressionCodec codec)
+    {
+        switch (codec)
+        {
+            case CompressionCodec::ZLIB:
+                os << "zlib";
+                break;
+            case CompressionCodec::LZ4:
+                os << "lz4";
+                break;
+            case CompressionCodec::ZSTD:
+                os << "zstd";
+                break;
+            case CompressionCodec::ZSTD_DICT:
+                os << "zstd+dict";
+                break;
+            default:
+                os << "unknown";
+                break;
+        }
+        return os;
+    }
+
+#ifdef PEGASUS_HAVE_ZSTD
+    namespace
+    {
+        // Compression/decompression contexts are reused by each thread
+        ZSTD_CCtx* getCCtx()
+        {
+            thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(
+                ZSTD_createCCtx(), &ZSTD_freeCCtx);
+            return cctx.get();
+        }
+
+        ZSTD_DCtx* getDCtx()
+        {
+            thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(
+                ZSTD_createDCtx(), &ZSTD_freeDCtx);
+            return dctx.get();
+        }
+
+        void checkZstd(size_t result, const char* what)
+        {
+            if (ZSTD_isError(result))
+            {
+                throw sparta::SpartaException("Zstd ") << what << " failed: "
+                                                       << ZSTD_getErrorName(result);
+            }
+        }
+    } // namespace
+#endif
+
+    EventDictionary::EventDictionary(std::vector<char> bytes) : bytes_(std::move(bytes))
+    {
+#ifdef PEGASUS_HAVE_ZSTD
+        for (const int level :
+             {EventCompressor::ZSTD_FAST_LEVEL, EventCompressor::ZSTD_DEFAULT_LEVEL})
+        {
+            cdicts_[level] = ZSTD_createCDict(bytes_.data(), bytes_.size(), level);
+        }
+        ddict_ = ZSTD_createDDict(bytes_.data(), bytes_.size());
+#endif
+    }
+
+    EventDictionary::~EventDictionary()
+    {
+#ifdef PEGASUS_HAVE_ZSTD
+        for (auto & [level, cdict] : cdicts_)
+        {
+            ZSTD_freeCDict(cdict);
+        }
+        ZSTD_freeDDict(ddict_);
+#endif
+    }
+
+    EventCompressor::EventCompressor(const std::string & policy)
+    {
+        if (policy == "zlib")
+        {
+            policy_ = Policy::ZLIB;
+        }
+        else if (policy == "lz4")
+        {
+            policy_ = Policy::LZ4;
+        }
+        else if (policy == "zstd")
+        {
+            policy_ = Policy::ZSTD;
+        }
+        else if (policy == "adaptive")
+        {
+            policy_ = Policy::ADAPTIVE;
+        }
+        else
+        {
+            throw sparta::SpartaException("Unknown cosim event compression '")
+                << policy << "'. Valid values are 'zlib', 'lz4', 'zstd' and 'adaptive'.";
+        }
+
+        if (((policy_ == Policy::LZ4) && !isAvailable(CompressionCodec::LZ4))
+            || ((policy_ == Policy::ZSTD) && !isAvailable(CompressionCodec::ZSTD)))
+        {
+            throw sparta::SpartaException("Pegasus was built without ")
+                << policy << " support. Rebuild with " << policy
+                << " installed or use 'zlib' or 'adaptive'.";
+        }
+
+        // Only Zstd can use the trained dictionary
+        training_done_ = !isAvailable(CompressionCodec::ZSTD)
+                         || ((policy_ != Policy::ZSTD) && (policy_ != Policy::ADAPTIVE));
+    }
+
+    CompressionCodec EventCompressor::choose_(size_t queue_depth, int & level) const
+    {
+        const CompressionCodec zstd_codec =
+            dictionary_ ? CompressionCodec::ZSTD_DICT : CompressionCodec::ZSTD;
+        level = ZSTD_DEFAULT_LEVEL;
+
+        switch (policy_)
+        {
+            case Policy::ZLIB:
+                return CompressionCodec::ZLIB;
+            case Policy::LZ4:
+                return CompressionCodec::LZ4;
+            case Policy::ZSTD:
+                return zstd_codec;
+            case Policy::ADAPTIVE:
+                if ((queue_depth >= LZ4_QUEUE_DEPTH) && isAvailable(CompressionCodec::LZ4))
+                {
+                    return CompressionCodec::LZ4;
+                }
+                if (!isAvailable(CompressionCodec::ZSTD))
+                {
+                    return CompressionCodec::ZLIB;
+                }
+                if (queue_depth >= ZSTD_FAST_QUEUE_DEPTH)
+                {
+                    level = ZSTD_FAST_LEVEL;
+                }
+                return zstd_codec;
+        }
+        return CompressionCodec::ZLIB;
+    }
+
+    CompressionCodec EventCompressor::compress(const std::vector<char> & bytes,
+                                               size_t queue_depth, std::vector<char> & compressed)
+    {
+        int level = 0;
+        const CompressionCodec codec = choose_(queue_depth, level);
+        compress(bytes, codec, level, dictionary_.get(), compressed);
+
+        if (!training_done_)
+        {
+            training_samples_.emplace_back(bytes);
+            if (training_samples_.size() == NUM_TRAINING_WINDOWS)
+            {
+                dictionary_ = trainDictionary(training_samples_, MAX_DICTIONARY_SIZE);
+                training_samples_.clear();
+                training_samples_.shrink_to_fit();
+                training_done_ = true;
+            }
+        }
+
+        ++num_windows_.at(static_cast<uint32_t>(codec));
+        num_bytes_in_ += bytes.size();
+        num_bytes_out_ += compressed.size();
+        return codec;
+    }
+
+    size_t EventCompressor::getNumWindows(CompressionCodec codec) const
+    {
+        return num_windows_.at(static_cast<uint32_t>(codec));
+    }
+
+    bool EventCompressor::isAvailable(CompressionCodec codec)
+    {
+        switch (codec)
+        {
+            case CompressionCodec::ZLIB:
+                return true;
+            case CompressionCodec::LZ4:
+#ifdef PEGASUS_HAVE_LZ4
+                return true;
+#else
+                return false;
+#endif
+            case CompressionCodec::ZSTD:
+            case CompressionCodec::ZSTD_DICT:
+#ifdef PEGASUS_HAVE_ZSTD
+                return true;
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    void EventCompressor::compress(const std::vector<char> & bytes, CompressionCodec codec,
+                                   int level, const EventDictionary* dict,
+                                   std::vector<char> & compressed)
+    {
+        (void)level;
+        (void)dict;
+
+        switch (codec)
+        {
+            case CompressionCodec::ZLIB:
+                simdb::compressData(bytes, compressed);
+                return;
+
+            case CompressionCodec::LZ4:
+            {
+#ifdef PEGASUS_HAVE_LZ4
+                const uint64_t num_bytes = bytes.size();
+                const int bound = LZ4_compressBound(bytes.size());
+                compressed.resize(sizeof(num_bytes) + bound);
+                std::memcpy(compressed.data(), &num_bytes, sizeof(num_bytes));
+                const int size = LZ4_compress_default(
+                    bytes.data(), compressed.data() + sizeof(num_bytes), bytes.size(), bound);
+                if (size <= 0)
+                {
+                    throw sparta::SpartaException("LZ4 compression failed");
+                }
+                compressed.resize(sizeof(num_bytes) + size);
+                return;
+#else
+                break;
+#endif
+            }
+
+            case CompressionCodec::ZSTD:
+            case CompressionCodec::ZSTD_DICT:
+            {
+#ifdef PEGASUS_HAVE_ZSTD
+                if (level == 0)
+                {
+                    level = ZSTD_DEFAULT_LEVEL;
+                }
+                compressed.resize(ZSTD_compressBound(bytes.size()));
+
+                size_t size;
+                if (codec == CompressionCodec::ZSTD)
+                {
+                    size = ZSTD_compressCCtx(getCCtx(), compressed.data(), compressed.size(),
+                                             bytes.data(), bytes.size(), level);
+                }
+                else if (dict == nullptr)
+                {
+                    throw sparta::SpartaException("Zstd dictionary compression needs a "
+                                                  "dictionary");
+                }
+                else if (auto it = dict->cdicts_.find(level); it != dict->cdicts_.end())
+                {
+                    size = ZSTD_compress_usingCDict(getCCtx(), compressed.data(),
+                                                    compressed.size(), bytes.data(),
+                                                    bytes.size(), it->second);
+                }
+                else
+                {
+                    size = ZSTD_compress_usingDict(
+                        getCCtx(), compressed.data(), compressed.size(), bytes.data(),
+                        bytes.size(), dict->bytes_.data(), dict->bytes_.size(), level);
+                }
+                checkZstd(size, "compression");
+                compressed.resize(size);
+                return;
+#else
+                break;
+#endif
+            }
+        }
+
+        throw sparta::SpartaException("Cosim event compression codec '")
+            << codec << "' is not available in this build";
+    }
+
+    void EventCompressor::decompress(const std::vector<char> & compressed,
+                                     CompressionCodec codec, const EventDictionary* dict,
+                                     std::vector<char> & bytes)
+    {
+        (void)dict;
+
+        switch (codec)
+        {
+            case CompressionCodec::ZLIB:
+                simdb::decompressData(compressed, bytes);
+                return;
+
+            case CompressionCodec::LZ4:
+            {
+#ifdef PEGASUS_HAVE_LZ4
+                uint64_t num_bytes = 0;
+                if (compressed.size() < sizeof(num_bytes))
+                {
+                    throw sparta::SpartaException("Truncated LZ4 event window");
+                }
+                std::memcpy(&num_bytes, compressed.data(), sizeof(num_bytes));
+                bytes.resize(num_bytes);
+                const int size = LZ4_decompress_safe(compressed.data() + sizeof(num_bytes),
+                                                     bytes.data(),
+                                                     compressed.size() - sizeof(num_bytes),
+                                                     bytes.size());
+                if ((size < 0) || (static_cast<uint64_t>(size) != num_bytes))
+                {
+                    throw sparta::SpartaException("LZ4 decompression failed");
+                }
+                return;
+#else
+                break;
+#endif
+            }
+
+            case CompressionCodec::ZSTD:
+            case CompressionCodec::ZSTD_DICT:
+            {
+#ifdef PEGASUS_HAVE_ZSTD
+                const auto num_bytes =
+                    ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+                if ((num_bytes == ZSTD_CONTENTSIZE_ERROR)
+                    || (num_bytes == ZSTD_CONTENTSIZE_UNKNOWN))
+                {
+                    throw sparta::SpartaException("Corrupt Zstd event window");
+                }
+                bytes.resize(num_bytes);
+
+                size_t size;
+                if (codec == CompressionCodec::ZSTD)
+                {
+                    size = ZSTD_decompressDCtx(getDCtx(), bytes.data(), bytes.size(),
+                                               compressed.data(), compressed.size());
+                }
+                else if (dict == nullptr)
+                {
+                    throw sparta::SpartaException("Zstd dictionary decompression needs a "
+                                                  "dictionary");
+                }
+                else
+                {
+                    size = ZSTD_decompress_usingDDict(getDCtx(), bytes.data(), bytes.size(),
+                                                      compressed.data(), compressed.size(),
+                                                      dict->ddict_);
+                }
+                checkZstd(size, "decompression");
+                return;
+#else
+                break;
+#endif
+            }
+        }
+
+        throw sparta::SpartaException("Cosim event compression codec '")
+            << codec << "' is not available in this build";
+    }
+
+    std::shared_ptr<const EventDictionary>
+    EventCompressor::trainDictionary(const std::vector<std::vector<char>> & samples,
+                                     size_t max_size)
+    {
+#ifdef PEGASUS_HAVE_ZSTD
+        std::vector<char> sample_bytes;
+        std::vector<size_t> sample_sizes;
+        for (const auto & sample : samples)
+        {
+            sample_bytes.insert(sample_bytes.end(), sample.begin(), sample.end());
+            sample_sizes.emplace_back(sample.size());
+        }
+
+        std::vector<char> dict_bytes(max_size);
+        const size_t size =
+            ZDICT_trainFromBuffer(dict_bytes.data(), dict_bytes.size(), sample_bytes.data(),
+                                  sample_sizes.data(), sample_sizes.size());
+        if (ZDICT_isError(size))
+        {
+            return nullptr;
+        }
+        dict_bytes.resize(size);
+        return std::make_shared<const EventDictionary>(std::move(dict_bytes));
+#else
+        (void)samples;
+        (void)max_size;
+        return nullptr;
+#endif
+    }
+} // namespace pegasus::cosim
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Opaque Zstd dictionary handles (zstd.h is only included by EventCompression.cpp)
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace pegasus::cosim
+{
+    /// Compression applied to an encoded event window. Every row of the CompressedEvents
+    /// table records the codec it was written with (Compression column).
+    enum class CompressionCodec : uint32_t
+    {
+        ZLIB = 0,     //!< simdb::compressData
+        LZ4 = 1,      //!< LZ4 block with the uncompressed size prepended; fastest to decode
+        ZSTD = 2,     //!< Zstd frame
+        ZSTD_DICT = 3 //!< Zstd frame using the core/hart's trained dictionary
+    };
+
+    std::ostream & operator<<(std::ostream & os, CompressionCodec codec);
+
+    /// Zstd dictionary trained from the first event windows of a core/hart. Windows
+    /// of the same hart share most of their disassembly strings and register tables,
+    /// so a dictionary mostly helps the first events of each window.
+    class EventDictionary
+    {
+      public:
+        explicit EventDictionary(std::vector<char> bytes);
+
+        ~EventDictionary();
+
+        EventDictionary(const EventDictionary &) = delete;
+        EventDictionary & operator=(const EventDictionary &) = delete;
+
+        const std::vector<char> & getBytes() const { return bytes_; }
+
+      private:
+        friend class EventCompressor;
+
+        const std::vector<char> bytes_;
+
+        /// Digested dictionaries, one per compression level used by EventCompressor
+        std::map<int, ZSTD_CDict_s*> cdicts_;
+        ZSTD_DDict_s* ddict_ = nullptr;
+    };
+
+    /// Compresses encoded event windows for one CoSimEventPipeline.
+    ///
+    /// The policy is set with the "cosim_event_compression" sim parameter:
+    ///   "zlib"     - always zlib
+    ///   "lz4"      - always LZ4
+    ///   "zstd"     - Zstd; a dictionary is trained from the first windows and used after that
+    ///   "adaptive" - pick the codec and level from the number of windows waiting to be
+    ///                compressed: LZ4 when the pipeline falls behind, fast Zstd when a few
+    ///                windows are queued and regular Zstd when the pipeline is idle
+    /// LZ4 and Zstd are optional dependencies (see cosim/CMakeLists.txt). The adaptive
+    /// policy only uses the codecs which were compiled in.
+    class EventCompressor
+    {
+      public:
+        explicit EventCompressor(const std::string & policy);
+
+        /// Compress an encoded event window. 'queue_depth' is the number of windows waiting
+        /// behind this one. Returns the codec that was used.
+        CompressionCodec compress(const std::vector<char> & bytes, size_t queue_depth,
+                                  std::vector<char> & compressed);
+
+        /// Dictionary for ZSTD_DICT windows (null until trained)
+        const std::shared_ptr<const EventDictionary> & getDictionary() const
+        {
+            return dictionary_;
+        }
+
+        /// Number of windows compressed with the given codec
+        size_t getNumWindows(CompressionCodec codec) const;
+
+        /// Total bytes before/after compression
+        size_t getNumBytesIn() const { return num_bytes_in_; }
+
+        size_t getNumBytesOut() const { return num_bytes_out_; }
+
+        /// Is the codec compiled in?
+        static bool isAvailable(CompressionCodec codec);
+
+        /// Compress with a specific codec. A level of 0 uses the codec default.
+        static void compress(const std::vector<char> & bytes, CompressionCodec codec, int level,
+                             const EventDictionary* dict, std::vector<char> & compressed);
+
+        /// Decompress a window. 'dict' is required for ZSTD_DICT windows.
+        static void decompress(const std::vector<char> & compressed, CompressionCodec codec,
+                               const EventDictionary* dict, std::vector<char> & bytes);
+
+        /// Train a Zstd dictionary from encoded windows. Returns null if there is not enough
+        /// data to train on or Zstd is not available.
+        static std::shared_ptr<const EventDictionary>
+        trainDictionary(const std::vector<std::vector<char>> & samples, size_t max_size);
+
+        /// Zstd levels used by the compressor
+        static constexpr int ZSTD_FAST_LEVEL = 1;
+        static constexpr int ZSTD_DEFAULT_LEVEL = 3;
+
+        /// Number of windows used to train the dictionary
+        static constexpr size_t NUM_TRAINING_WINDOWS = 64;
+
+        /// Maximum dictionary size in bytes
+        static constexpr size_t MAX_DICTIONARY_SIZE = 16 * 1024;
+
+        /// Queue depths at which the adaptive policy switches to fast Zstd and LZ4
+        static constexpr size_t ZSTD_FAST_QUEUE_DEPTH = 2;
+        static constexpr size_t LZ4_QUEUE_DEPTH = 8;
+
+      private:
+        enum class Policy
+        {
+            ZLIB,
+            LZ4,
+            ZSTD,
+            ADAPTIVE
+        };
+
+        /// Pick the codec and level for the next window
+        CompressionCodec choose_(size_t queue_depth, int & level) const;
+
+        Policy policy_;
+        std::shared_ptr<const EventDictionary> dictionary_;
+        std::vector<std::vector<char>> training_samples_;
+        bool training_done_ = false;
+
+        std::array<size_t, 4> num_windows_{};
+        size_t num_bytes_in_ = 0;
+        size_t num_bytes_out_ = 0;
+    };
+} // namespace pegasus::cosim
@@ -38,6 +38,9 @@ namespace pegasus
         FORK,      //! New thread
         WRS_NTO,   //! Wait on reservation set, with no timeout
         WRS_STO,   //! Wait on reservation set, with short timeout
+        WFI,       //! Wait for interrupt
+        FUTEX,     //! Wait on a futex (system call emulation)
+        SYNC,      //! Parallel window reached state shared with other harts
         INVALID    //! Invalid
     };
 
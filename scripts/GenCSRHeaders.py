@@ -170,8 +170,85 @@ def gen_csr_helpers_header():
 
         return '\n'.join(lines)
 
+    def GetConstexprBitRangesCode(RV32_CSR_DEFS, RV64_CSR_DEFS):
+        lines = []
+        lines.append('    struct CsrBitRange')
+        lines.append('    {')
+        lines.append('        uint32_t low_bit;')
+        lines.append('        uint32_t high_bit;')
+        lines.append('    };')
+        lines.append('')
+        lines.append('    // Case insensitive compare, field names are lowercase')
+        lines.append('    constexpr bool csrFieldNameEquals(const std::string_view name,')
+        lines.append('                                      const std::string_view lower_name)')
+        lines.append('    {')
+        lines.append('        if (name.size() != lower_name.size())')
+        lines.append('        {')
+        lines.append('            return false;')
+        lines.append('        }')
+        lines.append('        for (size_t idx = 0; idx < name.size(); ++idx)')
+        lines.append('        {')
+        lines.append('            const char c = ((name[idx] >= \'A\') && (name[idx] <= \'Z\'))')
+        lines.append('                               ? static_cast<char>(name[idx] - \'A\' + \'a\')')
+        lines.append('                               : name[idx];')
+        lines.append('            if (c != lower_name[idx])')
+        lines.append('            {')
+        lines.append('                return false;')
+        lines.append('            }')
+        lines.append('        }')
+        lines.append('        return true;')
+        lines.append('    }')
+        lines.append('')
+        lines.append('    // Compile-time equivalent of getCsrBitRange. Must be evaluated in a constant')
+        lines.append('    // expression so an unknown CSR field is a compile error.')
+        lines.append('    template <typename XLEN>')
+        lines.append('    constexpr CsrBitRange getCsrFieldBitRange(')
+        lines.append('        const uint32_t csr_num,')
+        lines.append('        const std::string_view field_name);')
+        lines.append('')
+
+        def WriteImpl(xlen, CSR_DEFS):
+            assert xlen in (4,8)
+            if xlen == 4:
+                xlen_t = 'uint32_t'
+            else:
+                xlen_t = 'uint64_t'
+
+            lines.append('    template <>')
+            lines.append('    constexpr CsrBitRange getCsrFieldBitRange<{}>('.format(xlen_t))
+            lines.append('        const uint32_t csr_num,')
+            lines.append('        const std::string_view field_name)')
+            lines.append('    {')
+            lines.append('        switch (csr_num)')
+            lines.append('        {')
+
+            for csr_num, csr_defn in CSR_DEFS.items():
+                csr_fields = csr_defn['fields']
+                if not csr_fields:
+                    continue
+
+                lines.append('            case 0x{:08x}:'.format(csr_num))
+                for field_name, field_defn in csr_fields.items():
+                    low_bit = field_defn['low_bit']
+                    high_bit = field_defn['high_bit']
+                    lines.append('                if (csrFieldNameEquals(field_name, "{}")) return {{{}, {}}};'.format(
+                        field_name.lower(), low_bit, high_bit))
+                lines.append('                break;')
+
+            lines.append('            default: break;')
+            lines.append('        }')
+            lines.append('        throw std::invalid_argument("Invalid CSR field!");')
+            lines.append('    }')
+            lines.append('')
+
+        WriteImpl(4, RV32_CSR_DEFS)
+        WriteImpl(8, RV64_CSR_DEFS)
+
+        return '\n'.join(lines)
+
     bit_masks_init_code = GetBitMasksInitCode(CSR32_DEFS, CSR64_DEFS)
     bit_ranges_init_code = GetBitRangesInitCode(CSR32_DEFS, CSR64_DEFS)
+    constexpr_bit_ranges_code = GetConstexprBitRangesCode(CSR32_DEFS, CSR64_DEFS)
 
     code = f"""#pragma once
 
@@ -180,7 +257,9 @@ def gen_csr_helpers_header():
 
 #include "sparta/utils/SpartaAssert.hpp"
 #include "include/gen/CSRNums.hpp"
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -190,6 +269,8 @@ namespace pegasus
 {bit_masks_init_code}
 
 {bit_ranges_init_code}
+
+{constexpr_bit_ranges_code}
 }} // namespace pegasus
 
 """
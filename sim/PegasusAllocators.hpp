@@ -47,6 +47,15 @@ namespace pegasus
             return allocators;
         }
 
+        // Allocated blocks are recycled through the free list, so the number of blocks ever
+        // allocated is the high-water mark of live objects
+        uint64_t getInstHighWaterMark() const { return inst_allocator.getNumAllocated(); }
+
+        uint64_t getExtractorHighWaterMark() const
+        {
+            return extractor_allocator.getNumAllocated();
+        }
+
         PegasusInstAllocator inst_allocator{2000, 1500};
         PegasusExtractorAllocator extractor_allocator{10000, 8500};
     };
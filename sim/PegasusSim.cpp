@@ -1,4 +1,6 @@
 #include "sim/PegasusSim.hpp"
+#include "core/Exception.hpp"
+#include "core/Fetch.hpp"
 #include "include/ActionTags.hpp"
 #include "include/gen/CSRFieldIdxs64.hpp"
 #include <filesystem>
@@ -53,6 +55,38 @@ namespace pegasus
         std::cout << "MIPS: " << std::dec << ((inst_count / (sim_time / 1000000.0)) / 1000000.0)
                   << std::endl;
 
+        const BlockCache* block_cache = state->getFetchUnit()->getBlockCache();
+        const uint64_t block_lookups = block_cache->getNumHits() + block_cache->getNumMisses();
+        if (block_lookups != 0)
+        {
+            const uint64_t block_hits = block_cache->getNumHits();
+            std::cout << "Block cache hit rate: " << std::dec
+                      << (100.0 * block_hits / block_lookups) << "%" << std::endl;
+            std::cout << "Average block length: " << std::dec
+                      << (block_hits ? (double)block_cache->getNumBlockInsts() / block_hits : 0.0)
+                      << std::endl;
+        }
+
+        const DecodeCache* decode_cache = state->getFetchUnit()->getDecodeCache();
+        const uint64_t decode_lookups = decode_cache->getNumHits() + decode_cache->getNumMisses();
+        if (decode_lookups != 0)
+        {
+            std::cout << "Decode cache hit rate: " << std::dec
+                      << (100.0 * decode_cache->getNumHits() / decode_lookups) << "%" << std::endl;
+        }
+        std::cout << "Inst allocator high-water mark: " << std::dec
+                  << allocators_tn_->getInstHighWaterMark() << std::endl;
+        std::cout << "Extractor allocator high-water mark: " << std::dec
+                  << allocators_tn_->getExtractorHighWaterMark() << std::endl;
+
+        for (auto & [core_idx, core] : cores_)
+        {
+            if (core->getNumThreads() > 1)
+            {
+                core->reportHartSchedStats(std::cout);
+            }
+        }
+
         // TODO: mem usage, workload exit code
     }
 
@@ -75,6 +109,105 @@ namespace pegasus
         return true;
     }
 
+    PegasusSim::RunResult PegasusSim::runUntil(CoreId core_id, HartId hart_id, uint64_t max_insts,
+                                               uint32_t stop_predicate_mask)
+    {
+        PegasusState* state = getPegasusCore(core_id)->getPegasusState(hart_id);
+        PegasusState::SimState* sim_state = state->getSimState();
+
+        RunResult result;
+        if (sim_state->sim_stopped)
+        {
+            result.stop_reason = StopReason::SIM_STOPPED;
+            return result;
+        }
+
+        Fetch* fetch = state->getFetchUnit();
+        ActionGroup* fetch_action_group = fetch->getActionGroup();
+        ActionGroup* decode_action_group = fetch->getDecodeActionGroup();
+        ActionGroup* exception_action_group = state->getExceptionUnit()->getActionGroup();
+
+        const bool stop_on_breakpoint =
+            (stop_predicate_mask & STOP_ON_BREAKPOINT) && !breakpoints_.empty();
+        const bool stop_on_priv_change = stop_predicate_mask & STOP_ON_PRIV_CHANGE;
+        const bool stop_on_trap = stop_predicate_mask & STOP_ON_TRAP;
+
+        // Blocks cannot be stopped in the middle, so they are only executed when every
+        // instruction does not need to be checked for a breakpoint and the whole block fits
+        // in the remaining instructions
+        const bool block_cache_enabled = fetch->isBlockCacheEnabled() && !stop_on_breakpoint;
+        const uint64_t max_block_insts = fetch->getBlockCache()->getMaxBlockInsts();
+
+        const uint64_t start_inst_count = sim_state->inst_count;
+        PrivMode priv_mode = state->getPrivMode();
+        while (result.num_insts < max_insts)
+        {
+            const bool use_block_cache =
+                block_cache_enabled && ((max_insts - result.num_insts) >= max_block_insts);
+            bool trap_taken = false;
+
+            ActionGroup* next_action_group = fetch_action_group;
+            do
+            {
+                if ((next_action_group == decode_action_group) && use_block_cache)
+                {
+                    next_action_group = fetch->executeBlock(state);
+                    if (next_action_group != decode_action_group)
+                    {
+                        trap_taken |= (next_action_group == exception_action_group);
+                        continue;
+                    }
+                }
+                next_action_group = next_action_group->execute(state);
+                trap_taken |= (next_action_group == exception_action_group);
+            } while (next_action_group && !next_action_group->hasTag(ActionTags::FETCH_TAG));
+
+            result.num_insts = sim_state->inst_count - start_inst_count;
+
+            if (SPARTA_EXPECT_FALSE(next_action_group == nullptr))
+            {
+                if (sim_state->sim_stopped)
+                {
+                    result.stop_reason = StopReason::SIM_STOPPED;
+                    return result;
+                }
+                else if ((sim_state->sim_pause_reason != SimPauseReason::QUANTUM)
+                         && (sim_state->sim_pause_reason != SimPauseReason::WFI))
+                {
+                    result.stop_reason = StopReason::PAUSED;
+                    return result;
+                }
+                // There is no scheduler to put the hart to sleep on WFI, so keep going
+                state->unpauseHart();
+            }
+
+            if (SPARTA_EXPECT_FALSE(trap_taken) && stop_on_trap)
+            {
+                result.stop_reason = StopReason::TRAP;
+                return result;
+            }
+
+            if (SPARTA_EXPECT_FALSE(state->getPrivMode() != priv_mode))
+            {
+                priv_mode = state->getPrivMode();
+                if (stop_on_priv_change)
+                {
+                    result.stop_reason = StopReason::PRIV_CHANGE;
+                    return result;
+                }
+            }
+
+            if (stop_on_breakpoint && breakpoints_.contains(state->getPc()))
+            {
+                result.stop_reason = StopReason::BREAKPOINT;
+                return result;
+            }
+        }
+
+        result.stop_reason = StopReason::INST_LIMIT;
+        return result;
+    }
+
     void PegasusSim::setEOTMode(const std::string & eot_mode)
     {
         if (eot_mode == "pass_fail")
@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <cinttypes>
+#include <unordered_set>
 
 #include "sim/PegasusSimParameters.hpp"
 #include "core/PegasusCore.hpp"
@@ -26,6 +27,43 @@ namespace pegasus
         // Step the simulator. Returns false if simulation already ended.
         bool step(CoreId core_id, HartId hart_id);
 
+        // Conditions that stop runUntil before it reaches its instruction limit
+        enum StopPredicate : uint32_t
+        {
+            STOP_ON_BREAKPOINT = 1 << 0,  //! PC reached a breakpoint
+            STOP_ON_PRIV_CHANGE = 1 << 1, //! Privilege mode changed
+            STOP_ON_TRAP = 1 << 2,        //! Exception or interrupt taken
+            STOP_ON_ANY = STOP_ON_BREAKPOINT | STOP_ON_PRIV_CHANGE | STOP_ON_TRAP
+        };
+
+        enum class StopReason
+        {
+            INST_LIMIT,  //! Executed the requested number of instructions
+            BREAKPOINT,  //! PC reached a breakpoint
+            PRIV_CHANGE, //! Privilege mode changed
+            TRAP,        //! Exception or interrupt taken
+            PAUSED,      //! Hart paused itself (PAUSE, WRS.NTO, WRS.STO)
+            SIM_STOPPED  //! End of simulation
+        };
+
+        struct RunResult
+        {
+            uint64_t num_insts = 0;
+            StopReason stop_reason = StopReason::INST_LIMIT;
+        };
+
+        // Run a hart for up to max_insts instructions without returning to the Sparta
+        // scheduler. Stops early when one of the conditions in stop_predicate_mask is met.
+        // Instruction quantum pauses are ignored.
+        RunResult runUntil(CoreId core_id, HartId hart_id, uint64_t max_insts,
+                           uint32_t stop_predicate_mask = STOP_ON_ANY);
+
+        void addBreakpoint(Addr pc) { breakpoints_.insert(pc); }
+
+        void removeBreakpoint(Addr pc) { breakpoints_.erase(pc); }
+
+        void clearBreakpoints() { breakpoints_.clear(); }
+
         PegasusCore* getPegasusCore(CoreId core_id = 0) const { return cores_.at(core_id); }
 
         PegasusSystem* getPegasusSystem() const { return system_; }
@@ -75,6 +113,9 @@ namespace pegasus
         // Simulation callback listeners (buildTree_, etc.)
         std::vector<SimListener*> sim_listeners_;
 
+        // PC breakpoints for runUntil
+        std::unordered_set<Addr> breakpoints_;
+
         friend class PegasusCoSim;
     };
 } // namespace pegasus
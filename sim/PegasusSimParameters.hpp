@@ -51,6 +51,15 @@ namespace pegasus
             ignore_wkld_exit_code_.reset(new sparta::Parameter<bool>(
                 "ignore_wkld_exit_code", false,
                 "Don't pass the workload's exit code as the Pegasus sim's exit code", ps));
+            cosim_event_codec_.reset(new sparta::Parameter<std::string>(
+                "cosim_event_codec", "compact",
+                "Encoding of cosim events written to the database (\"compact\" or \"boost\")",
+                ps));
+            cosim_event_compression_.reset(new sparta::Parameter<std::string>(
+                "cosim_event_compression", "adaptive",
+                "Compression of cosim events written to the database (\"zlib\", \"lz4\", "
+                "\"zstd\" or \"adaptive\")",
+                ps));
         }
 
         template <typename T>
@@ -90,5 +99,7 @@ namespace pegasus
         std::unique_ptr<sparta::Parameter<bool>> syscall_emulation_;
         std::unique_ptr<RegisterOverridesParam> reg_overrides_;
         std::unique_ptr<sparta::Parameter<bool>> ignore_wkld_exit_code_;
+        std::unique_ptr<sparta::Parameter<std::string>> cosim_event_codec_;
+        std::unique_ptr<sparta::Parameter<std::string>> cosim_event_compression_;
     };
 } // namespace pegasus
@@ -0,0 +1,218 @@
+#include "system/Clint.hpp"
+#include "system/PegasusSystem.hpp"
+#include "core/PegasusCore.hpp"
+#include "sparta/utils/LogUtils.hpp"
+
+#include <cstring>
+
+namespace pegasus
+{
+    Clint::Clint(sparta::TreeNode* node, const ClintParameters* params) :
+        sparta::Unit(node),
+        sparta::memory::BlockingMemoryIF("CLINT", PegasusSystem::PEGASUS_SYSTEM_BLOCK_SIZE,
+                                         {0, params->size, "clint_window"}, nullptr),
+        base_addr_(params->base_addr),
+        size_(params->size),
+        cycles_per_tick_(params->cycles_per_tick),
+        ev_timer_expires_(&unit_event_set_, "timer_expires",
+                          CREATE_SPARTA_HANDLER_WITH_DATA(Clint, timerExpires_, HartId))
+    {
+        sparta_assert(cycles_per_tick_ != 0, "CLINT cycles per tick must not be 0");
+        sparta_assert(size_ > MTIME_OFFSET, "CLINT size is too small: " << size_);
+    }
+
+    void Clint::onBindTreeEarly_()
+    {
+        auto core_tn = getContainer()->getRoot()->getChildAs<sparta::ResourceTreeNode>("core0");
+        core_ = core_tn->getResourceAs<PegasusCore>();
+        if (getContainer()->getRoot()->getChild("core1", false))
+        {
+            WLOG("The CLINT only delivers interrupts to the harts of core0");
+        }
+
+        // mtimecmp is reset to the maximum value so no timer interrupt is pending at boot
+        msip_.resize(core_->getNumThreads(), 0);
+        mtimecmp_.resize(core_->getNumThreads(), std::numeric_limits<uint64_t>::max());
+    }
+
+    uint64_t Clint::getCurrentCycle_() const
+    {
+        return core_->getPegasusState(core_->getCurrentHartId())->getSimState()->cycles;
+    }
+
+    uint64_t Clint::readDoubleword_(sparta::memory::addr_t offset) const
+    {
+        if (offset < MTIMECMP_OFFSET)
+        {
+            // Two 32-bit msip registers per doubleword
+            const HartId hart_id = (offset - MSIP_OFFSET) / sizeof(uint32_t);
+            uint64_t value = 0;
+            if (hart_id < msip_.size())
+            {
+                value |= msip_[hart_id];
+            }
+            if ((hart_id + 1) < msip_.size())
+            {
+                value |= uint64_t(msip_[hart_id + 1]) << 32;
+            }
+            return value;
+        }
+        else if (offset < MTIME_OFFSET)
+        {
+            const HartId hart_id = (offset - MTIMECMP_OFFSET) / sizeof(uint64_t);
+            return (hart_id < mtimecmp_.size()) ? mtimecmp_[hart_id] : 0;
+        }
+        else if (offset == MTIME_OFFSET)
+        {
+            return getMtime(getCurrentCycle_());
+        }
+        return 0;
+    }
+
+    void Clint::writeDoubleword_(sparta::memory::addr_t offset, uint64_t value)
+    {
+        if (offset < MTIMECMP_OFFSET)
+        {
+            const HartId hart_id = (offset - MSIP_OFFSET) / sizeof(uint32_t);
+            if (hart_id < msip_.size())
+            {
+                setMsip_(hart_id, value & 0x1);
+            }
+            if ((hart_id + 1) < msip_.size())
+            {
+                setMsip_(hart_id + 1, (value >> 32) & 0x1);
+            }
+        }
+        else if (offset < MTIME_OFFSET)
+        {
+            const HartId hart_id = (offset - MTIMECMP_OFFSET) / sizeof(uint64_t);
+            if (hart_id < mtimecmp_.size())
+            {
+                DLOG("hart" << std::dec << hart_id << " mtimecmp: " << value);
+                mtimecmp_[hart_id] = value;
+                updateTimer_(hart_id, getCurrentCycle_());
+            }
+        }
+        else if (offset == MTIME_OFFSET)
+        {
+            DLOG("mtime: " << std::dec << value);
+            const uint64_t cycle = getCurrentCycle_();
+            mtime_offset_ = value - (cycle / cycles_per_tick_);
+            for (HartId hart_id = 0; hart_id < mtimecmp_.size(); ++hart_id)
+            {
+                updateTimer_(hart_id, cycle);
+            }
+        }
+    }
+
+    void Clint::setMsip_(HartId hart_id, uint32_t value)
+    {
+        if (msip_[hart_id] != value)
+        {
+            DLOG("hart" << std::dec << hart_id << " msip: " << value);
+            msip_[hart_id] = value;
+            setInterruptPending_(hart_id, MSIP_BIT, value != 0);
+        }
+    }
+
+    void Clint::updateTimer_(HartId hart_id, uint64_t cycle)
+    {
+        ev_timer_expires_.cancelIf(hart_id);
+
+        const uint64_t mtime = getMtime(cycle);
+        const uint64_t mtimecmp = mtimecmp_[hart_id];
+        if (mtime >= mtimecmp)
+        {
+            setInterruptPending_(hart_id, MTIP_BIT, true);
+            return;
+        }
+        setInterruptPending_(hart_id, MTIP_BIT, false);
+
+        // Deadlines that are too far away to ever be reached (e.g. mtimecmp = -1 to disable the
+        // timer) are not scheduled
+        const uint64_t ticks = mtimecmp - mtime;
+        if (ticks < (MAX_TIMER_CYCLES / cycles_per_tick_))
+        {
+            const uint64_t deadline = ((cycle / cycles_per_tick_) + ticks) * cycles_per_tick_;
+            const uint64_t current_cycle = getClock()->currentCycle();
+            ev_timer_expires_.preparePayload(hart_id)->schedule(
+                (deadline > current_cycle) ? (deadline - current_cycle) : 0);
+        }
+    }
+
+    void Clint::timerExpires_(const HartId & hart_id)
+    {
+        DLOG("Timer expired for hart" << std::dec << hart_id);
+        updateTimer_(hart_id, getClock()->currentCycle());
+    }
+
+    void Clint::setInterruptPending_(HartId hart_id, uint32_t bit, bool pending)
+    {
+        // Interrupt devices change MIP between instructions, so observers are not notified
+        PegasusState* state = core_->getPegasusState(hart_id);
+        const uint64_t mip_val = (state->getXlen() == 64) ? PEEK_CSR_REG<RV64>(state, MIP)
+                                                          : PEEK_CSR_REG<RV32>(state, MIP);
+        const uint64_t new_mip_val =
+            pending ? (mip_val | (uint64_t(1) << bit)) : (mip_val & ~(uint64_t(1) << bit));
+        if (new_mip_val == mip_val)
+        {
+            return;
+        }
+
+        if (state->getXlen() == 64)
+        {
+            POKE_CSR_REG<RV64>(state, MIP, new_mip_val);
+        }
+        else
+        {
+            POKE_CSR_REG<RV32>(state, MIP, new_mip_val);
+        }
+
+        if (pending)
+        {
+            core_->interruptPending(hart_id);
+        }
+    }
+
+    bool Clint::tryRead_(sparta::memory::addr_t addr, sparta::memory::addr_t size, uint8_t* buf,
+                         const void*, void*)
+    {
+        return tryPeek_(addr, size, buf);
+    }
+
+    bool Clint::tryWrite_(sparta::memory::addr_t addr, sparta::memory::addr_t size,
+                          const uint8_t* buf, const void*, void*)
+    {
+        return tryPoke_(addr, size, buf);
+    }
+
+    bool Clint::tryPeek_(sparta::memory::addr_t addr, sparta::memory::addr_t size,
+                         uint8_t* buf) const
+    {
+        const sparta::memory::addr_t byte_offset = addr % sizeof(uint64_t);
+        if ((byte_offset + size) > sizeof(uint64_t))
+        {
+            return false;
+        }
+
+        const uint64_t value = readDoubleword_(addr - byte_offset);
+        ::memcpy(buf, reinterpret_cast<const uint8_t*>(&value) + byte_offset, size);
+        return true;
+    }
+
+    bool Clint::tryPoke_(sparta::memory::addr_t addr, sparta::memory::addr_t size,
+                         const uint8_t* buf)
+    {
+        const sparta::memory::addr_t byte_offset = addr % sizeof(uint64_t);
+        if ((byte_offset + size) > sizeof(uint64_t))
+        {
+            return false;
+        }
+
+        // Partial writes (e.g. the halves of mtimecmp on RV32) keep the other bytes
+        uint64_t value = readDoubleword_(addr - byte_offset);
+        ::memcpy(reinterpret_cast<uint8_t*>(&value) + byte_offset, buf, size);
+        writeDoubleword_(addr - byte_offset, value);
+        return true;
+    }
+} // namespace pegasus
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "include/PegasusTypes.hpp"
+
+#include "sparta/simulation/Unit.hpp"
+#include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/memory/BlockingMemoryIFNode.hpp"
+#include "sparta/events/PayloadEvent.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace pegasus
+{
+    class PegasusCore;
+
+    /*!
+     * \class Clint
+     * \brief Core-local interruptor with the SiFive CLINT memory map
+     *
+     *     0x0000 + 4 * hart  msip      Machine software interrupt pending (bit 0)
+     *     0x4000 + 8 * hart  mtimecmp  Machine timer interrupt when mtime >= mtimecmp
+     *     0xbff8             mtime     Machine timer
+     *
+     * mtime is never incremented: it is computed from the cycle count of the hart that reads
+     * it, so the timer costs nothing while no one looks at it. Each hart has one event
+     * scheduled for its mtimecmp deadline, which sets MIP.MTIP when it fires. Harts take the
+     * interrupt before their next fetch, so timer interrupts are delivered at the end of the
+     * instruction quantum in which they become pending.
+     *
+     * The CLINT serves the harts of core0 only: hart N in the memory map is hart N of core0.
+     * Harts of other cores never see msip or mtimecmp interrupts.
+     */
+    class Clint : public sparta::Unit, public sparta::memory::BlockingMemoryIF
+    {
+      public:
+        //! \brief Name of this resource. Required by sparta::UnitFactory
+        static constexpr char name[] = "Clint";
+
+        class ClintParameters : public sparta::ParameterSet
+        {
+          public:
+            explicit ClintParameters(sparta::TreeNode* node) : sparta::ParameterSet(node) {}
+
+            PARAMETER(sparta::memory::addr_t, base_addr, 0x2000000, "Base address")
+            PARAMETER(sparta::memory::addr_t, size, 0x10000, "Memory size")
+            PARAMETER(uint32_t, cycles_per_tick, 1, "Number of cycles per mtime increment")
+        };
+
+        Clint(sparta::TreeNode* node, const ClintParameters* params);
+
+        sparta::memory::addr_t getBaseAddr() const { return base_addr_; }
+
+        sparta::memory::addr_t getSize() const { return size_; }
+
+        sparta::memory::addr_t getHighEnd() const { return base_addr_ + size_; }
+
+        //! Value of mtime at the given cycle
+        uint64_t getMtime(uint64_t cycle) const
+        {
+            return (cycle / cycles_per_tick_) + mtime_offset_;
+        }
+
+        static constexpr sparta::memory::addr_t MSIP_OFFSET = 0x0;
+        static constexpr sparta::memory::addr_t MTIMECMP_OFFSET = 0x4000;
+        static constexpr sparta::memory::addr_t MTIME_OFFSET = 0xbff8;
+
+        static constexpr uint32_t MSIP_BIT = 3;
+        static constexpr uint32_t MTIP_BIT = 7;
+
+      private:
+        void onBindTreeEarly_() override;
+
+        const sparta::memory::addr_t base_addr_;
+        const sparta::memory::addr_t size_;
+        const uint64_t cycles_per_tick_;
+
+        // The only core whose harts are served, see the class comment
+        PegasusCore* core_ = nullptr;
+
+        // mtime is the number of ticks since cycle 0 plus this offset, which changes when
+        // mtime is written
+        uint64_t mtime_offset_ = 0;
+
+        std::vector<uint32_t> msip_;
+        std::vector<uint64_t> mtimecmp_;
+
+        // Cycle count of the hart accessing the CLINT
+        uint64_t getCurrentCycle_() const;
+
+        // Read and write the naturally aligned 8 bytes containing the offset
+        uint64_t readDoubleword_(sparta::memory::addr_t offset) const;
+        void writeDoubleword_(sparta::memory::addr_t offset, uint64_t value);
+
+        void setMsip_(HartId hart_id, uint32_t value);
+
+        // Update MIP.MTIP of a hart and schedule its next timer interrupt
+        void updateTimer_(HartId hart_id, uint64_t cycle);
+
+        static constexpr uint64_t MAX_TIMER_CYCLES = uint64_t(1) << 62;
+
+        void timerExpires_(const HartId & hart_id);
+        sparta::PayloadEvent<HartId> ev_timer_expires_;
+
+        // Set or clear a MIP bit of a hart
+        void setInterruptPending_(HartId hart_id, uint32_t bit, bool pending);
+
+        bool tryRead_(sparta::memory::addr_t addr, sparta::memory::addr_t size, uint8_t* buf,
+                      const void* in_supplement, void* out_supplement) override final;
+        bool tryWrite_(sparta::memory::addr_t addr, sparta::memory::addr_t size, const uint8_t* buf,
+                       const void* in_supplement, void* out_supplement) override final;
+        bool tryPeek_(sparta::memory::addr_t addr, sparta::memory::addr_t size,
+                      uint8_t* buf) const override final;
+        bool tryPoke_(sparta::memory::addr_t addr, sparta::memory::addr_t size,
+                      const uint8_t* buf) override final;
+    };
+} // namespace pegasus
@@ -34,6 +34,15 @@ namespace pegasus
             uart_ = uart_rtn->getResourceAs<SimpleUART>();
         }
 
+        if (p->enable_clint)
+        {
+            sparta::ResourceTreeNode* clint_rtn = nullptr;
+            tree_nodes_.emplace_back(clint_rtn = new sparta::ResourceTreeNode(
+                                         sys_node, "clint", "Clint", &clint_fact_));
+            clint_rtn->finalize();
+            clint_ = clint_rtn->getResourceAs<Clint>();
+        }
+
         // Initialize memory map
         memory_map_.reset(new sparta::memory::SimpleMemoryMapNode(
             sys_node, "memory_map", sparta::TreeNode::GROUP_NAME_NONE,
@@ -205,7 +214,7 @@ namespace pegasus
         BMIfNode* memory_if = nullptr;
         MemObj* mem_obj = nullptr;
 
-        // The allocated memory blocks (Magic Mem, UART, etc)
+        // The allocated memory blocks (Magic Mem, UART, CLINT, etc)
         struct AllocatedMemoryBlock
         {
             AllocatedMemoryBlock(sparta::memory::addr_t start_address,
@@ -268,6 +277,15 @@ namespace pegasus
             allocated_blocks.emplace(uart_->getBaseAddr(), uart_->getSize());
         }
 
+        ////////////////////////////////////////////////////////////////////////////////
+        // CLINT
+        if (nullptr != clint_)
+        {
+            memory_map_->addMapping(clint_->getBaseAddr(), clint_->getHighEnd(), clint_,
+                                    0x0 /* Additional offset -- not used */);
+            allocated_blocks.emplace(clint_->getBaseAddr(), clint_->getSize());
+        }
+
         ////////////////////////////////////////////////////////////////////////////////
         // Now fill in the memory "blanks"
         sparta::memory::addr_t addr_block_start = 0;
@@ -295,6 +313,8 @@ namespace pegasus
                                              "mb_" + std::to_string(block_num), nullptr, *mem_obj));
                 memory_map_->addMapping(addr_block_start, addr_block_start + block_size, memory_if,
                                         0x0 /* Additional offset */);
+                memory_regions_.emplace_back(
+                    MemoryRegion{addr_block_start, addr_block_start + block_size, mem_obj});
             }
 
             // Determine the next large block of memory
@@ -317,6 +337,8 @@ namespace pegasus
                               "mb_" + std::to_string(block_num), nullptr, *mem_obj));
         memory_map_->addMapping(addr_block_start, PEGASUS_SYSTEM_TOTAL_MEMORY, memory_if,
                                 0x0 /* Additional offset */);
+        memory_regions_.emplace_back(
+            MemoryRegion{addr_block_start, PEGASUS_SYSTEM_TOTAL_MEMORY, mem_obj});
         memory_map_->dumpMappings(std::cout);
     }
 
@@ -392,6 +414,22 @@ namespace pegasus
         }
     }
 
+    uint8_t* PegasusSystem::getHostPage(const Addr paddr) const
+    {
+        for (const auto & region : memory_regions_)
+        {
+            if ((paddr >= region.start_address) && (paddr < region.end_address))
+            {
+                // Memory objects are made of 4K blocks, one per page
+                const sparta::memory::addr_t offset =
+                    (paddr - region.start_address) & ~(PEGASUS_SYSTEM_BLOCK_SIZE - 1);
+                std::lock_guard<std::mutex> lock(host_page_mutex_);
+                return region.memory_object->getLine(offset).getRawDataPtr(0);
+            }
+        }
+        return nullptr;
+    }
+
     void PegasusSystem::registerMemoryCallbacks(Observer* observer)
     {
         using BMOIfNode = sparta::memory::BlockingMemoryIFNode;
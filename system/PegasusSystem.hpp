@@ -5,6 +5,7 @@
 #include "include/PegasusTypes.hpp"
 #include "sim/PegasusSimParameters.hpp"
 #include "system/SimpleUART.hpp"
+#include "system/Clint.hpp"
 #include "system/MagicMemory.hpp"
 
 #include "sparta/simulation/Unit.hpp"
@@ -13,6 +14,8 @@
 #include "sparta/simulation/ResourceTreeNode.hpp"
 #include "sparta/simulation/ResourceFactory.hpp"
 
+#include <mutex>
+
 namespace sparta::memory
 {
     class MemoryObject;
@@ -37,6 +40,7 @@ namespace pegasus
             PegasusSystemParameters(sparta::TreeNode* node) : sparta::ParameterSet(node) {}
 
             PARAMETER(bool, enable_uart, false, "Enable a Uart")
+            PARAMETER(bool, enable_clint, false, "Enable a CLINT (timer and software interrupts)")
         };
 
         // Constructor
@@ -45,9 +49,16 @@ namespace pegasus
         // Get pointer to memory map
         sparta::memory::SimpleMemoryMapNode* getSystemMemory() const { return memory_map_.get(); }
 
+        // CLINT, or nullptr if it is not enabled
+        const Clint* getClint() const { return clint_; }
+
         // Give observers their callbacks to read/write memory operations
         void registerMemoryCallbacks(Observer* observer);
 
+        // Get the host pointer to the start of the 4K page containing paddr. Returns nullptr if
+        // the page is not plain memory (i.e. MagicMemory, UART or CLINT).
+        uint8_t* getHostPage(const Addr paddr) const;
+
         // Get starting PC from ELF
         Addr getStartingPc() const { return starting_pc_.isValid() ? starting_pc_.getValue() : 0; }
 
@@ -71,6 +82,7 @@ namespace pegasus
         // Device factories
         sparta::ResourceFactory<SimpleUART, SimpleUART::SimpleUARTParameters> uart_fact_;
         sparta::ResourceFactory<MagicMemory, MagicMemory::MagicMemoryParameters> magic_mem_fact_;
+        sparta::ResourceFactory<Clint, Clint::ClintParameters> clint_fact_;
 
         // Tree nodes
         std::vector<std::unique_ptr<sparta::TreeNode>> tree_nodes_;
@@ -78,11 +90,26 @@ namespace pegasus
         // Devices
         SimpleUART* uart_ = nullptr;
         MagicMemory* magic_mem_ = nullptr;
+        Clint* clint_ = nullptr;
 
         // Memory maps
         std::unique_ptr<sparta::memory::SimpleMemoryMapNode> memory_map_;
         std::vector<std::unique_ptr<sparta::memory::MemoryObject>> memory_objects_;
 
+        // Address ranges of the memory objects, used for direct memory access
+        struct MemoryRegion
+        {
+            sparta::memory::addr_t start_address = 0;
+            sparta::memory::addr_t end_address = 0;
+            sparta::memory::MemoryObject* memory_object = nullptr;
+        };
+
+        std::vector<MemoryRegion> memory_regions_;
+
+        // Memory objects allocate their blocks on first access, and harts running on host
+        // threads may look up host pages at the same time
+        mutable std::mutex host_page_mutex_;
+
         struct MemorySection
         {
             std::string name = "?";
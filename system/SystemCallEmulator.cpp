@@ -1,10 +1,12 @@
 
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <algorithm>
 
 #include "system/SystemCallEmulator.hpp"
 #include "sim/PegasusSim.hpp"
+#include "core/PegasusCore.hpp"
 #include "sparta/utils/LogUtils.hpp"
 
 #include <unistd.h>      // for write, etc
@@ -17,6 +19,7 @@
 #include <sys/types.h>
 #include <sys/stat.h> //fstat, etc
 #include <sys/syscall.h>
+#include <cerrno>
 
 #define SYSCALL_LOG(x)                                                                             \
     if (SPARTA_EXPECT_FALSE(syscall_log_))                                                         \
@@ -26,6 +29,23 @@
 
 namespace pegasus
 {
+    // Futex operations (include/uapi/linux/futex.h)
+    static constexpr uint64_t RV_FUTEX_WAIT = 0;
+    static constexpr uint64_t RV_FUTEX_WAKE = 1;
+    static constexpr uint64_t RV_FUTEX_WAIT_BITSET = 9;
+    static constexpr uint64_t RV_FUTEX_WAKE_BITSET = 10;
+    static constexpr uint64_t RV_FUTEX_CLOCK_REALTIME = 256;
+    static constexpr uint64_t RV_FUTEX_CMD_MASK = 0x7f;
+    static constexpr uint32_t RV_FUTEX_BITSET_MATCH_ANY = 0xffffffff;
+
+    // Clone flags (include/uapi/linux/sched.h)
+    static constexpr uint64_t RV_CLONE_VM = 0x100;
+    static constexpr uint64_t RV_CLONE_THREAD = 0x10000;
+    static constexpr uint64_t RV_CLONE_SETTLS = 0x80000;
+    static constexpr uint64_t RV_CLONE_PARENT_SETTID = 0x100000;
+    static constexpr uint64_t RV_CLONE_CHILD_CLEARTID = 0x200000;
+    static constexpr uint64_t RV_CLONE_CHILD_SETTID = 0x1000000;
+
     class SysCallHandlers
     {
       public:
@@ -77,6 +97,7 @@ namespace pegasus
                  {178, {"getegid", cfp(&SysCallHandlers::getegid_)}},
                  {214, {"brk", cfp(&SysCallHandlers::brk_)}},
                  {215, {"munmap", cfp(&SysCallHandlers::munmap_)}},
+                 {220, {"clone", cfp(&SysCallHandlers::clone_)}},
                  {222, {"mmap", cfp(&SysCallHandlers::mmap_)}},
                  {226, {"mprotect", cfp(&SysCallHandlers::mprotect_)}},
                  {258, {"hwprobe", cfp(&SysCallHandlers::hwprobe_)}},
@@ -87,7 +108,8 @@ namespace pegasus
                   {"clock_gettime",
                    cfp(&SysCallHandlers::clock_gettime_)}}, // sc_call_id = 403 is for
                                                             // "clock_gettime64".
-                 {435, {"clone", cfp(&SysCallHandlers::clone_)}},
+                 {422, {"futex_time64", cfp(&SysCallHandlers::futex_)}},
+                 {435, {"clone3", cfp(&SysCallHandlers::clone3_)}},
                  {1024, {"open", cfp(&SysCallHandlers::open_)}},
                  {1039, {"lstat", cfp(&SysCallHandlers::lstat_)}},
                  {2011, {"getmainvars", cfp(&SysCallHandlers::getmainvars_)}}});
@@ -139,10 +161,11 @@ namespace pegasus
         };
 
         int64_t emulateSystemCall(const SystemCallStack & call_stack,
-                                  sparta::memory::BlockingMemoryIF* memory)
+                                  sparta::memory::BlockingMemoryIF* memory, PegasusState* state)
         {
             int64_t ret_val = -1;
             const auto sc_call_id = call_stack[0];
+            calling_state_ = state;
             try
             {
                 const auto & syscall = supported_sys_calls_.at(sc_call_id);
@@ -161,6 +184,9 @@ namespace pegasus
 
         Addr getBreakAddress() const { return brk_address_; }
 
+        // The futex wait of a hart timed out
+        void futexTimeout(HartId hart_id);
+
       private:
         // Helpers
         std::string readString_(sparta::memory::BlockingMemoryIF* mem, uint64_t string_addr,
@@ -265,13 +291,54 @@ namespace pegasus
         int64_t getrandom_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
         int64_t statx_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
         int64_t clone_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
+        int64_t clone3_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
         int64_t open_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
         int64_t lstat_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
         int64_t getmainvars_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*);
 
+        // Guest threads
+        int64_t getTid_(const PegasusState* state) const;
+        int64_t startThread_(uint64_t flags, Addr stack, Addr parent_tid, Addr tls,
+                             Addr child_tid, sparta::memory::BlockingMemoryIF* memory);
+        int64_t endSimulation_(int64_t exit_code);
+
+        // Futexes
+        int64_t futexWait_(Addr uaddr, uint32_t val, Addr timeout, bool absolute_timeout,
+                           clockid_t clock, uint32_t bitset,
+                           sparta::memory::BlockingMemoryIF* memory);
+        uint32_t futexWake_(Addr uaddr, uint32_t max_waiters, uint32_t bitset);
+        void wakeFutexWaiter_(PegasusState* state);
+
+        static uint64_t readIntReg_(PegasusState* state, uint32_t reg);
+        static void writeIntReg_(PegasusState* state, uint32_t reg, uint64_t value);
+
         // The parent emulator
         SystemCallEmulator* emulator_ = nullptr;
 
+        // Hart making the current system call
+        PegasusState* calling_state_ = nullptr;
+
+        // Threads started by clone, by hart. The first thread of the workload is not in here.
+        struct GuestThread
+        {
+            int64_t tid;
+
+            // Cleared and woken up when the thread exits (CLONE_CHILD_CLEARTID)
+            Addr clear_child_tid;
+        };
+
+        std::map<HartId, GuestThread> guest_threads_;
+
+        // Harts sleeping in FUTEX_WAIT, in the order they started waiting
+        struct FutexWaiter
+        {
+            PegasusState* state;
+            Addr uaddr;
+            uint32_t bitset;
+        };
+
+        std::vector<FutexWaiter> futex_waiters_;
+
         // Callbacks
         using HandlerFunc =
             std::function<int64_t(const SystemCallStack &, sparta::memory::BlockingMemoryIF*)>;
@@ -368,6 +435,16 @@ namespace pegasus
         syscall_emulation_enabled_(
             PegasusSimParameters::getParameter<bool>(my_node, "enable_syscall_emulation")),
         memory_map_params_(p->mem_map_params),
+        futex_sleep_(p->futex_sleep),
+        ev_futex_timeout_expires_(
+            &unit_event_set_, "futex_timeout_expires",
+            CREATE_SPARTA_HANDLER_WITH_DATA(SystemCallEmulator, futexTimeoutExpires_, HartId)),
+        futex_parks_(&unit_stat_set_, "futex_parks", "Number of harts put to sleep by FUTEX_WAIT",
+                     sparta::Counter::COUNT_NORMAL),
+        futex_wakes_(&unit_stat_set_, "futex_wakes", "Number of sleeping harts woken by a futex",
+                     sparta::Counter::COUNT_NORMAL),
+        futex_timeouts_(&unit_stat_set_, "futex_timeouts", "Number of futex waits that timed out",
+                        sparta::Counter::COUNT_NORMAL),
         syscall_log_(my_node, "syscall", "System Call Logger"),
         workload_(getWorkloadParam(my_node->getRoot()))
     {
@@ -428,9 +505,24 @@ namespace pegasus
     }
 
     int64_t SystemCallEmulator::emulateSystemCall(const SystemCallStack & call_stack,
-                                                  sparta::memory::BlockingMemoryIF* memory)
+                                                  sparta::memory::BlockingMemoryIF* memory,
+                                                  PegasusState* state)
     {
-        return callbacks_->emulateSystemCall(call_stack, memory);
+        return callbacks_->emulateSystemCall(call_stack, memory, state);
+    }
+
+    void SystemCallEmulator::scheduleFutexTimeout(const PegasusState* state, uint64_t cycles)
+    {
+        // The hart starts sleeping at its own cycle count, which can be ahead of the scheduler
+        const uint64_t sleep_cycle = state->getSimState()->cycles;
+        const uint64_t current_cycle = getClock()->currentCycle();
+        const uint64_t delay = (sleep_cycle > current_cycle) ? (sleep_cycle - current_cycle) : 0;
+        ev_futex_timeout_expires_.preparePayload(state->getHartId())->schedule(delay + cycles);
+    }
+
+    void SystemCallEmulator::futexTimeoutExpires_(const HartId & hart_id)
+    {
+        callbacks_->futexTimeout(hart_id);
     }
 
     int SystemCallEmulator::getFDOverrideForWrite(int caller_fd)
@@ -492,10 +584,9 @@ namespace pegasus
         return getuid_(call_stack, memory);
     }
 
-    int64_t SysCallHandlers::gettid_(const SystemCallStack & call_stack,
-                                     sparta::memory::BlockingMemoryIF* memory)
+    int64_t SysCallHandlers::gettid_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*)
     {
-        return getuid_(call_stack, memory);
+        return getTid_(calling_state_);
     }
 
     int64_t SysCallHandlers::getegid_(const SystemCallStack & call_stack,
@@ -942,16 +1033,175 @@ namespace pegasus
     int64_t SysCallHandlers::set_tid_address_(const SystemCallStack &,
                                               sparta::memory::BlockingMemoryIF*)
     {
-        SYSCALL_LOG(__func__ << "(...) -> 0 # ignored");
-        return 0;
+        // Only called by the first thread, which does not clear its TID on exit
+        const int64_t ret = getTid_(calling_state_);
+        SYSCALL_LOG(__func__ << "(...) -> " << ret << " # ignored");
+        return ret;
     }
 
-    int64_t SysCallHandlers::futex_(const SystemCallStack &, sparta::memory::BlockingMemoryIF*)
+    int64_t SysCallHandlers::futex_(const SystemCallStack & call_stack,
+                                    sparta::memory::BlockingMemoryIF* memory)
     {
-        SYSCALL_LOG(__func__ << "(...) -> 0 # ignored");
+        const Addr uaddr = call_stack[1];
+        const uint64_t futex_op = call_stack[2];
+        const uint32_t val = call_stack[3];
+        const Addr timeout = call_stack[4];
+        const uint32_t val3 = call_stack[6];
+        const clockid_t clock =
+            (futex_op & RV_FUTEX_CLOCK_REALTIME) ? CLOCK_REALTIME : CLOCK_MONOTONIC;
+
+        // Other operations (requeue, PI futexes) are not used by the pthread library
+        int64_t ret = -ENOSYS;
+        switch (futex_op & RV_FUTEX_CMD_MASK)
+        {
+            case RV_FUTEX_WAIT:
+                ret = futexWait_(uaddr, val, timeout, false, clock, RV_FUTEX_BITSET_MATCH_ANY,
+                                 memory);
+                break;
+            case RV_FUTEX_WAIT_BITSET:
+                ret = futexWait_(uaddr, val, timeout, true, clock, val3, memory);
+                break;
+            case RV_FUTEX_WAKE:
+                ret = futexWake_(uaddr, val, RV_FUTEX_BITSET_MATCH_ANY);
+                break;
+            case RV_FUTEX_WAKE_BITSET:
+                ret = (val3 == 0) ? -EINVAL : futexWake_(uaddr, val, val3);
+                break;
+        }
+
+        SYSCALL_LOG(__func__ << "(" << HEX16(uaddr) << ", " << HEX16(futex_op) << ", " << val
+                             << ", " << HEX16(timeout) << ", " << HEX16(val3) << ") -> " << ret);
+        return ret;
+    }
+
+    int64_t SysCallHandlers::futexWait_(Addr uaddr, uint32_t val, Addr timeout,
+                                        bool absolute_timeout, clockid_t clock, uint32_t bitset,
+                                        sparta::memory::BlockingMemoryIF* memory)
+    {
+        if (bitset == 0)
+        {
+            return -EINVAL;
+        }
+
+        uint32_t futex_word = 0;
+        if (!memory->tryRead(uaddr, sizeof(futex_word), reinterpret_cast<uint8_t*>(&futex_word)))
+        {
+            return -EFAULT;
+        }
+        if (futex_word != val)
+        {
+            return -EAGAIN;
+        }
+
+        // The timeout is a 64-bit timespec (futex_time64 on RV32). FUTEX_WAIT_BITSET takes an
+        // absolute time on the host clock, the same clock clock_gettime returns.
+        uint64_t timeout_cycles = 0;
+        if (timeout != 0)
+        {
+            int64_t guest_timeout[2];
+            if (!memory->tryRead(timeout, sizeof(guest_timeout),
+                                 reinterpret_cast<uint8_t*>(guest_timeout)))
+            {
+                return -EFAULT;
+            }
+
+            int64_t timeout_ns = guest_timeout[0] * 1000000000 + guest_timeout[1];
+            if (absolute_timeout)
+            {
+                struct timespec now;
+                ::clock_gettime(clock, &now);
+                timeout_ns -= now.tv_sec * 1000000000 + now.tv_nsec;
+            }
+            if (timeout_ns <= 0)
+            {
+                return -ETIMEDOUT;
+            }
+
+            const double cycles = timeout_ns * emulator_->getClock()->getFrequencyMhz() / 1000.0;
+            timeout_cycles = std::max(uint64_t(1), static_cast<uint64_t>(cycles));
+        }
+
+        // A futex wait is allowed to return without being woken up. The guest checks the futex
+        // word again and waits again, so it spins until the futex is released.
+        PegasusState* state = calling_state_;
+        if (!emulator_->isFutexSleepEnabled() || state->getCore()->inCoSimMode())
+        {
+            return 0;
+        }
+
+        // A hart that was made to run again without being woken up is still waiting
+        const HartId hart_id = state->getHartId();
+        std::erase_if(futex_waiters_, [state](const FutexWaiter & waiter)
+                      { return waiter.state == state; });
+        emulator_->cancelFutexTimeout(hart_id);
+
+        // The hart goes to sleep after the ecall. FUTEX_WAKE wakes it up with a return value
+        // of 0.
+        futex_waiters_.push_back({state, uaddr, bitset});
+        state->pauseHart(SimPauseReason::FUTEX);
+        ++emulator_->futex_parks_;
+        if (timeout_cycles != 0)
+        {
+            emulator_->scheduleFutexTimeout(state, timeout_cycles);
+        }
         return 0;
     }
 
+    uint32_t SysCallHandlers::futexWake_(Addr uaddr, uint32_t max_waiters, uint32_t bitset)
+    {
+        uint32_t num_woken = 0;
+        auto waiter = futex_waiters_.begin();
+        while ((waiter != futex_waiters_.end()) && (num_woken < max_waiters))
+        {
+            if ((waiter->uaddr == uaddr) && (waiter->bitset & bitset))
+            {
+                PegasusState* state = waiter->state;
+                waiter = futex_waiters_.erase(waiter);
+                emulator_->cancelFutexTimeout(state->getHartId());
+                wakeFutexWaiter_(state);
+                ++num_woken;
+                ++emulator_->futex_wakes_;
+            }
+            else
+            {
+                ++waiter;
+            }
+        }
+        return num_woken;
+    }
+
+    void SysCallHandlers::futexTimeout(HartId hart_id)
+    {
+        auto waiter = std::find_if(futex_waiters_.begin(), futex_waiters_.end(),
+                                   [hart_id](const FutexWaiter & waiter)
+                                   { return waiter.state->getHartId() == hart_id; });
+        if (waiter == futex_waiters_.end())
+        {
+            return;
+        }
+
+        PegasusState* state = waiter->state;
+        futex_waiters_.erase(waiter);
+        ++emulator_->futex_timeouts_;
+        SYSCALL_LOG("futex wait of hart" << std::dec << hart_id << " -> " << -ETIMEDOUT);
+
+        // The hart is still right after its ecall
+        if (state->getSimState()->sim_pause_reason == SimPauseReason::FUTEX)
+        {
+            writeIntReg_(state, 10, -ETIMEDOUT);
+        }
+        wakeFutexWaiter_(state);
+    }
+
+    void SysCallHandlers::wakeFutexWaiter_(PegasusState* state)
+    {
+        if (state->getSimState()->sim_pause_reason == SimPauseReason::FUTEX)
+        {
+            state->unpauseHart();
+            state->getCore()->unpauseHart(state->getHartId());
+        }
+    }
+
     int64_t SysCallHandlers::set_robust_list_(const SystemCallStack &,
                                               sparta::memory::BlockingMemoryIF*)
     {
@@ -987,7 +1237,7 @@ namespace pegasus
     int64_t SysCallHandlers::tgkill_(const SystemCallStack & call_stack,
                                      sparta::memory::BlockingMemoryIF* mem)
     {
-        return exit_(call_stack, mem);
+        return exit_group_(call_stack, mem);
     }
 
     int64_t SysCallHandlers::rt_sigaction_(const SystemCallStack &,
@@ -1048,20 +1298,49 @@ namespace pegasus
     }
 
     int64_t SysCallHandlers::exit_(const SystemCallStack & call_stack,
-                                   sparta::memory::BlockingMemoryIF*)
+                                   sparta::memory::BlockingMemoryIF* memory)
     {
         const int64_t exit_code = call_stack[1];
         SYSCALL_LOG("exit(" << exit_code << ");");
-        emulator_->getPegasusSim()->endSimulation(exit_code);
+
+        // A thread started by clone only stops its own hart. The first thread ends the
+        // simulation.
+        PegasusState* state = calling_state_;
+        const auto thread = guest_threads_.find(state->getHartId());
+        if (thread == guest_threads_.end())
+        {
+            return endSimulation_(exit_code);
+        }
+
+        // pthread_join waits for the TID to be cleared
+        const Addr clear_child_tid = thread->second.clear_child_tid;
+        guest_threads_.erase(thread);
+        if (clear_child_tid != 0)
+        {
+            const uint32_t cleared_tid = 0;
+            memory->poke(clear_child_tid, sizeof(cleared_tid),
+                         reinterpret_cast<const uint8_t*>(&cleared_tid));
+            futexWake_(clear_child_tid, 1, RV_FUTEX_BITSET_MATCH_ANY);
+        }
+        state->setSimStopped(true, exit_code);
         return exit_code;
     }
 
     int64_t SysCallHandlers::exit_group_(const SystemCallStack & call_stack,
-                                         sparta::memory::BlockingMemoryIF* memory)
+                                         sparta::memory::BlockingMemoryIF*)
     {
         const int64_t exit_code = call_stack[1];
         SYSCALL_LOG("exit_group(" << exit_code << ");");
-        return exit_(call_stack, memory);
+        return endSimulation_(exit_code);
+    }
+
+    int64_t SysCallHandlers::endSimulation_(int64_t exit_code)
+    {
+        guest_threads_.clear();
+        futex_waiters_.clear();
+        emulator_->cancelFutexTimeouts();
+        emulator_->getPegasusSim()->endSimulation(exit_code);
+        return exit_code;
     }
 
     int64_t SysCallHandlers::statx_(const SystemCallStack & call_stack,
@@ -1137,14 +1416,39 @@ namespace pegasus
     int64_t SysCallHandlers::clone_(const SystemCallStack & call_stack,
                                     sparta::memory::BlockingMemoryIF* memory)
     {
-        // Get clone args struct from memory
-        clone_args args;
+        const uint64_t flags = call_stack[1];
+        const Addr stack = call_stack[2];
+        const Addr parent_tid = call_stack[3];
+        const Addr tls = call_stack[4];
+        const Addr child_tid = call_stack[5];
+
+        const int64_t ret = startThread_(flags, stack, parent_tid, tls, child_tid, memory);
+        SYSCALL_LOG(__func__ << "(" << HEX16(flags) << ", " << HEX16(stack) << ", "
+                             << HEX16(parent_tid) << ", " << HEX16(tls) << ", "
+                             << HEX16(child_tid) << ") -> " << ret);
+        return ret;
+    }
+
+    // Size of the first version of clone_args
+    static constexpr size_t CLONE_ARGS_SIZE_VER0 = 64;
+
+    int64_t SysCallHandlers::clone3_(const SystemCallStack & call_stack,
+                                     sparta::memory::BlockingMemoryIF* memory)
+    {
+        // Get clone args struct from memory. Older versions of the struct are shorter.
+        clone_args args = {};
         const uint64_t addr = call_stack[1];
         const size_t size = call_stack[2];
-        sparta_assert(sizeof(clone_args) == size,
-                      "Size of clone_args struct does not match size parameter!");
-        const bool success = memory->tryRead(addr, size, reinterpret_cast<uint8_t*>(&args));
-        sparta_assert(success);
+        if (size < CLONE_ARGS_SIZE_VER0)
+        {
+            return -EINVAL;
+        }
+        const bool success = memory->tryRead(addr, std::min(size, sizeof(clone_args)),
+                                             reinterpret_cast<uint8_t*>(&args));
+        if (!success)
+        {
+            return -EFAULT;
+        }
 
         SYSCALL_LOG(__func__ << " clone_args: flags: 0x" << std::hex << args.flags);
         SYSCALL_LOG(__func__ << " clone_args: pidfd: 0x" << std::hex << args.pidfd);
@@ -1158,13 +1462,102 @@ namespace pegasus
         SYSCALL_LOG(__func__ << " clone_args: set_tid_size: 0x" << std::hex << args.set_tid_size);
         SYSCALL_LOG(__func__ << " clone_args: cgroup: 0x" << std::hex << args.cgroup);
 
-        // TODO: Boot up a new thread, set the thread/hart ID, pause the current thread, etc.
-
-        sparta_assert(false, __func__ << " returning -1, i.e. not implemented");
-        int64_t ret = -1;
+        // Unlike clone, clone3 takes the lowest address of the stack
+        const Addr stack = (args.stack != 0) ? (args.stack + args.stack_size) : 0;
+        const int64_t ret =
+            startThread_(args.flags, stack, args.parent_tid, args.tls, args.child_tid, memory);
+        SYSCALL_LOG(__func__ << "(" << HEX16(addr) << ", " << size << ") -> " << std::dec << ret);
         return ret;
     }
 
+    // The new thread runs on an idle hart of the same core, starting with the registers of the
+    // parent thread (except for the FP and vector registers) right after the ecall
+    int64_t SysCallHandlers::startThread_(uint64_t flags, Addr stack, Addr parent_tid, Addr tls,
+                                          Addr child_tid, sparta::memory::BlockingMemoryIF* memory)
+    {
+        // New processes (fork) are not supported
+        if (((flags & RV_CLONE_VM) == 0) || ((flags & RV_CLONE_THREAD) == 0))
+        {
+            return -ENOSYS;
+        }
+
+        PegasusState* parent = calling_state_;
+        PegasusCore* core = parent->getCore();
+        PegasusState* child = nullptr;
+        for (const auto & [hart_idx, state] : core->getThreads())
+        {
+            if ((state != parent) && state->getSimState()->sim_stopped)
+            {
+                child = state;
+                break;
+            }
+        }
+        if (child == nullptr)
+        {
+            SYSCALL_LOG("No idle hart to run a new thread on");
+            return -EAGAIN;
+        }
+
+        const HartId child_hart_id = child->getHartId();
+        const int64_t tid = ::getpid() + child_hart_id;
+        guest_threads_[child_hart_id] = {
+            tid, (flags & RV_CLONE_CHILD_CLEARTID) ? child_tid : Addr(0)};
+
+        for (uint32_t reg = 1; reg < 32; ++reg)
+        {
+            writeIntReg_(child, reg, readIntReg_(parent, reg));
+        }
+        writeIntReg_(child, 10, 0);
+        if (stack != 0)
+        {
+            writeIntReg_(child, 2, stack);
+        }
+        if (flags & RV_CLONE_SETTLS)
+        {
+            writeIntReg_(child, 4, tls);
+        }
+
+        const uint32_t tid_val = tid;
+        if (flags & RV_CLONE_PARENT_SETTID)
+        {
+            memory->poke(parent_tid, sizeof(tid_val), reinterpret_cast<const uint8_t*>(&tid_val));
+        }
+        if (flags & RV_CLONE_CHILD_SETTID)
+        {
+            memory->poke(child_tid, sizeof(tid_val), reinterpret_cast<const uint8_t*>(&tid_val));
+        }
+
+        // ecall is never compressed
+        SYSCALL_LOG("Starting thread " << std::dec << tid << " on hart" << child_hart_id);
+        core->startHart(child_hart_id, parent->getPc() + 4);
+        return tid;
+    }
+
+    // The first thread has the TID of the process
+    int64_t SysCallHandlers::getTid_(const PegasusState* state) const
+    {
+        const auto thread = guest_threads_.find(state->getHartId());
+        return (thread != guest_threads_.end()) ? thread->second.tid : ::getpid();
+    }
+
+    uint64_t SysCallHandlers::readIntReg_(PegasusState* state, uint32_t reg)
+    {
+        return (state->getXlen() == 64) ? READ_INT_REG<RV64>(state, reg)
+                                        : READ_INT_REG<RV32>(state, reg);
+    }
+
+    void SysCallHandlers::writeIntReg_(PegasusState* state, uint32_t reg, uint64_t value)
+    {
+        if (state->getXlen() == 64)
+        {
+            WRITE_INT_REG<RV64>(state, reg, value);
+        }
+        else
+        {
+            WRITE_INT_REG<RV32>(state, reg, value);
+        }
+    }
+
     int64_t SysCallHandlers::open_(const SystemCallStack & call_stack,
                                    sparta::memory::BlockingMemoryIF* mem)
     {
@@ -9,12 +9,15 @@
 #include "sparta/simulation/ParameterSet.hpp"
 #include "sparta/simulation/ResourceTreeNode.hpp"
 #include "sparta/simulation/ResourceFactory.hpp"
+#include "sparta/events/PayloadEvent.hpp"
+#include "sparta/statistics/Counter.hpp"
 #include "sparta/memory/BlockingMemoryIF.hpp"
 #include "sparta/utils/ValidValue.hpp"
 
 namespace pegasus
 {
     class PegasusSim;
+    class PegasusState;
     class SysCallHandlers;
 
     /**
@@ -52,6 +55,9 @@ namespace pegasus
             PARAMETER(std::vector<uint64_t>, mem_map_params,
                       std::vector<uint64_t>({0x10000000, 0x1000000, 0x1000}),
                       "Memory Mapping parameters: <base addr> <total size> <page size>")
+            PARAMETER(bool, futex_sleep, true,
+                      "Put harts waiting on a futex to sleep until FUTEX_WAKE or a timeout wakes "
+                      "them up (false: FUTEX_WAIT returns right away and the guest spins)")
         };
 
         //! Construct!
@@ -60,9 +66,9 @@ namespace pegasus
         //! Destroy!
         ~SystemCallEmulator();
 
-        //! Handle a system call
+        //! Handle a system call made by the given hart
         int64_t emulateSystemCall(const SystemCallStack & call_stack,
-                                  sparta::memory::BlockingMemoryIF* memory);
+                                  sparta::memory::BlockingMemoryIF* memory, PegasusState* state);
 
         //! Handle exit call
         void exitCall(uint64_t exit_code);
@@ -76,6 +82,25 @@ namespace pegasus
         //! Get the memory map parameters (used by Callback delegate class)
         const std::vector<uint64_t> & getMemMapParams() const { return memory_map_params_; }
 
+        //! Do harts waiting on a futex go to sleep?
+        bool isFutexSleepEnabled() const { return futex_sleep_; }
+
+        //! Wake up a hart waiting on a futex once it has slept for the given number of cycles
+        void scheduleFutexTimeout(const PegasusState* state, uint64_t cycles);
+
+        void cancelFutexTimeout(HartId hart_id) { ev_futex_timeout_expires_.cancelIf(hart_id); }
+
+        void cancelFutexTimeouts() { ev_futex_timeout_expires_.cancel(); }
+
+        //! Number of times a hart went to sleep in FUTEX_WAIT
+        uint64_t getNumFutexParks() const { return futex_parks_.get(); }
+
+        //! Number of sleeping harts woken up by FUTEX_WAKE or a thread exit
+        uint64_t getNumFutexWakes() const { return futex_wakes_.get(); }
+
+        //! Number of futex waits that timed out
+        uint64_t getNumFutexTimeouts() const { return futex_timeouts_.get(); }
+
       private:
         void onBindTreeLate_() override;
 
@@ -84,6 +109,16 @@ namespace pegasus
 
         const std::vector<uint64_t> memory_map_params_;
 
+        const bool futex_sleep_;
+        void futexTimeoutExpires_(const HartId & hart_id);
+        sparta::PayloadEvent<HartId> ev_futex_timeout_expires_;
+
+        // Futex statistics, counted by the system call handlers
+        friend class SysCallHandlers;
+        sparta::Counter futex_parks_;
+        sparta::Counter futex_wakes_;
+        sparta::Counter futex_timeouts_;
+
         sparta::log::MessageSource syscall_log_;
         FILE* file_for_write_ = nullptr;
         int fd_for_write_ = DEFAULT_WRITE_FD;
@@ -51,6 +51,17 @@ macro (pegasus_test target)
   pegasus_named_test (${target} ${target} ${ARGN})
 endmacro (pegasus_test)
 
+# Run a benchmark as part of the pegasus_bench target. Benchmarks measure
+# host time and are not registered with ctest; put the correctness checks
+# of a feature in a test instead.
+function (pegasus_named_benchmark name target)
+  add_custom_target (${name} COMMAND $<TARGET_FILE:${target}> ${ARGN}
+    DEPENDS ${target}
+    WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+    USES_TERMINAL)
+  add_dependencies (pegasus_bench ${name})
+endfunction (pegasus_named_benchmark)
+
 # Define a macro for copying required files to be along side the build
 # files.  This is useful for golden outputs in pegasus's tests that need
 # to be copied to the build directory.
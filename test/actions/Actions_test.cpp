@@ -3,6 +3,8 @@
 
 #include "sparta/utils/SpartaTester.hpp"
 
+#include <chrono>
+
 void runSim(pegasus::PegasusState* state, pegasus::ActionGroup* pegasus_core,
             const uint32_t expected_num_insts, const uint32_t expected_num_action_groups)
 {
@@ -35,6 +37,66 @@ class dummyClass
     }
 };
 
+// Takes a trap on every execution, either by throwing or by returning a redirect
+class TrapUnit
+{
+  public:
+    using base_type = TrapUnit;
+
+    TrapUnit(pegasus::ActionGroup* trap_handler) : trap_handler_(trap_handler) {}
+
+    pegasus::Action::ItrType throwTrap(pegasus::PegasusState*, pegasus::Action::ItrType)
+    {
+        throw pegasus::ActionException(trap_handler_);
+    }
+
+    pegasus::Action::ItrType redirectTrap(pegasus::PegasusState* state, pegasus::Action::ItrType)
+    {
+        return state->redirectActionGroup(trap_handler_);
+    }
+
+  private:
+    pegasus::ActionGroup* trap_handler_;
+};
+
+// Compare the cost of taking traps by throwing an ActionException and by returning a redirect
+void benchmarkTraps(pegasus::PegasusState* state)
+{
+    std::cout << "BENCHMARK: Traps\n";
+
+    pegasus::ActionGroup trap_handler{"TrapHandler"};
+    TrapUnit trap_unit{&trap_handler};
+    pegasus::ActionGroup throw_group{
+        "ThrowTrap",
+        pegasus::Action::createAction<&TrapUnit::throwTrap>(&trap_unit, "throw_trap")};
+    pegasus::ActionGroup redirect_group{
+        "RedirectTrap",
+        pegasus::Action::createAction<&TrapUnit::redirectTrap>(&trap_unit, "redirect_trap")};
+
+    const uint64_t num_traps = 100000;
+    auto run = [&](pegasus::ActionGroup* action_group)
+    {
+        uint64_t num_handled = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < num_traps; ++i)
+        {
+            num_handled += (action_group->execute(state) == &trap_handler);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        EXPECT_EQUAL(num_handled, num_traps);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    };
+
+    const double throw_ns = run(&throw_group);
+    const double redirect_ns = run(&redirect_group);
+    std::cout << "    Traps:                 " << num_traps << std::endl;
+    std::cout << "    Time per thrown trap:  " << (throw_ns / num_traps) << "ns" << std::endl;
+    std::cout << "    Time per redirect:     " << (redirect_ns / num_traps) << "ns" << std::endl;
+
+    // A redirect does not leak into the next ActionGroup
+    EXPECT_TRUE(state->takeActionGroupRedirect() == nullptr);
+}
+
 int main()
 {
     // Create the simulator
@@ -170,6 +232,8 @@ int main()
     // each vadd.vv counts as 2 insts + wfi
     runSim(state, fetch, 11, 31);
 
+    benchmarkTraps(state);
+
     REPORT_ERROR;
     return ERROR_CODE;
 }
@@ -0,0 +1,63 @@
+#include "test/sim/WorkloadTester.hpp"
+
+#include <chrono>
+
+// Measures the cost of the counter CSRs on instruction retirement. test/sim has the correctness
+// checks (CounterCsrs_test).
+
+// Dhrystone with system call emulation does not read the counter CSRs, so only the cost of
+// keeping them up to date is measured
+static PegasusWorkloadTester::Params getParams(const bool enable_zicntr)
+{
+    PegasusWorkloadTester::Params params;
+    if (enable_zicntr)
+    {
+        params["top.core0.params.isa"] = "rv64imafdcbv_zicsr_zifencei_zicntr";
+    }
+    return params;
+}
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_INSTS = 2000000;
+
+static double runMips(PegasusWorkloadTester & bench, const uint64_t num_insts)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const pegasus::PegasusSim::RunResult result =
+        bench.getSim()->runUntil(CORE_ID, HART_ID, num_insts, 0);
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    return us ? (result.num_insts / us) : 0.0;
+}
+
+// Retiring instructions must not be slowed down by the counter CSRs
+void benchmarkRetire()
+{
+    std::cout << "Benchmarking instruction retirement with counter CSRs" << std::endl;
+
+    double mips_without_zicntr = 0.0;
+    {
+        PegasusWorkloadTester bench("rv64_dhry.elf", getParams(false));
+        mips_without_zicntr = runMips(bench, NUM_INSTS);
+    }
+
+    double mips_with_zicntr = 0.0;
+    {
+        PegasusWorkloadTester bench("rv64_dhry.elf", getParams(true));
+        mips_with_zicntr = runMips(bench, NUM_INSTS);
+    }
+
+    std::cout << "    Without Zicntr: " << mips_without_zicntr << " MIPS" << std::endl;
+    std::cout << "    With Zicntr:    " << mips_with_zicntr << " MIPS" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    benchmarkRetire();
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "cosim/PegasusCoSim.hpp"
+#include "cosim/EventCodec.hpp"
+#include "sim/PegasusSimParameters.hpp"
+
+#include <chrono>
+#include <filesystem>
+
+// Measures the size and speed of the cosim event codecs. test/cosim/event_codec checks that the
+// events survive the round trip.
+
+using pegasus::cosim::CompressionCodec;
+using pegasus::cosim::EventCodec;
+using pegasus::cosim::EventFormat;
+using pegasus::cosim::EventList;
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_EVENTS = 200000;
+
+// Same window size as the CoSimEventPipeline
+static constexpr size_t WINDOW_SIZE = 100;
+
+// Number of times each window is encoded and decoded when timing the codecs
+static constexpr uint32_t NUM_ITERATIONS = 5;
+
+// Runs Dhrystone with system call emulation through cosim and keeps a copy of every event
+EventList collectEvents(const std::string & codec)
+{
+    const std::string workload =
+        std::filesystem::canonical(std::filesystem::absolute("workloads/rv64_dhry.elf")).string();
+    const std::map<std::string, std::string> sim_params = {
+        {"top.extension.sim.enable_syscall_emulation", "true"},
+        {"top.extension.sim.reg_overrides",
+         "[[core0.hart0.sp, 0x0000003ffffff000], [core0.hart0.gp, 0x77000], "
+         "[core0.hart0.tp, 0x7d000]]"},
+        {"top.extension.sim.cosim_event_codec", codec}};
+    const std::string db_file = "EventCodec_bench_" + codec + ".db";
+
+    EventList evts;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        pegasus::cosim::PegasusCoSim cosim(NUM_EVENTS, workload, sim_params, {}, db_file);
+        auto state = cosim.getPegasusSim().getPegasusCore(CORE_ID)->getPegasusState(HART_ID);
+        while (!state->getSimState()->sim_stopped && (evts.size() < NUM_EVENTS))
+        {
+            auto event = cosim.step(CORE_ID, HART_ID);
+            evts.emplace_back(*event.get());
+            cosim.commit(event);
+        }
+        cosim.finish();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << "    cosim with '" << codec << "' codec: " << std::dec << evts.size()
+              << " events, " << (us ? (evts.size() / us * 1e6) : 0.0) << " events/sec"
+              << std::endl;
+
+    std::filesystem::remove(db_file);
+    return evts;
+}
+
+void benchmarkCodec(const std::string & codec, const EventList & evts)
+{
+    const EventFormat format = EventCodec::getFormat(codec);
+
+    std::vector<EventList> windows;
+    for (auto it = evts.begin(); it != evts.end();)
+    {
+        const auto window_end = it + std::min<size_t>(WINDOW_SIZE, evts.end() - it);
+        windows.emplace_back(it, window_end);
+        it = window_end;
+    }
+
+    size_t num_bytes = 0;
+    size_t num_compressed_bytes = 0;
+    std::chrono::steady_clock::duration encode_time{0};
+    std::chrono::steady_clock::duration decode_time{0};
+    for (const auto & window : windows)
+    {
+        std::vector<char> bytes;
+        std::vector<char> compressed_bytes;
+        EventList decoded_evts;
+        for (uint32_t i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            EventCodec::compress(window, format, CompressionCodec::ZLIB, nullptr, compressed_bytes);
+            const auto encoded = std::chrono::steady_clock::now();
+            EventCodec::decompress(compressed_bytes, format, CompressionCodec::ZLIB, nullptr,
+                                   decoded_evts);
+            const auto end = std::chrono::steady_clock::now();
+            encode_time += encoded - start;
+            decode_time += end - encoded;
+        }
+
+        EventCodec::encode(window, format, bytes);
+        num_bytes += bytes.size();
+        num_compressed_bytes += compressed_bytes.size();
+    }
+
+    auto events_per_sec = [&](const std::chrono::steady_clock::duration & dur)
+    {
+        const double us = std::chrono::duration_cast<std::chrono::microseconds>(dur).count();
+        return us ? (evts.size() * NUM_ITERATIONS / us * 1e6) : 0.0;
+    };
+
+    std::cout << "    " << codec << ": " << std::dec
+              << static_cast<double>(num_bytes) / evts.size() << " bytes/event, "
+              << static_cast<double>(num_compressed_bytes) / evts.size()
+              << " bytes/event after zlib, " << events_per_sec(encode_time)
+              << " events/sec encode+zlib, " << events_per_sec(decode_time)
+              << " events/sec zlib+decode" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "Running cosim on Dhrystone" << std::endl;
+    const EventList evts = collectEvents("compact");
+    collectEvents("boost");
+
+    std::cout << "Benchmarking event codecs (" << WINDOW_SIZE << " events per window)"
+              << std::endl;
+    benchmarkCodec("boost", evts);
+    benchmarkCodec("compact", evts);
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "cosim/PegasusCoSim.hpp"
+#include "cosim/EventCodec.hpp"
+#include "cosim/EventCompression.hpp"
+#include "sim/PegasusSimParameters.hpp"
+
+#include <chrono>
+#include <filesystem>
+
+// Measures the ratio and speed of the cosim event compression codecs.
+// test/cosim/event_compression checks that the windows survive the round trip.
+
+using pegasus::cosim::CompressionCodec;
+using pegasus::cosim::EventCodec;
+using pegasus::cosim::EventCompressor;
+using pegasus::cosim::EventDictionary;
+using pegasus::cosim::EventFormat;
+using pegasus::cosim::EventList;
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_EVENTS = 200000;
+
+// Same window size as the CoSimEventPipeline
+static constexpr size_t WINDOW_SIZE = 100;
+
+// Number of times each window is compressed and decompressed when timing the codecs
+static constexpr uint32_t NUM_ITERATIONS = 5;
+
+// Runs Dhrystone with system call emulation through cosim and returns the encoded
+// (not yet compressed) event windows
+std::vector<std::vector<char>> collectWindows(const std::string & compression)
+{
+    const std::string workload =
+        std::filesystem::canonical(std::filesystem::absolute("workloads/rv64_dhry.elf")).string();
+    const std::map<std::string, std::string> sim_params = {
+        {"top.extension.sim.enable_syscall_emulation", "true"},
+        {"top.extension.sim.reg_overrides",
+         "[[core0.hart0.sp, 0x0000003ffffff000], [core0.hart0.gp, 0x77000], "
+         "[core0.hart0.tp, 0x7d000]]"},
+        {"top.extension.sim.cosim_event_compression", compression}};
+    const std::string db_file = "EventCompression_bench_" + compression + ".db";
+
+    EventList evts;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        pegasus::cosim::PegasusCoSim cosim(NUM_EVENTS, workload, sim_params, {}, db_file);
+        auto state = cosim.getPegasusSim().getPegasusCore(CORE_ID)->getPegasusState(HART_ID);
+        while (!state->getSimState()->sim_stopped && (evts.size() < NUM_EVENTS))
+        {
+            auto event = cosim.step(CORE_ID, HART_ID);
+            evts.emplace_back(*event.get());
+            cosim.commit(event);
+        }
+        cosim.finish();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << "    cosim with '" << compression << "' compression: " << std::dec
+              << evts.size() << " events, " << (us ? (evts.size() / us * 1e6) : 0.0)
+              << " events/sec" << std::endl;
+
+    std::filesystem::remove(db_file);
+
+    std::vector<std::vector<char>> windows;
+    for (auto it = evts.begin(); it != evts.end();)
+    {
+        const auto window_end = it + std::min<size_t>(WINDOW_SIZE, evts.end() - it);
+        auto & bytes = windows.emplace_back();
+        EventCodec::encode(EventList(it, window_end), EventFormat::COMPACT_V1, bytes);
+        it = window_end;
+    }
+    return windows;
+}
+
+void benchmarkCodec(const std::vector<std::vector<char>> & windows, CompressionCodec codec,
+                    int level, const EventDictionary* dict)
+{
+    size_t num_bytes = 0;
+    size_t num_compressed_bytes = 0;
+    std::chrono::steady_clock::duration compress_time{0};
+    std::chrono::steady_clock::duration decompress_time{0};
+    for (const auto & window : windows)
+    {
+        std::vector<char> compressed_bytes;
+        std::vector<char> decompressed_bytes;
+        for (uint32_t i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            EventCompressor::compress(window, codec, level, dict, compressed_bytes);
+            const auto compressed = std::chrono::steady_clock::now();
+            EventCompressor::decompress(compressed_bytes, codec, dict, decompressed_bytes);
+            const auto end = std::chrono::steady_clock::now();
+            compress_time += compressed - start;
+            decompress_time += end - compressed;
+        }
+
+        num_bytes += window.size();
+        num_compressed_bytes += compressed_bytes.size();
+    }
+
+    const double compress_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(compress_time).count();
+    const double decompress_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(decompress_time).count();
+    const double num_windows = windows.size() * NUM_ITERATIONS;
+
+    std::cout << "    " << codec;
+    if (level)
+    {
+        std::cout << " level " << level;
+    }
+    std::cout << ": " << std::dec << static_cast<double>(num_bytes) / num_compressed_bytes
+              << "x ratio, "
+              << (compress_us ? (num_bytes * NUM_ITERATIONS / compress_us) : 0.0)
+              << " MB/s compress, " << decompress_us / num_windows
+              << " us/window decompress" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "Running cosim on Dhrystone" << std::endl;
+    const auto windows = collectWindows("adaptive");
+    collectWindows("zlib");
+
+    std::cout << "Benchmarking event compression (" << WINDOW_SIZE << " events per window)"
+              << std::endl;
+    benchmarkCodec(windows, CompressionCodec::ZLIB, 0, nullptr);
+
+    if (EventCompressor::isAvailable(CompressionCodec::LZ4))
+    {
+        benchmarkCodec(windows, CompressionCodec::LZ4, 0, nullptr);
+    }
+    else
+    {
+        std::cout << "    lz4: not available in this build" << std::endl;
+    }
+
+    if (EventCompressor::isAvailable(CompressionCodec::ZSTD))
+    {
+        benchmarkCodec(windows, CompressionCodec::ZSTD, EventCompressor::ZSTD_FAST_LEVEL,
+                       nullptr);
+        benchmarkCodec(windows, CompressionCodec::ZSTD, EventCompressor::ZSTD_DEFAULT_LEVEL,
+                       nullptr);
+
+        // Train on the first windows like the CoSimEventPipeline does
+        const size_t num_training_windows =
+            std::min(EventCompressor::NUM_TRAINING_WINDOWS, windows.size());
+        const std::vector<std::vector<char>> samples(windows.begin(),
+                                                     windows.begin() + num_training_windows);
+        const auto dict =
+            EventCompressor::trainDictionary(samples, EventCompressor::MAX_DICTIONARY_SIZE);
+        if (dict)
+        {
+            std::cout << "    (" << dict->getBytes().size() << " byte dictionary)"
+                      << std::endl;
+            benchmarkCodec(windows, CompressionCodec::ZSTD_DICT,
+                           EventCompressor::ZSTD_FAST_LEVEL, dict.get());
+            benchmarkCodec(windows, CompressionCodec::ZSTD_DICT,
+                           EventCompressor::ZSTD_DEFAULT_LEVEL, dict.get());
+        }
+    }
+    else
+    {
+        std::cout << "    zstd: not available in this build" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "test/sim/WorkloadTester.hpp"
+
+#include <chrono>
+#include <ctime>
+
+// Measures the host time spent on threading.elf with and without futex sleep. test/sim has the
+// correctness checks (GuestThreads_test).
+
+static constexpr uint32_t NUM_HARTS = 2;
+
+// Number of times each configuration is run
+static constexpr uint32_t NUM_ITERATIONS = 3;
+
+struct RunResult
+{
+    std::vector<uint64_t> num_insts;
+    std::vector<uint64_t> sleep_cycles;
+    double seconds = 0;
+    double cpu_seconds = 0;
+};
+
+// Runs threading.elf with system call emulation. The main thread starts a thread on hart1 with
+// clone3 and waits for it in pthread_join, and both threads contend for the stdout lock in
+// printf. Without futex sleep, FUTEX_WAIT returns right away and the waiting thread spins.
+RunResult runThreading(bool futex_sleep)
+{
+    PegasusWorkloadTester::Params params = PegasusWorkloadTester::getNumHartsParams(NUM_HARTS);
+    params["top.system_call_emulator.params.futex_sleep"] = futex_sleep ? "true" : "false";
+    PegasusWorkloadTester tester("threading.elf", params, false);
+
+    RunResult result;
+    const auto start = std::chrono::steady_clock::now();
+    const std::clock_t cpu_start = std::clock();
+    tester.getSim()->run(sparta::Scheduler::INDEFINITE);
+    const std::clock_t cpu_end = std::clock();
+    const auto end = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.cpu_seconds = double(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+
+    pegasus::PegasusCore* core = tester.getCore();
+    for (pegasus::HartId hart_idx = 0; hart_idx < NUM_HARTS; ++hart_idx)
+    {
+        const pegasus::PegasusState* state = core->getPegasusState(hart_idx);
+        result.num_insts.emplace_back(state->getSimState()->inst_count);
+        result.sleep_cycles.emplace_back(core->getHartSchedStats(hart_idx).sleep_cycles);
+    }
+    return result;
+}
+
+void benchmarkFutexSleep()
+{
+    std::cout << "Benchmarking guest threads waiting on futexes" << std::endl;
+
+    for (const bool futex_sleep : {false, true})
+    {
+        RunResult result;
+        double seconds = 0;
+        double cpu_seconds = 0;
+        for (uint32_t i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            result = runThreading(futex_sleep);
+            seconds += result.seconds;
+            cpu_seconds += result.cpu_seconds;
+        }
+
+        std::cout << "    " << (futex_sleep ? "Futex sleep:" : "Spinning:   ") << std::dec
+                  << " hart0 " << result.num_insts[0] << " insts (" << result.sleep_cycles[0]
+                  << " cycles asleep), hart1 " << result.num_insts[1] << " insts ("
+                  << result.sleep_cycles[1] << " cycles asleep), "
+                  << (seconds * 1e6 / NUM_ITERATIONS) << " us host time, "
+                  << (cpu_seconds * 1e6 / NUM_ITERATIONS) << " us host CPU time" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    benchmarkFutexSleep();
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusSimParameters.hpp"
+#include "core/PegasusState.hpp"
+
+#include <chrono>
+#include <filesystem>
+
+// Measures the speedup of running the harts of a core on 1 to 8 host threads. test/sim has the
+// correctness checks (ParallelHarts_test).
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+
+// Number of times each configuration is run
+static constexpr uint32_t NUM_ITERATIONS = 3;
+
+struct RunResult
+{
+    std::vector<uint64_t> num_insts;
+    std::vector<uint64_t> cycles;
+    uint64_t num_parallel_windows = 0;
+    uint64_t num_window_syncs = 0;
+    double seconds = 0;
+};
+
+// Runs multihart.elf on every hart of core0 through the scheduler
+RunResult runMultihart(uint32_t num_harts, uint32_t host_threads)
+{
+    const std::string workload =
+        std::filesystem::canonical(std::filesystem::absolute("workloads/multihart.elf"))
+            .string();
+    pegasus::PegasusSimParameters::WorkloadsAndArgs workloads_and_args(num_harts, {workload});
+
+    sparta::Scheduler scheduler;
+    sparta::app::SimulationConfiguration config;
+    config.processParameter(
+        "top.extension.sim.workloads",
+        pegasus::PegasusSimParameters::convertVectorToStringParam(workloads_and_args));
+    config.processParameter("top.core0.params.isa", "rv64imafdcbv_zicsr_zifencei_zihintpause");
+    config.processParameter("top.core0.params.num_harts", std::to_string(num_harts));
+    config.processParameter("top.core0.params.host_threads", std::to_string(host_threads));
+    for (uint32_t hart_idx = 0; hart_idx < num_harts; ++hart_idx)
+    {
+        config.processParameter("top.core0.hart" + std::to_string(hart_idx) + ".params.hart_id",
+                                std::to_string(hart_idx));
+    }
+
+    RunResult result;
+    pegasus::PegasusSim sim(&scheduler);
+    sim.configure(0, nullptr, &config);
+    sim.buildTree();
+    sim.configureTree();
+    sim.finalizeTree();
+
+    const auto start = std::chrono::steady_clock::now();
+    sim.run(sparta::Scheduler::INDEFINITE);
+    const auto end = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+
+    pegasus::PegasusCore* core = sim.getPegasusCore(CORE_ID);
+    for (pegasus::HartId hart_idx = 0; hart_idx < num_harts; ++hart_idx)
+    {
+        const pegasus::PegasusState* state = core->getPegasusState(hart_idx);
+        result.num_insts.emplace_back(state->getSimState()->inst_count);
+        result.cycles.emplace_back(state->getSimState()->cycles);
+    }
+    result.num_parallel_windows = core->getNumParallelWindows();
+    result.num_window_syncs = core->getNumWindowSyncs();
+    return result;
+}
+
+void benchmarkParallelHarts(uint32_t num_harts)
+{
+    std::cout << "Benchmarking " << num_harts << " harts" << std::endl;
+
+    double serial_seconds = 0;
+    for (const uint32_t host_threads : {1, 2, 4, 8})
+    {
+        if (host_threads > num_harts)
+        {
+            break;
+        }
+
+        double seconds = 0;
+        uint64_t num_insts = 0;
+        RunResult result;
+        for (uint32_t i = 0; i < NUM_ITERATIONS; ++i)
+        {
+            result = runMultihart(num_harts, host_threads);
+            seconds += result.seconds;
+            num_insts = 0;
+            for (const uint64_t hart_insts : result.num_insts)
+            {
+                num_insts += hart_insts;
+            }
+        }
+
+        if (host_threads == 1)
+        {
+            serial_seconds = seconds;
+        }
+
+        const double us = seconds * 1e6 / NUM_ITERATIONS;
+        std::cout << "    " << host_threads << " host threads: " << std::dec << num_insts
+                  << " instructions, " << (us ? (num_insts / us) : 0.0) << " MIPS, "
+                  << (seconds ? (serial_seconds / seconds) : 0.0) << "x speedup, "
+                  << result.num_parallel_windows << " parallel windows, "
+                  << result.num_window_syncs << " syncs" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    for (const uint32_t num_harts : {2, 4, 8})
+    {
+        benchmarkParallelHarts(num_harts);
+    }
+
+    return 0;
+}
@@ -0,0 +1,668 @@
+#include "cosim/PegasusCoSim.hpp"
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusSimParameters.hpp"
+#include "core/PegasusState.hpp"
+#include "mavis/JSONUtils.hpp"
+
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Performance regression suite over the workloads in test/sim/workloads.
+//
+// Every configuration of the matrix runs in a forked child process so the peak RSS and
+// the allocation count belong to that configuration only. The results are written as
+// JSON and compared against a baseline file: a configuration fails when its median MIPS
+// drops, or its allocation count grows, by more than the tolerance.
+//
+// Run "make pegasus_bench" to run the whole matrix against the checked-in baseline, or
+// run PegasusBench directly (--help) to filter configurations or write a new baseline.
+
+namespace po = boost::program_options;
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocation counting
+
+static std::atomic<uint64_t> num_allocations{0};
+
+static void* countedAlloc(std::size_t size)
+{
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+static void* countedAlignedAlloc(std::size_t size, std::align_val_t align)
+{
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    // aligned_alloc requires the size to be a multiple of the alignment
+    const std::size_t aligned_size = ((size ? size : 1) + alignment - 1) & ~(alignment - 1);
+    if (void* ptr = std::aligned_alloc(alignment, aligned_size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    return countedAlignedAlloc(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    return countedAlignedAlloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark matrix
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+
+// A workload and the values of each matrix dimension it is run with
+struct WorkloadSpec
+{
+    std::string name;
+    std::string elf;
+    std::vector<std::string> args;
+    bool syscall_emulation;
+    // Run the workload on every hart, instead of on hart0 with the other harts waiting for
+    // the guest threads it creates
+    bool workload_per_hart;
+    std::map<std::string, std::string> params;
+    std::vector<uint32_t> num_harts;
+    std::vector<uint32_t> vlens;
+    std::vector<bool> observers;
+    std::vector<bool> cosim;
+    uint64_t ilimit;
+};
+
+// Cosim takes a single workload without arguments, so it is only enabled for Dhrystone.
+// The vector and arch tests are not part of the matrix: the vector tests are unit tests
+// and the arch test ELFs are not in test/. threading.elf runs on 4 harts so its clone()
+// threads get harts of their own and wait for each other on futexes.
+static const std::vector<WorkloadSpec> WORKLOADS = {
+    {"dhry", "rv64_dhry.elf", {}, true, true, {}, {1}, {256}, {false, true}, {false, true},
+     2000000},
+    {"syscall_test",
+     "syscall_test.elf",
+     {"test_text.txt"},
+     true,
+     true,
+     {},
+     {1},
+     {256},
+     {false, true},
+     {false},
+     2000000},
+    {"threading",
+     "threading.elf",
+     {},
+     true,
+     false,
+     {},
+     {1, 4},
+     {256},
+     {false, true},
+     {false},
+     2000000},
+    {"multihart",
+     "multihart.elf",
+     {},
+     false,
+     true,
+     {{"top.core0.params.isa", "rv64imafdcbv_zicsr_zifencei_zihintpause"}},
+     {1, 2},
+     {128, 512},
+     {false, true},
+     {false},
+     1000000}};
+
+// One point of the matrix
+struct BenchConfig
+{
+    std::string name;
+    const WorkloadSpec* workload;
+    uint32_t num_harts;
+    uint32_t vlen;
+    bool observers;
+    bool cosim;
+};
+
+std::vector<BenchConfig> getMatrix()
+{
+    std::vector<BenchConfig> configs;
+    for (const auto & workload : WORKLOADS)
+    {
+        for (const uint32_t num_harts : workload.num_harts)
+        {
+            for (const uint32_t vlen : workload.vlens)
+            {
+                for (const bool observers : workload.observers)
+                {
+                    for (const bool cosim : workload.cosim)
+                    {
+                        const std::string name =
+                            workload.name + "/harts" + std::to_string(num_harts) + "/vlen"
+                            + std::to_string(vlen) + (observers ? "/stf" : "/no_stf")
+                            + (cosim ? "/cosim" : "/no_cosim");
+                        configs.push_back(
+                            {name, &workload, num_harts, vlen, observers, cosim});
+                    }
+                }
+            }
+        }
+    }
+    return configs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Running one configuration
+
+static constexpr uint32_t MAX_HARTS = 8;
+
+// Sent from the child process to the parent through a pipe
+struct RunStats
+{
+    double seconds = 0;
+    uint64_t num_insts[MAX_HARTS] = {};
+    uint64_t peak_rss_kb = 0;
+    uint64_t num_allocations = 0;
+};
+
+std::map<std::string, std::string> getParams(const BenchConfig & config,
+                                             const std::string & stf_filename)
+{
+    sparta_assert(config.num_harts <= MAX_HARTS, "Too many harts: " << config.num_harts);
+    const WorkloadSpec & workload = *config.workload;
+    std::map<std::string, std::string> params = workload.params;
+    if (workload.syscall_emulation)
+    {
+        params["top.extension.sim.enable_syscall_emulation"] = "true";
+        params["top.extension.sim.reg_overrides"] =
+            "[[core0.hart0.sp, 0x0000003ffffff000], [core0.hart0.gp, 0x77000], "
+            "[core0.hart0.tp, 0x7d000]]";
+    }
+    params["top.core0.params.num_harts"] = std::to_string(config.num_harts);
+    for (uint32_t hart_idx = 0; hart_idx < config.num_harts; ++hart_idx)
+    {
+        const std::string hart_params = "top.core0.hart" + std::to_string(hart_idx) + ".params.";
+        params[hart_params + "hart_id"] = std::to_string(hart_idx);
+        params[hart_params + "vlen"] = std::to_string(config.vlen);
+        if (config.observers)
+        {
+            params[hart_params + "stf_filename"] =
+                std::to_string(hart_idx) + "_" + stf_filename;
+        }
+    }
+    return params;
+}
+
+std::string getWorkloadPath(const WorkloadSpec & workload)
+{
+    return std::filesystem::canonical(std::filesystem::absolute("workloads/" + workload.elf))
+        .string();
+}
+
+// Runs the harts through PegasusSim::run(), the same scheduler (runnable queue, WFI sleep and
+// parallel windows) the simulator uses. The instruction limit applies to each hart.
+RunStats runSim(const BenchConfig & config, const std::map<std::string, std::string> & params,
+                uint64_t ilimit)
+{
+    const WorkloadSpec & workload = *config.workload;
+
+    pegasus::PegasusSimParameters::WorkloadsAndArgs workloads_and_args;
+    const uint32_t num_workloads = workload.workload_per_hart ? config.num_harts : 1;
+    for (uint32_t hart_idx = 0; hart_idx < num_workloads; ++hart_idx)
+    {
+        auto & workload_and_args = workloads_and_args.emplace_back();
+        workload_and_args.emplace_back(getWorkloadPath(workload));
+        for (const auto & arg : workload.args)
+        {
+            workload_and_args.emplace_back(std::filesystem::absolute(arg).string());
+        }
+    }
+
+    sparta::Scheduler scheduler;
+    sparta::app::SimulationConfiguration sim_config;
+    sim_config.processParameter(
+        "top.extension.sim.workloads",
+        pegasus::PegasusSimParameters::convertVectorToStringParam(workloads_and_args));
+    sim_config.processParameter("top.extension.sim.inst_limit", std::to_string(ilimit));
+    for (const auto & [name, value] : params)
+    {
+        sim_config.processParameter(name, value);
+    }
+
+    RunStats stats;
+    {
+        pegasus::PegasusSim sim(&scheduler);
+        sim.configure(0, nullptr, &sim_config);
+        sim.buildTree();
+        sim.configureTree();
+        sim.finalizeTree();
+
+        const uint64_t start_allocations = num_allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+        sim.run(sparta::Scheduler::INDEFINITE);
+        const auto end = std::chrono::steady_clock::now();
+        stats.num_allocations = num_allocations.load() - start_allocations;
+        stats.seconds = std::chrono::duration<double>(end - start).count();
+
+        pegasus::PegasusCore* core = sim.getPegasusCore(CORE_ID);
+        for (pegasus::HartId hart_idx = 0; hart_idx < config.num_harts; ++hart_idx)
+        {
+            stats.num_insts[hart_idx] =
+                core->getPegasusState(hart_idx)->getSimState()->inst_count;
+        }
+    }
+    return stats;
+}
+
+RunStats runCoSim(const BenchConfig & config, const std::map<std::string, std::string> & params,
+                  uint64_t ilimit)
+{
+    const WorkloadSpec & workload = *config.workload;
+    sparta_assert(config.num_harts == 1, "Cosim benchmarks only run one hart");
+    sparta_assert(workload.args.empty(), "Cosim workloads cannot have arguments");
+
+    const std::string db_file = "pegasus_bench_" + std::to_string(getpid()) + ".db";
+
+    RunStats stats;
+    {
+        pegasus::cosim::PegasusCoSim cosim(ilimit, getWorkloadPath(workload), params, {},
+                                           db_file);
+        const pegasus::HartId hart_idx = 0;
+        pegasus::PegasusState* state =
+            cosim.getPegasusSim().getPegasusCore(CORE_ID)->getPegasusState(hart_idx);
+
+        const uint64_t start_allocations = num_allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+
+        while (!state->getSimState()->sim_stopped && (stats.num_insts[hart_idx] < ilimit))
+        {
+            auto event = cosim.step(CORE_ID, hart_idx);
+            cosim.commit(event);
+            ++stats.num_insts[hart_idx];
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        stats.num_allocations = num_allocations.load() - start_allocations;
+        stats.seconds = std::chrono::duration<double>(end - start).count();
+
+        cosim.finish();
+    }
+    std::filesystem::remove(db_file);
+    return stats;
+}
+
+// Runs the configuration in a child process. Returns false if the child failed.
+bool runConfig(const BenchConfig & config, uint64_t ilimit, bool verbose, RunStats & stats)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        throw std::runtime_error("pipe() failed");
+    }
+
+    std::cout.flush();
+    const pid_t pid = fork();
+    if (pid < 0)
+    {
+        throw std::runtime_error("fork() failed");
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        if (!verbose)
+        {
+            // The simulator prints its own statistics
+            if (std::freopen("/dev/null", "w", stdout) == nullptr)
+            {
+                _exit(1);
+            }
+        }
+
+        const std::string stf_filename =
+            "pegasus_bench_" + std::to_string(getpid()) + ".zstf";
+        RunStats child_stats;
+        try
+        {
+            const auto params = getParams(config, stf_filename);
+            child_stats = config.cosim ? runCoSim(config, params, ilimit)
+                                       : runSim(config, params, ilimit);
+        }
+        catch (const std::exception & ex)
+        {
+            std::cerr << config.name << ": " << ex.what() << std::endl;
+            _exit(1);
+        }
+
+        for (uint32_t hart_idx = 0; hart_idx < config.num_harts; ++hart_idx)
+        {
+            std::filesystem::remove(std::to_string(hart_idx) + "_" + stf_filename);
+        }
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        child_stats.peak_rss_kb = usage.ru_maxrss;
+
+        const bool written =
+            write(fds[1], &child_stats, sizeof(child_stats)) == sizeof(child_stats);
+        close(fds[1]);
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    const bool read_ok = read(fds[0], &stats, sizeof(stats)) == sizeof(stats);
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return read_ok && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Results
+
+template <typename T> T median(std::vector<T> values)
+{
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+    return (values.size() % 2) ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+boost::json::object summarize(const BenchConfig & config, const std::vector<RunStats> & runs)
+{
+    std::vector<double> mips;
+    std::vector<uint64_t> allocations;
+    uint64_t peak_rss_kb = 0;
+    for (const auto & run : runs)
+    {
+        uint64_t num_insts = 0;
+        for (uint32_t hart_idx = 0; hart_idx < config.num_harts; ++hart_idx)
+        {
+            num_insts += run.num_insts[hart_idx];
+        }
+        mips.emplace_back(run.seconds ? (num_insts / run.seconds / 1e6) : 0.0);
+        allocations.emplace_back(run.num_allocations);
+        peak_rss_kb = std::max(peak_rss_kb, run.peak_rss_kb);
+    }
+
+    boost::json::array insts_per_second;
+    boost::json::array num_insts;
+    for (uint32_t hart_idx = 0; hart_idx < config.num_harts; ++hart_idx)
+    {
+        std::vector<double> rates;
+        for (const auto & run : runs)
+        {
+            rates.emplace_back(run.seconds ? (run.num_insts[hart_idx] / run.seconds) : 0.0);
+        }
+        insts_per_second.emplace_back(median(rates));
+        num_insts.emplace_back(runs.front().num_insts[hart_idx]);
+    }
+
+    boost::json::object result;
+    result["workload"] = config.workload->name;
+    result["num_harts"] = config.num_harts;
+    result["vlen"] = config.vlen;
+    result["observers"] = config.observers;
+    result["cosim"] = config.cosim;
+    result["num_runs"] = runs.size();
+    result["median_mips"] = median(mips);
+    result["mips"] = boost::json::value_from(mips);
+    result["num_insts_per_hart"] = std::move(num_insts);
+    result["insts_per_host_second_per_hart"] = std::move(insts_per_second);
+    result["peak_rss_kb"] = peak_rss_kb;
+    result["allocations"] = median(allocations);
+    return result;
+}
+
+// boost::json::serialize() does not indent; keep the files diffable
+void writeJSON(std::ostream & os, const boost::json::value & value, uint32_t indent = 0)
+{
+    const std::string pad(indent + 2, ' ');
+    if (value.is_object())
+    {
+        const auto & obj = value.as_object();
+        if (obj.empty())
+        {
+            os << "{}";
+            return;
+        }
+        os << "{\n";
+        for (auto it = obj.begin(); it != obj.end(); ++it)
+        {
+            os << pad << boost::json::serialize(boost::json::string(it->key())) << ": ";
+            writeJSON(os, it->value(), indent + 2);
+            os << ((std::next(it) != obj.end()) ? ",\n" : "\n");
+        }
+        os << std::string(indent, ' ') << "}";
+    }
+    else
+    {
+        os << boost::json::serialize(value);
+    }
+}
+
+// Returns the number of regressions. A configuration without a baseline entry is reported but
+// is not a regression, so the target still passes until the baseline has been generated.
+uint32_t compareToBaseline(const boost::json::object & results,
+                           const boost::json::object & baseline, double tolerance)
+{
+    std::cout << "Comparing against the baseline (tolerance " << tolerance * 100 << "%)"
+              << std::endl;
+    uint32_t num_regressions = 0;
+    uint32_t num_missing = 0;
+    for (const auto & kv : results)
+    {
+        const std::string name(kv.key());
+        const boost::json::value & result = kv.value();
+        const auto* base = baseline.if_contains(name);
+        if (!base)
+        {
+            std::cout << "    " << name << ": WARNING: no baseline entry" << std::endl;
+            ++num_missing;
+            continue;
+        }
+
+        const double mips = result.at("median_mips").to_number<double>();
+        const double base_mips = base->at("median_mips").to_number<double>();
+        const double allocations = result.at("allocations").to_number<double>();
+        const double base_allocations = base->at("allocations").to_number<double>();
+
+        std::cout << "    " << name << ": " << std::fixed << std::setprecision(2)
+                  << mips << " MIPS (baseline " << base_mips << ")";
+        if (mips < base_mips * (1.0 - tolerance))
+        {
+            std::cout << " REGRESSION";
+            ++num_regressions;
+        }
+        if (allocations > base_allocations * (1.0 + tolerance))
+        {
+            std::cout << " ALLOCATIONS " << std::setprecision(0) << allocations
+                      << " (baseline " << base_allocations << ")";
+            ++num_regressions;
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    if (num_missing)
+    {
+        std::cout << "WARNING: " << num_missing << " configuration(s) have no baseline entry "
+                  << "and were not checked. Add them by running PegasusBench --write-baseline "
+                  << "on the reference machine." << std::endl;
+    }
+    return num_regressions;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t repeat = 5;
+    uint64_t ilimit = 0;
+    double tolerance = 0.10;
+    std::string filter;
+    std::string output_file = "pegasus_bench.json";
+    std::string baseline_file;
+    std::string write_baseline_file;
+
+    po::options_description desc("PegasusBench options");
+    desc.add_options()("help,h", "Print this message")(
+        "repeat,r", po::value<uint32_t>(&repeat), "Number of runs of each configuration")(
+        "filter,f", po::value<std::string>(&filter),
+        "Only run configurations whose name contains this string")(
+        "inst-limit,i", po::value<uint64_t>(&ilimit),
+        "Override the instruction limit of every workload")(
+        "output,o", po::value<std::string>(&output_file), "JSON results file")(
+        "baseline,b", po::value<std::string>(&baseline_file),
+        "Baseline JSON file to compare against")(
+        "tolerance,t", po::value<double>(&tolerance),
+        "Allowed slowdown (and allocation growth) relative to the baseline, as a fraction")(
+        "write-baseline", po::value<std::string>(&write_baseline_file),
+        "Write the results as a new baseline file")("list", "List the configurations")(
+        "verbose,v", "Show the simulator output");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    std::vector<BenchConfig> configs;
+    for (const auto & config : getMatrix())
+    {
+        if (config.name.find(filter) != std::string::npos)
+        {
+            configs.emplace_back(config);
+        }
+    }
+
+    if (vm.count("list"))
+    {
+        for (const auto & config : configs)
+        {
+            std::cout << config.name << std::endl;
+        }
+        return 0;
+    }
+
+    boost::json::object results;
+    uint32_t num_failures = 0;
+    for (const auto & config : configs)
+    {
+        const uint64_t config_ilimit = ilimit ? ilimit : config.workload->ilimit;
+        std::cout << config.name << ":" << std::flush;
+
+        std::vector<RunStats> runs;
+        for (uint32_t run_idx = 0; run_idx < repeat; ++run_idx)
+        {
+            RunStats stats;
+            if (!runConfig(config, config_ilimit, vm.count("verbose"), stats))
+            {
+                break;
+            }
+            runs.emplace_back(stats);
+        }
+
+        if (runs.size() != repeat)
+        {
+            std::cout << " FAILED" << std::endl;
+            ++num_failures;
+            continue;
+        }
+
+        auto result = summarize(config, runs);
+        std::cout << " " << result.at("median_mips").as_double() << " MIPS, "
+                  << result.at("peak_rss_kb").to_number<uint64_t>() << " KB peak RSS, "
+                  << result.at("allocations").to_number<uint64_t>() << " allocations"
+                  << std::endl;
+        results[config.name] = std::move(result);
+    }
+
+    boost::json::object report;
+    report["repeat"] = repeat;
+    report["results"] = results;
+    {
+        std::ofstream out(output_file);
+        writeJSON(out, report);
+        out << std::endl;
+    }
+    std::cout << "Results written to " << output_file << std::endl;
+
+    if (!write_baseline_file.empty())
+    {
+        // Keep the entries of the configurations that were filtered out
+        boost::json::object baseline_results;
+        if (std::filesystem::exists(write_baseline_file))
+        {
+            baseline_results =
+                mavis::parseJSON(write_baseline_file).at("results").as_object();
+        }
+        for (const auto & kv : results)
+        {
+            baseline_results[kv.key()] = kv.value();
+        }
+
+        std::ofstream out(write_baseline_file);
+        writeJSON(out, boost::json::object{{"results", baseline_results}});
+        out << std::endl;
+        std::cout << "Baseline written to " << write_baseline_file << std::endl;
+    }
+
+    uint32_t num_regressions = 0;
+    if (!baseline_file.empty())
+    {
+        const boost::json::value baseline = mavis::parseJSON(baseline_file);
+        num_regressions =
+            compareToBaseline(results, baseline.at("results").as_object(), tolerance);
+    }
+
+    if (num_failures || num_regressions)
+    {
+        std::cout << num_failures << " failed configuration(s), " << num_regressions
+                  << " regression(s)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
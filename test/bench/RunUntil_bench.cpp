@@ -0,0 +1,55 @@
+#include "test/sim/WorkloadTester.hpp"
+
+#include <chrono>
+
+// Compares the MIPS of stepping Dhrystone one instruction at a time against runUntil()
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_INSTS = 2000000;
+
+static void reportMips(const std::string & name, const uint64_t num_insts,
+                       const std::chrono::steady_clock::time_point start,
+                       const std::chrono::steady_clock::time_point end)
+{
+    const double us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << "    " << name << ": " << std::dec << num_insts << " instructions, "
+              << (us ? (num_insts / us) : 0.0) << " MIPS" << std::endl;
+}
+
+void benchmarkRunUntil()
+{
+    std::cout << "Benchmarking step() against runUntil()" << std::endl;
+
+    uint64_t step_insts = 0;
+    {
+        PegasusWorkloadTester bench("rv64_dhry.elf");
+        pegasus::PegasusSim* sim = bench.getSim();
+        const auto start = std::chrono::steady_clock::now();
+        while ((step_insts < NUM_INSTS) && sim->step(CORE_ID, HART_ID))
+        {
+            ++step_insts;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        reportMips("step()", step_insts, start, end);
+    }
+
+    {
+        PegasusWorkloadTester bench("rv64_dhry.elf");
+        pegasus::PegasusSim* sim = bench.getSim();
+        const auto start = std::chrono::steady_clock::now();
+        const pegasus::PegasusSim::RunResult result =
+            sim->runUntil(CORE_ID, HART_ID, NUM_INSTS, 0);
+        const auto end = std::chrono::steady_clock::now();
+        reportMips("runUntil()", result.num_insts, start, end);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    benchmarkRunUntil();
+    return 0;
+}
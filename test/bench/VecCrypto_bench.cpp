@@ -0,0 +1,72 @@
+#include "core/VecCrypto.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Compares the speed of the host and portable vector crypto engines, one call per register group
+// of 16 element groups. test/vector/crypto checks that both engines produce the same results.
+
+static constexpr size_t NUM_EGS = 16;
+static constexpr size_t NUM_BYTES = NUM_EGS * 32;
+static constexpr uint32_t NUM_ITERS = 20000;
+
+template <typename CallType> double timeCall(CallType call)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t iter = 0; iter < NUM_ITERS; ++iter)
+    {
+        call();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+           / double(NUM_ITERS);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    const pegasus::VecCryptoEngine & portable = pegasus::vec_crypto::getPortableEngine();
+    const pegasus::VecCryptoEngine & host = pegasus::vec_crypto::getHostEngine();
+    std::cout << "Benchmarking the vector crypto engines (host AES: "
+              << pegasus::vec_crypto::hostHasAes()
+              << ", host SHA: " << pegasus::vec_crypto::hostHasSha() << ")" << std::endl;
+
+    std::mt19937 rng(0xc0ffee);
+    std::vector<uint8_t> vd(NUM_BYTES), vs2(NUM_BYTES), vs1(NUM_BYTES);
+    for (auto* bytes : {&vd, &vs2, &vs1})
+    {
+        for (uint8_t & byte : *bytes)
+        {
+            byte = rng();
+        }
+    }
+
+    auto report = [](const char* name, double portable_ns, double host_ns)
+    {
+        std::cout << "    " << name << ": portable " << portable_ns << "ns, host " << host_ns
+                  << "ns, speedup " << (host_ns ? (portable_ns / host_ns) : 0.0) << "x"
+                  << std::endl;
+    };
+
+    // AES and SM4 round keys from vs2, one per element group
+    auto aes = [&](pegasus::VecCryptoEngine::AesRoundFunc func)
+    { return timeCall([&]() { func(vd.data(), vs2.data(), NUM_EGS, 16); }); };
+    report("vaesem.vv", aes(portable.aesem), aes(host.aesem));
+    report("vaesdm.vv", aes(portable.aesdm), aes(host.aesdm));
+    report("vsm4r.vv", aes(portable.sm4r), aes(host.sm4r));
+
+    // SHA-256 on EGW=128, SM3 on EGW=256
+    auto three = [&](pegasus::VecCryptoEngine::ThreeOpFunc func, size_t num_egs)
+    { return timeCall([&]() { func(vd.data(), vs2.data(), vs1.data(), num_egs); }); };
+    report("vsha2ch.vv (256)", three(portable.sha256ch, NUM_EGS),
+           three(host.sha256ch, NUM_EGS));
+    report("vsha2ms.vv (256)", three(portable.sha256ms, NUM_EGS),
+           three(host.sha256ms, NUM_EGS));
+    report("vsm3me.vv", three(portable.sm3me, NUM_EGS / 2), three(host.sm3me, NUM_EGS / 2));
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "sim/PegasusSim.hpp"
+#include "core/PegasusState.hpp"
+#include "core/Fetch.hpp"
+#include "core/BlockCache.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+class PegasusBlockCacheTester
+{
+  public:
+    PegasusBlockCacheTester()
+    {
+        // Create the simulator
+        pegasus_sim_.reset(new pegasus::PegasusSim(&scheduler_));
+
+        sparta::app::SimulationConfiguration config;
+        pegasus_sim_->configure(0, nullptr, &config);
+        pegasus_sim_->buildTree();
+        pegasus_sim_->configureTree();
+        pegasus_sim_->finalizeTree();
+
+        state_ = pegasus_sim_->getPegasusCore()->getPegasusState();
+        block_cache_ = state_->getFetchUnit()->getBlockCache();
+        block_cache_->flush();
+
+        addi_ = state_->getMavis()->makeInst(ADDI_OPCODE, state_);
+        jal_ = state_->getMavis()->makeInst(JAL_OPCODE, state_);
+    }
+
+    void testRecordAndLookup()
+    {
+        std::cout << "Testing block recording" << std::endl;
+
+        // Straight-line code ends at the jump
+        block_cache_->record(0x1000, CONTEXT, addi_, false);
+        block_cache_->record(0x1004, CONTEXT, addi_, false);
+        block_cache_->record(0x1008, CONTEXT, addi_, false);
+        block_cache_->record(0x100c, CONTEXT, jal_, true);
+        block_cache_->record(0x1010, CONTEXT, addi_, false);
+
+        const pegasus::BlockCache::Block* block = block_cache_->lookup(0x1000, CONTEXT);
+        EXPECT_TRUE(block != nullptr);
+        EXPECT_EQUAL(block->insts.size(), 4);
+        EXPECT_EQUAL(block->next_paddr, 0x1010);
+        EXPECT_TRUE(block->insts.back() == jal_);
+
+        block = block_cache_->lookup(0x1010, CONTEXT);
+        EXPECT_TRUE(block != nullptr);
+        EXPECT_EQUAL(block->insts.size(), 1);
+
+        // Blocks are only entered at their first instruction and in the same context
+        EXPECT_TRUE(block_cache_->lookup(0x1004, CONTEXT) == nullptr);
+        EXPECT_TRUE(block_cache_->lookup(0x1000, CONTEXT + 1) == nullptr);
+
+        block_cache_->flush();
+        EXPECT_TRUE(block_cache_->lookup(0x1000, CONTEXT) == nullptr);
+        EXPECT_FALSE(block_cache_->containsCode(0x1000));
+    }
+
+    void testBlockBoundaries()
+    {
+        std::cout << "Testing block boundaries" << std::endl;
+
+        // Blocks are limited to the maximum block length
+        const uint32_t max_block_insts = block_cache_->getMaxBlockInsts();
+        for (uint32_t idx = 0; idx < (max_block_insts + 1); ++idx)
+        {
+            block_cache_->record(0x2000 + (idx * 4), CONTEXT, addi_, false);
+        }
+        const pegasus::BlockCache::Block* block = block_cache_->lookup(0x2000, CONTEXT);
+        EXPECT_TRUE(block != nullptr);
+        EXPECT_EQUAL(block->insts.size(), max_block_insts);
+        EXPECT_TRUE(block_cache_->lookup(0x2000 + (max_block_insts * 4), CONTEXT) != nullptr);
+
+        // Blocks do not cross 4K pages
+        block_cache_->record(0x3ff8, CONTEXT, addi_, false);
+        block_cache_->record(0x3ffc, CONTEXT, addi_, false);
+        block_cache_->record(0x4000, CONTEXT, addi_, false);
+        block = block_cache_->lookup(0x3ff8, CONTEXT);
+        EXPECT_TRUE(block != nullptr);
+        EXPECT_EQUAL(block->insts.size(), 2);
+        EXPECT_TRUE(block_cache_->lookup(0x4000, CONTEXT) != nullptr);
+
+        block_cache_->flush();
+    }
+
+    void testInvalidation()
+    {
+        std::cout << "Testing block invalidation" << std::endl;
+
+        block_cache_->record(0x5000, CONTEXT, addi_, true);
+        block_cache_->record(0x6000, CONTEXT, addi_, true);
+        EXPECT_TRUE(block_cache_->containsCode(0x5800));
+        EXPECT_FALSE(block_cache_->containsCode(0x7000));
+
+        // Store to a data page
+        block_cache_->invalidateStore(0x7000, 8);
+        EXPECT_TRUE(block_cache_->lookup(0x5000, CONTEXT) != nullptr);
+
+        // Store to a code page only invalidates blocks on that page
+        block_cache_->invalidateStore(0x5ff8, 8);
+        EXPECT_TRUE(block_cache_->lookup(0x5000, CONTEXT) == nullptr);
+        EXPECT_TRUE(block_cache_->lookup(0x6000, CONTEXT) != nullptr);
+
+        // Misaligned store crossing into a code page
+        block_cache_->invalidateStore(0x5ffc, 8);
+        EXPECT_TRUE(block_cache_->lookup(0x6000, CONTEXT) == nullptr);
+
+        // Stores through PegasusState also invalidate blocks
+        block_cache_->record(0x21000, CONTEXT, addi_, true);
+        EXPECT_TRUE(state_->writeMemory<uint32_t>(0x21000, ADDI_OPCODE));
+        EXPECT_TRUE(block_cache_->lookup(0x21000, CONTEXT) == nullptr);
+
+        block_cache_->releaseRetiredBlocks();
+    }
+
+  private:
+    sparta::Scheduler scheduler_;
+    std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
+
+    pegasus::PegasusState* state_ = nullptr;
+    pegasus::BlockCache* block_cache_ = nullptr;
+
+    // addi x1, x1, 1
+    static constexpr pegasus::Opcode ADDI_OPCODE = 0x00108093;
+    // jal x0, 0
+    static constexpr pegasus::Opcode JAL_OPCODE = 0x0000006f;
+    static constexpr uint64_t CONTEXT = 0x40404040;
+
+    pegasus::PegasusInstPtr addi_;
+    pegasus::PegasusInstPtr jal_;
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    PegasusBlockCacheTester tester;
+
+    tester.testRecordAndLookup();
+    tester.testBlockBoundaries();
+    tester.testInvalidation();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
@@ -0,0 +1,296 @@
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusSimParameters.hpp"
+#include "core/PegasusCore.hpp"
+#include "core/PegasusState.hpp"
+#include "include/PegasusTypes.hpp"
+#include "system/Clint.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <filesystem>
+
+// Every hart boots nop.elf so that it is queued like any other workload. The tests that run the
+// simulator move the PCs to programs written to memory by the test.
+class PegasusClintTester
+{
+  public:
+    PegasusClintTester()
+    {
+        const std::string workload =
+            std::filesystem::canonical(std::filesystem::absolute("workloads/nop.elf")).string();
+        pegasus::PegasusSimParameters::WorkloadsAndArgs workloads_and_args(NUM_HARTS,
+                                                                           {workload});
+
+        sparta::app::SimulationConfiguration config;
+        config.processParameter(
+            "top.extension.sim.workloads",
+            pegasus::PegasusSimParameters::convertVectorToStringParam(workloads_and_args));
+        config.processParameter("top.system.params.enable_clint", "true");
+        config.processParameter("top.core0.params.wfi_timeout", std::to_string(WFI_TIMEOUT_NEVER));
+        config.processParameter("top.core0.params.supported_trap_modes", "[0, 1]");
+        config.processParameter("top.core0.params.num_harts", std::to_string(NUM_HARTS));
+        for (uint32_t hart_idx = 0; hart_idx < NUM_HARTS; ++hart_idx)
+        {
+            config.processParameter("top.core0.hart" + std::to_string(hart_idx)
+                                        + ".params.hart_id",
+                                    std::to_string(hart_idx));
+        }
+
+        // Create the simulator
+        pegasus_sim_.reset(new pegasus::PegasusSim(&scheduler_));
+        pegasus_sim_->configure(0, nullptr, &config);
+        pegasus_sim_->buildTree();
+        pegasus_sim_->configureTree();
+        pegasus_sim_->finalizeTree();
+
+        core_ = pegasus_sim_->getPegasusCore();
+        state_ = core_->getPegasusState(0);
+    }
+
+    // mtime follows the cycle count of the accessing hart and can be written
+    void testMtime()
+    {
+        std::cout << "Testing mtime" << std::endl;
+
+        const pegasus::Addr mtime_addr = CLINT_BASE + pegasus::Clint::MTIME_OFFSET;
+        state_->getSimState()->cycles = 1000;
+        EXPECT_EQUAL(*state_->readMemory<uint64_t>(mtime_addr), 1000);
+        state_->getSimState()->cycles = 1500;
+        EXPECT_EQUAL(*state_->readMemory<uint64_t>(mtime_addr), 1500);
+
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(mtime_addr, 10000));
+        EXPECT_EQUAL(*state_->readMemory<uint64_t>(mtime_addr), 10000);
+        state_->getSimState()->cycles = 1600;
+        EXPECT_EQUAL(*state_->readMemory<uint64_t>(mtime_addr), 10100);
+
+        // RV32 software reads the halves separately
+        EXPECT_EQUAL(*state_->readMemory<uint32_t>(mtime_addr), 10100);
+        EXPECT_EQUAL(*state_->readMemory<uint32_t>(mtime_addr + 4), 0);
+    }
+
+    // Writing msip sets MIP.MSIP of its hart only
+    void testMsip()
+    {
+        std::cout << "Testing msip" << std::endl;
+
+        pegasus::PegasusState* state1 = core_->getPegasusState(1);
+        const pegasus::Addr msip1_addr = CLINT_BASE + pegasus::Clint::MSIP_OFFSET + 4;
+        EXPECT_TRUE(state_->writeMemory<uint32_t>(msip1_addr, 1));
+        EXPECT_EQUAL(*state_->readMemory<uint32_t>(msip1_addr), 1);
+        EXPECT_EQUAL(getMip_(state1) & MSIP, MSIP);
+        EXPECT_EQUAL(getMip_(state_) & MSIP, 0);
+        EXPECT_TRUE(state1->isInterruptCheckRequested());
+
+        // Interrupt is taken once it is enabled
+        EXPECT_FALSE(state1->checkInterrupts().isValid());
+        pegasus::POKE_CSR_REG<pegasus::RV64>(state1, pegasus::MIE, MSIP);
+        pegasus::POKE_CSR_REG<pegasus::RV64>(
+            state1, pegasus::MSTATUS,
+            pegasus::PEEK_CSR_REG<pegasus::RV64>(state1, pegasus::MSTATUS) | MSTATUS_MIE);
+        const auto cause = state1->checkInterrupts();
+        EXPECT_TRUE(cause.isValid());
+        EXPECT_TRUE(cause.getValue() == pegasus::InterruptCause::MACHINE_SOFTWARE);
+
+        EXPECT_TRUE(state_->writeMemory<uint32_t>(msip1_addr, 0));
+        EXPECT_EQUAL(getMip_(state1) & MSIP, 0);
+        EXPECT_FALSE(state1->checkInterrupts().isValid());
+    }
+
+    // MIP.MTIP is pending while mtime >= mtimecmp
+    void testMtimecmp()
+    {
+        std::cout << "Testing mtimecmp" << std::endl;
+
+        const pegasus::Addr mtime_addr = CLINT_BASE + pegasus::Clint::MTIME_OFFSET;
+        const pegasus::Addr mtimecmp_addr = CLINT_BASE + pegasus::Clint::MTIMECMP_OFFSET;
+        EXPECT_EQUAL(*state_->readMemory<uint64_t>(mtimecmp_addr),
+                     std::numeric_limits<uint64_t>::max());
+        EXPECT_EQUAL(getMip_(state_) & MTIP, 0);
+
+        const uint64_t mtime = *state_->readMemory<uint64_t>(mtime_addr);
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(mtimecmp_addr, mtime + 100));
+        EXPECT_EQUAL(getMip_(state_) & MTIP, 0);
+
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(mtimecmp_addr, mtime));
+        EXPECT_EQUAL(getMip_(state_) & MTIP, MTIP);
+
+        // Writing mtime back clears the interrupt
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(mtime_addr, mtime - 1));
+        EXPECT_EQUAL(getMip_(state_) & MTIP, 0);
+
+        // mtimecmp of hart1 does not affect hart0
+        pegasus::PegasusState* state1 = core_->getPegasusState(1);
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(mtimecmp_addr + 8, 0));
+        EXPECT_EQUAL(getMip_(state1) & MTIP, MTIP);
+        EXPECT_EQUAL(getMip_(state_) & MTIP, 0);
+
+        // Accesses crossing a register fail
+        EXPECT_FALSE(state_->writeMemory<uint64_t>(mtimecmp_addr + 4, 0));
+    }
+
+    // hart0 sleeps on WFI until the timer event fires at mtimecmp. The timer interrupt is
+    // enabled in MIE but not in MSTATUS, so hart0 wakes up without taking a trap. hart1 sleeps
+    // for the whole run.
+    void testTimerWakeup()
+    {
+        std::cout << "Testing WFI wakeup by the timer" << std::endl;
+
+        pegasus::PegasusState* state1 = core_->getPegasusState(1);
+        pegasus::WRITE_INT_REG<pegasus::RV64>(state_, 4, CLINT_BASE + pegasus::Clint::MTIME_OFFSET);
+        loadProgram_(state_, MAIN_PC, {WFI_OPCODE, LD_X3_X4_OPCODE, ADDI_X1_OPCODE,
+                                       JAL_BACK_4_OPCODE});
+        loadProgram_(state1, MAIN_PC + 0x100, {WFI_OPCODE, JAL_BACK_4_OPCODE});
+        pegasus::POKE_CSR_REG<pegasus::RV64>(state_, pegasus::MIE, MTIP);
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(
+            CLINT_BASE + pegasus::Clint::MTIMECMP_OFFSET, MTIMECMP));
+        EXPECT_EQUAL(getMip_(state_) & MTIP, 0);
+        pegasus_sim_->run(RUN_CYCLES);
+
+        EXPECT_EQUAL(getMip_(state_) & MTIP, MTIP);
+        EXPECT_EQUAL(pegasus::PEEK_CSR_REG<pegasus::RV64>(state_, pegasus::MCAUSE), 0);
+
+        // The first instruction after WFI reads mtime at the deadline
+        const uint64_t wakeup_mtime = pegasus::READ_INT_REG<pegasus::RV64>(state_, 3);
+        EXPECT_TRUE((wakeup_mtime == MTIMECMP) || (wakeup_mtime == (MTIMECMP + 1)));
+
+        const auto & stats = core_->getHartSchedStats(0);
+        EXPECT_TRUE(stats.sleep_cycles != 0);
+        EXPECT_TRUE(stats.sleep_cycles <= MTIMECMP);
+        EXPECT_TRUE(pegasus::READ_INT_REG<pegasus::RV64>(state_, 1) != 0);
+        EXPECT_TRUE(state_->getSimState()->sim_pause_reason == pegasus::SimPauseReason::INVALID);
+
+        // Only hart0 has a timer interrupt
+        EXPECT_EQUAL(getMip_(state1) & MTIP, 0);
+        EXPECT_TRUE(state1->getSimState()->sim_pause_reason == pegasus::SimPauseReason::WFI);
+    }
+
+    // With interrupts enabled, the timer and software interrupts trap to their entry of a
+    // vectored mtvec. Every entry of the vector table loops on itself.
+    void testVectoredTrap(const uint64_t interrupt)
+    {
+        std::cout << "Testing vectored trap of " << ((interrupt == MTIP) ? "MTIP" : "MSIP")
+                  << std::endl;
+
+        pegasus::PegasusState* state1 = core_->getPegasusState(1);
+        std::vector<pegasus::Opcode> vector_table(16, JAL_SELF_OPCODE);
+        loadProgram_(state_, TRAP_VECTOR_BASE, vector_table);
+        loadProgram_(state_, MAIN_PC, {ADDI_X1_OPCODE, JAL_BACK_4_OPCODE});
+        loadProgram_(state1, MAIN_PC + 0x100, {WFI_OPCODE, JAL_BACK_4_OPCODE});
+        pegasus::POKE_CSR_REG<pegasus::RV64>(state_, pegasus::MTVEC, TRAP_VECTOR_BASE | 0x1);
+        pegasus::POKE_CSR_REG<pegasus::RV64>(state_, pegasus::MIE, interrupt);
+        pegasus::POKE_CSR_REG<pegasus::RV64>(
+            state_, pegasus::MSTATUS,
+            pegasus::PEEK_CSR_REG<pegasus::RV64>(state_, pegasus::MSTATUS) | MSTATUS_MIE);
+        if (interrupt == MTIP)
+        {
+            EXPECT_TRUE(state_->writeMemory<uint64_t>(
+                CLINT_BASE + pegasus::Clint::MTIMECMP_OFFSET, MTIMECMP));
+        }
+        else
+        {
+            EXPECT_TRUE(
+                state_->writeMemory<uint32_t>(CLINT_BASE + pegasus::Clint::MSIP_OFFSET, 1));
+        }
+        pegasus_sim_->run(RUN_CYCLES);
+
+        const uint64_t excp_code = (interrupt == MTIP) ? pegasus::Clint::MTIP_BIT
+                                                       : pegasus::Clint::MSIP_BIT;
+        EXPECT_EQUAL(pegasus::PEEK_CSR_REG<pegasus::RV64>(state_, pegasus::MCAUSE),
+                     INTERRUPT_BIT | excp_code);
+        EXPECT_EQUAL(state_->getPc(), TRAP_VECTOR_BASE + (4 * excp_code));
+
+        // The interrupted instruction is in the main loop, and interrupts are disabled in the
+        // handler
+        const uint64_t mepc = pegasus::PEEK_CSR_REG<pegasus::RV64>(state_, pegasus::MEPC);
+        EXPECT_TRUE((mepc == MAIN_PC) || (mepc == (MAIN_PC + 4)));
+        const uint64_t mstatus = pegasus::PEEK_CSR_REG<pegasus::RV64>(state_, pegasus::MSTATUS);
+        EXPECT_EQUAL(mstatus & MSTATUS_MIE, 0);
+        EXPECT_EQUAL(mstatus & MSTATUS_MPIE, MSTATUS_MPIE);
+        EXPECT_EQUAL(getMip_(state_) & interrupt, interrupt);
+
+        // The main loop ran until mtimecmp, one increment every two cycles
+        if (interrupt == MTIP)
+        {
+            EXPECT_TRUE(pegasus::READ_INT_REG<pegasus::RV64>(state_, 1) >= (MTIMECMP / 2) - 1);
+        }
+    }
+
+    static constexpr uint64_t MSIP = 1 << 3;
+    static constexpr uint64_t MTIP = 1 << 7;
+
+  private:
+    static constexpr uint32_t NUM_HARTS = 2;
+    static constexpr pegasus::Addr CLINT_BASE = 0x2000000;
+    static constexpr uint64_t MSTATUS_MIE = 1 << 3;
+    static constexpr uint64_t MSTATUS_MPIE = 1 << 7;
+    static constexpr uint64_t INTERRUPT_BIT = 1ull << 63;
+    static constexpr uint64_t MTIMECMP = 3000;
+    static constexpr uint64_t RUN_CYCLES = 20000;
+
+    // WFI timeout longer than the tests run
+    static constexpr uint64_t WFI_TIMEOUT_NEVER = 1000000;
+
+    static constexpr pegasus::Addr MAIN_PC = 0x1000;
+    static constexpr pegasus::Addr TRAP_VECTOR_BASE = 0x4000;
+
+    // addi x1, x1, 1
+    static constexpr pegasus::Opcode ADDI_X1_OPCODE = 0x00108093;
+    // ld x3, 0(x4)
+    static constexpr pegasus::Opcode LD_X3_X4_OPCODE = 0x00023183;
+    // wfi
+    static constexpr pegasus::Opcode WFI_OPCODE = 0x10500073;
+    // jal x0, 0
+    static constexpr pegasus::Opcode JAL_SELF_OPCODE = 0x0000006f;
+    // jal x0, -4
+    static constexpr pegasus::Opcode JAL_BACK_4_OPCODE = 0xffdff06f;
+
+    static void loadProgram_(pegasus::PegasusState* state, const pegasus::Addr pc,
+                             const std::vector<pegasus::Opcode> & program)
+    {
+        for (size_t idx = 0; idx < program.size(); ++idx)
+        {
+            EXPECT_TRUE(
+                state->writeMemory<uint32_t>(pc + (idx * sizeof(pegasus::Opcode)), program[idx]));
+        }
+        state->setPc(pc);
+    }
+
+    static uint64_t getMip_(pegasus::PegasusState* state)
+    {
+        return pegasus::PEEK_CSR_REG<pegasus::RV64>(state, pegasus::MIP);
+    }
+
+    sparta::Scheduler scheduler_;
+    std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
+
+    pegasus::PegasusCore* core_ = nullptr;
+    pegasus::PegasusState* state_ = nullptr;
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    {
+        PegasusClintTester tester;
+        tester.testMtime();
+        tester.testMsip();
+        tester.testMtimecmp();
+    }
+    {
+        PegasusClintTester tester;
+        tester.testTimerWakeup();
+    }
+    {
+        PegasusClintTester tester;
+        tester.testVectoredTrap(PegasusClintTester::MTIP);
+    }
+    {
+        PegasusClintTester tester;
+        tester.testVectoredTrap(PegasusClintTester::MSIP);
+    }
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
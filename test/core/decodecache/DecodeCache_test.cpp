@@ -0,0 +1,169 @@
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusAllocators.hpp"
+#include "core/PegasusState.hpp"
+#include "core/Fetch.hpp"
+#include "core/DecodeCache.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+class PegasusDecodeCacheTester
+{
+  public:
+    PegasusDecodeCacheTester()
+    {
+        // Create the simulator
+        pegasus_sim_.reset(new pegasus::PegasusSim(&scheduler_));
+
+        sparta::app::SimulationConfiguration config;
+        pegasus_sim_->configure(0, nullptr, &config);
+        pegasus_sim_->buildTree();
+        pegasus_sim_->configureTree();
+        pegasus_sim_->finalizeTree();
+
+        state_ = pegasus_sim_->getPegasusCore()->getPegasusState();
+        decode_cache_ = state_->getFetchUnit()->getDecodeCache();
+        decode_cache_->flush();
+        allocators_ = pegasus::PegasusAllocators::getAllocators(state_->getContainer());
+    }
+
+    void testLookupAndInsert()
+    {
+        std::cout << "Testing decode cache lookup" << std::endl;
+
+        EXPECT_TRUE(decode_cache_->lookup(ADDI_OPCODE) == nullptr);
+
+        const pegasus::PegasusInstPtr addi = state_->getMavis()->makeInst(ADDI_OPCODE, state_);
+        decode_cache_->insert(ADDI_OPCODE, addi);
+
+        // The same opcode always returns the same decoded instruction
+        const pegasus::PegasusInstPtr* cached_inst = decode_cache_->lookup(ADDI_OPCODE);
+        EXPECT_TRUE(cached_inst != nullptr);
+        EXPECT_TRUE(*cached_inst == addi);
+        EXPECT_TRUE(decode_cache_->lookup(ADDI_OPCODE + (1 << 20)) == nullptr);
+
+        decode_cache_->flush();
+        EXPECT_TRUE(decode_cache_->lookup(ADDI_OPCODE) == nullptr);
+    }
+
+    void testSharedInstState()
+    {
+        std::cout << "Testing per-hart instruction state" << std::endl;
+
+        const pegasus::PegasusInstPtr addi = state_->getMavis()->makeInst(ADDI_OPCODE, state_);
+        const pegasus::PegasusInstPtr jal = state_->getMavis()->makeInst(JAL_OPCODE, state_);
+
+        // The uid belongs to the current execution, not to the decoded instruction
+        state_->setCurrentInst(addi);
+        const uint64_t uid = addi->getUid();
+        state_->getSimState()->reset();
+        state_->setCurrentInst(addi);
+        EXPECT_EQUAL(addi->getUid(), uid + 1);
+        EXPECT_EQUAL(jal->getUid(), addi->getUid());
+        state_->getSimState()->reset();
+
+        // Instructions that have not been executed print their unlinked ActionGroup
+        EXPECT_TRUE(addi->getActionGroup() == addi->getExtractorInfo()->getActionGroup());
+    }
+
+    void testHighWaterMark()
+    {
+        std::cout << "Testing instruction allocator high-water mark" << std::endl;
+
+        const pegasus::PegasusInstPtr addi = state_->getMavis()->makeInst(ADDI_OPCODE, state_);
+        decode_cache_->insert(ADDI_OPCODE, addi);
+
+        // Decoding from the cache does not allocate
+        const uint64_t high_water_mark = allocators_->getInstHighWaterMark();
+        for (uint32_t idx = 0; idx < 10000; ++idx)
+        {
+            pegasus::PegasusInstPtr inst = *decode_cache_->lookup(ADDI_OPCODE);
+            state_->setCurrentInst(inst);
+            state_->getSimState()->reset();
+        }
+        EXPECT_EQUAL(allocators_->getInstHighWaterMark(), high_water_mark);
+
+        decode_cache_->flush();
+    }
+
+    void testRepeatedDecodes()
+    {
+        std::cout << "Testing allocations across repeated decodes" << std::endl;
+
+        // A loop of a few instructions, each one at its own PC
+        const std::vector<pegasus::Opcode> loop{ADDI_OPCODE, ADDI_X2_OPCODE, XOR_OPCODE,
+                                                JAL_LOOP_OPCODE};
+        for (size_t idx = 0; idx < loop.size(); ++idx)
+        {
+            state_->writeMemory<uint32_t>(LOOP_PC + (idx * sizeof(pegasus::Opcode)), loop[idx]);
+        }
+        state_->setPc(LOOP_PC);
+
+        // The first iteration decodes every PC...
+        runLoopIteration_();
+        const uint64_t inst_high_water_mark = allocators_->getInstHighWaterMark();
+        const uint64_t extractor_high_water_mark = allocators_->getExtractorHighWaterMark();
+        const uint64_t num_misses = decode_cache_->getNumMisses();
+
+        // ...and decoding the same PCs again does not allocate
+        for (uint32_t iter = 0; iter < 1000; ++iter)
+        {
+            runLoopIteration_();
+        }
+        EXPECT_EQUAL(allocators_->getInstHighWaterMark(), inst_high_water_mark);
+        EXPECT_EQUAL(allocators_->getExtractorHighWaterMark(), extractor_high_water_mark);
+        EXPECT_EQUAL(decode_cache_->getNumMisses(), num_misses);
+
+        decode_cache_->flush();
+    }
+
+  private:
+    // Fetch and execute instructions until the loop jumps back to its start
+    void runLoopIteration_()
+    {
+        do
+        {
+            pegasus::ActionGroup* next_action_group = state_->getFetchUnit()->getActionGroup();
+            do
+            {
+                next_action_group = next_action_group->execute(state_);
+            } while (next_action_group
+                     && (next_action_group->hasTag(pegasus::ActionTags::FETCH_TAG) == false));
+        } while (state_->getPc() != LOOP_PC);
+    }
+
+    sparta::Scheduler scheduler_;
+    std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
+
+    pegasus::PegasusState* state_ = nullptr;
+    pegasus::DecodeCache* decode_cache_ = nullptr;
+    pegasus::PegasusAllocators* allocators_ = nullptr;
+
+    // addi x1, x1, 1
+    static constexpr pegasus::Opcode ADDI_OPCODE = 0x00108093;
+    // jal x0, 0
+    static constexpr pegasus::Opcode JAL_OPCODE = 0x0000006f;
+    // addi x2, x2, 2
+    static constexpr pegasus::Opcode ADDI_X2_OPCODE = 0x00210113;
+    // xor x3, x1, x2
+    static constexpr pegasus::Opcode XOR_OPCODE = 0x0020c1b3;
+    // jal x0, -12
+    static constexpr pegasus::Opcode JAL_LOOP_OPCODE = 0xff5ff06f;
+
+    static constexpr pegasus::Addr LOOP_PC = 0x1000;
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    PegasusDecodeCacheTester tester;
+
+    tester.testLookupAndInsert();
+    tester.testSharedInstState();
+    tester.testHighWaterMark();
+    tester.testRepeatedDecodes();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
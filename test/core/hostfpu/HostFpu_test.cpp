@@ -0,0 +1,343 @@
+#include "core/inst_handlers/hostfpu_helpers.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+
+namespace hostfpu = pegasus::hostfpu;
+
+// Compares the host FPU fast path against SoftFloat bit for bit (result and exception flags) on
+// random and special operands in every rounding mode. Cases the host path declines are counted
+// but not compared since the handlers use SoftFloat for them.
+class HostFpuTester
+{
+  public:
+    HostFpuTester() : rng_(0x5eed) {}
+
+    void testArithmetic()
+    {
+        std::cout << "Testing host FPU arithmetic" << std::endl;
+
+        testBinary<float32_t>("f32_add", f32_add, hostfpu::tryAdd<float32_t>);
+        testBinary<float32_t>("f32_sub", f32_sub, hostfpu::trySub<float32_t>);
+        testBinary<float32_t>("f32_mul", f32_mul, hostfpu::tryMul<float32_t>);
+        testBinary<float32_t>("f32_div", f32_div, hostfpu::tryDiv<float32_t>);
+        testBinary<float64_t>("f64_add", f64_add, hostfpu::tryAdd<float64_t>);
+        testBinary<float64_t>("f64_sub", f64_sub, hostfpu::trySub<float64_t>);
+        testBinary<float64_t>("f64_mul", f64_mul, hostfpu::tryMul<float64_t>);
+        testBinary<float64_t>("f64_div", f64_div, hostfpu::tryDiv<float64_t>);
+
+        testUnary<float32_t, float32_t>("f32_sqrt", f32_sqrt, hostfpu::trySqrt<float32_t>,
+                                        &HostFpuTester::randomFloat<float32_t>);
+        testUnary<float64_t, float64_t>("f64_sqrt", f64_sqrt, hostfpu::trySqrt<float64_t>,
+                                        &HostFpuTester::randomFloat<float64_t>);
+
+        testMulAdd<float32_t>("f32_mulAdd", f32_mulAdd);
+        testMulAdd<float64_t>("f64_mulAdd", f64_mulAdd);
+    }
+
+    void testConversions()
+    {
+        std::cout << "Testing host FPU conversions" << std::endl;
+
+        testUnary<float32_t, float64_t>("f64_to_f32", f64_to_f32,
+                                        hostfpu::tryConvert<float32_t, float64_t>,
+                                        &HostFpuTester::randomFloat<float64_t>);
+        testUnary<float64_t, float32_t>("f32_to_f64", f32_to_f64,
+                                        hostfpu::tryConvert<float64_t, float32_t>,
+                                        &HostFpuTester::randomFloat<float32_t>);
+
+        testUnary<float32_t, int32_t>("i32_to_f32", i32_to_f32,
+                                      hostfpu::tryConvert<float32_t, int32_t>,
+                                      &HostFpuTester::randomInt<int32_t>);
+        testUnary<float32_t, uint32_t>("ui32_to_f32", ui32_to_f32,
+                                       hostfpu::tryConvert<float32_t, uint32_t>,
+                                       &HostFpuTester::randomInt<uint32_t>);
+        testUnary<float32_t, int64_t>("i64_to_f32", i64_to_f32,
+                                      hostfpu::tryConvert<float32_t, int64_t>,
+                                      &HostFpuTester::randomInt<int64_t>);
+        testUnary<float32_t, uint64_t>("ui64_to_f32", ui64_to_f32,
+                                       hostfpu::tryConvert<float32_t, uint64_t>,
+                                       &HostFpuTester::randomInt<uint64_t>);
+        testUnary<float64_t, int32_t>("i32_to_f64", i32_to_f64,
+                                      hostfpu::tryConvert<float64_t, int32_t>,
+                                      &HostFpuTester::randomInt<int32_t>);
+        testUnary<float64_t, uint32_t>("ui32_to_f64", ui32_to_f64,
+                                       hostfpu::tryConvert<float64_t, uint32_t>,
+                                       &HostFpuTester::randomInt<uint32_t>);
+        testUnary<float64_t, int64_t>("i64_to_f64", i64_to_f64,
+                                      hostfpu::tryConvert<float64_t, int64_t>,
+                                      &HostFpuTester::randomInt<int64_t>);
+        testUnary<float64_t, uint64_t>("ui64_to_f64", ui64_to_f64,
+                                       hostfpu::tryConvert<float64_t, uint64_t>,
+                                       &HostFpuTester::randomInt<uint64_t>);
+
+        testToInt<int32_t, float32_t>("f32_to_i32", f32_to_i32);
+        testToInt<uint32_t, float32_t>("f32_to_ui32", f32_to_ui32);
+        testToInt<int64_t, float32_t>("f32_to_i64", f32_to_i64);
+        testToInt<uint64_t, float32_t>("f32_to_ui64", f32_to_ui64);
+        testToInt<int32_t, float64_t>("f64_to_i32", f64_to_i32);
+        testToInt<uint32_t, float64_t>("f64_to_ui32", f64_to_ui32);
+        testToInt<int64_t, float64_t>("f64_to_i64", f64_to_i64);
+        testToInt<uint64_t, float64_t>("f64_to_ui64", f64_to_ui64);
+    }
+
+    void testFallbacks()
+    {
+        std::cout << "Testing host FPU fallbacks" << std::endl;
+
+        const float32_t one{0x3f800000};
+        const float32_t snan{0x7f800001};
+        float32_t result{0};
+
+        // RMM has no host equivalent
+        softfloat_roundingMode = softfloat_round_near_maxMag;
+        EXPECT_TRUE(!hostfpu::tryAdd(one, one, result));
+
+        // NaN operands are left to SoftFloat
+        softfloat_roundingMode = softfloat_round_near_even;
+        softfloat_exceptionFlags = 0;
+        EXPECT_TRUE(!hostfpu::tryAdd(one, snan, result));
+        EXPECT_EQUAL(softfloat_exceptionFlags, 0);
+
+        // Inexact results in the subnormal range are left to SoftFloat
+        const float32_t min_normal{0x00800000};
+        const float32_t third{0x3eaaaaab};
+        EXPECT_TRUE(!hostfpu::tryMul(min_normal, third, result));
+        EXPECT_EQUAL(softfloat_exceptionFlags, 0);
+
+#if PEGASUS_HOST_FPU
+        // Flags accumulate like they do with SoftFloat
+        softfloat_exceptionFlags = softfloat_flag_invalid;
+        EXPECT_TRUE(hostfpu::tryDiv(one, float32_t{0x40400000}, result));
+        EXPECT_EQUAL(result.v, 0x3eaaaaab);
+        EXPECT_EQUAL(softfloat_exceptionFlags, softfloat_flag_invalid | softfloat_flag_inexact);
+
+        // The NaN of an invalid operation is the canonical NaN
+        softfloat_exceptionFlags = 0;
+        const float64_t inf{0x7ff0000000000000};
+        float64_t dp_result{0};
+        EXPECT_TRUE(hostfpu::trySub(inf, inf, dp_result));
+        EXPECT_EQUAL(dp_result.v, 0x7ff8000000000000);
+        EXPECT_EQUAL(softfloat_exceptionFlags, softfloat_flag_invalid);
+#endif
+    }
+
+  private:
+    static constexpr uint32_t NUM_SAMPLES = 20000;
+    static constexpr uint_fast8_t ROUNDING_MODES[] = {
+        softfloat_round_near_even, softfloat_round_minMag, softfloat_round_min,
+        softfloat_round_max, softfloat_round_near_maxMag};
+
+    std::mt19937_64 rng_;
+
+    template <typename F> F randomFloat()
+    {
+        using U = typename hostfpu::HostFloat<F>::bits;
+        constexpr pegasus::FConstants<U> cons = pegasus::getConst<U>();
+        constexpr U SIGN = (U)1 << cons.SGN_BIT;
+        constexpr U EXP_MAX = cons.EXP_MASK >> cons.EXP_LSB;
+        static const U specials[] = {
+            0,                             // zero
+            1,                             // smallest subnormal
+            cons.SIG_MASK,                 // largest subnormal
+            (U)1 << cons.EXP_LSB,          // smallest normal
+            cons.EXP_MASK - 1,             // largest normal
+            cons.EXP_MASK,                 // infinity
+            cons.CAN_NAN,                  // quiet NaN
+            cons.EXP_MASK | 1,             // signaling NaN
+            (EXP_MAX / 2) << cons.EXP_LSB, // one
+        };
+
+        const U sign = (rng_() & 1) ? SIGN : 0;
+        const U sig = static_cast<U>(rng_()) & cons.SIG_MASK;
+        switch (rng_() % 8)
+        {
+            case 0:
+                return F{static_cast<U>(sign | specials[rng_() % std::size(specials)])};
+            case 1:
+                // Near the subnormal range
+                return F{static_cast<U>(sign | ((U)(rng_() % 4) << cons.EXP_LSB) | sig)};
+            case 2:
+                // Near overflow
+                return F{static_cast<U>(sign | ((EXP_MAX - 1 - (U)(rng_() % 4)) << cons.EXP_LSB)
+                                        | sig)};
+            case 3:
+                // Small integers, which make exact results and cancellation likely
+                return F{static_cast<U>(sign | (((EXP_MAX / 2) + (U)(rng_() % 8)) << cons.EXP_LSB)
+                                        | (sig & ~(cons.SIG_MASK >> 3)))};
+            default:
+                return F{static_cast<U>(rng_())};
+        }
+    }
+
+    template <typename I> I randomInt()
+    {
+        switch (rng_() % 4)
+        {
+            case 0:
+                return std::numeric_limits<I>::min() + static_cast<I>(rng_() % 4);
+            case 1:
+                return std::numeric_limits<I>::max() - static_cast<I>(rng_() % 4);
+            case 2:
+                return static_cast<I>(rng_() % 1024) - (std::is_signed_v<I> ? 512 : 0);
+            default:
+                return static_cast<I>(rng_() >> (rng_() % 64));
+        }
+    }
+
+    // Runs soft_op and host_op on the same operands and compares them when host_op accepts
+    template <typename R, typename SoftT, typename HostT>
+    void compare(const std::string & name, const uint_fast8_t rm, SoftT soft_op, HostT host_op,
+                 uint32_t & num_host)
+    {
+        softfloat_roundingMode = rm;
+        softfloat_exceptionFlags = 0;
+        const R expected = soft_op();
+        const uint_fast8_t expected_flags = softfloat_exceptionFlags;
+
+        softfloat_exceptionFlags = 0;
+        R actual;
+        if (host_op(actual))
+        {
+            ++num_host;
+            if ((bits(actual) != bits(expected)) || (softfloat_exceptionFlags != expected_flags))
+            {
+                std::cout << name << " rm=" << (uint32_t)rm << " soft=0x" << std::hex
+                          << bits(expected) << "/" << (uint32_t)expected_flags << " host=0x"
+                          << bits(actual) << "/" << (uint32_t)softfloat_exceptionFlags << std::dec
+                          << std::endl;
+                EXPECT_EQUAL(bits(actual), bits(expected));
+                EXPECT_EQUAL(softfloat_exceptionFlags, expected_flags);
+            }
+        }
+        else
+        {
+            EXPECT_EQUAL(softfloat_exceptionFlags, 0);
+        }
+    }
+
+    template <typename T> static uint64_t bits(const T & value)
+    {
+        if constexpr (std::is_integral_v<T>)
+        {
+            return static_cast<uint64_t>(value);
+        }
+        else
+        {
+            return value.v;
+        }
+    }
+
+    void checkCoverage(const std::string & name, const uint32_t num_host)
+    {
+        std::cout << "  " << name << ": " << num_host << " of "
+                  << NUM_SAMPLES * std::size(ROUNDING_MODES) << " on the host FPU" << std::endl;
+#if PEGASUS_HOST_FPU
+        EXPECT_TRUE(num_host > 0);
+#else
+        EXPECT_EQUAL(num_host, 0);
+#endif
+    }
+
+    template <typename F, typename SoftT, typename HostT>
+    void testBinary(const std::string & name, SoftT soft_func, HostT host_func)
+    {
+        uint32_t num_host = 0;
+        for (const uint_fast8_t rm : ROUNDING_MODES)
+        {
+            for (uint32_t i = 0; i < NUM_SAMPLES; ++i)
+            {
+                const F a = randomFloat<F>();
+                const F b = randomFloat<F>();
+                compare<F>(
+                    name, rm, [&]() { return soft_func(a, b); },
+                    [&](F & result) { return host_func(a, b, result); }, num_host);
+            }
+        }
+        checkCoverage(name, num_host);
+    }
+
+    template <typename F, typename T, typename SoftT, typename HostT>
+    void testUnary(const std::string & name, SoftT soft_func, HostT host_func,
+                   T (HostFpuTester::*random)())
+    {
+        uint32_t num_host = 0;
+        for (const uint_fast8_t rm : ROUNDING_MODES)
+        {
+            for (uint32_t i = 0; i < NUM_SAMPLES; ++i)
+            {
+                const T a = (this->*random)();
+                compare<F>(
+                    name, rm, [&]() { return soft_func(a); },
+                    [&](F & result) { return host_func(a, result); }, num_host);
+            }
+        }
+        checkCoverage(name, num_host);
+    }
+
+    template <typename F, typename SoftT> void testMulAdd(const std::string & name, SoftT soft_func)
+    {
+        uint32_t num_host = 0;
+        for (const uint_fast8_t rm : ROUNDING_MODES)
+        {
+            for (uint32_t i = 0; i < NUM_SAMPLES; ++i)
+            {
+                const F a = randomFloat<F>();
+                const F b = randomFloat<F>();
+                // Make cancellation against the product likely
+                const F c =
+                    (rng_() & 1) ? pegasus::fnegate(soft_func(a, b, F{0})) : randomFloat<F>();
+                softfloat_exceptionFlags = 0;
+                compare<F>(
+                    name, rm, [&]() { return soft_func(a, b, c); },
+                    [&](F & result) { return hostfpu::tryMulAdd(a, b, c, result); }, num_host);
+            }
+        }
+        checkCoverage(name, num_host);
+    }
+
+    template <typename I, typename F, typename SoftT>
+    void testToInt(const std::string & name, SoftT soft_func)
+    {
+        uint32_t num_host = 0;
+        for (const uint_fast8_t rm : ROUNDING_MODES)
+        {
+            for (uint32_t i = 0; i < NUM_SAMPLES; ++i)
+            {
+                F a = randomFloat<F>();
+                if (rng_() & 1)
+                {
+                    // Values around the integer range
+                    using H = typename hostfpu::HostFloat<F>::type;
+                    const H value = static_cast<H>(randomInt<I>()) + static_cast<H>(rng_() % 8)
+                                    / static_cast<H>(4) - static_cast<H>(1);
+                    std::memcpy(&a.v, &value, sizeof(value));
+                }
+                compare<I>(
+                    name, rm, [&]() { return static_cast<I>(soft_func(a, rm, true)); },
+                    [&](I & result) { return hostfpu::tryToInt(a, rm, result); }, num_host);
+            }
+        }
+        checkCoverage(name, num_host);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    HostFpuTester tester;
+
+    tester.testArithmetic();
+    tester.testConversions();
+    tester.testFallbacks();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
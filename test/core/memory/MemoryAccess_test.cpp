@@ -0,0 +1,153 @@
+#include "sim/PegasusSim.hpp"
+#include "core/PegasusState.hpp"
+#include "include/PegasusTypes.hpp"
+#include "include/PegasusUtils.hpp"
+#include "system/PegasusSystem.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+// Count heap allocations made while measuring
+static bool count_allocations = false;
+static uint64_t num_allocations = 0;
+
+void* operator new(size_t size)
+{
+    if (count_allocations)
+    {
+        ++num_allocations;
+    }
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+class PegasusMemoryAccessTester
+{
+  public:
+    PegasusMemoryAccessTester()
+    {
+        // Create the simulator
+        pegasus_sim_.reset(new pegasus::PegasusSim(&scheduler_));
+
+        sparta::app::SimulationConfiguration config;
+        pegasus_sim_->configure(0, nullptr, &config);
+        pegasus_sim_->buildTree();
+        pegasus_sim_->configureTree();
+        pegasus_sim_->finalizeTree();
+
+        state_ = pegasus_sim_->getPegasusCore()->getPegasusState();
+    }
+
+    template <typename MemoryType> void testReadWrite()
+    {
+        std::cout << "Testing " << sizeof(MemoryType) << "B memory accesses" << std::endl;
+
+        const pegasus::Addr paddr = 0x20000;
+        const MemoryType value = static_cast<MemoryType>(0x0123456789abcdef);
+        EXPECT_TRUE(state_->writeMemory<MemoryType>(paddr, value));
+
+        const std::optional<MemoryType> read_val = state_->readMemory<MemoryType>(paddr);
+        EXPECT_TRUE(read_val.has_value());
+        EXPECT_EQUAL(*read_val, value);
+
+        // Legacy byte vector API must agree with the typed API
+        std::vector<uint8_t> buffer;
+        EXPECT_TRUE(state_->readMemory<MemoryType>(paddr, buffer));
+        EXPECT_EQUAL(pegasus::convertFromByteVector<MemoryType>(buffer), value);
+    }
+
+    // Direct memory accesses must be coherent with the memory map
+    void testDirectMemoryAccess()
+    {
+        std::cout << "Testing direct memory accesses" << std::endl;
+
+        auto* memory_map = pegasus_sim_->getPegasusCore()->getSystem()->getSystemMemory();
+        EXPECT_TRUE(pegasus_sim_->getPegasusCore()->getSystem()->getHostPage(0x20000) != nullptr);
+
+        // Store is visible through the memory map
+        const pegasus::Addr paddr = 0x20ff8;
+        const uint64_t value = 0xfeedfacecafebeef;
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(paddr, value));
+        uint64_t peek_val = 0;
+        EXPECT_TRUE(memory_map->tryPeek(paddr, sizeof(peek_val),
+                                        reinterpret_cast<uint8_t*>(&peek_val)));
+        EXPECT_EQUAL(peek_val, value);
+
+        // Load sees values written through the memory map
+        const uint32_t poke_val = 0x12345678;
+        EXPECT_TRUE(memory_map->tryPoke(paddr, sizeof(poke_val),
+                                        reinterpret_cast<const uint8_t*>(&poke_val)));
+        EXPECT_EQUAL(*state_->readMemory<uint32_t>(paddr), poke_val);
+
+        // Accesses that cross a page take the slow path
+        const pegasus::Addr page_crossing_paddr = 0x20ffc;
+        EXPECT_TRUE(state_->writeMemory<uint64_t>(page_crossing_paddr, value));
+        EXPECT_EQUAL(*state_->readMemory<uint64_t>(page_crossing_paddr), value);
+    }
+
+    // Microbenchmark for the load/store path, which must not touch the heap
+    void benchmarkLoadStore()
+    {
+        std::cout << "Benchmarking load/store memory accesses" << std::endl;
+
+        const uint64_t num_accesses = 1000000;
+        const pegasus::Addr paddr = 0x20000;
+        const pegasus::PegasusTranslationState::TranslationResult result{paddr, paddr,
+                                                                         sizeof(uint64_t)};
+        uint64_t sum = 0;
+
+        num_allocations = 0;
+        count_allocations = true;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < num_accesses; ++i)
+        {
+            state_->writeMemory<uint64_t>(result, i, pegasus::MemAccessSource::INSTRUCTION);
+            sum += *state_->readMemory<uint64_t>(result, pegasus::MemAccessSource::INSTRUCTION);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        count_allocations = false;
+
+        const double ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        std::cout << "    Load/store pairs: " << num_accesses << std::endl;
+        std::cout << "    Time per pair:    " << (ns / num_accesses) << "ns" << std::endl;
+        std::cout << "    Heap allocations: " << num_allocations << std::endl;
+
+        EXPECT_EQUAL(sum, num_accesses * (num_accesses - 1) / 2);
+        EXPECT_EQUAL(num_allocations, 0);
+    }
+
+  private:
+    sparta::Scheduler scheduler_;
+    std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
+
+    pegasus::PegasusState* state_ = nullptr;
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    PegasusMemoryAccessTester tester;
+
+    tester.testReadWrite<uint8_t>();
+    tester.testReadWrite<uint16_t>();
+    tester.testReadWrite<uint32_t>();
+    tester.testReadWrite<uint64_t>();
+    tester.testDirectMemoryAccess();
+    tester.benchmarkLoadStore();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
@@ -0,0 +1,237 @@
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusSimParameters.hpp"
+#include "core/PegasusCore.hpp"
+#include "core/PegasusState.hpp"
+#include "include/PegasusTypes.hpp"
+#include "system/Clint.hpp"
+#include "system/PegasusSystem.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <filesystem>
+#include <sstream>
+
+// Runs small programs on the harts of a 2-hart core through the scheduler. Every hart boots
+// nop.elf so that it is queued like any other workload, then its PC is moved to a program
+// written to memory by the test.
+class PegasusHartSchedulerTester
+{
+  public:
+    explicit PegasusHartSchedulerTester(const uint64_t wfi_timeout)
+    {
+        const std::string workload =
+            std::filesystem::canonical(std::filesystem::absolute("workloads/nop.elf")).string();
+        pegasus::PegasusSimParameters::WorkloadsAndArgs workloads_and_args(NUM_HARTS,
+                                                                           {workload});
+
+        sparta::app::SimulationConfiguration config;
+        config.processParameter(
+            "top.extension.sim.workloads",
+            pegasus::PegasusSimParameters::convertVectorToStringParam(workloads_and_args));
+        config.processParameter("top.system.params.enable_clint", "true");
+        config.processParameter("top.core0.params.num_harts", std::to_string(NUM_HARTS));
+        config.processParameter("top.core0.params.wfi_timeout", std::to_string(wfi_timeout));
+        config.processParameter("top.core0.params.max_shared_quantum",
+                                std::to_string(MAX_SHARED_QUANTUM));
+        for (uint32_t hart_idx = 0; hart_idx < NUM_HARTS; ++hart_idx)
+        {
+            const std::string hart_params = "top.core0.hart" + std::to_string(hart_idx) + ".params";
+            config.processParameter(hart_params + ".hart_id", std::to_string(hart_idx));
+            config.processParameter(hart_params + ".quantum", std::to_string(QUANTUM));
+        }
+
+        // Create the simulator
+        pegasus_sim_.reset(new pegasus::PegasusSim(&scheduler_));
+        pegasus_sim_->configure(0, nullptr, &config);
+        pegasus_sim_->buildTree();
+        pegasus_sim_->configureTree();
+        pegasus_sim_->finalizeTree();
+
+        core_ = pegasus_sim_->getPegasusCore();
+        state0_ = core_->getPegasusState(0);
+        state1_ = core_->getPegasusState(1);
+    }
+
+    // Both harts loop forever, so they take turns and every slice uses the whole quantum
+    void testRoundRobin()
+    {
+        std::cout << "Testing round robin scheduling" << std::endl;
+
+        loadProgram_(state0_, COUNT_LOOP_PC, {ADDI_X1_OPCODE, JAL_BACK_4_OPCODE});
+        loadProgram_(state1_, COUNT_LOOP_PC + 0x100, {ADDI_X1_OPCODE, JAL_BACK_4_OPCODE});
+        pegasus_sim_->run(RUN_CYCLES);
+
+        uint64_t total_insts = 0;
+        for (pegasus::PegasusState* state : {state0_, state1_})
+        {
+            const auto & stats = core_->getHartSchedStats(state->getHartId());
+            const uint64_t num_insts = state->getSimState()->inst_count;
+            EXPECT_TRUE(stats.num_slices > 3);
+            EXPECT_EQUAL(stats.num_insts, num_insts);
+            EXPECT_EQUAL(stats.num_insts, getQuantumInsts_(stats.num_slices));
+            EXPECT_EQUAL(stats.sleep_cycles, 0);
+            EXPECT_EQUAL(pegasus::READ_INT_REG<pegasus::RV64>(state, 1), num_insts / 2);
+            total_insts += num_insts;
+        }
+
+        // hart0 runs first, and the harts alternate
+        const uint64_t num_slices0 = core_->getHartSchedStats(0).num_slices;
+        const uint64_t num_slices1 = core_->getHartSchedStats(1).num_slices;
+        EXPECT_TRUE((num_slices0 == num_slices1) || (num_slices0 == (num_slices1 + 1)));
+
+        // One cycle per instruction, and the harts share the core's cycles
+        EXPECT_EQUAL(state0_->getSimState()->cycles, total_insts);
+        EXPECT_EQUAL(state1_->getSimState()->cycles, total_insts);
+    }
+
+    // hart1 sleeps on WFI with no interrupt enabled, so only the timeout wakes it up
+    void testWfiTimeout()
+    {
+        std::cout << "Testing WFI wakeup by the timeout" << std::endl;
+
+        loadProgram_(state0_, COUNT_LOOP_PC, {ADDI_X1_OPCODE, JAL_BACK_4_OPCODE});
+        loadProgram_(state1_, WFI_LOOP_PC, {WFI_OPCODE, ADDI_X2_OPCODE, JAL_BACK_8_OPCODE});
+        pegasus_sim_->run(RUN_CYCLES);
+
+        // Every wakeup runs the instructions after WFI and sleeps again on the next WFI
+        const auto & stats = core_->getHartSchedStats(1);
+        const uint64_t num_wakeups = pegasus::READ_INT_REG<pegasus::RV64>(state1_, 2);
+        EXPECT_TRUE(num_wakeups > 1);
+        EXPECT_EQUAL(stats.num_slices, num_wakeups + 1);
+        EXPECT_EQUAL(state1_->getSimState()->inst_count, 1 + (3 * num_wakeups));
+
+        // The hart may have been woken up again without having run yet
+        EXPECT_TRUE((stats.sleep_cycles == (num_wakeups * WFI_TIMEOUT))
+                    || (stats.sleep_cycles == ((num_wakeups + 1) * WFI_TIMEOUT)));
+
+        // hart0 kept running on its own while hart1 was asleep
+        EXPECT_EQUAL(core_->getHartSchedStats(0).sleep_cycles, 0);
+        EXPECT_TRUE(state0_->getSimState()->inst_count > (RUN_CYCLES / 2));
+
+        std::ostringstream report;
+        core_->reportHartSchedStats(report);
+        std::cout << report.str();
+        EXPECT_TRUE(report.str().find("hart0: ") != std::string::npos);
+        EXPECT_TRUE(report.str().find("hart1: ") != std::string::npos);
+        EXPECT_TRUE(report.str().find("% sleeping") != std::string::npos);
+    }
+
+    // hart1 sleeps on WFI until hart0 sets its msip, long before the timeout. Interrupts are
+    // enabled in MIE but not in MSTATUS, so hart1 wakes up without taking a trap.
+    void testWfiInterrupt()
+    {
+        std::cout << "Testing WFI wakeup by an interrupt" << std::endl;
+
+        const pegasus::Clint* clint = core_->getSystem()->getClint();
+        const pegasus::Addr msip1_addr = clint->getBaseAddr() + pegasus::Clint::MSIP_OFFSET + 4;
+        pegasus::WRITE_INT_REG<pegasus::RV64>(state0_, 6, 1);
+        pegasus::WRITE_INT_REG<pegasus::RV64>(state0_, 7, msip1_addr);
+        loadProgram_(state0_, COUNT_LOOP_PC,
+                     {LI_X5_OPCODE, ADDI_X5_OPCODE, BNEZ_X5_OPCODE, SW_X6_X7_OPCODE,
+                      JAL_SELF_OPCODE});
+        loadProgram_(state1_, WFI_LOOP_PC, {WFI_OPCODE, ADDI_X2_OPCODE, JAL_BACK_8_OPCODE});
+        pegasus::POKE_CSR_REG<pegasus::RV64>(state1_, pegasus::MIE, MSIP);
+        pegasus_sim_->run(RUN_CYCLES);
+
+        EXPECT_EQUAL(pegasus::PEEK_CSR_REG<pegasus::RV64>(state1_, pegasus::MIP) & MSIP, MSIP);
+        EXPECT_EQUAL(pegasus::PEEK_CSR_REG<pegasus::RV64>(state1_, pegasus::MCAUSE), 0);
+
+        // Once msip is set, WFI does not sleep anymore
+        const auto & stats = core_->getHartSchedStats(1);
+        EXPECT_TRUE(pegasus::READ_INT_REG<pegasus::RV64>(state1_, 2) > 1000);
+        EXPECT_TRUE(stats.sleep_cycles != 0);
+        EXPECT_TRUE(stats.sleep_cycles < WFI_TIMEOUT_NEVER);
+        EXPECT_TRUE(state1_->getSimState()->sim_pause_reason == pegasus::SimPauseReason::INVALID);
+    }
+
+    // WFI timeout of the tests that wake up harts with it
+    static constexpr uint64_t WFI_TIMEOUT = 1000;
+
+    // WFI timeout longer than the tests run
+    static constexpr uint64_t WFI_TIMEOUT_NEVER = 1000000;
+
+  private:
+    static constexpr uint32_t NUM_HARTS = 2;
+    static constexpr uint64_t QUANTUM = 500;
+    static constexpr uint64_t MAX_SHARED_QUANTUM = 2000;
+    static constexpr uint64_t RUN_CYCLES = 50000;
+    static constexpr uint64_t MSIP = 1 << 3;
+
+    static constexpr pegasus::Addr COUNT_LOOP_PC = 0x1000;
+    static constexpr pegasus::Addr WFI_LOOP_PC = 0x2000;
+
+    // addi x1, x1, 1
+    static constexpr pegasus::Opcode ADDI_X1_OPCODE = 0x00108093;
+    // addi x2, x2, 1
+    static constexpr pegasus::Opcode ADDI_X2_OPCODE = 0x00110113;
+    // addi x5, x0, 2000
+    static constexpr pegasus::Opcode LI_X5_OPCODE = 0x7d000293;
+    // addi x5, x5, -1
+    static constexpr pegasus::Opcode ADDI_X5_OPCODE = 0xfff28293;
+    // bne x5, x0, -4
+    static constexpr pegasus::Opcode BNEZ_X5_OPCODE = 0xfe029ee3;
+    // sw x6, 0(x7)
+    static constexpr pegasus::Opcode SW_X6_X7_OPCODE = 0x0063a023;
+    // wfi
+    static constexpr pegasus::Opcode WFI_OPCODE = 0x10500073;
+    // jal x0, 0
+    static constexpr pegasus::Opcode JAL_SELF_OPCODE = 0x0000006f;
+    // jal x0, -4
+    static constexpr pegasus::Opcode JAL_BACK_4_OPCODE = 0xffdff06f;
+    // jal x0, -8
+    static constexpr pegasus::Opcode JAL_BACK_8_OPCODE = 0xff9ff06f;
+
+    static void loadProgram_(pegasus::PegasusState* state, const pegasus::Addr pc,
+                             const std::vector<pegasus::Opcode> & program)
+    {
+        for (size_t idx = 0; idx < program.size(); ++idx)
+        {
+            EXPECT_TRUE(
+                state->writeMemory<uint32_t>(pc + (idx * sizeof(pegasus::Opcode)), program[idx]));
+        }
+        state->setPc(pc);
+    }
+
+    // Instructions executed in the given number of slices by a hart that never pauses. Its
+    // quantum doubles after every slice, up to the maximum quantum of a shared core.
+    static uint64_t getQuantumInsts_(const uint64_t num_slices)
+    {
+        uint64_t num_insts = 0;
+        uint64_t quantum = QUANTUM;
+        for (uint64_t slice = 0; slice < num_slices; ++slice)
+        {
+            num_insts += quantum;
+            quantum = std::min(quantum * 2, MAX_SHARED_QUANTUM);
+        }
+        return num_insts;
+    }
+
+    sparta::Scheduler scheduler_;
+    std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
+
+    pegasus::PegasusCore* core_ = nullptr;
+    pegasus::PegasusState* state0_ = nullptr;
+    pegasus::PegasusState* state1_ = nullptr;
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    {
+        PegasusHartSchedulerTester tester(PegasusHartSchedulerTester::WFI_TIMEOUT_NEVER);
+        tester.testRoundRobin();
+    }
+    {
+        PegasusHartSchedulerTester tester(PegasusHartSchedulerTester::WFI_TIMEOUT);
+        tester.testWfiTimeout();
+    }
+    {
+        PegasusHartSchedulerTester tester(PegasusHartSchedulerTester::WFI_TIMEOUT_NEVER);
+        tester.testWfiInterrupt();
+    }
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
@@ -447,6 +447,69 @@ class PegasusTranslateTester
         translation_state->reset();
     }
 
+    void testTLB()
+    {
+        std::cout << "Testing TLB class" << std::endl;
+        using pegasus::translate_types::AccessType;
+        namespace PteFields = pegasus::translate_types::Sv39::PteFields;
+
+        pegasus::TLB* tlb =
+            translate_unit_->getTLB(pegasus::translate_types::TranslationStage::SUPERVISOR);
+        EXPECT_TRUE(tlb->isEnabled());
+
+        pegasus::TLB::Context context;
+        context.atp = 0x8000000000000010;
+        context.asid = 1;
+        tlb->setContext(context);
+
+        // Read-only 4K page, accessed but not dirty
+        const uint64_t ro_pte = PteFields::valid.bitmask | PteFields::read.bitmask
+                                | PteFields::accessed.bitmask;
+        tlb->insert(0x1234, 0x80001234, 0xfff, 1, ro_pte);
+
+        // Loads hit, stores and fetches miss
+        const pegasus::TLB::TLBEntry* entry =
+            tlb->lookup(0x1ff8, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR);
+        EXPECT_TRUE(entry != nullptr);
+        EXPECT_EQUAL(entry->pa_base | (0x1ff8 & entry->page_offset_mask), 0x80001ff8);
+        EXPECT_TRUE(tlb->lookup(0x1ff8, AccessType::STORE, pegasus::PrivMode::SUPERVISOR)
+                    == nullptr);
+        EXPECT_TRUE(tlb->lookup(0x1ff8, AccessType::EXECUTE, pegasus::PrivMode::SUPERVISOR)
+                    == nullptr);
+
+        // Supervisor page cannot be accessed from User mode
+        EXPECT_TRUE(tlb->lookup(0x1000, AccessType::LOAD, pegasus::PrivMode::USER) == nullptr);
+
+        // Different page misses
+        EXPECT_TRUE(tlb->lookup(0x2000, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR)
+                    == nullptr);
+
+        // Flushing a different ASID keeps the entry
+        tlb->flush(std::nullopt, 2);
+        EXPECT_TRUE(tlb->lookup(0x1000, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR)
+                    != nullptr);
+
+        // Flushing the page removes the entry
+        tlb->flush(0x1800, std::nullopt);
+        EXPECT_TRUE(tlb->lookup(0x1000, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR)
+                    == nullptr);
+
+        // 2M global superpage survives ASID flushes but not a context change
+        const uint64_t global_pte = ro_pte | PteFields::global.bitmask;
+        tlb->insert(0x40201000, 0x80201000, 0x1fffff, 2, global_pte);
+        EXPECT_TRUE(tlb->lookup(0x40201abc, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR)
+                    != nullptr);
+        tlb->flush(std::nullopt, 1);
+        EXPECT_TRUE(tlb->lookup(0x40201abc, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR)
+                    != nullptr);
+        context.sum = true;
+        tlb->setContext(context);
+        EXPECT_TRUE(tlb->lookup(0x40201abc, AccessType::LOAD, pegasus::PrivMode::SUPERVISOR)
+                    == nullptr);
+
+        tlb->flush();
+    }
+
   private:
     sparta::Scheduler scheduler_;
     std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
@@ -465,6 +528,7 @@ int main(int argc, char** argv)
     translate_tester.testPegasusTranslationStateBasic();
     translate_tester.testPegasusTranslationStateMisaligned();
     translate_tester.testPegasusTranslationStateMultiple();
+    translate_tester.testTLB();
     // translate_tester.testPageTableEntry();
     // translate_tester.testPageTable();
 
@@ -645,6 +645,99 @@ int main(int argc, char** argv)
         EXPECT_EQUAL(exception_str, "");
     }
 
+    // Seek into the middle of the database and check that we end up in the same state
+    // as a replayer which stepped through every event. Then check the consistency of the
+    // whole database.
+    if (!ERROR_CODE)
+    {
+        CoSimEventReplayer replayer_stepped(db_test, arch);
+        CoSimEventReplayer replayer_seeked(db_test, arch);
+
+        const uint64_t seek_arch_id = replayer_stepped.getNumEventsOnDisk() / 2 + 1;
+        while (replayer_stepped.getNextArchId() < seek_arch_id)
+        {
+            replayer_stepped.step(core_id, hart_id);
+        }
+
+        std::cout << "Seeking CoSim event replayer to arch ID " << std::dec << seek_arch_id
+                  << "..." << std::endl;
+        replayer_seeked.seek(core_id, hart_id, seek_arch_id);
+        EXPECT_EQUAL(replayer_seeked.getNextArchId(), seek_arch_id);
+
+        auto state_stepped =
+            replayer_stepped.getPegasusSim().getPegasusCore(core_id)->getPegasusState(hart_id);
+        auto state_seeked =
+            replayer_seeked.getPegasusSim().getPegasusCore(core_id)->getPegasusState(hart_id);
+        if (arch == "rv32")
+        {
+            EXPECT_TRUE(Compare<uint32_t>(state_stepped, state_seeked));
+        }
+        else
+        {
+            EXPECT_TRUE(Compare<uint64_t>(state_stepped, state_seeked));
+        }
+
+        std::cout << "Checking the database consistency..." << std::endl;
+        CoSimEventReplayer replayer_checked(db_test, arch);
+        const auto mismatches = replayer_checked.checkConsistency(core_id, hart_id);
+        for (const auto & mismatch : mismatches)
+        {
+            std::cout << "    euid " << std::dec << mismatch.euid << ": " << mismatch.description
+                      << std::endl;
+        }
+        EXPECT_TRUE(mismatches.empty());
+        EXPECT_EQUAL(replayer_checked.getNextArchId(), replayer_checked.getNumEventsOnDisk());
+    }
+
+    // Plant a mismatch: corrupt the integer register written by an event after it has been
+    // replayed, and check that the consistency check reports it.
+    if (!ERROR_CODE)
+    {
+        std::cout << "Checking that a planted mismatch is detected..." << std::endl;
+        CoSimEventReplayer replayer(db_test, arch);
+        auto state = replayer.getPegasusSim().getPegasusCore(core_id)->getPegasusState(hart_id);
+
+        const pegasus::RegId* planted_reg_id = nullptr;
+        while ((planted_reg_id == nullptr) && replayer.step(core_id, hart_id))
+        {
+            const auto* event = replayer.getLastEvent(core_id, hart_id);
+            for (const auto & reg_write : event->getRegisterWrites())
+            {
+                if ((reg_write.reg_id.reg_type == pegasus::RegType::INTEGER)
+                    && (reg_write.reg_id.reg_num != 0))
+                {
+                    planted_reg_id = &reg_write.reg_id;
+                    break;
+                }
+            }
+        }
+        EXPECT_TRUE(planted_reg_id != nullptr);
+
+        if (planted_reg_id != nullptr)
+        {
+            const pegasus::cosim::Event* event = replayer.getLastEvent(core_id, hart_id);
+            EXPECT_TRUE(replayer.checkLastEvent(core_id, hart_id).empty());
+
+            sparta::Register* reg = state->findRegister(*planted_reg_id);
+            std::vector<uint8_t> value(reg->getNumBytes());
+            reg->peek(value.data(), value.size(), 0);
+            value[0] ^= 0x1;
+            reg->poke(value.data(), value.size(), 0);
+
+            const auto mismatches = replayer.checkLastEvent(core_id, hart_id);
+            EXPECT_EQUAL(mismatches.size(), 1);
+            if (!mismatches.empty())
+            {
+                std::cout << "    euid " << std::dec << mismatches.front().euid << ": "
+                          << mismatches.front().description << std::endl;
+                EXPECT_EQUAL(mismatches.front().euid, event->getEuid());
+                EXPECT_EQUAL(mismatches.front().arch_id, event->getArchId());
+                EXPECT_TRUE(mismatches.front().description.find(planted_reg_id->reg_name)
+                            != std::string::npos);
+            }
+        }
+    }
+
     REPORT_ERROR;
     return ERROR_CODE;
 }
@@ -0,0 +1,93 @@
+#include "cosim/PegasusCoSim.hpp"
+#include "cosim/EventCodec.hpp"
+#include "sim/PegasusSimParameters.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <filesystem>
+
+using pegasus::cosim::CompressionCodec;
+using pegasus::cosim::EventCodec;
+using pegasus::cosim::EventFormat;
+using pegasus::cosim::EventList;
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_EVENTS = 20000;
+
+// Same window size as the CoSimEventPipeline
+static constexpr size_t WINDOW_SIZE = 100;
+
+// Runs Dhrystone with system call emulation through cosim and keeps a copy of every event
+EventList collectEvents(const std::string & codec)
+{
+    const std::string workload =
+        std::filesystem::canonical(std::filesystem::absolute("workloads/rv64_dhry.elf")).string();
+    const std::map<std::string, std::string> sim_params = {
+        {"top.extension.sim.enable_syscall_emulation", "true"},
+        {"top.extension.sim.reg_overrides",
+         "[[core0.hart0.sp, 0x0000003ffffff000], [core0.hart0.gp, 0x77000], "
+         "[core0.hart0.tp, 0x7d000]]"},
+        {"top.extension.sim.cosim_event_codec", codec}};
+    const std::string db_file = "EventCodec_test_" + codec + ".db";
+
+    EventList evts;
+    {
+        pegasus::cosim::PegasusCoSim cosim(NUM_EVENTS, workload, sim_params, {}, db_file);
+        auto state = cosim.getPegasusSim().getPegasusCore(CORE_ID)->getPegasusState(HART_ID);
+        while (!state->getSimState()->sim_stopped && (evts.size() < NUM_EVENTS))
+        {
+            auto event = cosim.step(CORE_ID, HART_ID);
+            evts.emplace_back(*event.get());
+            cosim.commit(event);
+        }
+        cosim.finish();
+    }
+
+    std::filesystem::remove(db_file);
+    return evts;
+}
+
+// Every window must decode to the events it was encoded from
+void testRoundTrip(const std::string & codec, const EventList & evts)
+{
+    std::cout << "Testing the '" << codec << "' event codec" << std::endl;
+
+    const EventFormat format = EventCodec::getFormat(codec);
+    for (auto it = evts.begin(); it != evts.end();)
+    {
+        const auto window_end = it + std::min<size_t>(WINDOW_SIZE, evts.end() - it);
+        const EventList window(it, window_end);
+        it = window_end;
+
+        std::vector<char> bytes;
+        EventList decoded_evts;
+        EventCodec::encode(window, format, bytes);
+        EventCodec::decode(bytes, format, decoded_evts);
+        EXPECT_TRUE(decoded_evts == window);
+
+        std::vector<char> compressed_bytes;
+        decoded_evts.clear();
+        EventCodec::compress(window, format, CompressionCodec::ZLIB, nullptr, compressed_bytes);
+        EventCodec::decompress(compressed_bytes, format, CompressionCodec::ZLIB, nullptr,
+                               decoded_evts);
+        EXPECT_TRUE(decoded_evts == window);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    // Both codecs work in the cosim event pipeline. The events themselves are not compared
+    // across runs: the time system calls of Dhrystone return host values.
+    const EventList evts = collectEvents("compact");
+    EXPECT_TRUE(collectEvents("boost").size() == evts.size());
+
+    testRoundTrip("boost", evts);
+    testRoundTrip("compact", evts);
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
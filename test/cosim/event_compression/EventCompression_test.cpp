@@ -0,0 +1,121 @@
+#include "cosim/PegasusCoSim.hpp"
+#include "cosim/EventCodec.hpp"
+#include "cosim/EventCompression.hpp"
+#include "sim/PegasusSimParameters.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <filesystem>
+
+using pegasus::cosim::CompressionCodec;
+using pegasus::cosim::EventCodec;
+using pegasus::cosim::EventCompressor;
+using pegasus::cosim::EventDictionary;
+using pegasus::cosim::EventFormat;
+using pegasus::cosim::EventList;
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_EVENTS = 20000;
+
+// Same window size as the CoSimEventPipeline
+static constexpr size_t WINDOW_SIZE = 100;
+
+// Runs Dhrystone with system call emulation through cosim and returns the encoded
+// (not yet compressed) event windows
+std::vector<std::vector<char>> collectWindows(const std::string & compression)
+{
+    const std::string workload =
+        std::filesystem::canonical(std::filesystem::absolute("workloads/rv64_dhry.elf")).string();
+    const std::map<std::string, std::string> sim_params = {
+        {"top.extension.sim.enable_syscall_emulation", "true"},
+        {"top.extension.sim.reg_overrides",
+         "[[core0.hart0.sp, 0x0000003ffffff000], [core0.hart0.gp, 0x77000], "
+         "[core0.hart0.tp, 0x7d000]]"},
+        {"top.extension.sim.cosim_event_compression", compression}};
+    const std::string db_file = "EventCompression_test_" + compression + ".db";
+
+    EventList evts;
+    {
+        pegasus::cosim::PegasusCoSim cosim(NUM_EVENTS, workload, sim_params, {}, db_file);
+        auto state = cosim.getPegasusSim().getPegasusCore(CORE_ID)->getPegasusState(HART_ID);
+        while (!state->getSimState()->sim_stopped && (evts.size() < NUM_EVENTS))
+        {
+            auto event = cosim.step(CORE_ID, HART_ID);
+            evts.emplace_back(*event.get());
+            cosim.commit(event);
+        }
+        cosim.finish();
+    }
+
+    std::filesystem::remove(db_file);
+
+    std::vector<std::vector<char>> windows;
+    for (auto it = evts.begin(); it != evts.end();)
+    {
+        const auto window_end = it + std::min<size_t>(WINDOW_SIZE, evts.end() - it);
+        auto & bytes = windows.emplace_back();
+        EventCodec::encode(EventList(it, window_end), EventFormat::COMPACT_V1, bytes);
+        it = window_end;
+    }
+    return windows;
+}
+
+// Every window must decompress to the bytes it was compressed from
+void testRoundTrip(const std::vector<std::vector<char>> & windows, CompressionCodec codec,
+                   int level, const EventDictionary* dict)
+{
+    std::cout << "Testing " << codec << " level " << level << (dict ? " with a dictionary" : "")
+              << std::endl;
+
+    for (const auto & window : windows)
+    {
+        std::vector<char> compressed_bytes;
+        std::vector<char> decompressed_bytes;
+        EventCompressor::compress(window, codec, level, dict, compressed_bytes);
+        EventCompressor::decompress(compressed_bytes, codec, dict, decompressed_bytes);
+        EXPECT_TRUE(decompressed_bytes == window);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    // The adaptive policy works in the cosim event pipeline
+    const auto windows = collectWindows("adaptive");
+    EXPECT_TRUE(collectWindows("zlib").size() == windows.size());
+
+    testRoundTrip(windows, CompressionCodec::ZLIB, 0, nullptr);
+
+    if (EventCompressor::isAvailable(CompressionCodec::LZ4))
+    {
+        testRoundTrip(windows, CompressionCodec::LZ4, 0, nullptr);
+    }
+
+    if (EventCompressor::isAvailable(CompressionCodec::ZSTD))
+    {
+        testRoundTrip(windows, CompressionCodec::ZSTD, EventCompressor::ZSTD_FAST_LEVEL,
+                      nullptr);
+        testRoundTrip(windows, CompressionCodec::ZSTD, EventCompressor::ZSTD_DEFAULT_LEVEL,
+                      nullptr);
+
+        // Train on the first windows like the CoSimEventPipeline does
+        const size_t num_training_windows =
+            std::min(EventCompressor::NUM_TRAINING_WINDOWS, windows.size());
+        const std::vector<std::vector<char>> samples(windows.begin(),
+                                                     windows.begin() + num_training_windows);
+        const auto dict =
+            EventCompressor::trainDictionary(samples, EventCompressor::MAX_DICTIONARY_SIZE);
+        EXPECT_TRUE(dict != nullptr);
+        if (dict)
+        {
+            testRoundTrip(windows, CompressionCodec::ZSTD_DICT,
+                          EventCompressor::ZSTD_DEFAULT_LEVEL, dict.get());
+        }
+    }
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
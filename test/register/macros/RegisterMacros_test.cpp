@@ -116,6 +116,36 @@ void testVecElems()
     }
 }
 
+// The flat register files must stay coherent with the Sparta registers
+void testRegisterFiles()
+{
+    RegisterTester tester;
+    pegasus::PegasusState* state = tester.getPegasusState();
+
+    uint64_t rand_val = dis(gen);
+    WRITE_INT_REG<pegasus::RV64>(state, pegasus::X5, rand_val);
+    EXPECT_EQUAL(state->getIntRegister(pegasus::X5)->dmiRead<uint64_t>(), rand_val);
+    state->getIntRegister(pegasus::X31)->write<uint64_t>(~rand_val);
+    EXPECT_EQUAL(READ_INT_REG<pegasus::RV64>(state, pegasus::X31), ~rand_val);
+
+    rand_val = dis(gen);
+    WRITE_FP_REG<pegasus::RV64>(state, pegasus::F7, rand_val);
+    EXPECT_EQUAL(state->getFpRegister(pegasus::F7)->dmiRead<uint64_t>(), rand_val);
+    state->getFpRegister(pegasus::F31)->write<uint64_t>(~rand_val);
+    EXPECT_EQUAL(READ_FP_REG<pegasus::RV64>(state, pegasus::F31), ~rand_val);
+
+    // Every element of the last vector register
+    sparta::Register* v31 = state->getVecRegister(pegasus::V31);
+    const uint32_t num_elems = v31->getNumBytes() / sizeof(uint64_t);
+    for (uint32_t elem_idx = 0; elem_idx < num_elems; ++elem_idx)
+    {
+        WRITE_VEC_ELEM<uint64_t>(state, pegasus::V31, rand_val + elem_idx, elem_idx);
+        EXPECT_EQUAL(v31->dmiRead<uint64_t>(elem_idx), rand_val + elem_idx);
+    }
+    v31->write<uint64_t>(0, num_elems - 1);
+    EXPECT_EQUAL(READ_VEC_ELEM<uint64_t>(state, pegasus::V31, num_elems - 1), 0);
+}
+
 void testCsrRegs()
 {
     RegisterTester tester;
@@ -278,13 +308,46 @@ void testCsrRegs()
     EXPECT_EQUAL(READ_CSR_FIELD<pegasus::RV64>(state, pegasus::MVENDORID, "Offset"), 0xf);
 }
 
+void testTypedCsrFields()
+{
+    RegisterTester tester;
+    pegasus::PegasusState* state = tester.getPegasusState();
+
+    // Typed accessors must agree with the string-keyed accessors
+    POKE_CSR_REG<pegasus::RV64>(state, pegasus::MSTATUS, 0);
+    WRITE_CSR_FIELD<pegasus::RV64, pegasus::MSTATUS, "mpp">(state, 3);
+    EXPECT_EQUAL((READ_CSR_FIELD<pegasus::RV64, pegasus::MSTATUS, "mpp">(state)), 3);
+    EXPECT_EQUAL(READ_CSR_FIELD<pegasus::RV64>(state, pegasus::MSTATUS, "mpp"), 3);
+    EXPECT_EQUAL(READ_CSR_REG<pegasus::RV64>(state, pegasus::MSTATUS), 0x3 << 11);
+
+    // Field names are case insensitive
+    WRITE_CSR_FIELD<pegasus::RV64, pegasus::SSTATUS, "SUM">(state, 1);
+    EXPECT_EQUAL((READ_CSR_FIELD<pegasus::RV64, pegasus::SSTATUS, "sum">(state)), 1);
+
+    // Read-only fields are not written
+    POKE_CSR_REG<pegasus::RV64>(state, pegasus::DMCONTROL, 0);
+    WRITE_CSR_FIELD<pegasus::RV64, pegasus::DMCONTROL, "hasel">(state, 1);
+    EXPECT_EQUAL((READ_CSR_FIELD<pegasus::RV64, pegasus::DMCONTROL, "hasel">(state)), 0);
+    POKE_CSR_FIELD<pegasus::RV64, pegasus::DMCONTROL, "hasel">(state, 1);
+    EXPECT_EQUAL((READ_CSR_FIELD<pegasus::RV64, pegasus::DMCONTROL, "hasel">(state)), 1);
+
+    // Multi-bit fields
+    POKE_CSR_REG<pegasus::RV64>(state, pegasus::MVENDORID, 0);
+    POKE_CSR_FIELD<pegasus::RV64, pegasus::MVENDORID, "Bank">(state, 0xe);
+    EXPECT_EQUAL((READ_CSR_FIELD<pegasus::RV64, pegasus::MVENDORID, "bank">(state)), 0xe);
+    EXPECT_EQUAL((READ_CSR_FIELD<pegasus::RV64, pegasus::MVENDORID, "offset">(state)), 0);
+    EXPECT_EQUAL(READ_CSR_REG<pegasus::RV64>(state, pegasus::MVENDORID), 0xe << 7);
+}
+
 int main()
 {
     testIntRegs();
     testFpRegs();
     testVecRegs();
     testVecElems();
+    testRegisterFiles();
     testCsrRegs();
+    testTypedCsrFields();
 
     REPORT_ERROR;
     return ERROR_CODE;
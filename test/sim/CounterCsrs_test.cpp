@@ -0,0 +1,167 @@
+#include "test/sim/WorkloadTester.hpp"
+#include "system/Clint.hpp"
+#include "system/PegasusSystem.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+// Runs Dhrystone with system call emulation, which does not read the counter CSRs
+class PegasusCounterCsrsTester : public PegasusWorkloadTester
+{
+  public:
+    PegasusCounterCsrsTester(const bool enable_zicntr, const bool enable_clint = false) :
+        PegasusWorkloadTester("rv64_dhry.elf", getParams(enable_zicntr, enable_clint)),
+        state_(getState())
+    {
+    }
+
+    const pegasus::Clint* getClint() { return getCore()->getSystem()->getClint(); }
+
+    // Value held by the register object, without bringing the counter up to date
+    uint64_t getRawCsrValue(const uint32_t csr)
+    {
+        return state_->getCsrRegisterSet()->getRegister(csr)->dmiRead<uint64_t>();
+    }
+
+    // Up to date value of the counter, as seen by a CSR instruction
+    uint64_t getCsrValue(const uint32_t csr)
+    {
+        state_->syncCounterCsrs();
+        return pegasus::PEEK_CSR_REG<pegasus::RV64>(state_, csr);
+    }
+
+    // Write a counter or MCOUNTINHIBIT the way a CSR instruction does
+    void pokeCsrValue(const uint32_t csr, const uint64_t value)
+    {
+        state_->syncCounterCsrs();
+        pegasus::POKE_CSR_REG<pegasus::RV64>(state_, csr, value);
+    }
+
+  private:
+    static Params getParams(const bool enable_zicntr, const bool enable_clint)
+    {
+        Params params;
+        if (enable_zicntr)
+        {
+            params["top.core0.params.isa"] = "rv64imafdcbv_zicsr_zifencei_zicntr";
+        }
+        if (enable_clint)
+        {
+            params["top.system.params.enable_clint"] = "true";
+        }
+        return params;
+    }
+
+    pegasus::PegasusState* const state_;
+};
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_INSTS = 2000000;
+
+static const std::vector<uint32_t> COUNTER_CSRS{pegasus::CYCLE, pegasus::TIME, pegasus::INSTRET,
+                                                pegasus::MCYCLE, pegasus::MINSTRET};
+
+static void run(PegasusCounterCsrsTester & tester, const uint64_t num_insts)
+{
+    const pegasus::PegasusSim::RunResult result =
+        tester.getSim()->runUntil(CORE_ID, HART_ID, num_insts, 0);
+    EXPECT_EQUAL(result.num_insts, num_insts);
+}
+
+// Retiring instructions must not write the counter registers
+void testRetire()
+{
+    std::cout << "Testing instruction retirement with counter CSRs" << std::endl;
+
+    PegasusCounterCsrsTester tester(true);
+    std::vector<uint64_t> raw_values;
+    for (const uint32_t csr : COUNTER_CSRS)
+    {
+        raw_values.emplace_back(tester.getRawCsrValue(csr));
+    }
+
+    run(tester, NUM_INSTS);
+
+    // The register objects were not touched while running...
+    for (size_t idx = 0; idx < COUNTER_CSRS.size(); ++idx)
+    {
+        EXPECT_EQUAL(tester.getRawCsrValue(COUNTER_CSRS[idx]), raw_values[idx]);
+    }
+
+    // ...and are brought up to date when accessed
+    const pegasus::PegasusState::SimState* sim_state = tester.getState()->getSimState();
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MINSTRET), sim_state->inst_count);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::INSTRET), sim_state->inst_count);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MCYCLE), sim_state->cycles);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::CYCLE), sim_state->cycles);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::TIME), sim_state->cycles);
+    EXPECT_EQUAL(tester.getRawCsrValue(pegasus::MINSTRET), sim_state->inst_count);
+}
+
+// Counters keep counting from the written value
+void testCounterWrites()
+{
+    std::cout << "Testing counter CSR writes" << std::endl;
+
+    PegasusCounterCsrsTester tester(true);
+    run(tester, 1000);
+
+    tester.pokeCsrValue(pegasus::MINSTRET, 100);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MINSTRET), 100);
+    run(tester, 1000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MINSTRET), 1100);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::INSTRET), 2000);
+}
+
+// MCOUNTINHIBIT stops the counters while it is set
+void testCountInhibit()
+{
+    std::cout << "Testing MCOUNTINHIBIT" << std::endl;
+
+    PegasusCounterCsrsTester tester(true);
+    run(tester, 1000);
+
+    const uint64_t MCOUNTINHIBIT_IR = 0x4;
+    tester.pokeCsrValue(pegasus::MCOUNTINHIBIT, MCOUNTINHIBIT_IR);
+    run(tester, 1000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MINSTRET), 1000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::INSTRET), 1000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MCYCLE), 2000);
+
+    tester.pokeCsrValue(pegasus::MCOUNTINHIBIT, 0);
+    run(tester, 1000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MINSTRET), 2000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::MCYCLE), 3000);
+}
+
+// time follows mtime when there is a CLINT, including after mtime is written
+void testTimeFromClint()
+{
+    std::cout << "Testing time with a CLINT" << std::endl;
+
+    PegasusCounterCsrsTester tester(true, true);
+    const pegasus::Clint* clint = tester.getClint();
+    EXPECT_TRUE(clint != nullptr);
+    pegasus::PegasusState* state = tester.getState();
+    run(tester, 1000);
+
+    const pegasus::Addr mtime_addr = clint->getBaseAddr() + pegasus::Clint::MTIME_OFFSET;
+    EXPECT_TRUE(state->writeMemory<uint64_t>(mtime_addr, 1000000));
+    run(tester, 1000);
+    EXPECT_EQUAL(tester.getCsrValue(pegasus::TIME), clint->getMtime(state->getSimState()->cycles));
+    EXPECT_TRUE(tester.getCsrValue(pegasus::TIME) >= 1000000);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    testRetire();
+    testCounterWrites();
+    testCountInhibit();
+    testTimeFromClint();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
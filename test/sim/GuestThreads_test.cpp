@@ -0,0 +1,90 @@
+#include "test/sim/WorkloadTester.hpp"
+#include "system/SystemCallEmulator.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+struct ThreadingResult
+{
+    std::vector<uint64_t> num_insts;
+    uint64_t futex_parks = 0;
+    uint64_t futex_wakes = 0;
+    uint64_t futex_timeouts = 0;
+};
+
+// Runs threading.elf with system call emulation on a core with the given number of harts. The
+// main thread starts a thread on hart1 with clone3 and waits for it in pthread_join, and both
+// threads contend for the stdout lock in printf. Without futex sleep, FUTEX_WAIT returns right
+// away and the waiting thread spins.
+ThreadingResult runThreading(const uint32_t num_harts, const bool futex_sleep)
+{
+    PegasusWorkloadTester::Params params = PegasusWorkloadTester::getNumHartsParams(num_harts);
+    params["top.system_call_emulator.params.futex_sleep"] = futex_sleep ? "true" : "false";
+    PegasusWorkloadTester tester("threading.elf", params, false);
+    tester.getSim()->run(sparta::Scheduler::INDEFINITE);
+
+    ThreadingResult result;
+    for (pegasus::HartId hart_idx = 0; hart_idx < num_harts; ++hart_idx)
+    {
+        const pegasus::PegasusState* state = tester.getState(hart_idx);
+        result.num_insts.emplace_back(state->getSimState()->inst_count);
+    }
+    EXPECT_TRUE(tester.getState(0)->getSimState()->sim_stopped);
+    EXPECT_TRUE(tester.getState(1)->getSimState()->sim_stopped);
+    EXPECT_EQUAL(tester.getState(0)->getSimState()->workload_exit_code, 0);
+
+    // The thread ran on the first idle hart, and the other harts were never started
+    EXPECT_TRUE(result.num_insts[1] != 0);
+    for (pegasus::HartId hart_idx = 2; hart_idx < num_harts; ++hart_idx)
+    {
+        EXPECT_EQUAL(result.num_insts[hart_idx], 0);
+    }
+
+    const pegasus::SystemCallEmulator* emulator = tester.getCore()->getSystemCallEmulator();
+    result.futex_parks = emulator->getNumFutexParks();
+    result.futex_wakes = emulator->getNumFutexWakes();
+    result.futex_timeouts = emulator->getNumFutexTimeouts();
+    return result;
+}
+
+void testFutexSleep(const uint32_t num_harts)
+{
+    std::cout << "Testing guest threads waiting on futexes with " << num_harts << " harts"
+              << std::endl;
+
+    const ThreadingResult spin_result = runThreading(num_harts, false);
+    const ThreadingResult sleep_result = runThreading(num_harts, true);
+
+    // Spinning harts never sleep
+    EXPECT_EQUAL(spin_result.futex_parks, 0);
+    EXPECT_EQUAL(spin_result.futex_wakes, 0);
+    EXPECT_EQUAL(spin_result.futex_timeouts, 0);
+
+    // pthread_join and the stdout lock wait without a timeout, so every hart that went to sleep
+    // was woken up by the other thread
+    EXPECT_TRUE(sleep_result.futex_parks != 0);
+    EXPECT_TRUE(sleep_result.futex_wakes != 0);
+    EXPECT_EQUAL(sleep_result.futex_timeouts, 0);
+    EXPECT_TRUE(sleep_result.futex_wakes <= sleep_result.futex_parks);
+
+    // Sleeping harts do not execute the instructions a spinning hart burns
+    uint64_t spin_insts = 0;
+    uint64_t sleep_insts = 0;
+    for (pegasus::HartId hart_idx = 0; hart_idx < num_harts; ++hart_idx)
+    {
+        spin_insts += spin_result.num_insts[hart_idx];
+        sleep_insts += sleep_result.num_insts[hart_idx];
+    }
+    EXPECT_TRUE(sleep_insts <= spin_insts);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    testFutexSleep(2);
+    testFutexSleep(4);
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
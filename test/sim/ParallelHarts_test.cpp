@@ -0,0 +1,86 @@
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusSimParameters.hpp"
+#include "core/PegasusState.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <filesystem>
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr uint32_t NUM_HARTS = 4;
+
+struct WindowStats
+{
+    uint64_t num_parallel_windows = 0;
+    uint64_t num_window_syncs = 0;
+};
+
+// Runs multihart.elf on every hart of core0 through the scheduler and checks that every hart
+// finishes the workload
+WindowStats runMultihart(uint32_t host_threads)
+{
+    const std::string workload =
+        std::filesystem::canonical(std::filesystem::absolute("workloads/multihart.elf"))
+            .string();
+    pegasus::PegasusSimParameters::WorkloadsAndArgs workloads_and_args(NUM_HARTS, {workload});
+
+    sparta::Scheduler scheduler;
+    sparta::app::SimulationConfiguration config;
+    config.processParameter(
+        "top.extension.sim.workloads",
+        pegasus::PegasusSimParameters::convertVectorToStringParam(workloads_and_args));
+    config.processParameter("top.core0.params.isa", "rv64imafdcbv_zicsr_zifencei_zihintpause");
+    config.processParameter("top.core0.params.num_harts", std::to_string(NUM_HARTS));
+    config.processParameter("top.core0.params.host_threads", std::to_string(host_threads));
+    for (uint32_t hart_idx = 0; hart_idx < NUM_HARTS; ++hart_idx)
+    {
+        config.processParameter("top.core0.hart" + std::to_string(hart_idx) + ".params.hart_id",
+                                std::to_string(hart_idx));
+    }
+
+    pegasus::PegasusSim sim(&scheduler);
+    sim.configure(0, nullptr, &config);
+    sim.buildTree();
+    sim.configureTree();
+    sim.finalizeTree();
+    sim.run(sparta::Scheduler::INDEFINITE);
+
+    pegasus::PegasusCore* core = sim.getPegasusCore(CORE_ID);
+    EXPECT_EQUAL(core->hasParallelWindows(), host_threads > 1);
+    for (pegasus::HartId hart_idx = 0; hart_idx < NUM_HARTS; ++hart_idx)
+    {
+        const pegasus::PegasusState* state = core->getPegasusState(hart_idx);
+        EXPECT_TRUE(state->getSimState()->sim_stopped);
+        EXPECT_EQUAL(state->getSimState()->workload_exit_code, 0);
+        EXPECT_TRUE(state->getSimState()->inst_count != 0);
+    }
+    return {core->getNumParallelWindows(), core->getNumWindowSyncs()};
+}
+
+void testParallelHarts()
+{
+    std::cout << "Testing parallel hart execution" << std::endl;
+
+    // One host thread runs the harts in the scheduler's order, without parallel windows
+    const WindowStats serial_stats = runMultihart(1);
+    EXPECT_EQUAL(serial_stats.num_parallel_windows, 0);
+    EXPECT_EQUAL(serial_stats.num_window_syncs, 0);
+
+    // Loads and stores to plain memory race between the harts of a parallel window, so only
+    // the outcome of the workload is checked, not the instruction counts. Every hart starts
+    // with an LR/SC loop, so the first window ends with the harts syncing on the atomics.
+    const WindowStats parallel_stats = runMultihart(NUM_HARTS);
+    EXPECT_TRUE(parallel_stats.num_parallel_windows != 0);
+    EXPECT_TRUE(parallel_stats.num_window_syncs != 0);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    testParallelHarts();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
@@ -0,0 +1,71 @@
+#include "test/sim/WorkloadTester.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_INSTS = 2000000;
+
+void testRunUntil()
+{
+    std::cout << "Testing runUntil stop conditions" << std::endl;
+
+    PegasusWorkloadTester tester("rv64_dhry.elf");
+    pegasus::PegasusSim* sim = tester.getSim();
+    pegasus::PegasusState* state = tester.getState();
+
+    // Runs exactly the requested number of instructions
+    pegasus::PegasusSim::RunResult result = sim->runUntil(CORE_ID, HART_ID, 20000, 0);
+    EXPECT_EQUAL(result.num_insts, 20000);
+    EXPECT_TRUE(result.stop_reason == pegasus::PegasusSim::StopReason::INST_LIMIT);
+
+    // Dhrystone loops, so the current PC is reached again
+    const pegasus::Addr breakpoint_pc = state->getPc();
+    sim->runUntil(CORE_ID, HART_ID, 1, 0);
+    sim->addBreakpoint(breakpoint_pc);
+    result = sim->runUntil(CORE_ID, HART_ID, NUM_INSTS, pegasus::PegasusSim::STOP_ON_BREAKPOINT);
+    EXPECT_TRUE(result.stop_reason == pegasus::PegasusSim::StopReason::BREAKPOINT);
+    EXPECT_EQUAL(state->getPc(), breakpoint_pc);
+    EXPECT_TRUE(result.num_insts < NUM_INSTS);
+    sim->clearBreakpoints();
+
+    // Run to the end of the workload
+    result = sim->runUntil(CORE_ID, HART_ID, NUM_INSTS * 10, 0);
+    EXPECT_TRUE(result.stop_reason == pegasus::PegasusSim::StopReason::SIM_STOPPED);
+    EXPECT_FALSE(sim->step(CORE_ID, HART_ID));
+}
+
+void testRunUntilMatchesStep()
+{
+    std::cout << "Testing runUntil against step" << std::endl;
+
+    // An odd count, so the last batch of runUntil does not fit a whole block
+    const uint64_t num_insts = 100001;
+
+    PegasusWorkloadTester step_tester("rv64_dhry.elf");
+    uint64_t step_insts = 0;
+    while ((step_insts < num_insts) && step_tester.getSim()->step(CORE_ID, HART_ID))
+    {
+        ++step_insts;
+    }
+
+    PegasusWorkloadTester run_tester("rv64_dhry.elf");
+    const pegasus::PegasusSim::RunResult result =
+        run_tester.getSim()->runUntil(CORE_ID, HART_ID, num_insts, 0);
+
+    EXPECT_EQUAL(result.num_insts, step_insts);
+    EXPECT_EQUAL(run_tester.getState()->getSimState()->inst_count, result.num_insts);
+    EXPECT_EQUAL(run_tester.getState()->getPc(), step_tester.getState()->getPc());
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    testRunUntil();
+    testRunUntilMatchesStep();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
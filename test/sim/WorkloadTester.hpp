@@ -0,0 +1,90 @@
+#pragma once
+
+#include "sim/PegasusSim.hpp"
+#include "sim/PegasusSimParameters.hpp"
+#include "core/PegasusState.hpp"
+
+#include <filesystem>
+#include <map>
+
+// Builds a simulator running one of the Linux workloads in test/sim/workloads on hart0 with
+// system call emulation. Expects the workloads directory to be linked into the working directory.
+class PegasusWorkloadTester
+{
+  public:
+    using Params = std::map<std::string, std::string>;
+
+    // Parameters for running a Linux workload with system call emulation, including the initial
+    // registers it expects
+    static Params getSyscallEmulationParams()
+    {
+        return {{"top.extension.sim.enable_syscall_emulation", "true"},
+                {"top.extension.sim.reg_overrides",
+                 "[[core0.hart0.sp, 0x0000003ffffff000], [core0.hart0.gp, 0x77000], "
+                 "[core0.hart0.tp, 0x7d000]]"}};
+    }
+
+    // Parameters for a core with the given number of harts, numbered from 0
+    static Params getNumHartsParams(const uint32_t num_harts)
+    {
+        Params params{{"top.core0.params.num_harts", std::to_string(num_harts)}};
+        for (uint32_t hart_idx = 0; hart_idx < num_harts; ++hart_idx)
+        {
+            params["top.core0.hart" + std::to_string(hart_idx) + ".params.hart_id"] =
+                std::to_string(hart_idx);
+        }
+        return params;
+    }
+
+    static std::string getWorkloadPath(const std::string & elf)
+    {
+        return std::filesystem::canonical(std::filesystem::absolute("workloads/" + elf)).string();
+    }
+
+    // The params are added to the system call emulation parameters and can override them.
+    // With boot set, the harts are booted so they can be driven with PegasusSim::runUntil() or
+    // step(). PegasusSim::run() boots them itself.
+    PegasusWorkloadTester(const std::string & elf, const Params & params = {},
+                          const bool boot = true)
+    {
+        pegasus::PegasusSimParameters::WorkloadsAndArgs workloads_and_args{
+            {getWorkloadPath(elf)}};
+        config_.processParameter(
+            "top.extension.sim.workloads",
+            pegasus::PegasusSimParameters::convertVectorToStringParam(workloads_and_args));
+        Params all_params = getSyscallEmulationParams();
+        for (const auto & [name, value] : params)
+        {
+            all_params[name] = value;
+        }
+        for (const auto & [name, value] : all_params)
+        {
+            config_.processParameter(name, value);
+        }
+
+        // Create the simulator
+        pegasus_sim_.reset(new pegasus::PegasusSim(&scheduler_));
+        pegasus_sim_->configure(0, nullptr, &config_);
+        pegasus_sim_->buildTree();
+        pegasus_sim_->configureTree();
+        pegasus_sim_->finalizeTree();
+        if (boot)
+        {
+            pegasus_sim_->getPegasusCore()->boot();
+        }
+    }
+
+    pegasus::PegasusSim* getSim() { return pegasus_sim_.get(); }
+
+    pegasus::PegasusCore* getCore() { return pegasus_sim_->getPegasusCore(); }
+
+    pegasus::PegasusState* getState(pegasus::HartId hart_id = 0)
+    {
+        return getCore()->getPegasusState(hart_id);
+    }
+
+  private:
+    sparta::Scheduler scheduler_;
+    sparta::app::SimulationConfiguration config_;
+    std::unique_ptr<pegasus::PegasusSim> pegasus_sim_;
+};
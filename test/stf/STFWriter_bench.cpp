@@ -0,0 +1,75 @@
+#include "test/sim/WorkloadTester.hpp"
+
+#include <chrono>
+#include <filesystem>
+
+// Measures the trace throughput of the synchronous and buffered STF writers. STFWriter_test
+// checks that they write the same trace.
+
+// Runs Dhrystone with system call emulation, optionally writing an STF trace
+class PegasusSTFWriterBench : public PegasusWorkloadTester
+{
+  public:
+    PegasusSTFWriterBench(const std::string & stf_filename, uint32_t buffer_mb) :
+        PegasusWorkloadTester("rv64_dhry.elf", getParams(stf_filename, buffer_mb))
+    {
+    }
+
+  private:
+    static Params getParams(const std::string & stf_filename, uint32_t buffer_mb)
+    {
+        if (stf_filename.empty())
+        {
+            return {};
+        }
+        return {{"top.core0.hart0.params.stf_filename", stf_filename},
+                {"top.core0.hart0.params.stf_writer_buffer_mb", std::to_string(buffer_mb)}};
+    }
+};
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_INSTS = 2000000;
+
+// Returns the trace throughput in MIPS. The time includes tearing down the simulator so
+// all of the records buffered for the writer thread are on disk.
+double runDhrystone(const std::string & name, const std::string & stf_filename,
+                    uint32_t buffer_mb)
+{
+    auto bench = std::make_unique<PegasusSTFWriterBench>(stf_filename, buffer_mb);
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t num_insts = bench->getSim()->runUntil(CORE_ID, HART_ID, NUM_INSTS, 0).num_insts;
+    bench.reset();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    const double mips = us ? (num_insts / us) : 0.0;
+    std::cout << "    " << name << ": " << std::dec << num_insts << " instructions, " << mips
+              << " MIPS";
+    if (!stf_filename.empty())
+    {
+        std::cout << ", " << std::filesystem::file_size(stf_filename) << " byte trace";
+    }
+    std::cout << std::endl;
+    return mips;
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "Benchmarking STF trace generation on Dhrystone" << std::endl;
+
+    runDhrystone("no trace", "", 0);
+    runDhrystone("synchronous writer", "dhry_sync.zstf", 0);
+    runDhrystone("writer thread (4 MB)", "dhry_4mb.zstf", 4);
+    runDhrystone("writer thread (64 MB)", "dhry_64mb.zstf", 64);
+
+    for (const auto & filename : {"dhry_sync.zstf", "dhry_4mb.zstf", "dhry_64mb.zstf"})
+    {
+        std::filesystem::remove(filename);
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "test/sim/WorkloadTester.hpp"
+
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+// Runs Dhrystone with system call emulation and writes an STF trace
+class PegasusSTFWriterTester : public PegasusWorkloadTester
+{
+  public:
+    PegasusSTFWriterTester(const std::string & stf_filename, uint32_t buffer_mb) :
+        PegasusWorkloadTester("rv64_dhry.elf",
+                              {{"top.core0.hart0.params.stf_filename", stf_filename},
+                               {"top.core0.hart0.params.stf_writer_buffer_mb",
+                                std::to_string(buffer_mb)}})
+    {
+    }
+};
+
+static constexpr pegasus::CoreId CORE_ID = 0;
+static constexpr pegasus::HartId HART_ID = 0;
+static constexpr uint64_t NUM_INSTS = 200000;
+
+// Returns the contents of the trace. Tearing down the simulator flushes the records buffered
+// for the writer thread.
+std::vector<char> writeTrace(const std::string & stf_filename, uint32_t buffer_mb)
+{
+    {
+        PegasusSTFWriterTester tester(stf_filename, buffer_mb);
+        EXPECT_EQUAL(tester.getSim()->runUntil(CORE_ID, HART_ID, NUM_INSTS, 0).num_insts,
+                     NUM_INSTS);
+    }
+
+    std::vector<char> trace;
+    {
+        std::ifstream file(stf_filename, std::ios::binary);
+        trace.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::filesystem::remove(stf_filename);
+    return trace;
+}
+
+void testBufferedWriter()
+{
+    std::cout << "Testing the buffered STF writer against the synchronous writer" << std::endl;
+
+    // Buffering the records must not change the trace, including when the 1 MB buffer fills up
+    // and the simulation thread has to wait for the writer thread
+    const auto sync_trace = writeTrace("dhry_sync.zstf", 0);
+    EXPECT_FALSE(sync_trace.empty());
+    EXPECT_TRUE(writeTrace("dhry_1mb.zstf", 1) == sync_trace);
+    EXPECT_TRUE(writeTrace("dhry_64mb.zstf", 64) == sync_trace);
+}
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    testBufferedWriter();
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
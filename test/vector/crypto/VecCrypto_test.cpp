@@ -0,0 +1,435 @@
+#include "test/sim/InstructionTester.hpp"
+#include "core/VecCrypto.hpp"
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+// Runs the NIST/GM test vectors through both vector crypto engines, checks that the host and
+// portable engines agree on random inputs, and executes the instructions on a register group
+class VecCryptoTester : public PegasusInstructionTester
+{
+  public:
+    VecCryptoTester() :
+        PegasusInstructionTester("rv64imafdcv_zicsr_zifencei_zvkned_zvknhb_zvksed_zvksh")
+    {
+    }
+
+    static std::vector<uint8_t> fromHex(const std::string & str)
+    {
+        std::vector<uint8_t> bytes;
+        for (size_t idx = 0; idx < str.size(); idx += 2)
+        {
+            bytes.emplace_back(std::stoul(str.substr(idx, 2), nullptr, 16));
+        }
+        return bytes;
+    }
+
+    static std::string toHex(const uint8_t* bytes, size_t num_bytes)
+    {
+        std::ostringstream os;
+        for (size_t idx = 0; idx < num_bytes; ++idx)
+        {
+            os << std::hex << std::setw(2) << std::setfill('0') << (uint32_t)bytes[idx];
+        }
+        return os.str();
+    }
+
+    template <typename T> static std::string toHex(const std::vector<T> & words)
+    {
+        std::ostringstream os;
+        for (const T word : words)
+        {
+            os << std::hex << std::setw(sizeof(T) * 2) << std::setfill('0') << (uint64_t)word;
+        }
+        return os.str();
+    }
+
+    // FIPS-197 Appendix C.1 and C.3
+    void testAes(const pegasus::VecCryptoEngine & engine)
+    {
+        const std::vector<uint8_t> plaintext = fromHex("00112233445566778899aabbccddeeff");
+        uint8_t round_keys[15][16];
+        uint8_t state[16];
+
+        // AES-128
+        const std::vector<uint8_t> key128 = fromHex("000102030405060708090a0b0c0d0e0f");
+        std::memcpy(round_keys[0], key128.data(), 16);
+        for (uint32_t rnd = 1; rnd <= 10; ++rnd)
+        {
+            engine.aeskf1(round_keys[rnd], round_keys[rnd - 1], 1, rnd);
+        }
+
+        std::memcpy(state, plaintext.data(), 16);
+        engine.aesz(state, round_keys[0], 1, 0);
+        for (uint32_t rnd = 1; rnd < 10; ++rnd)
+        {
+            engine.aesem(state, round_keys[rnd], 1, 0);
+        }
+        engine.aesef(state, round_keys[10], 1, 0);
+        EXPECT_EQUAL(toHex(state, 16), "69c4e0d86a7b0430d8cdb78070b4c55a");
+
+        engine.aesz(state, round_keys[10], 1, 0);
+        for (uint32_t rnd = 9; rnd >= 1; --rnd)
+        {
+            engine.aesdm(state, round_keys[rnd], 1, 0);
+        }
+        engine.aesdf(state, round_keys[0], 1, 0);
+        EXPECT_EQUAL(toHex(state, 16), toHex(plaintext.data(), 16));
+
+        // AES-256
+        const std::vector<uint8_t> key256 =
+            fromHex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+        std::memcpy(round_keys[0], key256.data(), 16);
+        std::memcpy(round_keys[1], key256.data() + 16, 16);
+        for (uint32_t rnd = 2; rnd <= 14; ++rnd)
+        {
+            std::memcpy(round_keys[rnd], round_keys[rnd - 2], 16);
+            engine.aeskf2(round_keys[rnd], round_keys[rnd - 1], 1, rnd);
+        }
+
+        std::memcpy(state, plaintext.data(), 16);
+        engine.aesz(state, round_keys[0], 1, 0);
+        for (uint32_t rnd = 1; rnd < 14; ++rnd)
+        {
+            engine.aesem(state, round_keys[rnd], 1, 0);
+        }
+        engine.aesef(state, round_keys[14], 1, 0);
+        EXPECT_EQUAL(toHex(state, 16), "8ea2b7ca516745bfeafc49904b496089");
+
+        engine.aesz(state, round_keys[14], 1, 0);
+        for (uint32_t rnd = 13; rnd >= 1; --rnd)
+        {
+            engine.aesdm(state, round_keys[rnd], 1, 0);
+        }
+        engine.aesdf(state, round_keys[0], 1, 0);
+        EXPECT_EQUAL(toHex(state, 16), toHex(plaintext.data(), 16));
+    }
+
+    // SHA-256 or SHA-512 of a single padded block, the way software uses vsha2ms and vsha2c[hl]
+    template <typename T>
+    static std::string sha2Block(pegasus::VecCryptoEngine::ThreeOpFunc ms,
+                                 pegasus::VecCryptoEngine::ThreeOpFunc cl,
+                                 pegasus::VecCryptoEngine::ThreeOpFunc ch,
+                                 const std::vector<T> & k, const std::vector<T> & h,
+                                 const std::vector<T> & block)
+    {
+        std::vector<T> w(k.size());
+        std::copy(block.begin(), block.end(), w.begin());
+        for (size_t idx = 16; idx < w.size(); idx += 4)
+        {
+            T vd[4] = {w[idx - 16], w[idx - 15], w[idx - 14], w[idx - 13]};
+            T vs2[4] = {w[idx - 12], w[idx - 7], w[idx - 6], w[idx - 5]};
+            T vs1[4] = {w[idx - 4], w[idx - 3], w[idx - 2], w[idx - 1]};
+            ms((uint8_t*)vd, (uint8_t*)vs2, (uint8_t*)vs1, 1);
+            std::copy(vd, vd + 4, w.begin() + idx);
+        }
+
+        T abef[4] = {h[5], h[4], h[1], h[0]};
+        T cdgh[4] = {h[7], h[6], h[3], h[2]};
+        for (size_t idx = 0; idx < w.size(); idx += 4)
+        {
+            T wk[4];
+            for (size_t word = 0; word < 4; ++word)
+            {
+                wk[word] = w[idx + word] + k[idx + word];
+            }
+            cl((uint8_t*)cdgh, (uint8_t*)abef, (uint8_t*)wk, 1);
+            ch((uint8_t*)abef, (uint8_t*)cdgh, (uint8_t*)wk, 1);
+        }
+
+        return toHex(std::vector<T>{
+            T(abef[3] + h[0]), T(abef[2] + h[1]), T(cdgh[3] + h[2]), T(cdgh[2] + h[3]),
+            T(abef[1] + h[4]), T(abef[0] + h[5]), T(cdgh[1] + h[6]), T(cdgh[0] + h[7])});
+    }
+
+    // FIPS 180-2 "abc"
+    void testSha2(const pegasus::VecCryptoEngine & engine)
+    {
+        const std::vector<uint32_t> k256{
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+            0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+            0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+            0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+            0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+            0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+            0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+            0xc67178f2};
+        const std::vector<uint32_t> h256{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::vector<uint32_t> block256(16, 0);
+        block256[0] = 0x61626380;
+        block256[15] = 24;
+        EXPECT_EQUAL(sha2Block(engine.sha256ms, engine.sha256cl, engine.sha256ch, k256, h256,
+                               block256),
+                     "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+        const std::vector<uint64_t> k512{
+            0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+            0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+            0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+            0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+            0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+            0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+            0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+            0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+            0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+            0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+            0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+            0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+            0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+            0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+            0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+            0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+            0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+            0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+            0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+            0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+        const std::vector<uint64_t> h512{0x6a09e667f3bcc908, 0xbb67ae8584caa73b,
+                                         0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+                                         0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+                                         0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+        std::vector<uint64_t> block512(16, 0);
+        block512[0] = 0x6162638000000000;
+        block512[15] = 24;
+        EXPECT_EQUAL(sha2Block(engine.sha512ms, engine.sha512cl, engine.sha512ch, k512, h512,
+                               block512),
+                     "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                     "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+    }
+
+    // GB/T 32907-2016 Appendix A.1
+    void testSm4(const pegasus::VecCryptoEngine & engine)
+    {
+        const uint32_t fk[4] = {0xa3b1bac6, 0x56aa3350, 0x677d9197, 0xb27022dc};
+        const uint32_t text[4] = {0x01234567, 0x89abcdef, 0xfedcba98, 0x76543210};
+        uint32_t round_keys[36];
+        for (size_t idx = 0; idx < 4; ++idx)
+        {
+            round_keys[idx] = text[idx] ^ fk[idx];
+        }
+        for (uint32_t rnd = 0; rnd < 8; ++rnd)
+        {
+            engine.sm4k((uint8_t*)&round_keys[4 * rnd + 4], (uint8_t*)&round_keys[4 * rnd], 1,
+                        rnd);
+        }
+
+        uint32_t state[4] = {text[0], text[1], text[2], text[3]};
+        for (uint32_t rnd = 0; rnd < 8; ++rnd)
+        {
+            engine.sm4r((uint8_t*)state, (uint8_t*)&round_keys[4 * rnd + 4], 1, 0);
+        }
+        EXPECT_EQUAL(toHex(std::vector<uint32_t>{state[3], state[2], state[1], state[0]}),
+                     "681edf34d206965e86b3e94f536e4246");
+    }
+
+    // GB/T 32905-2016 Appendix A.1 "abc", words are big endian in the registers
+    void testSm3(const pegasus::VecCryptoEngine & engine)
+    {
+        uint8_t w[68 * 4] = {};
+        w[0] = 'a';
+        w[1] = 'b';
+        w[2] = 'c';
+        w[3] = 0x80;
+        w[63] = 24;
+        for (size_t idx = 16; idx < 68; idx += 8)
+        {
+            uint8_t next[32];
+            engine.sm3me(next, &w[(idx - 8) * 4], &w[(idx - 16) * 4], 1);
+            std::memcpy(&w[idx * 4], next, std::min<size_t>(8, 68 - idx) * 4);
+        }
+
+        const uint32_t iv[8] = {0x7380166f, 0x4914b2b9, 0x172442d7, 0xda8a0600,
+                                0xa96f30bc, 0x163138aa, 0xe38dee4d, 0xb0fb0e4e};
+        uint8_t state[32];
+        for (size_t idx = 0; idx < 8; ++idx)
+        {
+            const uint32_t word = __builtin_bswap32(iv[idx]);
+            std::memcpy(&state[idx * 4], &word, 4);
+        }
+        uint8_t initial[32];
+        std::memcpy(initial, state, 32);
+        for (uint32_t rnds = 0; rnds < 32; ++rnds)
+        {
+            engine.sm3c(state, &w[rnds * 8], 1, rnds);
+        }
+        for (size_t idx = 0; idx < 32; ++idx)
+        {
+            state[idx] ^= initial[idx];
+        }
+        EXPECT_EQUAL(toHex(state, 32),
+                     "66c7f0f462eeedd9d1f2d46bdc10e4e24167c4875cf2f7a2297da02b8f4ba8e0");
+    }
+
+    // The host and portable engines must be bit identical on several element groups at once
+    void testHostMatchesPortable()
+    {
+        const pegasus::VecCryptoEngine & portable = pegasus::vec_crypto::getPortableEngine();
+        const pegasus::VecCryptoEngine & host = pegasus::vec_crypto::getHostEngine();
+        std::cout << "Host AES: " << pegasus::vec_crypto::hostHasAes()
+                  << ", host SHA: " << pegasus::vec_crypto::hostHasSha() << std::endl;
+
+        static constexpr size_t NUM_BYTES = 256;
+        std::mt19937 rng(0xc0ffee);
+        auto random_bytes = [&]()
+        {
+            std::vector<uint8_t> bytes(NUM_BYTES);
+            for (uint8_t & byte : bytes)
+            {
+                byte = rng();
+            }
+            return bytes;
+        };
+
+        for (uint32_t iter = 0; iter < 100; ++iter)
+        {
+            const std::vector<uint8_t> vd = random_bytes();
+            const std::vector<uint8_t> vs2 = random_bytes();
+            const std::vector<uint8_t> vs1 = random_bytes();
+            const uint32_t uimm = rng() & 0x1f;
+
+            auto compare = [&](const char* name, auto portable_func, auto host_func, auto call)
+            {
+                std::vector<uint8_t> portable_vd = vd;
+                std::vector<uint8_t> host_vd = vd;
+                call(portable_func, portable_vd.data());
+                call(host_func, host_vd.data());
+                if (portable_vd != host_vd)
+                {
+                    std::cout << name << " mismatch" << std::endl;
+                }
+                EXPECT_TRUE(portable_vd == host_vd);
+            };
+
+            for (const size_t key_stride : {size_t(0), size_t(16)})
+            {
+                auto aes = [&](auto func, uint8_t* dst) { func(dst, vs2.data(), 16, key_stride); };
+                compare("vaesem", portable.aesem, host.aesem, aes);
+                compare("vaesef", portable.aesef, host.aesef, aes);
+                compare("vaesdm", portable.aesdm, host.aesdm, aes);
+                compare("vaesdf", portable.aesdf, host.aesdf, aes);
+                compare("vaesz", portable.aesz, host.aesz, aes);
+                compare("vsm4r", portable.sm4r, host.sm4r, aes);
+            }
+
+            auto imm = [&](auto func, uint8_t* dst) { func(dst, vs2.data(), 8, uimm); };
+            compare("vaeskf1", portable.aeskf1, host.aeskf1, imm);
+            compare("vaeskf2", portable.aeskf2, host.aeskf2, imm);
+            compare("vsm4k", portable.sm4k, host.sm4k, imm);
+            compare("vsm3c", portable.sm3c, host.sm3c, imm);
+
+            auto three = [&](auto func, uint8_t* dst) { func(dst, vs2.data(), vs1.data(), 8); };
+            compare("vsha2ch (256)", portable.sha256ch, host.sha256ch, three);
+            compare("vsha2cl (256)", portable.sha256cl, host.sha256cl, three);
+            compare("vsha2ms (256)", portable.sha256ms, host.sha256ms, three);
+            compare("vsha2ch (512)", portable.sha512ch, host.sha512ch, three);
+            compare("vsha2cl (512)", portable.sha512cl, host.sha512cl, three);
+            compare("vsha2ms (512)", portable.sha512ms, host.sha512ms, three);
+            compare("vsm3me", portable.sm3me, host.sm3me, three);
+        }
+    }
+
+    // vaesem.vv and vaesz.vs on a register group with LMUL=2
+    void testInstructions()
+    {
+        pegasus::PegasusState* state = getPegasusState();
+        const uint32_t vlen = state->getVectorConfig()->getVLEN();
+        const uint32_t vlenb = vlen / 8;
+        static constexpr uint32_t VD = 16;
+        static constexpr uint32_t VS2 = 8;
+
+        std::mt19937_64 rng(0x5eed);
+        std::vector<uint8_t> vd_init(2 * vlenb);
+        std::vector<uint8_t> vs2_init(2 * vlenb);
+        for (uint32_t reg_offset = 0; reg_offset < 2; ++reg_offset)
+        {
+            for (uint32_t idx = 0; idx < (vlenb / 8); ++idx)
+            {
+                const uint64_t vd_val = rng();
+                const uint64_t vs2_val = rng();
+                std::memcpy(&vd_init[(reg_offset * vlenb) + (idx * 8)], &vd_val, 8);
+                std::memcpy(&vs2_init[(reg_offset * vlenb) + (idx * 8)], &vs2_val, 8);
+                pegasus::WRITE_VEC_ELEM<uint64_t>(state, VS2 + reg_offset, vs2_val, idx);
+            }
+        }
+
+        // OP-VE, funct3=OPMVV, vm=1
+        auto run = [&](const uint32_t funct6, const uint32_t vs1)
+        {
+            const uint32_t opcode = (funct6 << 26) | (1 << 25) | (VS2 << 20) | (vs1 << 15)
+                                    | (0b010 << 12) | (VD << 7) | 0x77;
+            pegasus::PegasusInstPtr inst = state->getMavis()->makeInst(opcode, state);
+
+            pegasus::VectorConfig* config = state->getVectorConfig();
+            config->setSEW(32);
+            config->setLMUL(16);
+            config->setVL(vlen * 2 / 32);
+            config->setVSTART(0);
+            for (uint32_t reg_offset = 0; reg_offset < 2; ++reg_offset)
+            {
+                for (uint32_t idx = 0; idx < (vlenb / 8); ++idx)
+                {
+                    uint64_t value;
+                    std::memcpy(&value, &vd_init[(reg_offset * vlenb) + (idx * 8)], 8);
+                    pegasus::WRITE_VEC_ELEM<uint64_t>(state, VD + reg_offset, value, idx);
+                }
+            }
+            inst->updateVectorConfig(state);
+            executeInstruction(inst);
+
+            std::vector<uint8_t> result(2 * vlenb);
+            for (uint32_t reg_offset = 0; reg_offset < 2; ++reg_offset)
+            {
+                for (uint32_t idx = 0; idx < (vlenb / 8); ++idx)
+                {
+                    const uint64_t value =
+                        pegasus::READ_VEC_ELEM<uint64_t>(state, VD + reg_offset, idx);
+                    std::memcpy(&result[(reg_offset * vlenb) + (idx * 8)], &value, 8);
+                }
+            }
+            return result;
+        };
+
+        const pegasus::VecCryptoEngine & engine = pegasus::vec_crypto::getPortableEngine();
+        const size_t num_egs = (2 * vlenb) / 16;
+
+        std::vector<uint8_t> expected = vd_init;
+        engine.aesem(expected.data(), vs2_init.data(), num_egs, 16);
+        EXPECT_TRUE(run(0b101000, 0b00010) == expected);
+
+        expected = vd_init;
+        engine.aesz(expected.data(), vs2_init.data(), num_egs, 0);
+        EXPECT_TRUE(run(0b101001, 0b00111) == expected);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    VecCryptoTester tester;
+    for (const pegasus::VecCryptoEngine* engine :
+         {&pegasus::vec_crypto::getPortableEngine(), &pegasus::vec_crypto::getHostEngine()})
+    {
+        std::cout << "Testing the " << engine->name << " vector crypto engine" << std::endl;
+        tester.testAes(*engine);
+        tester.testSha2(*engine);
+        tester.testSm4(*engine);
+        tester.testSm3(*engine);
+    }
+    tester.testHostMatchesPortable();
+
+    for (const bool host_crypto : {false, true})
+    {
+        tester.getPegasusState()->setHostCryptoEnabled(host_crypto);
+        tester.testInstructions();
+    }
+
+    REPORT_ERROR;
+    return ERROR_CODE;
+}
@@ -0,0 +1,134 @@
+#include "test/sim/InstructionTester.hpp"
+
+#include <chrono>
+#include <random>
+
+// Compares the speed of the whole-register engine against the element path for element-wise
+// vector integer instructions. Via_test checks that both paths produce the same results.
+class VecKernelsBench : public PegasusInstructionTester
+{
+  public:
+    VecKernelsBench()
+    {
+        pegasus::PegasusState* state = getPegasusState();
+        vlen_ = state->getVectorConfig()->getVLEN();
+
+        // Random register contents, v0 is the mask
+        std::mt19937_64 rng(0x5eed);
+        for (uint32_t reg = 0; reg < 32; ++reg)
+        {
+            for (uint32_t idx = 0; idx < (vlen_ / 64); ++idx)
+            {
+                pegasus::WRITE_VEC_ELEM<uint64_t>(state, reg, rng(), idx);
+            }
+        }
+    }
+
+    struct OpcodeInfo
+    {
+        std::string mnemonic;
+        uint32_t funct6;
+        uint32_t funct3;
+        uint32_t rs1;
+    };
+
+    void runOpcode(const OpcodeInfo & info, const uint32_t sew, const bool masked)
+    {
+        pegasus::PegasusState* state = getPegasusState();
+        const uint32_t opcode = (info.funct6 << 26) | ((masked ? 0 : 1) << 25) | (VS2 << 20)
+                                | (info.rs1 << 15) | (info.funct3 << 12) | (VD << 7) | 0x57;
+        pegasus::PegasusInstPtr inst = state->getMavis()->makeInst(opcode, state);
+
+        // LMUL=8, VL=VLMAX
+        pegasus::VectorConfig* config = state->getVectorConfig();
+        config->setSEW(sew);
+        config->setLMUL(64);
+        config->setVL(vlen_ * 8 / sew);
+        config->setVSTART(0);
+
+        const std::vector<uint64_t> vd_init = readGroup_(VD);
+        auto run = [&](const bool vec_kernels_enabled)
+        {
+            state->setVecKernelsEnabled(vec_kernels_enabled);
+            writeGroup_(VD, vd_init);
+            inst->updateVectorConfig(state);
+
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t iter = 0; iter < NUM_ITERS; ++iter)
+            {
+                executeInstruction(inst);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            const double ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            return ns / NUM_ITERS;
+        };
+
+        const double element_ns = run(false);
+        const double kernel_ns = run(true);
+
+        std::cout << "    " << info.mnemonic << (masked ? " (masked)" : "") << " SEW=" << std::dec
+                  << sew << ": element " << element_ns << "ns, whole-register " << kernel_ns
+                  << "ns, speedup " << (kernel_ns ? (element_ns / kernel_ns) : 0.0) << "x"
+                  << std::endl;
+    }
+
+  private:
+    static constexpr uint32_t VD = 16;
+    static constexpr uint32_t VS2 = 8;
+    static constexpr uint32_t NUM_ITERS = 2000;
+
+    uint32_t vlen_ = 0;
+
+    std::vector<uint64_t> readGroup_(const uint32_t reg)
+    {
+        std::vector<uint64_t> values;
+        for (uint32_t reg_offset = 0; reg_offset < 8; ++reg_offset)
+        {
+            for (uint32_t idx = 0; idx < (vlen_ / 64); ++idx)
+            {
+                values.emplace_back(pegasus::READ_VEC_ELEM<uint64_t>(getPegasusState(),
+                                                                     reg + reg_offset, idx));
+            }
+        }
+        return values;
+    }
+
+    void writeGroup_(const uint32_t reg, const std::vector<uint64_t> & values)
+    {
+        const uint32_t elems_per_reg = vlen_ / 64;
+        for (uint32_t elem = 0; elem < values.size(); ++elem)
+        {
+            pegasus::WRITE_VEC_ELEM<uint64_t>(getPegasusState(), reg + (elem / elems_per_reg),
+                                              values[elem], elem % elems_per_reg);
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    VecKernelsBench bench;
+
+    // funct3: OPIVV=0, OPMVV=2, OPIVI=3, OPIVX=4
+    const std::vector<VecKernelsBench::OpcodeInfo> opcodes{
+        {"vadd.vv", 0b000000, 0b000, 24}, {"vsub.vv", 0b000010, 0b000, 24},
+        {"vand.vv", 0b001001, 0b000, 24}, {"vxor.vv", 0b001011, 0b000, 24},
+        {"vmaxu.vv", 0b000110, 0b000, 24}, {"vmul.vv", 0b100101, 0b010, 24},
+        {"vadd.vx", 0b000000, 0b100, 5},  {"vadd.vi", 0b000000, 0b011, 7},
+    };
+
+    std::cout << "Benchmarking element-wise vector integer instructions" << std::endl;
+    for (const auto & info : opcodes)
+    {
+        for (const uint32_t sew : {8, 16, 32, 64})
+        {
+            bench.runOpcode(info, sew, false);
+        }
+        bench.runOpcode(info, 32, true);
+    }
+
+    return 0;
+}
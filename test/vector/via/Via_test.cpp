@@ -3,6 +3,8 @@
 #include "sparta/utils/SpartaTester.hpp"
 #include "mavis/Mavis.h"
 
+#include <random>
+
 class ViaInstructionTester : public PegasusInstructionTester
 {
 
@@ -191,6 +193,80 @@ class ViaInstructionTester : public PegasusInstructionTester
         EXPECT_EQUAL(sim_state->inst_count, 4);
     }
 
+    // The whole-register engine must produce the same results as the element path
+    void testVecKernels()
+    {
+        pegasus::PegasusState* state = getPegasusState();
+        const uint32_t vlen = state->getVectorConfig()->getVLEN();
+
+        // Random register contents, v0 is the mask
+        std::mt19937_64 rng(0x5eed);
+        for (uint32_t reg = 0; reg < 32; ++reg)
+        {
+            for (uint32_t idx = 0; idx < (vlen / 64); ++idx)
+            {
+                pegasus::WRITE_VEC_ELEM<uint64_t>(state, reg, rng(), idx);
+            }
+        }
+
+        struct OpcodeInfo
+        {
+            std::string mnemonic;
+            uint32_t funct6;
+            uint32_t funct3;
+            uint32_t rs1;
+        };
+
+        // funct3: OPIVV=0, OPMVV=2, OPIVI=3, OPIVX=4
+        const std::vector<OpcodeInfo> opcodes{
+            {"vadd.vv", 0b000000, 0b000, 24}, {"vsub.vv", 0b000010, 0b000, 24},
+            {"vand.vv", 0b001001, 0b000, 24}, {"vxor.vv", 0b001011, 0b000, 24},
+            {"vmaxu.vv", 0b000110, 0b000, 24}, {"vmul.vv", 0b100101, 0b010, 24},
+            {"vadd.vx", 0b000000, 0b100, 5},  {"vadd.vi", 0b000000, 0b011, 7},
+        };
+
+        const uint32_t vd = 16, vs2 = 8;
+        for (const auto & info : opcodes)
+        {
+            for (const uint32_t sew : {8, 16, 32, 64})
+            {
+                for (const bool masked : {false, true})
+                {
+                    for (const uint32_t vstart : {0, 3})
+                    {
+                        std::cout << "Testing " << info.mnemonic << (masked ? " (masked)" : "")
+                                  << " SEW=" << std::dec << sew << " vstart=" << vstart
+                                  << std::endl;
+                        const uint32_t opcode = (info.funct6 << 26) | ((masked ? 0 : 1) << 25)
+                                                | (vs2 << 20) | (info.rs1 << 15)
+                                                | (info.funct3 << 12) | (vd << 7) | 0x57;
+                        pegasus::PegasusInstPtr inst = state->getMavis()->makeInst(opcode, state);
+
+                        // LMUL=8, VL=VLMAX
+                        pegasus::VectorConfig* config = state->getVectorConfig();
+                        config->setSEW(sew);
+                        config->setLMUL(64);
+                        config->setVL(vlen * 8 / sew);
+
+                        const std::vector<uint64_t> vd_init = readGroup_(vd, vlen);
+                        std::vector<uint64_t> results[2];
+                        for (const bool vec_kernels_enabled : {false, true})
+                        {
+                            state->setVecKernelsEnabled(vec_kernels_enabled);
+                            writeGroup_(vd, vd_init, vlen);
+                            config->setVSTART(vstart);
+                            inst->updateVectorConfig(state);
+                            executeInstruction(inst);
+                            results[vec_kernels_enabled] = readGroup_(vd, vlen);
+                        }
+                        EXPECT_TRUE(results[false] == results[true]);
+                        writeGroup_(vd, vd_init, vlen);
+                    }
+                }
+            }
+        }
+    }
+
     uint32_t vaddvvOp(uint8_t rd, uint8_t rs1, uint8_t rs2, uint8_t vm)
     {
         uint32_t opcode = 0;
@@ -215,6 +291,32 @@ class ViaInstructionTester : public PegasusInstructionTester
 
   private:
     pegasus::PegasusInst::PtrType instPtr_ = nullptr;
+
+    // Reads the 8 registers of an LMUL=8 group
+    std::vector<uint64_t> readGroup_(const uint32_t reg, const uint32_t vlen)
+    {
+        std::vector<uint64_t> values;
+        for (uint32_t reg_offset = 0; reg_offset < 8; ++reg_offset)
+        {
+            for (uint32_t idx = 0; idx < (vlen / 64); ++idx)
+            {
+                values.emplace_back(pegasus::READ_VEC_ELEM<uint64_t>(getPegasusState(),
+                                                                     reg + reg_offset, idx));
+            }
+        }
+        return values;
+    }
+
+    void writeGroup_(const uint32_t reg, const std::vector<uint64_t> & values,
+                     const uint32_t vlen)
+    {
+        const uint32_t elems_per_reg = vlen / 64;
+        for (uint32_t elem = 0; elem < values.size(); ++elem)
+        {
+            pegasus::WRITE_VEC_ELEM<uint64_t>(getPegasusState(), reg + (elem / elems_per_reg),
+                                              values[elem], elem % elems_per_reg);
+        }
+    }
 };
 
 int main()
@@ -226,6 +328,9 @@ int main()
     Via_tester.testVaddvv3();
     Via_tester.testVaddvv4();
 
+    ViaInstructionTester vec_kernels_tester;
+    vec_kernels_tester.testVecKernels();
+
     REPORT_ERROR;
     return ERROR_CODE;
 }
@@ -110,6 +110,70 @@ class VlsInstructionTester : public PegasusInstructionTester
         EXPECT_EQUAL(sim_state->inst_count, 3);
     }
 
+    void testVle8PageCrossing()
+    {
+        pegasus::PegasusState* state = getPegasusState();
+        const uint64_t pc = 0x1000;
+        const pegasus::Addr addr = 0x2ffc; // 4 bytes on each page
+        const uint64_t mem_val = 0x1112131415161718;
+        const uint32_t vd = 4, vs3 = 4, rs1 = 1;
+
+        state->getVectorConfig()->setVLEN(64);
+        state->getVectorConfig()->setVSTART(0);
+        state->getVectorConfig()->setVL(8); // avl = 8
+        state->writeMemory<uint64_t>(addr, mem_val);
+        WRITE_INT_REG<XLEN>(state, rs1, addr);
+
+        // Whole-register path and element path load the same bytes
+        for (const bool vec_kernels_enabled : {true, false})
+        {
+            state->setVecKernelsEnabled(vec_kernels_enabled);
+            WRITE_VEC_REG<VLEN>(state, vd, VLEN{});
+            injectInstruction(pc, vle8Op(vd, rs1, 1));
+
+            const VLEN vd_val = READ_VEC_REG<VLEN>(state, vd);
+            for (size_t i = 0; i < vd_val.size(); ++i)
+            {
+                EXPECT_EQUAL(vd_val[i], reinterpret_cast<const uint8_t*>(&mem_val)[i]);
+            }
+        }
+        state->setVecKernelsEnabled(true);
+
+        // Store it back one byte further
+        WRITE_INT_REG<XLEN>(state, rs1, addr + 1);
+        injectInstruction(pc, vse8Op(vs3, rs1, 1));
+        EXPECT_EQUAL(*state->readMemory<uint64_t>(addr + 1), mem_val);
+    }
+
+    void testVle8Vstart()
+    {
+        pegasus::PegasusState* state = getPegasusState();
+        const uint64_t pc = 0x1000;
+        const pegasus::Addr addr = 0x2000;
+        const uint64_t mem_val = 0x2122232425262728;
+        const uint32_t vd = 5, rs1 = 1;
+        const VLEN vd_init = {0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7};
+
+        state->getVectorConfig()->setVLEN(64);
+        state->getVectorConfig()->setVSTART(3);
+        state->getVectorConfig()->setVL(6);
+        state->writeMemory<uint64_t>(addr, mem_val);
+        WRITE_INT_REG<XLEN>(state, rs1, addr);
+        WRITE_VEC_REG<VLEN>(state, vd, vd_init);
+
+        injectInstruction(pc, vle8Op(vd, rs1, 1));
+
+        // Only the elements in [vstart, vl) are loaded
+        const VLEN vd_val = READ_VEC_REG<VLEN>(state, vd);
+        for (size_t i = 0; i < vd_val.size(); ++i)
+        {
+            const bool body = (i >= 3) && (i < 6);
+            EXPECT_EQUAL(vd_val[i],
+                         body ? reinterpret_cast<const uint8_t*>(&mem_val)[i] : vd_init[i]);
+        }
+        state->getVectorConfig()->setVSTART(0);
+    }
+
     uint32_t vle8Op(uint8_t rd, uint8_t rs1, uint8_t vm)
     {
         uint32_t opcode = 0;
@@ -134,6 +198,12 @@ class VlsInstructionTester : public PegasusInstructionTester
         return opcode;
     }
 
+    uint32_t vse8Op(uint8_t vs3, uint8_t rs1, uint8_t vm)
+    {
+        // Same encoding as vle8.v with the STORE-FP major opcode
+        return (vle8Op(vs3, rs1, vm) & ~0x7fu) | 0x27;
+    }
+
     uint32_t vlse8Op(uint8_t rd, uint8_t rs1, uint8_t rs2, uint8_t vm)
     {
         uint32_t opcode = 0;
@@ -193,6 +263,8 @@ int main()
     Vls_tester.testVle8();
     Vls_tester.testVlse8();
     Vls_tester.testVloxei8();
+    Vls_tester.testVle8PageCrossing();
+    Vls_tester.testVle8Vstart();
 
     REPORT_ERROR;
     return ERROR_CODE;